@@ -0,0 +1,113 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisLayerStyleBenchmark.h"
+
+#include <simpletest.h>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_image.h>
+#include <kis_image_config.h>
+#include <kis_paint_layer.h>
+#include <kis_paint_device.h>
+#include <kis_psd_layer_style.h>
+
+#define NUM_DABS 200
+#define DAB_SIZE 8
+
+void KisLayerStyleBenchmark::benchmarkStyledLayerUpdates_data()
+{
+    QTest::addColumn<bool>("paintStroke");
+    QTest::addColumn<bool>("useCache");
+
+    QTest::newRow("stroke, no cache") << true << false;
+    QTest::newRow("stroke, cache") << true << true;
+    QTest::newRow("opacity, no cache") << false << false;
+    QTest::newRow("opacity, cache") << false << true;
+}
+
+/**
+ * Emulates editing a text-sized layer with a drop shadow, a stroke,
+ * a bevel and a satin: either painting a stroke across the glyphs or
+ * dragging the opacity slider of the layer
+ */
+void KisLayerStyleBenchmark::benchmarkStyledLayerUpdates()
+{
+    QFETCH(bool, paintStroke);
+    QFETCH(bool, useCache);
+
+    KisImageConfig config(false);
+    const bool oldUseCache = config.useLayerStyleTileCache();
+    config.setUseLayerStyleTileCache(useCache);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 1024, 1024, cs, "layer style benchmark");
+
+    KisPaintLayerSP layer = new KisPaintLayer(image, "text", OPACITY_OPAQUE_U8, cs);
+    image->addNode(layer, image->root());
+
+    const QRect textRect(300, 400, 400, 60);
+    const KoColor textColor(Qt::black, cs);
+
+    // the "glyphs" of the text
+    for (int x = textRect.x(); x < textRect.right(); x += 32) {
+        layer->paintDevice()->fill(QRect(x, textRect.y(), 20, textRect.height()), textColor);
+    }
+
+    KisPSDLayerStyleSP style(new KisPSDLayerStyle());
+
+    style->dropShadow()->setEffectEnabled(true);
+    style->dropShadow()->setSize(10);
+    style->dropShadow()->setDistance(6);
+    style->dropShadow()->setOpacity(70);
+
+    style->stroke()->setEffectEnabled(true);
+    style->stroke()->setSize(2);
+    style->stroke()->setPosition(psd_stroke_outside);
+
+    style->bevelAndEmboss()->setEffectEnabled(true);
+    style->bevelAndEmboss()->setSize(5);
+    style->bevelAndEmboss()->setDepth(100);
+
+    style->satin()->setEffectEnabled(true);
+    style->satin()->setSize(8);
+    style->satin()->setDistance(6);
+
+    layer->setLayerStyle(style);
+
+    image->initialRefreshGraph();
+
+    int iteration = 0;
+
+    QBENCHMARK {
+        if (paintStroke) {
+            const KoColor dabColor(iteration++ % 2 ? Qt::black : Qt::transparent, cs);
+
+            for (int i = 0; i < NUM_DABS; i++) {
+                const QRect dabRect(textRect.x() + i * textRect.width() / NUM_DABS,
+                                    textRect.center().y() + (i % 8 - 4) * 2,
+                                    DAB_SIZE, DAB_SIZE);
+
+                layer->paintDevice()->fill(dabRect, dabColor);
+                layer->setDirty(dabRect);
+            }
+        } else {
+            for (int i = 0; i < 10; i++) {
+                layer->setOpacity(OPACITY_OPAQUE_U8 - 10 * i);
+                layer->setDirty();
+            }
+        }
+
+        image->waitForDone();
+    }
+
+    config.setUseLayerStyleTileCache(oldUseCache);
+}
+
+SIMPLE_TEST_MAIN(KisLayerStyleBenchmark)
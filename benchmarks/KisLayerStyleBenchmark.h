@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISLAYERSTYLEBENCHMARK_H
+#define KISLAYERSTYLEBENCHMARK_H
+
+#include <simpletest.h>
+
+/// measures the updates of a small layer with several layer styles
+class KisLayerStyleBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkStyledLayerUpdates_data();
+    void benchmarkStyledLayerUpdates();
+};
+
+#endif // KISLAYERSTYLEBENCHMARK_H
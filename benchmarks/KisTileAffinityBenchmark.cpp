@@ -0,0 +1,99 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTileAffinityBenchmark.h"
+
+#include <simpletest.h>
+
+#include <QThread>
+
+#include "kis_benchmark_values.h"
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_image.h>
+#include <kis_image_config.h>
+#include <kis_paint_device.h>
+#include <kis_paint_layer.h>
+
+#include "KisNumaTopology.h"
+
+#define NUM_LAYERS 16
+#define NUM_PASSES 4
+#define PATCH_SIZE 256
+
+void KisTileAffinityBenchmark::benchmarkRepeatedUpdates_data()
+{
+    QTest::addColumn<int>("numThreads");
+    QTest::addColumn<bool>("useTileAffinity");
+
+    const int maxThreads = QThread::idealThreadCount();
+
+    for (int numThreads : {4, 8, 16, 32, 64, 128, 256}) {
+        /**
+         * The interesting part starts above 32 threads, where the
+         * threads are spread over several sockets
+         */
+        if (numThreads > qMax(8, maxThreads)) break;
+
+        QTest::newRow(qPrintable(QString("%1 threads").arg(numThreads))) << numThreads << false;
+        QTest::newRow(qPrintable(QString("%1 threads, affinity").arg(numThreads))) << numThreads << true;
+    }
+}
+
+/**
+ * The layers are updated patch-by-patch several times in a row, like
+ * it happens when the user paints over the same area. With the tile
+ * affinity every patch is merged by the same thread, so its tiles are
+ * found in the caches of that thread (and in the memory of its node).
+ */
+void KisTileAffinityBenchmark::benchmarkRepeatedUpdates()
+{
+    QFETCH(int, numThreads);
+    QFETCH(bool, useTileAffinity);
+
+    qDebug() << "NUMA nodes:" << KisNumaTopology::numNodes()
+             << "hardware threads:" << QThread::idealThreadCount();
+
+    KisImageConfig config(false);
+    const bool oldUseTileAffinity = config.updaterTileAffinity();
+    config.setUpdaterTileAffinity(useTileAffinity);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT, cs, "tile affinity benchmark");
+    const QRect bounds = image->bounds();
+
+    QVector<KisPaintLayerSP> layers;
+
+    for (int i = 0; i < NUM_LAYERS; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer %1").arg(i), OPACITY_OPAQUE_U8 / 2, cs);
+        layer->paintDevice()->fill(bounds, KoColor(QColor::fromHsv(i * 23 % 360, 200, 200), cs));
+        image->addNode(layer, image->root());
+        layers << layer;
+    }
+
+    image->setWorkingThreadsLimit(numThreads);
+    image->initialRefreshGraph();
+    image->waitForDone();
+
+    QBENCHMARK {
+        for (int pass = 0; pass < NUM_PASSES; pass++) {
+            for (int y = bounds.top(); y <= bounds.bottom(); y += PATCH_SIZE) {
+                for (int x = bounds.left(); x <= bounds.right(); x += PATCH_SIZE) {
+                    const QRect patch(x, y, PATCH_SIZE, PATCH_SIZE);
+                    layers[(x / PATCH_SIZE + y / PATCH_SIZE) % NUM_LAYERS]->setDirty(patch & bounds);
+                }
+            }
+            image->waitForDone();
+        }
+    }
+
+    config.setUpdaterTileAffinity(oldUseTileAffinity);
+}
+
+SIMPLE_TEST_MAIN(KisTileAffinityBenchmark)
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTILEAFFINITYBENCHMARK_H
+#define KISTILEAFFINITYBENCHMARK_H
+
+#include <simpletest.h>
+
+/// measures scaling of the updates with and without the tile affinity of the updater threads
+class KisTileAffinityBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkRepeatedUpdates_data();
+    void benchmarkRepeatedUpdates();
+};
+
+#endif // KISTILEAFFINITYBENCHMARK_H
@@ -0,0 +1,99 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisUpdateCostModelBenchmark.h"
+
+#include <simpletest.h>
+
+#include "kis_benchmark_values.h"
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_image.h>
+#include <kis_image_config.h>
+#include <kis_paint_device.h>
+#include <kis_paint_layer.h>
+#include <kis_group_layer.h>
+#include <kis_filter_mask.h>
+
+#include "filter/kis_filter_registry.h"
+#include "filter/kis_filter_configuration.h"
+#include "filter/kis_filter.h"
+#include <KisGlobalResourcesInterface.h>
+
+#define NUM_EXPENSIVE_LAYERS 50
+
+void KisUpdateCostModelBenchmark::benchmarkMixedSubtrees_data()
+{
+    QTest::addColumn<bool>("useCostModel");
+
+    QTest::newRow("fixed patches") << false;
+    QTest::newRow("cost model") << true;
+}
+
+/**
+ * The image consists of a cheap subtree (a single paint layer) and an
+ * expensive one (a group of many layers with a blur filter mask). Both
+ * subtrees are updated at the same time, so the fixed-size patches of
+ * the expensive subtree define the time when the last thread finishes.
+ */
+void KisUpdateCostModelBenchmark::benchmarkMixedSubtrees()
+{
+    QFETCH(bool, useCostModel);
+
+    KisImageConfig config(false);
+    const bool oldUseCostModel = config.useUpdateCostModel();
+    config.setUseUpdateCostModel(useCostModel);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT, cs, "cost model benchmark");
+    const QRect bounds = image->bounds();
+
+    KisPaintLayerSP cheapLayer = new KisPaintLayer(image, "cheap", OPACITY_OPAQUE_U8, cs);
+    cheapLayer->paintDevice()->fill(bounds, KoColor(Qt::red, cs));
+    image->addNode(cheapLayer, image->root());
+
+    KisGroupLayerSP expensiveGroup = new KisGroupLayer(image, "expensive", OPACITY_OPAQUE_U8);
+    image->addNode(expensiveGroup, image->root());
+
+    for (int i = 0; i < NUM_EXPENSIVE_LAYERS; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer %1").arg(i), OPACITY_OPAQUE_U8 / 2, cs);
+
+        const int offset = i * bounds.width() / (2 * NUM_EXPENSIVE_LAYERS);
+        layer->paintDevice()->fill(bounds.adjusted(offset, offset, -offset, -offset),
+                                   KoColor(QColor::fromHsv(i * 7 % 360, 200, 200), cs));
+        image->addNode(layer, expensiveGroup);
+    }
+
+    KisFilterSP filter = KisFilterRegistry::instance()->value("blur");
+    KIS_ASSERT(filter);
+    KisFilterConfigurationSP configuration = filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    KIS_ASSERT(configuration);
+
+    KisFilterMaskSP blurMask = new KisFilterMask(image, "blur");
+    blurMask->initSelection(expensiveGroup);
+    blurMask->setFilter(configuration->cloneWithResourcesSnapshot());
+    image->addNode(blurMask, expensiveGroup);
+
+    image->initialRefreshGraph();
+    image->waitForDone();
+
+    // let the estimator learn the costs of the nodes
+    image->refreshGraphAsync();
+    image->waitForDone();
+
+    QBENCHMARK {
+        expensiveGroup->setDirty(bounds);
+        cheapLayer->setDirty(bounds);
+        image->waitForDone();
+    }
+
+    config.setUseUpdateCostModel(oldUseCostModel);
+}
+
+SIMPLE_TEST_MAIN(KisUpdateCostModelBenchmark)
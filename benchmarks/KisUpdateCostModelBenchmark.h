@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISUPDATECOSTMODELBENCHMARK_H
+#define KISUPDATECOSTMODELBENCHMARK_H
+
+#include <simpletest.h>
+
+/// compares the fixed-size update patches with the cost-based ones
+class KisUpdateCostModelBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkMixedSubtrees_data();
+    void benchmarkMixedSubtrees();
+};
+
+#endif // KISUPDATECOSTMODELBENCHMARK_H
@@ -0,0 +1,93 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisUpdateQueueBenchmark.h"
+
+#include <simpletest.h>
+
+#include <QRandomGenerator>
+
+#include "kis_benchmark_values.h"
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_image.h>
+#include <kis_paint_layer.h>
+#include <kis_simple_update_queue.h>
+
+#define NUM_RECTS 10000
+#define DAB_SIZE 32
+
+void KisUpdateQueueBenchmark::benchmarkEnqueueRects_data()
+{
+    QTest::addColumn<bool>("scattered");
+    QTest::addColumn<int>("numStrokes");
+
+    QTest::newRow("stroke") << false << 1;
+    QTest::newRow("mirrored strokes") << false << 4;
+    QTest::newRow("multibrush strokes") << false << 16;
+    QTest::newRow("scattered dabs") << true << 1;
+}
+
+/**
+ * Enqueues NUM_RECTS small rects into the queue without processing
+ * it, like it happens when the strokes produce the updates faster
+ * than the image can merge them. The strokes are spread over the
+ * image and interleaved, like with the mirror or multibrush tools.
+ */
+void KisUpdateQueueBenchmark::benchmarkEnqueueRects()
+{
+    QFETCH(bool, scattered);
+    QFETCH(int, numStrokes);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT, cs, "update queue benchmark");
+    const QRect bounds = image->bounds();
+
+    KisPaintLayerSP layer = new KisPaintLayer(image, "layer", OPACITY_OPAQUE_U8, cs);
+    image->addNode(layer, image->root());
+    image->waitForDone();
+
+    QVector<QRect> rects;
+    rects.reserve(NUM_RECTS);
+
+    QRandomGenerator random(1);
+
+    for (int i = 0; i < NUM_RECTS; i++) {
+        QPoint pt;
+
+        if (scattered) {
+            pt = QPoint(random.bounded(bounds.width() - DAB_SIZE),
+                        random.bounded(bounds.height() - DAB_SIZE));
+        } else {
+            const int stroke = i % numStrokes;
+            const int dab = i / numStrokes;
+
+            // every stroke is a horizontal zigzag over its own band of the image
+            const int bandHeight = bounds.height() / numStrokes;
+            const int row = (dab * DAB_SIZE / 2) / (bounds.width() - DAB_SIZE);
+            const int col = (dab * DAB_SIZE / 2) % (bounds.width() - DAB_SIZE);
+
+            pt = QPoint(row & 0x1 ? bounds.width() - DAB_SIZE - col : col,
+                        stroke * bandHeight + (row * DAB_SIZE / 2) % (bandHeight - DAB_SIZE));
+        }
+
+        rects.append(QRect(pt, QSize(DAB_SIZE, DAB_SIZE)));
+    }
+
+    QBENCHMARK {
+        KisSimpleUpdateQueue queue;
+
+        Q_FOREACH (const QRect &rc, rects) {
+            queue.addUpdateJob(layer, rc, bounds, 0);
+        }
+
+        queue.optimize();
+    }
+}
+
+SIMPLE_TEST_MAIN(KisUpdateQueueBenchmark)
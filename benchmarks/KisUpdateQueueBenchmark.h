@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISUPDATEQUEUEBENCHMARK_H
+#define KISUPDATEQUEUEBENCHMARK_H
+
+#include <simpletest.h>
+
+/// measures merging of many small update rects in KisSimpleUpdateQueue
+class KisUpdateQueueBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkEnqueueRects_data();
+    void benchmarkEnqueueRects();
+};
+
+#endif // KISUPDATEQUEUEBENCHMARK_H
@@ -28,6 +28,8 @@
 #include <KoCompositeOpAlphaDarken.h>
 #include <KoCompositeOpOver.h>
 #include <KoCompositeOpCopy2.h>
+#include <KoCompositeOpGeneric.h>
+#include <KoCompositeOpRegistry.h>
 #include <KoOptimizedCompositeOpFactory.h>
 #include <KoAlphaDarkenParamsWrapper.h>
 
@@ -360,7 +362,7 @@ bool compareTwoOpsPixels(QVector<Tile> &tiles, channel_type prec) {
 }
 
 template<template<typename> class Compare = PixelEqualDirect>
-bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp *op2)
+bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp *op2, const QBitArray &channelFlags = QBitArray())
 {
     Q_ASSERT(op1->colorSpace()->pixelSize() == op2->colorSpace()->pixelSize());
     const quint32 pixelSize = op1->colorSpace()->pixelSize();
@@ -376,7 +378,7 @@ bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp
     // This is a hack as in the old version we get a rounding of opacity to this value
     params.opacity       = float(Arithmetic::scale<quint8>(0.5*1.0f))/255.0;
     params.flow          = 0.3*1.0f;
-    params.channelFlags  = QBitArray();
+    params.channelFlags  = channelFlags;
 
     params.dstRowStart   = tiles[0].dst;
     params.srcRowStart   = tiles[0].src;
@@ -885,6 +887,122 @@ void KisCompositionBenchmark::compareRgbF32CopyOps()
     delete opAct;
 }
 
+/**
+ * The channel flags the generic ops are compared with: all channels,
+ * locked alpha, a disabled color channel and both of them. They cover
+ * all the code paths of the vectorized ops.
+ */
+template<class Traits>
+QVector<QBitArray> genericOpsChannelFlags()
+{
+    QBitArray alphaLocked(Traits::channels_nb, true);
+    alphaLocked.clearBit(Traits::alpha_pos);
+
+    QBitArray noGreen(Traits::channels_nb, true);
+    noGreen.clearBit(Traits::green_pos);
+
+    return {QBitArray(), alphaLocked, noGreen, noGreen & alphaLocked};
+}
+
+template<class Traits>
+bool compareGenericOpWithFlags(bool haveMask, const KoCompositeOp *opAct, const KoCompositeOp *opExp)
+{
+    Q_FOREACH (const QBitArray &channelFlags, genericOpsChannelFlags<Traits>()) {
+        if (!compareTwoOps(haveMask, opAct, opExp, channelFlags)) {
+            qDebug() << "Failed composite op:" << opExp->id() << "channel flags:" << channelFlags;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Compares the op registered in the colorspace, which is the vectorized
+ * one if the CPU supports it, with the scalar template op
+ */
+template<class Traits, typename Traits::channels_type compositeFunc(typename Traits::channels_type, typename Traits::channels_type)>
+bool compareGenericOp(bool haveMask, const KoColorSpace *cs, const QString &id)
+{
+    const KoCompositeOp *opAct = cs->compositeOp(id);
+    KoCompositeOpGenericSC<Traits, compositeFunc> opExp(cs, id, opAct->category());
+
+    return compareGenericOpWithFlags<Traits>(haveMask, opAct, &opExp);
+}
+
+template<class Traits, void compositeFunc(float, float, float, float&, float&, float&)>
+bool compareGenericHSLOp(bool haveMask, const KoColorSpace *cs, const QString &id)
+{
+    const KoCompositeOp *opAct = cs->compositeOp(id);
+    KoCompositeOpGenericHSL<Traits, compositeFunc> opExp(cs, id, opAct->category());
+
+    return compareGenericOpWithFlags<Traits>(haveMask, opAct, &opExp);
+}
+
+void KisCompositionBenchmark::compareGenericOps()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    typedef KoBgrU8Traits Traits;
+    typedef quint8 Arg;
+
+    QVERIFY((compareGenericOp<Traits, &cfMultiply<Arg>>(true, cs, COMPOSITE_MULT)));
+    QVERIFY((compareGenericOp<Traits, &cfMultiply<Arg>>(false, cs, COMPOSITE_MULT)));
+    QVERIFY((compareGenericOp<Traits, &cfScreen<Arg>>(true, cs, COMPOSITE_SCREEN)));
+    QVERIFY((compareGenericOp<Traits, &cfOverlay<Arg>>(true, cs, COMPOSITE_OVERLAY)));
+    QVERIFY((compareGenericOp<Traits, &cfSoftLight<Arg>>(true, cs, COMPOSITE_SOFT_LIGHT_PHOTOSHOP)));
+    QVERIFY((compareGenericOp<Traits, &cfHardLight<Arg>>(true, cs, COMPOSITE_HARD_LIGHT)));
+    QVERIFY((compareGenericOp<Traits, &cfColorDodge<Arg>>(true, cs, COMPOSITE_DODGE)));
+    QVERIFY((compareGenericOp<Traits, &cfColorBurn<Arg>>(true, cs, COMPOSITE_BURN)));
+    QVERIFY((compareGenericOp<Traits, &cfAddition<Arg>>(true, cs, COMPOSITE_ADD)));
+    QVERIFY((compareGenericOp<Traits, &cfSubtract<Arg>>(true, cs, COMPOSITE_SUBTRACT)));
+    QVERIFY((compareGenericOp<Traits, &cfDarkenOnly<Arg>>(true, cs, COMPOSITE_DARKEN)));
+    QVERIFY((compareGenericOp<Traits, &cfLightenOnly<Arg>>(true, cs, COMPOSITE_LIGHTEN)));
+    QVERIFY((compareGenericOp<Traits, &cfDifference<Arg>>(true, cs, COMPOSITE_DIFF)));
+    QVERIFY((compareGenericOp<Traits, &cfXor<Arg>>(true, cs, COMPOSITE_XOR)));
+
+    QVERIFY((compareGenericHSLOp<Traits, &cfColor<HSYType, float>>(true, cs, COMPOSITE_COLOR)));
+    QVERIFY((compareGenericHSLOp<Traits, &cfHue<HSYType, float>>(true, cs, COMPOSITE_HUE)));
+    QVERIFY((compareGenericHSLOp<Traits, &cfSaturation<HSYType, float>>(true, cs, COMPOSITE_SATURATION)));
+    QVERIFY((compareGenericHSLOp<Traits, &cfLightness<HSYType, float>>(true, cs, COMPOSITE_LUMINIZE)));
+}
+
+void KisCompositionBenchmark::compareRgbU16GenericOps()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    typedef KoBgrU16Traits Traits;
+    typedef quint16 Arg;
+
+    QVERIFY((compareGenericOp<Traits, &cfMultiply<Arg>>(true, cs, COMPOSITE_MULT)));
+    QVERIFY((compareGenericOp<Traits, &cfScreen<Arg>>(false, cs, COMPOSITE_SCREEN)));
+    QVERIFY((compareGenericOp<Traits, &cfOverlay<Arg>>(false, cs, COMPOSITE_OVERLAY)));
+    QVERIFY((compareGenericOp<Traits, &cfSoftLight<Arg>>(false, cs, COMPOSITE_SOFT_LIGHT_PHOTOSHOP)));
+    QVERIFY((compareGenericOp<Traits, &cfColorDodge<Arg>>(false, cs, COMPOSITE_DODGE)));
+    QVERIFY((compareGenericOp<Traits, &cfAddition<Arg>>(false, cs, COMPOSITE_ADD)));
+    QVERIFY((compareGenericOp<Traits, &cfDifference<Arg>>(false, cs, COMPOSITE_DIFF)));
+
+    QVERIFY((compareGenericHSLOp<Traits, &cfColor<HSYType, float>>(false, cs, COMPOSITE_COLOR)));
+    QVERIFY((compareGenericHSLOp<Traits, &cfHue<HSLType, float>>(false, cs, COMPOSITE_HUE_HSL)));
+}
+
+void KisCompositionBenchmark::compareRgbF32GenericOps()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
+    typedef KoRgbF32Traits Traits;
+    typedef float Arg;
+
+    QVERIFY((compareGenericOp<Traits, &cfMultiply<Arg>>(true, cs, COMPOSITE_MULT)));
+    QVERIFY((compareGenericOp<Traits, &cfScreen<Arg>>(false, cs, COMPOSITE_SCREEN)));
+    QVERIFY((compareGenericOp<Traits, &cfOverlay<Arg>>(false, cs, COMPOSITE_OVERLAY)));
+    QVERIFY((compareGenericOp<Traits, &cfSoftLight<Arg>>(false, cs, COMPOSITE_SOFT_LIGHT_PHOTOSHOP)));
+    QVERIFY((compareGenericOp<Traits, &cfAddition<Arg>>(false, cs, COMPOSITE_ADD)));
+    QVERIFY((compareGenericOp<Traits, &cfDarkenOnly<Arg>>(false, cs, COMPOSITE_DARKEN)));
+    QVERIFY((compareGenericOp<Traits, &cfDifference<Arg>>(false, cs, COMPOSITE_DIFF)));
+    QVERIFY((compareGenericOp<Traits, &cfModulo<Arg>>(false, cs, COMPOSITE_MOD)));
+    QVERIFY((compareGenericOp<Traits, &cfXor<Arg>>(false, cs, COMPOSITE_XOR)));
+
+    QVERIFY((compareGenericHSLOp<Traits, &cfColor<HSYType, float>>(false, cs, COMPOSITE_COLOR)));
+    QVERIFY((compareGenericHSLOp<Traits, &cfHue<HSYType, float>>(false, cs, COMPOSITE_HUE)));
+}
+
 void KisCompositionBenchmark::testRgb8CompositeAlphaDarkenLegacy()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
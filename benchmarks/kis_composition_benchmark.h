@@ -47,6 +47,10 @@ private Q_SLOTS:
     void compareRgbU16CopyOps();
     void compareRgbF32CopyOps();
 
+    void compareGenericOps();
+    void compareRgbU16GenericOps();
+    void compareRgbF32GenericOps();
+
     void testRgb8CompositeAlphaDarkenLegacy();
     void testRgb8CompositeAlphaDarkenOptimized();
 
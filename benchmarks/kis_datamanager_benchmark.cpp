@@ -8,7 +8,10 @@
 #include "kis_benchmark_values.h"
 
 #include <simpletest.h>
+#include <QThreadPool>
 #include <kis_datamanager.h>
+#include <kis_debug.h>
+#include "tiles3/kis_tile_data_store.h"
 
 // RGBA
 #define PIXEL_SIZE 4
@@ -186,5 +189,121 @@ void KisDatamanagerBenchmark::benchmarkMemCpy()
     delete[] dst;
 }
 
+void KisDatamanagerBenchmark::benchmarkConcurrentTileAccess_data()
+{
+    QTest::addColumn<int>("numThreads");
+
+    for (int numThreads = 1; numThreads <= 64; numThreads *= 2) {
+        QTest::newRow(qPrintable(QString("%1 threads").arg(numThreads))) << numThreads;
+    }
+}
+
+void KisDatamanagerBenchmark::benchmarkConcurrentTileAccess()
+{
+    QFETCH(int, numThreads);
+
+    quint8 *p = new quint8[PIXEL_SIZE];
+    memset(p, 0, PIXEL_SIZE);
+    KisDataManager dm(PIXEL_SIZE, p);
+
+    const int numCols = TEST_IMAGE_WIDTH / 64;
+    const int numRows = TEST_IMAGE_HEIGHT / 64;
+
+    /**
+     * The total amount of work is fixed, so in the ideal case the
+     * time should decrease linearly with the number of threads. Every
+     * thread walks over the whole image, so all of them hit the same
+     * tiles and the same hash table at the same time. Every fourth
+     * access is a writable one, which creates the tiles lazily.
+     */
+    const int totalPasses = 64;
+
+    struct Job : public QRunnable
+    {
+        Job(KisDataManager &dm, int numCols, int numRows, int numPasses)
+            : m_dm(dm), m_numCols(numCols), m_numRows(numRows), m_numPasses(numPasses) {}
+
+        void run() override {
+            for (int i = 0; i < m_numPasses; i++) {
+                for (int row = 0; row < m_numRows; row++) {
+                    for (int col = 0; col < m_numCols; col++) {
+                        KisTileSP tile = m_dm.getTile(col, row, !((col + row + i) % 4));
+                        Q_UNUSED(tile);
+                    }
+                }
+            }
+        }
+
+        KisDataManager &m_dm;
+        const int m_numCols;
+        const int m_numRows;
+        const int m_numPasses;
+    };
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads);
+
+    QBENCHMARK {
+        for (int i = 0; i < numThreads; i++) {
+            pool.start(new Job(dm, numCols, numRows, qMax(1, totalPasses / numThreads)));
+        }
+        pool.waitForDone();
+    }
+}
+
+void KisDatamanagerBenchmark::benchmarkHistoryMemory()
+{
+    quint8 *p = new quint8[PIXEL_SIZE];
+    memset(p, 0, PIXEL_SIZE);
+    KisDataManager dm(PIXEL_SIZE, p);
+
+    quint8 *bytes = new quint8[PIXEL_SIZE * TEST_IMAGE_WIDTH * TEST_IMAGE_HEIGHT];
+    for (int i = 0; i < PIXEL_SIZE * TEST_IMAGE_WIDTH * TEST_IMAGE_HEIGHT; i++) {
+        bytes[i] = i % 251;
+    }
+    dm.writeBytes(bytes, 0, 0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT);
+    delete[] bytes;
+
+    /**
+     * Emulates 1000 small strokes, each of them is a separate
+     * transaction. Every superseded revision of the tile would
+     * take a full tile in the history without delta packing.
+     */
+    const int numStrokes = 1000;
+    const int dabSize = 32;
+    const qint64 tileSize = PIXEL_SIZE * 64 * 64;
+
+    quint8 pixel[PIXEL_SIZE];
+    qint64 numRevisions = 0;
+
+    const qint64 deltaSizeBefore =
+        KisTileDataStore::instance()->memoryStatistics().historicalDeltaSize;
+
+    QBENCHMARK_ONCE {
+        for (int i = 0; i < numStrokes; i++) {
+            memset(pixel, i % 256, PIXEL_SIZE);
+
+            const QRect dabRect((i * 97) % (TEST_IMAGE_WIDTH - dabSize),
+                                (i * 61) % (TEST_IMAGE_HEIGHT - dabSize),
+                                dabSize, dabSize);
+
+            KisMementoSP memento = dm.getMemento();
+            dm.clear(dabRect, pixel);
+            dm.commit();
+
+            numRevisions += (dabRect.right() / 64 - dabRect.left() / 64 + 1) *
+                (dabRect.bottom() / 64 - dabRect.top() / 64 + 1);
+        }
+    }
+
+    const KisTileDataStore::MemoryStatistics stats =
+        KisTileDataStore::instance()->memoryStatistics();
+
+    qDebug() << "History memory per" << numStrokes << "strokes:"
+             << "full tiles" << numRevisions * tileSize
+             << "deltas" << stats.historicalDeltaSize - deltaSizeBefore
+             << "total historical" << stats.historicalMemorySize;
+}
+
 
 SIMPLE_TEST_MAIN(KisDatamanagerBenchmark)
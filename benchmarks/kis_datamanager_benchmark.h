@@ -24,6 +24,9 @@ private Q_SLOTS:
     void benchmarkExtent();
     void benchmarkClear();
     void benchmarkMemCpy();
+    void benchmarkConcurrentTileAccess_data();
+    void benchmarkConcurrentTileAccess();
+    void benchmarkHistoryMemory();
 };
 
 #endif
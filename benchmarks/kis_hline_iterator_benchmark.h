@@ -44,6 +44,10 @@ private Q_SLOTS:
     void benchmarkConstNoMemCpy();
     // copy from one device to another
     void benchmarkTwoIteratorsNoMemCpy();
+
+    // reading a data manager with different tile sizes
+    void benchmarkTileSizes_data();
+    void benchmarkTileSizes();
     
 
     
@@ -90,6 +90,7 @@ void KisLowMemoryBenchmark::benchmarkWideArea(const QString presetFileName,
     config.setMemoryPoolLimitPercent(poolLimitMiB * _MiB);
 
     KisTileDataStore::instance()->testingRereadConfig();
+    KisTileDataStore::instance()->testingResetPrefetchStatistics();
 
     /**
      * Create an empty the log file
@@ -133,6 +134,13 @@ void KisLowMemoryBenchmark::benchmarkWideArea(const QString presetFileName,
         while(line.y1() < rectBottom) {
             lineTime.restart();
 
+            /**
+             * Emulate a stroke strategy that knows the area it is
+             * going to paint on in advance
+             */
+            const QRectF nextLineRect(line.p1() + QPointF(0, vstep), QSizeF(rect.width(), vstep));
+            painter->device()->prefetchRect(nextLineRect.toAlignedRect());
+
             KisPaintInformation pi1(line.p1(), 0.0);
             KisPaintInformation pi2(line.p2(), 1.0);
             painter->paintLine(pi1, pi2, &currentDistance);
@@ -164,6 +172,26 @@ void KisLowMemoryBenchmark::benchmarkWideArea(const QString presetFileName,
                   << config.memoryPoolLimitPercent() / _MiB  << endl;
     }
 
+    const KisTileDataPrefetcher::Statistics prefetchStats =
+        KisTileDataStore::instance()->prefetchStatistics();
+
+    qDebug() << "Prefetch statistics:"
+             << ppVar(prefetchStats.numRequested)
+             << ppVar(prefetchStats.numDropped)
+             << ppVar(prefetchStats.numHits)
+             << ppVar(prefetchStats.numMisses);
+
+    const KisTileDataStore::MemoryStatistics memoryStats =
+        KisTileDataStore::instance()->memoryStatistics();
+
+    qDebug() << "Deduplication statistics:"
+             << ppVar(memoryStats.deduplicatedSize)
+             << ppVar(memoryStats.deduplicationRatio);
+
+    qDebug() << "History statistics:"
+             << ppVar(memoryStats.historicalMemorySize)
+             << ppVar(memoryStats.historicalDeltaSize);
+
     config.setMemoryHardLimitPercent(oldHardLimit * _MiB);
     config.setMemorySoftLimitPercent(oldSoftLimit * _MiB);
     config.setMemoryPoolLimitPercent(oldPoolLimit * _MiB);
@@ -9,8 +9,16 @@
 #include "kis_benchmark_values.h"
 
 #include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
 
 #include <kis_group_layer.h>
+#include <kis_paint_layer.h>
+#include <kis_filter_mask.h>
+#include <filter/kis_filter.h>
+#include <filter/kis_filter_configuration.h>
+#include <filter/kis_filter_registry.h>
+#include <KisGlobalResourcesInterface.h>
+#include <kis_image_config.h>
 #include <kis_paint_device.h>
 #include <KisDocument.h>
 #include <kis_image.h>
@@ -37,6 +45,144 @@ void KisProjectionBenchmark::benchmarkProjection()
     }
 }
 
+void KisProjectionBenchmark::benchmarkProjectionThreads_data()
+{
+    QTest::addColumn<int>("numThreads");
+
+    for (int numThreads : {4, 16, 64}) {
+        QTest::newRow(qPrintable(QString("%1 threads").arg(numThreads))) << numThreads;
+    }
+}
+
+void KisProjectionBenchmark::benchmarkProjectionThreads()
+{
+    QFETCH(int, numThreads);
+
+    KisDocument *doc = KisPart::instance()->createDocument();
+    doc->loadNativeFormat(QString(FILES_DATA_DIR) + '/' + "load_test.kra");
+
+    KisImageSP image = doc->image();
+    image->waitForDone();
+    image->setWorkingThreadsLimit(numThreads);
+
+    // the asynchronous refresh is split into many small merge jobs
+    QBENCHMARK {
+        image->refreshGraphAsync();
+        image->waitForDone();
+    }
+
+    delete doc;
+}
+
+void KisProjectionBenchmark::benchmarkBelowStackCache_data()
+{
+    QTest::addColumn<int>("numLayers");
+    QTest::addColumn<bool>("useCache");
+
+    for (int numLayers : {20, 100}) {
+        QTest::newRow(qPrintable(QString("%1 layers, no cache").arg(numLayers))) << numLayers << false;
+        QTest::newRow(qPrintable(QString("%1 layers, cache").arg(numLayers))) << numLayers << true;
+    }
+}
+
+/**
+ * Emulates a stroke on a layer in the middle of a deep stack of
+ * semi-transparent layers
+ */
+void KisProjectionBenchmark::benchmarkBelowStackCache()
+{
+    QFETCH(int, numLayers);
+    QFETCH(bool, useCache);
+
+    KisImageConfig config(false);
+    const bool oldUseCache = config.useBelowStackCache();
+    config.setUseBelowStackCache(useCache);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 1024, 1024, cs, "below stack cache benchmark");
+    const QRect bounds = image->bounds();
+
+    KisPaintLayerSP activeLayer;
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer %1").arg(i), OPACITY_OPAQUE_U8 / 2, cs);
+        layer->paintDevice()->fill(bounds, KoColor(QColor::fromHsv(i * 7 % 360, 200, 200), cs));
+        image->addNode(layer, image->root());
+
+        if (i == numLayers / 2) {
+            activeLayer = layer;
+        }
+    }
+
+    image->initialRefreshGraph();
+
+    const int dabSize = 64;
+    const int numDabs = 100;
+
+    QBENCHMARK {
+        for (int i = 0; i < numDabs; i++) {
+            activeLayer->setDirty(QRect(i * dabSize / 8, i * dabSize / 8, dabSize, dabSize));
+        }
+        image->waitForDone();
+    }
+
+    config.setUseBelowStackCache(oldUseCache);
+}
+
+void KisProjectionBenchmark::benchmarkParallelChildren_data()
+{
+    QTest::addColumn<int>("numLayers");
+    QTest::addColumn<bool>("parallel");
+
+    for (int numLayers : {4, 16}) {
+        QTest::newRow(qPrintable(QString("%1 layers, sequential").arg(numLayers))) << numLayers << false;
+        QTest::newRow(qPrintable(QString("%1 layers, parallel").arg(numLayers))) << numLayers << true;
+    }
+}
+
+/**
+ * Refreshes a group of layers, each of which has a blur filter mask
+ */
+void KisProjectionBenchmark::benchmarkParallelChildren()
+{
+    QFETCH(int, numLayers);
+    QFETCH(bool, parallel);
+
+    KisImageConfig config(false);
+    const bool oldParallel = config.recalculateChildrenInParallel();
+    config.setRecalculateChildrenInParallel(parallel);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 1024, 1024, cs, "parallel children benchmark");
+    const QRect bounds = image->bounds();
+
+    KisFilterSP filter = KisFilterRegistry::instance()->value("blur");
+    KisFilterConfigurationSP filterConfig = filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+
+    KisGroupLayerSP group = new KisGroupLayer(image, "group", OPACITY_OPAQUE_U8);
+    image->addNode(group, image->root());
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer %1").arg(i), OPACITY_OPAQUE_U8 / 2, cs);
+        layer->paintDevice()->fill(bounds, KoColor(QColor::fromHsv(i * 7 % 360, 200, 200), cs));
+        image->addNode(layer, group);
+
+        KisFilterMaskSP mask = new KisFilterMask(image, QString("blur %1").arg(i));
+        mask->initSelection(layer);
+        mask->setFilter(filterConfig->cloneWithResourcesSnapshot());
+        image->addNode(mask, layer);
+    }
+
+    image->initialRefreshGraph();
+
+    QBENCHMARK {
+        image->refreshGraphAsync(group);
+        image->waitForDone();
+    }
+
+    config.setRecalculateChildrenInParallel(oldParallel);
+}
+
 void KisProjectionBenchmark::benchmarkLoading()
 {
     QBENCHMARK{
@@ -19,6 +19,12 @@ private Q_SLOTS:
     void cleanupTestCase();
 
     void benchmarkProjection();
+    void benchmarkProjectionThreads_data();
+    void benchmarkProjectionThreads();
+    void benchmarkBelowStackCache_data();
+    void benchmarkBelowStackCache();
+    void benchmarkParallelChildren_data();
+    void benchmarkParallelChildren();
     void benchmarkLoading();
 };
 
@@ -15,6 +15,7 @@
 
 #include <simpletest.h>
 #include <kis_random_accessor_ng.h>
+#include "tiles3/kis_random_accessor.h"
 
 
 void KisRandomIteratorBenchmark::initTestCase()
@@ -222,5 +223,55 @@ void KisRandomIteratorBenchmark::benchmarkTwoIteratorsNoMemCpy()
     }
 }
 
+void KisRandomIteratorBenchmark::benchmarkTileSizes_data()
+{
+    QTest::addColumn<int>("tileSize");
+    QTest::addColumn<bool>("sparse");
+
+    for (int tileSize : {32, 64, 128, 256}) {
+        QTest::newRow(qPrintable(QString("%1px, dense").arg(tileSize))) << tileSize << false;
+        QTest::newRow(qPrintable(QString("%1px, sparse").arg(tileSize))) << tileSize << true;
+    }
+}
+
+void KisRandomIteratorBenchmark::benchmarkTileSizes()
+{
+    QFETCH(int, tileSize);
+    QFETCH(bool, sparse);
+
+    const quint8 defaultPixel[4] = {0, 0, 0, 0};
+    KisDataManagerSP dm = new KisDataManager(m_colorSpace->pixelSize(), defaultPixel,
+                                             tileSize, tileSize);
+
+    if (sparse) {
+        // a thin diagonal line, like in a vector-rasterized mask
+        for (int i = 0; i < qMin(TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT); i++) {
+            dm->setPixel(i, i, m_color->data());
+        }
+    } else {
+        dm->clear(0, 0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT, m_color->data());
+    }
+
+    KisRandomConstAccessorSP it = new KisRandomAccessor2(dm.data(), 0, 0, false, 0);
+    // set the seed so that we always go in the same permutation over the device
+    srand(123456);
+
+    QBENCHMARK{
+        for (int i = 0; i < TEST_IMAGE_HEIGHT; i++){
+            for (int j = 0; j < TEST_IMAGE_WIDTH; j++) {
+                it->moveTo( rand() % TEST_IMAGE_WIDTH,
+                           rand() % TEST_IMAGE_HEIGHT );
+                memcpy(m_color->data(), it->oldRawData(), m_colorSpace->pixelSize());
+            }
+        }
+    }
+
+    qint64 residentBytes = 0;
+    qint64 swappedBytes = 0;
+    dm->memoryStatistics(residentBytes, swappedBytes);
+
+    qDebug() << "Tile size" << tileSize << (sparse ? "(sparse):" : "(dense):")
+             << "memory used" << (residentBytes + swappedBytes) / 1024 << "KiB";
+}
 
 SIMPLE_TEST_MAIN(KisRandomIteratorBenchmark)
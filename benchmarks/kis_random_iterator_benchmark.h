@@ -46,6 +46,10 @@ private Q_SLOTS:
     void benchmarkNoMemCpy();
     void benchmarkConstNoMemCpy();
     void benchmarkTwoIteratorsNoMemCpy();
+
+    // randomly reading a data manager with different tile sizes
+    void benchmarkTileSizes_data();
+    void benchmarkTileSizes();
 };
 
 #endif
@@ -33,6 +33,14 @@ inline double drand48()
 #include <brushengine/kis_paint_information.h>
 #include <brushengine/kis_paintop_preset.h>
 
+#include <KisRunnableBasedStrokeStrategy.h>
+#include <KisRunnableStrokeJobData.h>
+#include <kis_simple_stroke_strategy.h>
+#include <kis_lod_transform.h>
+#include <kis_image_config.h>
+#include <QElapsedTimer>
+#include <QThread>
+
 #define GMP_IMAGE_WIDTH 3274
 #define GMP_IMAGE_HEIGHT 2067
 #include <kis_painter.h>
@@ -621,5 +629,208 @@ void KisStrokeBenchmark::becnhmarkPresetCloning()
     }
 }
 
+namespace {
+struct ScheduledBenchmarkStrokeStrategy : public KisRunnableBasedStrokeStrategy
+{
+    ScheduledBenchmarkStrokeStrategy()
+        : KisRunnableBasedStrokeStrategy(QLatin1String("scheduled-benchmark-stroke"))
+    {
+        enableJob(JOB_DOSTROKE);
+    }
+};
+}
+
+void KisStrokeBenchmark::benchmarkScheduledStroke_data()
+{
+    QTest::addColumn<int>("numThreads");
+    QTest::addColumn<bool>("useSubtasks");
+
+    for (int numThreads : {4, 16, 64}) {
+        QTest::newRow(qPrintable(QString("%1 threads, jobs").arg(numThreads))) << numThreads << false;
+        QTest::newRow(qPrintable(QString("%1 threads, subtasks").arg(numThreads))) << numThreads << true;
+    }
+}
+
+/**
+ * Fills the layer with many small concurrent stroke jobs, either queued
+ * one-by-one into the strokes queue or spawned as subtasks of a few
+ * bigger jobs
+ */
+void KisStrokeBenchmark::benchmarkScheduledStroke()
+{
+    QFETCH(int, numThreads);
+    QFETCH(bool, useSubtasks);
+
+    KisImageSP image = new KisImage(0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT, m_colorSpace, "scheduled stroke image");
+    KisLayerSP layer = new KisPaintLayer(image, "scheduled stroke layer", OPACITY_OPAQUE_U8, m_colorSpace);
+    image->addNode(layer, image->root());
+    image->waitForDone();
+    image->setWorkingThreadsLimit(numThreads);
+
+    KisPaintDeviceSP device = layer->paintDevice();
+    const KoColor color(Qt::black, m_colorSpace);
+    const QRect bounds = image->bounds();
+
+    const int patchSize = 64;
+    const int rowHeight = 4 * patchSize;
+
+    QBENCHMARK {
+        KisStrokeId id = image->startStroke(new ScheduledBenchmarkStrokeStrategy());
+
+        for (int y = bounds.top(); y <= bounds.bottom(); y += rowHeight) {
+            QVector<QRect> patches;
+
+            for (int py = y; py < y + rowHeight && py <= bounds.bottom(); py += patchSize) {
+                for (int px = bounds.left(); px <= bounds.right(); px += patchSize) {
+                    patches << (QRect(px, py, patchSize, patchSize) & bounds);
+                }
+            }
+
+            if (useSubtasks) {
+                image->addJob(id, new KisRunnableStrokeJobData(
+                    [device, color, patches] () {
+                        Q_FOREACH (const QRect &rc, patches) {
+                            KisRunnableStrokeJobData::spawnSubtask([device, color, rc] () {
+                                device->fill(rc, color);
+                            });
+                        }
+                    },
+                    KisStrokeJobData::CONCURRENT));
+            } else {
+                Q_FOREACH (const QRect &rc, patches) {
+                    image->addJob(id, new KisRunnableStrokeJobData(
+                        [device, color, rc] () {
+                            device->fill(rc, color);
+                        },
+                        KisStrokeJobData::CONCURRENT));
+                }
+            }
+        }
+
+        image->endStroke(id);
+        image->waitForDone();
+    }
+}
+
+namespace {
+struct LodBenchmarkDabData : public KisStrokeJobData
+{
+    LodBenchmarkDabData(const QRect &_rect)
+        : KisStrokeJobData(KisStrokeJobData::SEQUENTIAL),
+          rect(_rect)
+    {
+    }
+
+    KisStrokeJobData* createLodClone(int levelOfDetail) override {
+        return new LodBenchmarkDabData(KisLodTransform::scaledRect(rect, levelOfDetail));
+    }
+
+    QRect rect;
+};
+
+struct LodBenchmarkStrokeStrategy : public KisSimpleStrokeStrategy
+{
+    LodBenchmarkStrokeStrategy(KisLayerSP layer, const KoColor &color)
+        : KisSimpleStrokeStrategy(QLatin1String("lod-benchmark-stroke")),
+          m_layer(layer),
+          m_color(color)
+    {
+        enableJob(JOB_DOSTROKE);
+        setSupportsSpeculativeLod0Replay(true);
+    }
+
+    LodBenchmarkStrokeStrategy(const LodBenchmarkStrokeStrategy &rhs)
+        : KisSimpleStrokeStrategy(rhs),
+          m_layer(rhs.m_layer),
+          m_color(rhs.m_color)
+    {
+    }
+
+    KisStrokeStrategy* createLodClone(int levelOfDetail) override {
+        Q_UNUSED(levelOfDetail);
+        return new LodBenchmarkStrokeStrategy(*this);
+    }
+
+    void doStrokeCallback(KisStrokeJobData *data) override {
+        LodBenchmarkDabData *d = dynamic_cast<LodBenchmarkDabData*>(data);
+        KIS_ASSERT(d);
+
+        KisPainter gc(m_layer->paintDevice());
+        gc.setOpacity(OPACITY_OPAQUE_U8 / 2);
+        gc.fill(d->rect.x(), d->rect.y(), d->rect.width(), d->rect.height(), m_color);
+
+        m_layer->setDirty(d->rect);
+    }
+
+private:
+    KisLayerSP m_layer;
+    KoColor m_color;
+};
+}
+
+void KisStrokeBenchmark::benchmarkLodStrokeEndWait_data()
+{
+    QTest::addColumn<qreal>("speculativeBudget");
+
+    QTest::newRow("no speculation") << 0.0;
+    QTest::newRow("speculation 25%") << 0.25;
+    QTest::newRow("speculation 50%") << 0.5;
+}
+
+/**
+ * Paints strokes with instant preview enabled, emulating the pauses
+ * between the tablet events, and measures how long the user has to
+ * wait for the LoD0 stroke to complete after releasing the stylus
+ */
+void KisStrokeBenchmark::benchmarkLodStrokeEndWait()
+{
+    QFETCH(qreal, speculativeBudget);
+
+    KisImageConfig cfg(false);
+    const qreal oldBudget = cfg.speculativeLod0Budget();
+    cfg.setSpeculativeLod0Budget(speculativeBudget);
+
+    KisImageSP image = new KisImage(0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT, m_colorSpace, "lod stroke image");
+    KisLayerSP layer = new KisPaintLayer(image, "lod stroke layer", OPACITY_OPAQUE_U8, m_colorSpace);
+    image->addNode(layer, image->root());
+    image->setLodPreferences(KisLodPreferences(2));
+    image->waitForDone();
+
+    const KoColor color(Qt::black, m_colorSpace);
+    const int numStrokes = 5;
+    const int numDabs = 100;
+    const int dabSize = 300;
+    const int eventIntervalMsec = 5;
+
+    qint64 totalWait = 0;
+
+    for (int i = 0; i < numStrokes; i++) {
+        KisStrokeId id = image->startStroke(new LodBenchmarkStrokeStrategy(layer, color));
+
+        for (int j = 0; j < numDabs; j++) {
+            const int x = (TEST_IMAGE_WIDTH - dabSize) * j / numDabs;
+            const int y = (TEST_IMAGE_HEIGHT - dabSize) * (j + i * numDabs) / (numStrokes * numDabs);
+
+            image->addJob(id, new LodBenchmarkDabData(QRect(x, y, dabSize, dabSize)));
+            QThread::msleep(eventIntervalMsec);
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        image->endStroke(id);
+        image->waitForDone();
+
+        totalWait += timer.elapsed();
+    }
+
+    cfg.setSpeculativeLod0Budget(oldBudget);
+
+    qDebug() << "End-of-stroke wait, budget" << speculativeBudget << ":"
+             << qreal(totalWait) / numStrokes << "ms";
+
+    QTest::setBenchmarkResult(qreal(totalWait) / numStrokes, QTest::WalltimeMilliseconds);
+}
+
 
 SIMPLE_TEST_MAIN(KisStrokeBenchmark)
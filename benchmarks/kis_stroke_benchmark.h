@@ -131,6 +131,13 @@ private Q_SLOTS:
     void benchmarkRand48();
 
     void becnhmarkPresetCloning();
+
+    // Strokes executed by the image's updates scheduler
+    void benchmarkScheduledStroke_data();
+    void benchmarkScheduledStroke();
+
+    void benchmarkLodStrokeEndWait_data();
+    void benchmarkLodStrokeEndWait();
 };
 
 #endif
@@ -13,6 +13,7 @@
 #include <KoColorSpaceRegistry.h>
 #include <KoColor.h>
 #include <kis_iterator_ng.h>
+#include "tiles3/kis_vline_iterator.h"
 #include <simpletest.h>
 
 
@@ -153,5 +154,54 @@ void KisVLineIteratorBenchmark::benchmarkTwoIteratorsNoMemCpy()
     }
 }
 
+void KisVLineIteratorBenchmark::benchmarkTileSizes_data()
+{
+    QTest::addColumn<int>("tileSize");
+    QTest::addColumn<bool>("sparse");
+
+    for (int tileSize : {32, 64, 128, 256}) {
+        QTest::newRow(qPrintable(QString("%1px, dense").arg(tileSize))) << tileSize << false;
+        QTest::newRow(qPrintable(QString("%1px, sparse").arg(tileSize))) << tileSize << true;
+    }
+}
+
+void KisVLineIteratorBenchmark::benchmarkTileSizes()
+{
+    QFETCH(int, tileSize);
+    QFETCH(bool, sparse);
+
+    const quint8 defaultPixel[4] = {0, 0, 0, 0};
+    KisDataManagerSP dm = new KisDataManager(m_colorSpace->pixelSize(), defaultPixel,
+                                             tileSize, tileSize);
+
+    if (sparse) {
+        // a thin diagonal line, like in a vector-rasterized mask
+        for (int i = 0; i < qMin(TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT); i++) {
+            dm->setPixel(i, i, m_color->data());
+        }
+    } else {
+        dm->clear(0, 0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT, m_color->data());
+    }
+
+    KisVLineConstIteratorSP it =
+        new KisVLineIterator2(dm.data(), 0, 0, TEST_IMAGE_HEIGHT, 0, 0, false, 0);
+
+    QBENCHMARK{
+        for (int j = 0; j < TEST_IMAGE_WIDTH; j++) {
+            do {
+                memcpy(m_color->data(), it->oldRawData(), m_colorSpace->pixelSize());
+            } while (it->nextPixel());
+            it->nextColumn();
+        }
+        it->resetColumnPos();
+    }
+
+    qint64 residentBytes = 0;
+    qint64 swappedBytes = 0;
+    dm->memoryStatistics(residentBytes, swappedBytes);
+
+    qDebug() << "Tile size" << tileSize << (sparse ? "(sparse):" : "(dense):")
+             << "memory used" << (residentBytes + swappedBytes) / 1024 << "KiB";
+}
 
 SIMPLE_TEST_MAIN(KisVLineIteratorBenchmark)
@@ -40,6 +40,10 @@ private Q_SLOTS:
     void benchmarkNoMemCpy();
     void benchmarkConstNoMemCpy();
     void benchmarkTwoIteratorsNoMemCpy();
+
+    // reading a data manager with different tile sizes
+    void benchmarkTileSizes_data();
+    void benchmarkTileSizes();
 };
 
 #endif
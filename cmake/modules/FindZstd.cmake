@@ -0,0 +1,40 @@
+# - Try to find the Zstandard compression library
+# Once done this will define
+#
+#  Zstd_FOUND - system has Zstandard
+#  Zstd_INCLUDE_DIRS - the Zstandard include directories
+#  Zstd_LIBRARIES - the libraries needed to use Zstandard
+#  Zstd_VERSION - the version of Zstandard
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+include(LibFindMacros)
+libfind_pkg_check_modules(Zstd_PKGCONF libzstd)
+
+find_path(Zstd_INCLUDE_DIR
+    NAMES zstd.h
+    HINTS ${Zstd_PKGCONF_INCLUDE_DIRS} ${Zstd_PKGCONF_INCLUDEDIR}
+)
+
+find_library(Zstd_LIBRARY
+    NAMES zstd libzstd zstd_static
+    HINTS ${Zstd_PKGCONF_LIBRARY_DIRS} ${Zstd_PKGCONF_LIBDIR}
+    DOC "Libraries to link against for Zstandard tile compression"
+)
+
+set(Zstd_PROCESS_LIBS Zstd_LIBRARY)
+set(Zstd_PROCESS_INCLUDES Zstd_INCLUDE_DIR)
+set(Zstd_VERSION ${Zstd_PKGCONF_VERSION})
+libfind_process(Zstd)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Zstd
+    REQUIRED_VARS
+        Zstd_INCLUDE_DIR
+        Zstd_LIBRARY
+    VERSION_VAR
+        Zstd_VERSION
+)
+
+mark_as_advanced(Zstd_INCLUDE_DIR Zstd_LIBRARY)
@@ -0,0 +1,154 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTRIPEDREADWRITELOCK_H
+#define KISSTRIPEDREADWRITELOCK_H
+
+#include <atomic>
+
+#include <QMutex>
+#include <QThread>
+
+#include <boost/utility.hpp>
+
+/**
+ * A read-write lock optimized for the case when the readers are many
+ * and the writers are very rare (a "big reader" lock).
+ *
+ * QReadWriteLock keeps the counter of the readers in a single atomic
+ * variable, so all the reader threads fight for the same cache line,
+ * even though they never block each other. Here every thread is
+ * assigned to one of the stripes, and the readers increment only the
+ * counter of their own stripe. The writer, on the other hand, has to
+ * check all the stripes, so taking a write lock is much more expensive.
+ *
+ * The lock is not recursive. The ticket returned by lockForRead() must
+ * be passed to the corresponding unlockRead() call.
+ */
+class KisStripedReadWriteLock : private boost::noncopyable
+{
+public:
+    static const int NumStripes = 16;
+
+    /**
+     * Returns the index of the stripe assigned to the current
+     * thread. The stripes are assigned in a round-robin manner,
+     * so the threads are distributed evenly.
+     */
+    static inline int currentStripe() {
+        static std::atomic<int> s_nextStripe {0};
+        thread_local int stripe =
+            s_nextStripe.fetch_add(1, std::memory_order_relaxed) % NumStripes;
+        return stripe;
+    }
+
+    KisStripedReadWriteLock() {
+        for (int i = 0; i < NumStripes; i++) {
+            m_stripes[i].readers.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    inline int lockForRead() {
+        const int stripe = currentStripe();
+        std::atomic<int> &readers = m_stripes[stripe].readers;
+
+        while (true) {
+            readers.fetch_add(1, std::memory_order_seq_cst);
+
+            if (!m_writerActive.load(std::memory_order_seq_cst)) break;
+
+            // a writer is coming, get out of its way and wait
+            readers.fetch_sub(1, std::memory_order_release);
+
+            m_writerMutex.lock();
+            m_writerMutex.unlock();
+        }
+
+        return stripe;
+    }
+
+    inline void unlockRead(int ticket) {
+        m_stripes[ticket].readers.fetch_sub(1, std::memory_order_release);
+    }
+
+    inline void lockForWrite() {
+        m_writerMutex.lock();
+        m_writerActive.store(true, std::memory_order_seq_cst);
+
+        for (int i = 0; i < NumStripes; i++) {
+            while (m_stripes[i].readers.load(std::memory_order_seq_cst)) {
+                QThread::yieldCurrentThread();
+            }
+        }
+    }
+
+    inline void unlockWrite() {
+        m_writerActive.store(false, std::memory_order_release);
+        m_writerMutex.unlock();
+    }
+
+    /**
+     * Returns true if there is at least one reader holding the lock
+     * at the moment. Used for sanity checks only.
+     */
+    inline bool hasReaders() const {
+        for (int i = 0; i < NumStripes; i++) {
+            if (m_stripes[i].readers.load(std::memory_order_acquire)) return true;
+        }
+        return false;
+    }
+
+private:
+    /**
+     * C++14 doesn't guarantee alignment of the heap-allocated
+     * objects, so just pad the stripes to the size of a cache line
+     */
+    struct Stripe {
+        std::atomic<int> readers;
+        char padding[64 - sizeof(std::atomic<int>)];
+    };
+
+    Stripe m_stripes[NumStripes];
+    std::atomic<bool> m_writerActive {false};
+    QMutex m_writerMutex;
+};
+
+class KisStripedReadLocker : private boost::noncopyable
+{
+public:
+    KisStripedReadLocker(KisStripedReadWriteLock *lock)
+        : m_lock(lock),
+          m_ticket(lock->lockForRead())
+    {
+    }
+
+    ~KisStripedReadLocker() {
+        m_lock->unlockRead(m_ticket);
+    }
+
+private:
+    KisStripedReadWriteLock *m_lock;
+    int m_ticket;
+};
+
+class KisStripedWriteLocker : private boost::noncopyable
+{
+public:
+    KisStripedWriteLocker(KisStripedReadWriteLock *lock)
+        : m_lock(lock)
+    {
+        m_lock->lockForWrite();
+    }
+
+    ~KisStripedWriteLocker() {
+        m_lock->unlockWrite();
+    }
+
+private:
+    KisStripedReadWriteLock *m_lock;
+};
+
+#endif // KISSTRIPEDREADWRITELOCK_H
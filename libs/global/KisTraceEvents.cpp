@@ -0,0 +1,333 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTraceEvents.h"
+
+#include <chrono>
+#include <vector>
+#include <memory>
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QHash>
+#include <QIODevice>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+
+#include "kis_assert.h"
+
+namespace {
+
+const char *traceFileVariable = "KRITA_TRACE_EVENTS";
+
+/**
+ * The amount of events each thread keeps before starting to
+ * overwrite the oldest ones (32 bytes per event)
+ */
+const quint64 bufferCapacity = 1 << 16;
+
+struct Event {
+    const char *category;
+    const char *name;
+    qint64 timestamp;
+    quint32 threadId;
+    char phase;
+};
+
+/**
+ * A single-producer ring buffer. Only the owner thread writes into
+ * it, the readers copy the events out and then check that the
+ * writer has not overtaken them while copying.
+ */
+struct ThreadBuffer {
+    ThreadBuffer() : events(bufferCapacity) {}
+
+    std::vector<Event> events;
+    std::atomic<quint64> head {0};
+    quint32 threadId {0};
+    bool retired {false};
+};
+
+inline qint64 currentTimestamp() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+struct Tracer {
+    ~Tracer();
+
+    ThreadBuffer* acquireBuffer();
+    void retireBuffer(ThreadBuffer *buffer);
+
+    QMutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    QHash<quint32, QString> threadNames;
+    quint32 nextThreadId {1};
+    std::atomic<qint64> clearTimestamp {0};
+};
+
+Q_GLOBAL_STATIC(Tracer, s_tracer)
+
+/**
+ * Gives the buffer back to the tracer when the thread exits, so that
+ * the threads recreated by the thread pools would not allocate new
+ * buffers every time. The events stay in the buffer until they are
+ * overwritten, each of them remembers its thread.
+ */
+struct ThreadBufferHolder {
+    ~ThreadBufferHolder() {
+        if (buffer && !s_tracer.isDestroyed()) {
+            s_tracer->retireBuffer(buffer);
+        }
+    }
+
+    ThreadBuffer *buffer {nullptr};
+};
+
+thread_local ThreadBufferHolder t_buffer;
+
+QByteArray tracerToJson(Tracer *tracer);
+
+Tracer::~Tracer()
+{
+    const QString fileName = qEnvironmentVariable(traceFileVariable);
+
+    if (!fileName.isEmpty()) {
+        QFile file(fileName);
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write(tracerToJson(this));
+        }
+    }
+}
+
+ThreadBuffer* Tracer::acquireBuffer()
+{
+    QMutexLocker l(&mutex);
+
+    ThreadBuffer *buffer = nullptr;
+
+    for (auto it = buffers.begin(); it != buffers.end(); ++it) {
+        if ((*it)->retired) {
+            buffer = it->get();
+            buffer->retired = false;
+            break;
+        }
+    }
+
+    if (!buffer) {
+        buffers.emplace_back(new ThreadBuffer());
+        buffer = buffers.back().get();
+    }
+
+    buffer->threadId = nextThreadId++;
+
+    QThread *thread = QThread::currentThread();
+    QString name = thread ? thread->objectName() : QString();
+    if (name.isEmpty()) {
+        name = QString("Thread %1").arg(buffer->threadId);
+    }
+    threadNames.insert(buffer->threadId, name);
+
+    return buffer;
+}
+
+void Tracer::retireBuffer(ThreadBuffer *buffer)
+{
+    QMutexLocker l(&mutex);
+    buffer->retired = true;
+}
+
+inline void addEvent(char phase, const char *category, const char *name)
+{
+    ThreadBuffer *buffer = t_buffer.buffer;
+
+    if (Q_UNLIKELY(!buffer)) {
+        buffer = t_buffer.buffer = s_tracer->acquireBuffer();
+    }
+
+    const quint64 index = buffer->head.load(std::memory_order_relaxed);
+
+    Event &event = buffer->events[index % bufferCapacity];
+    event.category = category;
+    event.name = name;
+    event.timestamp = currentTimestamp();
+    event.threadId = buffer->threadId;
+    event.phase = phase;
+
+    buffer->head.store(index + 1, std::memory_order_release);
+}
+
+/**
+ * Copies the valid events of the buffer into \p events
+ */
+void readBuffer(const ThreadBuffer *buffer, qint64 clearTimestamp, std::vector<Event> &events)
+{
+    const quint64 head = buffer->head.load(std::memory_order_acquire);
+    const quint64 tail = head > bufferCapacity ? head - bufferCapacity : 0;
+
+    std::vector<Event> copied;
+    copied.reserve(head - tail);
+
+    for (quint64 i = tail; i < head; i++) {
+        copied.push_back(buffer->events[i % bufferCapacity]);
+    }
+
+    /**
+     * The writer might have overwritten the oldest events while we
+     * were copying them, drop everything that could be damaged (the
+     * slot of the event being written right now included)
+     */
+    const quint64 newHead = buffer->head.load(std::memory_order_acquire);
+    const quint64 firstValid =
+        newHead >= bufferCapacity ? qMax(tail, newHead - bufferCapacity + 1) : tail;
+
+    for (quint64 i = firstValid; i < head; i++) {
+        const Event &event = copied[i - tail];
+        if (event.timestamp >= clearTimestamp) {
+            events.push_back(event);
+        }
+    }
+}
+
+std::vector<Event> collectEvents(Tracer *tracer, QHash<quint32, QString> *threadNames)
+{
+    std::vector<Event> events;
+
+    QMutexLocker l(&tracer->mutex);
+
+    const qint64 clearTimestamp = tracer->clearTimestamp.load();
+
+    for (auto it = tracer->buffers.begin(); it != tracer->buffers.end(); ++it) {
+        readBuffer(it->get(), clearTimestamp, events);
+    }
+
+    if (threadNames) {
+        *threadNames = tracer->threadNames;
+    }
+
+    return events;
+}
+
+void writeJsonString(QByteArray &out, const char *str)
+{
+    out += '"';
+    for (const char *c = str; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            out += '\\';
+            out += *c;
+        } else if (uchar(*c) < 0x20) {
+            out += ' ';
+        } else {
+            out += *c;
+        }
+    }
+    out += '"';
+}
+
+QByteArray tracerToJson(Tracer *tracer)
+{
+    QHash<quint32, QString> threadNames;
+    const std::vector<Event> events = collectEvents(tracer, &threadNames);
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+
+    QByteArray out;
+    out.reserve(int(events.size()) * 96 + 64);
+
+    out += "{\"traceEvents\":[\n";
+
+    bool isFirst = true;
+
+    for (auto it = threadNames.constBegin(); it != threadNames.constEnd(); ++it) {
+        if (!isFirst) out += ",\n";
+        isFirst = false;
+
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid +
+            ",\"tid\":" + QByteArray::number(it.key()) + ",\"args\":{\"name\":";
+        writeJsonString(out, it.value().toUtf8().constData());
+        out += "}}";
+    }
+
+    for (const Event &event : events) {
+        if (!isFirst) out += ",\n";
+        isFirst = false;
+
+        out += "{\"name\":";
+        writeJsonString(out, event.name);
+        out += ",\"cat\":";
+        writeJsonString(out, event.category);
+        out += ",\"ph\":\"";
+        out += event.phase;
+        out += "\",\"ts\":" + QByteArray::number(double(event.timestamp) / 1000.0, 'f', 3) +
+            ",\"pid\":" + pid +
+            ",\"tid\":" + QByteArray::number(event.threadId);
+        if (event.phase == 'i') {
+            out += ",\"s\":\"t\"";
+        }
+        out += "}";
+    }
+
+    out += "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return out;
+}
+
+}
+
+std::atomic<bool> KisTraceEvents::s_enabled(qEnvironmentVariableIsSet(traceFileVariable));
+
+void KisTraceEvents::setEnabled(bool value)
+{
+    s_enabled.store(value);
+}
+
+void KisTraceEvents::begin(const char *category, const char *name)
+{
+    addEvent('B', category, name);
+}
+
+void KisTraceEvents::end(const char *category, const char *name)
+{
+    addEvent('E', category, name);
+}
+
+void KisTraceEvents::instant(const char *category, const char *name)
+{
+    if (!isEnabled()) return;
+    addEvent('i', category, name);
+}
+
+void KisTraceEvents::clear()
+{
+    s_tracer->clearTimestamp.store(currentTimestamp());
+}
+
+int KisTraceEvents::numEvents()
+{
+    return int(collectEvents(s_tracer, nullptr).size());
+}
+
+QByteArray KisTraceEvents::toJson()
+{
+    return tracerToJson(s_tracer);
+}
+
+bool KisTraceEvents::saveJson(QIODevice *device)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(device, false);
+
+    const QByteArray data = toJson();
+    return device->write(data) == data.size();
+}
+
+bool KisTraceEvents::saveJson(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    return saveJson(&file);
+}
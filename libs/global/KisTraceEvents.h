@@ -0,0 +1,97 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTRACEEVENTS_H
+#define KISTRACEEVENTS_H
+
+#include <atomic>
+
+#include <QByteArray>
+#include <QString>
+
+#include "kritaglobal_export.h"
+
+class QIODevice;
+
+/**
+ * A low-overhead tracer for the update pipeline. Every thread records
+ * begin/end events into its own lock-free ring buffer, which can be
+ * exported into a Chrome trace-event JSON file on demand and opened in
+ * chrome://tracing or https://ui.perfetto.dev.
+ *
+ * When the tracer is disabled, KIS_TRACE_SCOPE() costs a single relaxed
+ * atomic load. The tracer can be enabled at startup by setting the
+ * KRITA_TRACE_EVENTS environment variable to the name of the file, where
+ * the trace should be saved on exit.
+ *
+ * NOTE: category and name must be string literals (or any other strings
+ *       that live until the trace is exported), they are not copied.
+ */
+class KRITAGLOBAL_EXPORT KisTraceEvents
+{
+public:
+    static inline bool isEnabled() {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    static void setEnabled(bool value);
+
+    static void begin(const char *category, const char *name);
+    static void end(const char *category, const char *name);
+    static void instant(const char *category, const char *name);
+
+    /**
+     * Drops all the events recorded so far
+     */
+    static void clear();
+
+    /**
+     * Number of events currently stored in all the ring buffers
+     */
+    static int numEvents();
+
+    static QByteArray toJson();
+    static bool saveJson(QIODevice *device);
+    static bool saveJson(const QString &fileName);
+
+    class Scope
+    {
+    public:
+        inline Scope(const char *category, const char *name)
+            : m_category(isEnabled() ? category : nullptr),
+              m_name(name)
+        {
+            if (m_category) {
+                begin(m_category, m_name);
+            }
+        }
+
+        inline ~Scope() {
+            if (m_category) {
+                end(m_category, m_name);
+            }
+        }
+
+    private:
+        Scope(const Scope &rhs) = delete;
+        Scope& operator=(const Scope &rhs) = delete;
+
+    private:
+        const char *m_category;
+        const char *m_name;
+    };
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+#define KIS_TRACE_CONCAT_IMPL(a, b) a##b
+#define KIS_TRACE_CONCAT(a, b) KIS_TRACE_CONCAT_IMPL(a, b)
+
+#define KIS_TRACE_SCOPE(category, name) \
+    KisTraceEvents::Scope KIS_TRACE_CONCAT(__kisTraceScope, __LINE__)(category, name)
+
+#endif // KISTRACEEVENTS_H
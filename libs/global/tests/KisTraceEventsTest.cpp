@@ -0,0 +1,107 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTraceEventsTest.h"
+
+#include "simpletest.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtConcurrent>
+
+#include "KisTraceEvents.h"
+
+void KisTraceEventsTest::init()
+{
+    KisTraceEvents::clear();
+}
+
+void KisTraceEventsTest::cleanup()
+{
+    KisTraceEvents::setEnabled(false);
+}
+
+void KisTraceEventsTest::testDisabled()
+{
+    KisTraceEvents::setEnabled(false);
+
+    {
+        KIS_TRACE_SCOPE("test", "disabled");
+    }
+    KisTraceEvents::instant("test", "disabled-instant");
+
+    QCOMPARE(KisTraceEvents::numEvents(), 0);
+}
+
+void KisTraceEventsTest::testJsonExport()
+{
+    KisTraceEvents::setEnabled(true);
+
+    {
+        KIS_TRACE_SCOPE("test", "outer");
+        {
+            KIS_TRACE_SCOPE("test", "inner \"quoted\"");
+        }
+        KisTraceEvents::instant("test", "marker");
+    }
+
+    QCOMPARE(KisTraceEvents::numEvents(), 5);
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(KisTraceEvents::toJson(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    QStringList sequence;
+    int tid = -1;
+
+    Q_FOREACH (const QJsonValue &value, doc.object()["traceEvents"].toArray()) {
+        const QJsonObject event = value.toObject();
+        const QString phase = event["ph"].toString();
+
+        if (phase == "M") continue;
+
+        QCOMPARE(event["cat"].toString(), QString("test"));
+        QVERIFY(event.contains("ts"));
+        QVERIFY(event.contains("pid"));
+
+        if (tid < 0) {
+            tid = event["tid"].toInt();
+        }
+        QCOMPARE(event["tid"].toInt(), tid);
+
+        sequence << phase + ":" + event["name"].toString();
+    }
+
+    QCOMPARE(sequence, QStringList({"B:outer",
+                                    "B:inner \"quoted\"",
+                                    "E:inner \"quoted\"",
+                                    "i:marker",
+                                    "E:outer"}));
+}
+
+void KisTraceEventsTest::testMultipleThreads()
+{
+    KisTraceEvents::setEnabled(true);
+
+    const int numJobs = 64;
+    const int numEventsPerJob = 100;
+
+    QVector<int> jobs(numJobs);
+    QtConcurrent::blockingMap(jobs, [] (int &) {
+        for (int i = 0; i < numEventsPerJob; i++) {
+            KIS_TRACE_SCOPE("test", "job");
+        }
+    });
+
+    QCOMPARE(KisTraceEvents::numEvents(), numJobs * numEventsPerJob * 2);
+
+    QJsonParseError error;
+    QJsonDocument::fromJson(KisTraceEvents::toJson(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+}
+
+SIMPLE_TEST_MAIN(KisTraceEventsTest);
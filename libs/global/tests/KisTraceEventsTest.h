@@ -0,0 +1,24 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTRACEEVENTSTEST_H
+#define KISTRACEEVENTSTEST_H
+
+#include <QObject>
+
+class KisTraceEventsTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void testDisabled();
+    void testJsonExport();
+    void testMultipleThreads();
+};
+
+#endif // KISTRACEEVENTSTEST_H
@@ -15,9 +15,25 @@
 #include <QMutex>
 #include <QMutexLocker>
 #include <kis_lockless_stack.h>
+#include <KisStripedReadWriteLock.h>
 
 #define CALL_MEMBER(obj, pmf) ((obj).*(pmf))
 
+/**
+ * Epoch-based reclamation of the memory retired by the map.
+ *
+ * The readers are registered in one of the two epochs (even and odd).
+ * The reader counters are striped the same way as in
+ * KisStripedReadWriteLock, so the readers of different threads don't
+ * fight for the same cache line.
+ *
+ * The retired objects are first collected in the "pending" pools. When
+ * all the readers of the previous epoch are gone, the objects, that
+ * were retired before the previous epoch switch, are destroyed, the
+ * pending objects become "waiting" and the epoch is switched again.
+ * This way the reclamation never waits for the readers of the
+ * current epoch, so a stream of short readers cannot starve it.
+ */
 class QSBR
 {
 private:
@@ -39,36 +55,41 @@ private:
         }
     };
 
-    QAtomicInt m_rawPointerUsers;
+    struct ReaderStripe {
+        std::atomic<int> users[2];
+        char padding[64 - 2 * sizeof(std::atomic<int>)];
+    };
+
+    ReaderStripe m_stripes[KisStripedReadWriteLock::NumStripes];
+    std::atomic<int> m_epoch {0};
+    std::atomic<bool> m_reclaimInProgress {false};
+
     KisLocklessStack<Action> m_pendingActions;
     KisLocklessStack<Action> m_migrationReclaimActions;
+    KisLocklessStack<Action> m_waitingActions;
 
-    void releasePoolSafely(KisLocklessStack<Action> *pool, bool force = false) {
-        KisLocklessStack<Action> tmp;
-        tmp.mergeFrom(*pool);
-        if (tmp.isEmpty()) return;
-
-        if (force || tmp.size() > 4096) {
-            while (m_rawPointerUsers.loadAcquire());
+    bool hasReaders(int epoch) const {
+        for (int i = 0; i < KisStripedReadWriteLock::NumStripes; i++) {
+            if (m_stripes[i].users[epoch].load(std::memory_order_seq_cst)) return true;
+        }
+        return false;
+    }
 
-            Action action;
-            while (tmp.pop(action)) {
-                action();
-            }
-        } else {
-            if (!m_rawPointerUsers.loadAcquire()) {
-                Action action;
-                while (tmp.pop(action)) {
-                    action();
-                }
-            } else {
-                // push elements back to the source
-                pool->mergeFrom(tmp);
-            }
+    static void runActions(KisLocklessStack<Action> *pool) {
+        Action action;
+        while (pool->pop(action)) {
+            action();
         }
     }
 
 public:
+    QSBR()
+    {
+        for (int i = 0; i < KisStripedReadWriteLock::NumStripes; i++) {
+            m_stripes[i].users[0].store(0, std::memory_order_relaxed);
+            m_stripes[i].users[1].store(0, std::memory_order_relaxed);
+        }
+    }
 
     template <class T>
     void enqueue(void (T::*pmf)(), T* target, bool migration = false)
@@ -95,28 +116,80 @@ public:
 
     void update()
     {
-        releasePoolSafely(&m_pendingActions);
-        releasePoolSafely(&m_migrationReclaimActions);
+        if (m_pendingActions.isEmpty() &&
+            m_migrationReclaimActions.isEmpty() &&
+            m_waitingActions.isEmpty()) {
+
+            return;
+        }
+
+        // only one thread does the reclamation, others just go on
+        if (m_reclaimInProgress.exchange(true, std::memory_order_acquire)) return;
+
+        const int previousEpoch = 1 - m_epoch.load(std::memory_order_seq_cst);
+
+        if (!hasReaders(previousEpoch)) {
+            runActions(&m_waitingActions);
+
+            m_waitingActions.mergeFrom(m_pendingActions);
+            m_waitingActions.mergeFrom(m_migrationReclaimActions);
+
+            if (!m_waitingActions.isEmpty()) {
+                m_epoch.store(previousEpoch, std::memory_order_seq_cst);
+            }
+        }
+
+        m_reclaimInProgress.store(false, std::memory_order_release);
     }
 
     void flush()
     {
-        releasePoolSafely(&m_pendingActions, true);
-        releasePoolSafely(&m_migrationReclaimActions, true);
+        while (m_reclaimInProgress.exchange(true, std::memory_order_acquire));
+        while (hasReaders(0) || hasReaders(1));
+
+        runActions(&m_waitingActions);
+        runActions(&m_pendingActions);
+        runActions(&m_migrationReclaimActions);
+
+        m_reclaimInProgress.store(false, std::memory_order_release);
     }
 
-    void lockRawPointerAccess()
+    /**
+     * Registers the current thread as a reader of the raw pointers
+     * stored in the map. The returned ticket must be passed to
+     * the corresponding unlockRawPointerAccess() call.
+     *
+     * The epoch may be switched between reading it and registering
+     * the reader, so the epoch is rechecked after the counter is
+     * incremented. If it has changed, the registration is rolled back
+     * and retried in the new epoch, so the reader is always counted
+     * in the epoch it has actually seen.
+     */
+    int lockRawPointerAccess()
     {
-        m_rawPointerUsers.ref();
+        const int stripe = KisStripedReadWriteLock::currentStripe();
+        int epoch = m_epoch.load(std::memory_order_seq_cst);
+
+        while (true) {
+            m_stripes[stripe].users[epoch].fetch_add(1, std::memory_order_seq_cst);
+
+            const int currentEpoch = m_epoch.load(std::memory_order_seq_cst);
+            if (currentEpoch == epoch) break;
+
+            m_stripes[stripe].users[epoch].fetch_sub(1, std::memory_order_seq_cst);
+            epoch = currentEpoch;
+        }
+
+        return (stripe << 1) | epoch;
     }
 
-    void unlockRawPointerAccess()
+    void unlockRawPointerAccess(int ticket)
     {
-        m_rawPointerUsers.deref();
+        m_stripes[ticket >> 1].users[ticket & 1].fetch_sub(1, std::memory_order_release);
     }
 
     bool sanityRawPointerAccessLocked() const {
-        return m_rawPointerUsers.loadAcquire();
+        return hasReaders(0) || hasReaders(1);
     }
 };
 
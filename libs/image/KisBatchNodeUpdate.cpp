@@ -6,6 +6,8 @@
 
 #include "KisBatchNodeUpdate.h"
 
+#include <QSet>
+
 #include "kis_node.h"
 #include "kis_layer_utils.h"
 
@@ -51,6 +53,75 @@ KisBatchNodeUpdate KisBatchNodeUpdate::compressed() const
     return newUpdateData;
 }
 
+namespace {
+KisNodeSP findCommonAncestor(KisNodeSP lhs, KisNodeSP rhs)
+{
+    QSet<KisNode*> lhsAncestors;
+
+    for (KisNodeSP node = lhs; node; node = node->parent()) {
+        lhsAncestors.insert(node.data());
+    }
+
+    for (KisNodeSP node = rhs; node; node = node->parent()) {
+        if (lhsAncestors.contains(node.data())) {
+            return node;
+        }
+    }
+
+    return KisNodeSP();
+}
+}
+
+QVector<KisBatchNodeUpdate::SharedTraversal> KisBatchNodeUpdate::sharedTraversals() const
+{
+    QVector<SharedTraversal> traversals;
+
+    const KisBatchNodeUpdate updates = compressed();
+
+    for (auto it = updates.begin(); it != updates.end(); ++it) {
+        if (it->second.isEmpty()) continue;
+
+        SharedTraversal traversal;
+        traversal.commonAncestor = it->first;
+        traversal.dirtyNodes << it->first;
+        traversal.dirtyRect = it->second;
+
+        /**
+         * The united rect may start overlapping the traversals
+         * we have already checked, so repeat until nothing is joined
+         */
+        bool joined = false;
+
+        do {
+            joined = false;
+
+            for (auto trIt = traversals.begin(); trIt != traversals.end();) {
+                KisNodeSP commonAncestor;
+
+                if (trIt->dirtyRect.intersects(traversal.dirtyRect)) {
+                    commonAncestor = findCommonAncestor(trIt->commonAncestor,
+                                                        traversal.commonAncestor);
+                }
+
+                if (commonAncestor) {
+                    traversal.commonAncestor = commonAncestor;
+                    traversal.dirtyNodes << trIt->dirtyNodes;
+                    traversal.dirtyRect |= trIt->dirtyRect;
+
+                    trIt = traversals.erase(trIt);
+                    joined = true;
+                } else {
+                    ++trIt;
+                }
+            }
+        } while (joined);
+
+        traversals.append(traversal);
+    }
+
+    return traversals;
+}
+
 KisBatchNodeUpdate &KisBatchNodeUpdate::operator|=(const KisBatchNodeUpdate &rhs)
 {
     if (this == &rhs)
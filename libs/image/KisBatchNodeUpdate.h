@@ -10,6 +10,7 @@
 #include "kritaimage_export.h"
 
 #include <QRect>
+#include <QVector>
 #include <QSharedPointer>
 #include <boost/operators.hpp>
 #include <kis_types.h>
@@ -24,6 +25,18 @@ class KRITAIMAGE_EXPORT KisBatchNodeUpdate
         : public std::vector<std::pair<KisNodeSP, QRect>>,
         boost::orable<KisBatchNodeUpdate>
 {
+public:
+    /**
+     * A set of updates that can be executed with a single
+     * traversal of the graph, starting at \p commonAncestor
+     * of the dirty nodes
+     */
+    struct SharedTraversal {
+        KisNodeSP commonAncestor;
+        KisNodeList dirtyNodes;
+        QRect dirtyRect;
+    };
+
 public:
     KisBatchNodeUpdate() = default;
     KisBatchNodeUpdate(const KisBatchNodeUpdate &rhs) = default;
@@ -64,6 +77,17 @@ public:
      */
     KisBatchNodeUpdate compressed() const;
 
+    /**
+     * Compresses the updates and groups the ones with overlapping
+     * dirty rects into shared traversals. Every traversal gets the
+     * united dirty rect of its nodes, so the overlapping areas are
+     * recomposited only once. The updates that don't overlap with
+     * anything form the traversals of a single node.
+     *
+     * \see compress()
+     */
+    QVector<SharedTraversal> sharedTraversals() const;
+
     /**
      * Merge two update batches. The updates for the same nodes
      * will be merged. This merge operation does **not** do
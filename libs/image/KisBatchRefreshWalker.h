@@ -0,0 +1,118 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISBATCHREFRESHWALKER_H
+#define KISBATCHREFRESHWALKER_H
+
+#include <QSet>
+
+#include "kis_full_refresh_walker.h"
+
+
+/**
+ * Refreshes several dirty nodes with a single traversal of their
+ * common ancestor. The walker is started on the ancestor and works
+ * like KisFullRefreshWalker, but descends only into the groups that
+ * contain dirty nodes. The subtrees of the dirty nodes are refreshed
+ * completely, the rest of the nodes are just composited (or
+ * recalculated if they depend on the lower nodes), so every group on
+ * the way from the dirty nodes to the root is blended only once.
+ *
+ * The dirty nodes should not be the children of each other, see
+ * KisBatchNodeUpdate::compress().
+ */
+class KisBatchRefreshWalker : public KisFullRefreshWalker
+{
+public:
+    KisBatchRefreshWalker(QRect cropRect, const KisNodeList &dirtyNodes)
+        : KisFullRefreshWalker(cropRect),
+          m_dirtyNodes(dirtyNodes)
+    {
+        // the walker depends on its set of dirty nodes
+        setJoinable(false);
+    }
+
+    UpdateType type() const override {
+        return BATCH_REFRESH;
+    }
+
+    KisNodeList dirtyNodes() const {
+        return m_dirtyNodes;
+    }
+
+protected:
+    void startTrip(KisProjectionLeafSP startWith) override {
+        /**
+         * The nodes might have been moved since the previous
+         * calculation of the walker, so rebuild the paths on
+         * every trip
+         */
+        if (isStartLeaf(startWith)) {
+            rebuildDirtyPaths();
+        }
+
+        KisFullRefreshWalker::startTrip(startWith);
+    }
+
+    NodePosition positionToFilthy(KisProjectionLeafSP leaf) const override {
+        if (isOnDirtyPath(leaf) || isInsideDirtySubtree(leaf)) {
+            return N_FILTHY;
+        }
+
+        KisProjectionLeafSP prevLeaf = leaf->prevSibling();
+        while (prevLeaf) {
+            if (isOnDirtyPath(prevLeaf)) {
+                return N_ABOVE_FILTHY;
+            }
+            prevLeaf = prevLeaf->prevSibling();
+        }
+
+        return N_BELOW_FILTHY;
+    }
+
+    bool needsSubtreeRefresh(KisProjectionLeafSP leaf) const override {
+        return isOnDirtyPath(leaf) || isInsideDirtySubtree(leaf);
+    }
+
+private:
+    void rebuildDirtyPaths() {
+        m_dirtyNodesSet.clear();
+        m_dirtyPaths.clear();
+
+        Q_FOREACH (KisNodeSP node, m_dirtyNodes) {
+            m_dirtyNodesSet.insert(node.data());
+
+            KisProjectionLeafSP leaf = node->projectionLeaf();
+            while (leaf) {
+                m_dirtyPaths.insert(leaf->node().data());
+                leaf = leaf->parent();
+            }
+        }
+    }
+
+    inline bool isOnDirtyPath(KisProjectionLeafSP leaf) const {
+        return m_dirtyPaths.contains(leaf->node().data());
+    }
+
+    inline bool isInsideDirtySubtree(KisProjectionLeafSP leaf) const {
+        while (leaf) {
+            if (m_dirtyNodesSet.contains(leaf->node().data())) return true;
+            leaf = leaf->parent();
+        }
+        return false;
+    }
+
+private:
+    KisNodeList m_dirtyNodes;
+
+    /**
+     * The dirty nodes themselves and all their parents
+     */
+    QSet<KisNode*> m_dirtyPaths;
+    QSet<KisNode*> m_dirtyNodesSet;
+};
+
+#endif // KISBATCHREFRESHWALKER_H
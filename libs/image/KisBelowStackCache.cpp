@@ -0,0 +1,116 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisBelowStackCache.h"
+
+#include <QMutexLocker>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+
+#include "kis_paint_device.h"
+#include "kis_painter.h"
+
+namespace {
+/**
+ * The valid area is built from the rects of the updates, which are
+ * rather small during a stroke. Don't let the region become too
+ * fragmented, the stroke will fill the cache again quickly.
+ */
+const int MaxRegionRects = 512;
+}
+
+KisBelowStackCache::KisBelowStackCache()
+{
+}
+
+KisBelowStackCache::~KisBelowStackCache()
+{
+}
+
+int KisBelowStackCache::validate(const LeafList &belowLeaves)
+{
+    QMutexLocker l(&m_lock);
+
+    if (belowLeaves != m_leaves) {
+        m_leaves = belowLeaves;
+        resetImpl();
+    }
+
+    return m_generation;
+}
+
+bool KisBelowStackCache::fetch(int generation, KisPaintDeviceSP dst, const QRect &rect)
+{
+    KisPaintDeviceSP device;
+
+    {
+        QMutexLocker l(&m_lock);
+
+        if (generation != m_generation || !m_device || !isCompatible(dst)) return false;
+        if (!(QRegion(rect) - m_validRegion).isEmpty()) return false;
+
+        device = m_device;
+    }
+
+    /**
+     * Even if the cache is reset meanwhile, our rect is not touched
+     * by the job that did that, so the copied data is still correct
+     */
+    KisPainter::copyAreaOptimized(rect.topLeft(), device, dst, rect);
+    return true;
+}
+
+void KisBelowStackCache::store(int generation, KisPaintDeviceSP src, const QRect &rect)
+{
+    KisPaintDeviceSP device;
+
+    {
+        QMutexLocker l(&m_lock);
+
+        if (generation != m_generation) return;
+
+        if (!m_device || !isCompatible(src)) {
+            m_device = new KisPaintDevice(src->colorSpace());
+            m_device->setDefaultPixel(src->defaultPixel());
+            m_validRegion = QRegion();
+        }
+
+        device = m_device;
+    }
+
+    KisPainter::copyAreaOptimized(rect.topLeft(), src, device, rect);
+
+    QMutexLocker l(&m_lock);
+
+    if (generation != m_generation || device != m_device) return;
+
+    if (m_validRegion.rectCount() > MaxRegionRects) {
+        m_validRegion = QRegion();
+    }
+
+    m_validRegion += rect;
+}
+
+void KisBelowStackCache::reset()
+{
+    QMutexLocker l(&m_lock);
+    m_leaves.clear();
+    resetImpl();
+}
+
+void KisBelowStackCache::resetImpl()
+{
+    m_device = 0;
+    m_validRegion = QRegion();
+    m_generation++;
+}
+
+bool KisBelowStackCache::isCompatible(KisPaintDeviceSP dev) const
+{
+    return *m_device->colorSpace() == *dev->colorSpace() &&
+        m_device->defaultPixel() == dev->defaultPixel();
+}
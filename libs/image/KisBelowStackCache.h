@@ -0,0 +1,86 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISBELOWSTACKCACHE_H
+#define KISBELOWSTACKCACHE_H
+
+#include "kritaimage_export.h"
+
+#include <QMutex>
+#include <QRegion>
+#include <QVector>
+
+#include "kis_types.h"
+
+class KisProjectionLeaf;
+
+/**
+ * Keeps the composition of the children of a group lying below
+ * the currently updated (filthy) one.
+ *
+ * When the user paints on a layer in the middle of a deep stack,
+ * every update of the group re-composites all the layers below the
+ * painted one, although they do not change. KisAsyncMerger stores the
+ * result of this composition here and later copies it to the group
+ * projection instead of blending the lower layers again.
+ *
+ * The cache is built for a specific list of the lower leaves. Every
+ * time the group is composited the merger passes the list of leaves
+ * lying below the filthy one. If the list differs, then either the
+ * user switched to another layer, or one of the lower layers has
+ * changed itself, and the cache is dropped.
+ *
+ * The cache is accessed by the merge jobs of the group that run in
+ * parallel. The scheduler guarantees that the rects of these jobs do
+ * not overlap, so only the bookkeeping is guarded by the lock.
+ */
+class KRITAIMAGE_EXPORT KisBelowStackCache
+{
+public:
+    typedef QVector<KisProjectionLeaf*> LeafList;
+
+public:
+    KisBelowStackCache();
+    ~KisBelowStackCache();
+
+    /**
+     * Resets the cache if it has been built for the leaves other than
+     * \p belowLeaves. Should be called every time the group is
+     * composited, even when the cache is not going to be used.
+     *
+     * \return the generation of the cache content that should be
+     *         passed to fetch() and store()
+     */
+    int validate(const LeafList &belowLeaves);
+
+    /**
+     * Copies \p rect from the cache into \p dst if the whole rect is
+     * available in the generation \p generation
+     */
+    bool fetch(int generation, KisPaintDeviceSP dst, const QRect &rect);
+
+    /**
+     * Saves the composition of the lower leaves from \p src. If the
+     * cache has been reset after \p generation was issued, the data
+     * is ignored.
+     */
+    void store(int generation, KisPaintDeviceSP src, const QRect &rect);
+
+    void reset();
+
+private:
+    void resetImpl();
+    bool isCompatible(KisPaintDeviceSP dev) const;
+
+private:
+    QMutex m_lock;
+    LeafList m_leaves;
+    KisPaintDeviceSP m_device;
+    QRegion m_validRegion;
+    int m_generation = 0;
+};
+
+#endif // KISBELOWSTACKCACHE_H
@@ -0,0 +1,129 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisNumaTopology.h"
+
+#include <QtGlobal>
+#include <QVector>
+
+#ifdef Q_OS_LINUX
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+struct Topology
+{
+    Topology();
+
+    int numNodes = 1;
+    QVector<QVector<int>> nodeCpus;
+};
+
+#ifdef Q_OS_LINUX
+
+/**
+ * Parses the lists like "0-15,32-47"
+ */
+QVector<int> parseCpuList(const QString &list)
+{
+    QVector<int> cpus;
+
+    Q_FOREACH (const QString &range, list.trimmed().split(',', QString::SkipEmptyParts)) {
+        const QStringList bounds = range.split('-');
+
+        bool startOk = false;
+        bool endOk = false;
+        const int start = bounds.first().toInt(&startOk);
+        const int end = bounds.size() > 1 ? bounds[1].toInt(&endOk) : start;
+
+        if (!startOk || (bounds.size() > 1 && !endOk)) continue;
+
+        for (int cpu = start; cpu <= end; cpu++) {
+            cpus.append(cpu);
+        }
+    }
+
+    return cpus;
+}
+
+Topology::Topology()
+{
+    QDir dir("/sys/devices/system/node");
+    const QStringList nodeDirs = dir.entryList(QStringList() << "node*", QDir::Dirs);
+    const QRegularExpression nodeName("^node(\\d+)$");
+
+    QVector<QVector<int>> cpusOfNodes;
+
+    Q_FOREACH (const QString &nodeDir, nodeDirs) {
+        QRegularExpressionMatch match = nodeName.match(nodeDir);
+        if (!match.hasMatch()) continue;
+
+        const int node = match.captured(1).toInt();
+
+        QFile file(dir.filePath(nodeDir + "/cpulist"));
+        if (!file.open(QIODevice::ReadOnly)) continue;
+
+        if (node >= cpusOfNodes.size()) {
+            cpusOfNodes.resize(node + 1);
+        }
+        cpusOfNodes[node] = parseCpuList(QString::fromLatin1(file.readAll()));
+    }
+
+    if (cpusOfNodes.size() <= 1) return;
+
+    nodeCpus = cpusOfNodes;
+    numNodes = nodeCpus.size();
+}
+
+#else
+
+Topology::Topology()
+{
+}
+
+#endif
+
+const Topology& topology()
+{
+    static const Topology s_topology;
+    return s_topology;
+}
+
+}
+
+int KisNumaTopology::numNodes()
+{
+    return topology().numNodes;
+}
+
+bool KisNumaTopology::bindCurrentThreadToNode(int node)
+{
+    const Topology &t = topology();
+    if (t.numNodes <= 1 || node < 0 || node >= t.numNodes) return false;
+
+#ifdef Q_OS_LINUX
+    if (t.nodeCpus[node].isEmpty()) return false;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    Q_FOREACH (int cpu, t.nodeCpus[node]) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,33 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISNUMATOPOLOGY_H
+#define KISNUMATOPOLOGY_H
+
+#include "kritaimage_export.h"
+
+/**
+ * Describes NUMA nodes of the machine. The topology is read once on
+ * the first call. On the systems where it is unavailable (and on
+ * non-Linux systems) the machine is considered to have a single node.
+ */
+class KRITAIMAGE_EXPORT KisNumaTopology
+{
+public:
+    /**
+     * The number of NUMA nodes, always greater than zero
+     */
+    static int numNodes();
+
+    /**
+     * Restricts the calling thread to the CPUs of \p node.
+     *
+     * \return false if the binding is not supported or failed
+     */
+    static bool bindCurrentThreadToNode(int node);
+};
+
+#endif // KISNUMATOPOLOGY_H
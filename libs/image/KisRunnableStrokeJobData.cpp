@@ -8,6 +8,7 @@
 
 #include <QRunnable>
 #include <kis_assert.h>
+#include "KisWorkStealingExecutor.h"
 
 KisRunnableStrokeJobData::KisRunnableStrokeJobData(QRunnable *runnable, KisStrokeJobData::Sequentiality sequentiality, KisStrokeJobData::Exclusivity exclusivity)
     : KisRunnableStrokeJobDataBase(sequentiality, exclusivity),
@@ -34,3 +35,14 @@ void KisRunnableStrokeJobData::run() {
         m_func();
     }
 }
+
+void KisRunnableStrokeJobData::spawnSubtask(std::function<void()> func)
+{
+    KisTaskGroup *group = KisTaskGroup::current();
+
+    if (group) {
+        group->run(std::move(func));
+    } else {
+        func();
+    }
+}
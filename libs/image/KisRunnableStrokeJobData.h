@@ -25,6 +25,16 @@ public:
 
     void run() override;
 
+    /**
+     * Splits off a part of the currently running stroke job. When
+     * called from inside a job executed by the updater context, \p func
+     * is queued into the context's work-stealing executor and may be run
+     * by any idle worker. The job will not be considered finished until
+     * all its subtasks are completed. Outside the updater context \p func
+     * is executed right away.
+     */
+    static void spawnSubtask(std::function<void()> func);
+
 private:
     QRunnable *m_runnable = 0;
     std::function<void()> m_func;
@@ -0,0 +1,115 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisUpdateCostEstimator.h"
+
+#include <QMutexLocker>
+
+#include "kis_projection_leaf.h"
+#include "kis_abstract_projection_plane.h"
+
+namespace {
+/**
+ * The weight of a new sample in the moving average
+ */
+const qreal SampleWeight = 0.2;
+
+/**
+ * Samples covering smaller areas are dominated by the fixed per-leaf
+ * overhead and say nothing about the per-pixel cost
+ */
+const qint64 MinSamplePixels = 32 * 32;
+
+/**
+ * The planes are identified by their addresses only, so the table
+ * may collect the entries for already deleted layers. Just drop
+ * everything when it grows too big, the costs will be learned again
+ * in a couple of updates.
+ */
+const int MaxCostEntries = 4096;
+}
+
+KisUpdateCostEstimator::KisUpdateCostEstimator()
+{
+}
+
+KisUpdateCostEstimator::~KisUpdateCostEstimator()
+{
+}
+
+bool KisUpdateCostEstimator::isRecalculated(const KisBaseRectsWalker::JobItem &item)
+{
+    return !(item.m_position & KisBaseRectsWalker::N_BELOW_FILTHY);
+}
+
+KisUpdateCostEstimator::Sample KisUpdateCostEstimator::createSample(const KisBaseRectsWalker::JobItem &item, qint64 nsecs)
+{
+    Sample sample;
+    sample.plane = item.m_leaf->projectionPlane().data();
+    sample.recalculated = isRecalculated(item);
+    sample.numPixels = qint64(item.m_applyRect.width()) * item.m_applyRect.height();
+    sample.nsecs = nsecs;
+    return sample;
+}
+
+void KisUpdateCostEstimator::addSamples(const Samples &samples)
+{
+    QMutexLocker l(&m_lock);
+
+    if (m_costPerPixel.size() > MaxCostEntries) {
+        m_costPerPixel.clear();
+    }
+
+    Q_FOREACH (const Sample &sample, samples) {
+        if (sample.numPixels < MinSamplePixels) continue;
+
+        const qreal cost = qreal(sample.nsecs) / sample.numPixels;
+
+        auto it = m_costPerPixel.find(qMakePair(sample.plane, sample.recalculated));
+        if (it == m_costPerPixel.end()) {
+            m_costPerPixel.insert(qMakePair(sample.plane, sample.recalculated), cost);
+        } else {
+            *it += SampleWeight * (cost - *it);
+        }
+
+        if (!m_hasSamples) {
+            m_averageCostPerPixel = cost;
+            m_hasSamples = true;
+        } else {
+            m_averageCostPerPixel += SampleWeight * (cost - m_averageCostPerPixel);
+        }
+    }
+}
+
+bool KisUpdateCostEstimator::hasSamples() const
+{
+    QMutexLocker l(&m_lock);
+    return m_hasSamples;
+}
+
+qreal KisUpdateCostEstimator::estimateCost(KisBaseRectsWalker &walker) const
+{
+    QMutexLocker l(&m_lock);
+
+    qreal cost = 0.0;
+
+    Q_FOREACH (const KisBaseRectsWalker::JobItem &item, walker.leafStack()) {
+        const CostKey key(item.m_leaf->projectionPlane().data(), isRecalculated(item));
+        const qreal costPerPixel = m_costPerPixel.value(key, m_averageCostPerPixel);
+
+        cost += costPerPixel * item.m_applyRect.width() * item.m_applyRect.height();
+    }
+
+    return cost;
+}
+
+void KisUpdateCostEstimator::clear()
+{
+    QMutexLocker l(&m_lock);
+    m_costPerPixel.clear();
+    m_averageCostPerPixel = 0.0;
+    m_hasSamples = false;
+}
@@ -0,0 +1,82 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISUPDATECOSTESTIMATOR_H
+#define KISUPDATECOSTESTIMATOR_H
+
+#include "kritaimage_export.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QVector>
+
+#include "kis_base_rects_walker.h"
+
+/**
+ * Learns how expensive the merge of every node of the image is.
+ *
+ * KisAsyncMerger measures the time spent on every leaf of the walker
+ * and reports it here as a sample. For every projection plane the
+ * estimator keeps a moving average of the nanoseconds spent per pixel
+ * of the apply rect, separately for the leaves that are recalculated
+ * and for the ones that are only composited onto the projection.
+ *
+ * KisSimpleUpdateQueue uses the estimations to choose the size of the
+ * patches when splitting big updates and to start the most expensive
+ * patches first.
+ */
+class KRITAIMAGE_EXPORT KisUpdateCostEstimator
+{
+public:
+    struct Sample {
+        const void *plane = nullptr;
+        bool recalculated = false;
+        qint64 numPixels = 0;
+        qint64 nsecs = 0;
+    };
+
+    typedef QVector<Sample> Samples;
+
+public:
+    KisUpdateCostEstimator();
+    ~KisUpdateCostEstimator();
+
+    /**
+     * Creates a sample for the leaf \p item that took \p nsecs
+     * nanoseconds to merge
+     */
+    static Sample createSample(const KisBaseRectsWalker::JobItem &item, qint64 nsecs);
+
+    void addSamples(const Samples &samples);
+
+    /**
+     * Return true if at least one sample has been reported
+     */
+    bool hasSamples() const;
+
+    /**
+     * Estimated cost of merging the (already collected) \p walker in
+     * nanoseconds. The leaves that have never been measured get the
+     * average per-pixel cost of all the known leaves.
+     */
+    qreal estimateCost(KisBaseRectsWalker &walker) const;
+
+    void clear();
+
+private:
+    static bool isRecalculated(const KisBaseRectsWalker::JobItem &item);
+
+private:
+    typedef QPair<const void*, bool> CostKey;
+
+    mutable QMutex m_lock;
+    QHash<CostKey, qreal> m_costPerPixel;
+    qreal m_averageCostPerPixel = 0.0;
+    bool m_hasSamples = false;
+};
+
+#endif // KISUPDATECOSTESTIMATOR_H
@@ -0,0 +1,184 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisUpdateRectsIndex.h"
+
+#include <algorithm>
+
+#include "kis_assert.h"
+#include "kis_base_rects_walker.h"
+
+namespace {
+inline qint32 floorDiv(qint32 value, qint32 divisor)
+{
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+}
+
+KisUpdateRectsIndex::KisUpdateRectsIndex()
+    : m_patchSize(512, 512)
+{
+}
+
+KisUpdateRectsIndex::~KisUpdateRectsIndex()
+{
+}
+
+void KisUpdateRectsIndex::resetPatchSize(const QSize &size)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(size.width() > 0 && size.height() > 0);
+
+    clear();
+    m_patchSize = size;
+}
+
+void KisUpdateRectsIndex::insert(KisBaseRectsWalker *walker)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!m_entries.contains(walker));
+
+    Entry entry;
+    entry.walker = walker;
+    entry.rect = walker->requestedRect();
+    entry.sequenceNumber = m_nextSequenceNumber++;
+
+    if (!isIndexable(entry.rect)) return;
+
+    m_entries.insert(walker, entry);
+    insertEntry(entry);
+}
+
+void KisUpdateRectsIndex::update(KisBaseRectsWalker *walker)
+{
+    auto it = m_entries.find(walker);
+
+    /**
+     * The walker that has never been indexed is bigger than a patch,
+     * its rect can only grow, so it will not become indexable
+     */
+    if (it == m_entries.end()) return;
+
+    removeEntry(*it);
+    it->rect = walker->requestedRect();
+
+    if (isIndexable(it->rect)) {
+        insertEntry(*it);
+    } else {
+        m_entries.erase(it);
+    }
+}
+
+void KisUpdateRectsIndex::remove(KisBaseRectsWalker *walker)
+{
+    auto it = m_entries.find(walker);
+    if (it == m_entries.end()) return;
+
+    removeEntry(*it);
+    m_entries.erase(it);
+}
+
+QVector<KisBaseRectsWalker*> KisUpdateRectsIndex::joinCandidates(const QRect &rect) const
+{
+    QVector<KisBaseRectsWalker*> result;
+    if (!isIndexable(rect)) return result;
+
+    /**
+     * The union of the rects may not be bigger than a patch, so the
+     * candidate must lie inside this window completely
+     */
+    const QRect window(QPoint(rect.right() - m_patchSize.width() + 1,
+                              rect.bottom() - m_patchSize.height() + 1),
+                       QPoint(rect.left() + m_patchSize.width() - 1,
+                              rect.top() + m_patchSize.height() - 1));
+
+    const qint32 firstCol = floorDiv(window.left(), m_patchSize.width());
+    const qint32 lastCol = floorDiv(window.right(), m_patchSize.width());
+    const qint32 firstRow = floorDiv(window.top(), m_patchSize.height());
+    const qint32 lastRow = floorDiv(window.bottom(), m_patchSize.height());
+
+    QVector<Entry> entries;
+
+    for (qint32 row = firstRow; row <= lastRow; row++) {
+        for (qint32 col = firstCol; col <= lastCol; col++) {
+            auto cellIt = m_cells.constFind(cellKey(QPoint(col, row)));
+            if (cellIt == m_cells.constEnd()) continue;
+
+            Q_FOREACH (const Entry &entry, *cellIt) {
+                if (window.contains(entry.rect)) {
+                    entries.append(entry);
+                }
+            }
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(),
+              [] (const Entry &lhs, const Entry &rhs) {
+                  return lhs.sequenceNumber < rhs.sequenceNumber;
+              });
+
+    result.reserve(entries.size());
+    Q_FOREACH (const Entry &entry, entries) {
+        result.append(entry.walker);
+    }
+
+    return result;
+}
+
+int KisUpdateRectsIndex::size() const
+{
+    return m_entries.size();
+}
+
+void KisUpdateRectsIndex::clear()
+{
+    m_cells.clear();
+    m_entries.clear();
+    m_nextSequenceNumber = 0;
+}
+
+bool KisUpdateRectsIndex::isIndexable(const QRect &rect) const
+{
+    return !rect.isEmpty() &&
+        rect.width() <= m_patchSize.width() &&
+        rect.height() <= m_patchSize.height();
+}
+
+quint64 KisUpdateRectsIndex::cellKey(const QPoint &cell) const
+{
+    return (quint64(quint32(cell.x())) << 32) | quint32(cell.y());
+}
+
+void KisUpdateRectsIndex::insertEntry(const Entry &entry)
+{
+    const QPoint cell(floorDiv(entry.rect.left(), m_patchSize.width()),
+                      floorDiv(entry.rect.top(), m_patchSize.height()));
+
+    m_cells[cellKey(cell)].append(entry);
+}
+
+void KisUpdateRectsIndex::removeEntry(const Entry &entry)
+{
+    const QPoint cell(floorDiv(entry.rect.left(), m_patchSize.width()),
+                      floorDiv(entry.rect.top(), m_patchSize.height()));
+
+    auto cellIt = m_cells.find(cellKey(cell));
+    KIS_SAFE_ASSERT_RECOVER_RETURN(cellIt != m_cells.end());
+
+    QVector<Entry> &entries = *cellIt;
+
+    auto it = std::find_if(entries.begin(), entries.end(),
+                           [&entry] (const Entry &item) {
+                               return item.walker == entry.walker;
+                           });
+    KIS_SAFE_ASSERT_RECOVER_RETURN(it != entries.end());
+
+    // the order inside the cell is not important
+    *it = entries.last();
+    entries.removeLast();
+
+    if (entries.isEmpty()) {
+        m_cells.erase(cellIt);
+    }
+}
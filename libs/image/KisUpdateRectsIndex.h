@@ -0,0 +1,90 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISUPDATERECTSINDEX_H
+#define KISUPDATERECTSINDEX_H
+
+#include "kritaimage_export.h"
+
+#include <QHash>
+#include <QRect>
+#include <QSize>
+#include <QVector>
+
+class KisBaseRectsWalker;
+
+/**
+ * A spatial index over the requested rects of the walkers pending in
+ * KisSimpleUpdateQueue.
+ *
+ * The queue can join two rects only when their union fits into a
+ * single update patch, so the index is a uniform grid with the cells
+ * of the patch size. Every walker is stored in the cell containing the
+ * top-left corner of its rect, therefore all the rects that can be
+ * joined with a given one are found in at most 3x3 cells, independently
+ * of the number of the pending walkers. The rects that don't fit into a
+ * single patch can never be joined and are not indexed at all.
+ *
+ * The walkers are reported in the order they were inserted into the
+ * index, which is the order of the queue.
+ */
+class KRITAIMAGE_EXPORT KisUpdateRectsIndex
+{
+public:
+    KisUpdateRectsIndex();
+    ~KisUpdateRectsIndex();
+
+    /**
+     * Sets the maximum size of a rect that can be joined with
+     * another one. All the walkers should be inserted again
+     * after the call.
+     */
+    void resetPatchSize(const QSize &size);
+
+    /**
+     * Adds \p walker to the index, using its current requested rect
+     */
+    void insert(KisBaseRectsWalker *walker);
+
+    /**
+     * Updates the position of \p walker after its requested rect has
+     * been changed. The walker keeps its place in the insertion order.
+     */
+    void update(KisBaseRectsWalker *walker);
+
+    void remove(KisBaseRectsWalker *walker);
+
+    /**
+     * Returns all the indexed walkers whose rects can be joined with
+     * \p rect without exceeding the patch size, sorted in the
+     * insertion order. The result may contain the walkers that are
+     * not joinable for other reasons (different node, type, etc.)
+     */
+    QVector<KisBaseRectsWalker*> joinCandidates(const QRect &rect) const;
+
+    int size() const;
+    void clear();
+
+private:
+    struct Entry {
+        KisBaseRectsWalker *walker = nullptr;
+        QRect rect;
+        quint64 sequenceNumber = 0;
+    };
+
+    bool isIndexable(const QRect &rect) const;
+    quint64 cellKey(const QPoint &cell) const;
+    void insertEntry(const Entry &entry);
+    void removeEntry(const Entry &entry);
+
+private:
+    QSize m_patchSize;
+    quint64 m_nextSequenceNumber = 0;
+    QHash<quint64, QVector<Entry>> m_cells;
+    QHash<KisBaseRectsWalker*, Entry> m_entries;
+};
+
+#endif // KISUPDATERECTSINDEX_H
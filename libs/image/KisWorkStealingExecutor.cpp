@@ -0,0 +1,502 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisWorkStealingExecutor.h"
+
+#include <deque>
+
+#include <QMutex>
+#include <QRunnable>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include "kis_assert.h"
+#include "KisNumaTopology.h"
+
+namespace {
+/**
+ * The number of attempts an idle worker makes to find some work
+ * before going to sleep
+ */
+const int IdleSpinCount = 100;
+
+thread_local KisTaskGroup *s_currentGroup = nullptr;
+}
+
+struct KisWorkStealingExecutor::Task
+{
+    QRunnable *runnable = nullptr;
+    std::function<void()> func;
+    KisTaskGroup *group = nullptr;
+
+    /**
+     * The pinned tasks are executed by the worker they were
+     * pushed to only, they are never stolen
+     */
+    bool pinned = false;
+
+    inline bool isSubtask() const {
+        return group;
+    }
+};
+
+class KisWorkStealingExecutor::Worker : public QThread
+{
+public:
+    Worker(KisWorkStealingExecutor::Private *_executor, int _index)
+        : executor(_executor),
+          index(_index)
+    {
+    }
+
+    void run() override;
+
+    void push(Task &&task) {
+        QMutexLocker l(&lock);
+        queue.push_back(std::move(task));
+    }
+
+    /**
+     * The owner takes the most recently added tasks
+     */
+    bool popBack(Task &task, bool subtasksOnly) {
+        QMutexLocker l(&lock);
+
+        for (auto it = queue.rbegin(); it != queue.rend(); ++it) {
+            if (!subtasksOnly || it->isSubtask()) {
+                task = std::move(*it);
+                queue.erase(std::next(it).base());
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * The thieves take the oldest tasks
+     */
+    bool stealFront(Task &task, bool subtasksOnly) {
+        QMutexLocker l(&lock);
+
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            if (it->pinned) continue;
+
+            if (!subtasksOnly || it->isSubtask()) {
+                task = std::move(*it);
+                queue.erase(it);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    KisWorkStealingExecutor::Private * const executor;
+    const int index;
+
+    QMutex lock;
+    std::deque<Task> queue;
+
+    /**
+     * The number of pinned tasks in the queue
+     */
+    std::atomic<int> numPinned {0};
+
+    /**
+     * Guarded by KisWorkStealingExecutor::Private::sleepLock
+     */
+    QWaitCondition wakeCondition;
+    bool isSleeping = false;
+
+    static thread_local Worker *s_current;
+};
+
+thread_local KisWorkStealingExecutor::Worker *KisWorkStealingExecutor::Worker::s_current = nullptr;
+
+struct KisWorkStealingExecutor::Private
+{
+    int maxThreadCount = 1;
+
+    QMutex workersLock;
+    QVector<Worker*> workers;
+    std::atomic<bool> workersStarted {false};
+    std::atomic<bool> quit {false};
+    std::atomic<unsigned int> nextWorker {0};
+    bool bindWorkersToNumaNodes = false;
+
+    /**
+     * The number of the tasks, that can be stolen, sitting in the
+     * queues of all the workers
+     */
+    std::atomic<int> numPending {0};
+
+    QMutex sleepLock;
+    std::atomic<int> numSleeping {0};
+
+    QMutex doneLock;
+    QWaitCondition doneCondition;
+    int numActiveRunnables = 0;
+
+    void ensureWorkersStarted();
+    void stopWorkers();
+
+    void pushTask(Worker *target, Task &&task);
+    bool tryTakeTask(Worker *self, Task &task, bool subtasksOnly);
+    void executeTask(Task &task);
+    void idleWait(Worker *self);
+    void wakeWorker(Worker *target);
+};
+
+void KisWorkStealingExecutor::Worker::run()
+{
+    s_current = this;
+
+    if (executor->bindWorkersToNumaNodes) {
+        const int numWorkers = executor->workers.size();
+        KisNumaTopology::bindCurrentThreadToNode(index * KisNumaTopology::numNodes() / numWorkers);
+    }
+
+    while (!executor->quit.load(std::memory_order_acquire)) {
+        Task task;
+
+        if (executor->tryTakeTask(this, task, false)) {
+            executor->executeTask(task);
+        } else {
+            executor->idleWait(this);
+        }
+    }
+
+    s_current = nullptr;
+}
+
+void KisWorkStealingExecutor::Private::ensureWorkersStarted()
+{
+    if (workersStarted.load(std::memory_order_acquire)) return;
+
+    QMutexLocker l(&workersLock);
+    if (workersStarted.load(std::memory_order_relaxed)) return;
+
+    KIS_SAFE_ASSERT_RECOVER_NOOP(workers.isEmpty());
+
+    for (int i = 0; i < maxThreadCount; i++) {
+        workers.append(new Worker(this, i));
+    }
+
+    Q_FOREACH (Worker *worker, workers) {
+        worker->start();
+    }
+
+    workersStarted.store(true, std::memory_order_release);
+}
+
+void KisWorkStealingExecutor::Private::stopWorkers()
+{
+    QMutexLocker l(&workersLock);
+    if (!workersStarted.load(std::memory_order_relaxed)) return;
+
+    quit.store(true);
+
+    {
+        QMutexLocker sl(&sleepLock);
+        Q_FOREACH (Worker *worker, workers) {
+            worker->wakeCondition.wakeAll();
+        }
+    }
+
+    Q_FOREACH (Worker *worker, workers) {
+        worker->wait();
+        KIS_SAFE_ASSERT_RECOVER_NOOP(worker->queue.empty());
+    }
+
+    qDeleteAll(workers);
+    workers.clear();
+
+    quit.store(false);
+    workersStarted.store(false, std::memory_order_release);
+}
+
+void KisWorkStealingExecutor::Private::pushTask(Worker *target, Task &&task)
+{
+    if (!target) {
+        target = workers[nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size()];
+    }
+
+    const bool pinned = task.pinned;
+
+    target->push(std::move(task));
+
+    if (pinned) {
+        target->numPinned.fetch_add(1);
+    } else {
+        numPending.fetch_add(1);
+    }
+
+    /**
+     * The sleeper registers itself in numSleeping before checking
+     * the counters, so we cannot miss it here
+     */
+    if (numSleeping.load() > 0) {
+        QMutexLocker l(&sleepLock);
+        wakeWorker(pinned ? target : nullptr);
+    }
+}
+
+void KisWorkStealingExecutor::Private::wakeWorker(Worker *target)
+{
+    if (target) {
+        if (target->isSleeping) {
+            target->wakeCondition.wakeOne();
+        }
+        return;
+    }
+
+    Q_FOREACH (Worker *worker, workers) {
+        if (worker->isSleeping) {
+            /**
+             * Reset the flag right away so that the next task
+             * would wake up another sleeper
+             */
+            worker->isSleeping = false;
+            worker->wakeCondition.wakeOne();
+            break;
+        }
+    }
+}
+
+bool KisWorkStealingExecutor::Private::tryTakeTask(Worker *self, Task &task, bool subtasksOnly)
+{
+    const bool hasPinnedTasks =
+        !subtasksOnly && self && self->numPinned.load(std::memory_order_relaxed) > 0;
+
+    if (numPending.load(std::memory_order_relaxed) <= 0 && !hasPinnedTasks) return false;
+
+    bool found = self && self->popBack(task, subtasksOnly);
+
+    if (!found) {
+        const int numWorkers = workers.size();
+        const int startIndex = self ? self->index + 1 : 0;
+
+        for (int i = 0; i < numWorkers && !found; i++) {
+            Worker *victim = workers[(startIndex + i) % numWorkers];
+            if (victim == self) continue;
+
+            found = victim->stealFront(task, subtasksOnly);
+        }
+    }
+
+    if (found) {
+        if (task.pinned) {
+            self->numPinned.fetch_sub(1);
+        } else {
+            numPending.fetch_sub(1);
+        }
+    }
+
+    return found;
+}
+
+void KisWorkStealingExecutor::Private::executeTask(Task &task)
+{
+    if (task.isSubtask()) {
+        KisTaskGroup *group = task.group;
+
+        {
+            KisTaskGroup::CurrentGroupScope scope(group);
+            task.func();
+        }
+
+        group->m_numPending.fetch_sub(1, std::memory_order_release);
+    } else {
+        // the runnable may be deleted by its owner right after run()
+        const bool autoDelete = task.runnable->autoDelete();
+
+        task.runnable->run();
+
+        if (autoDelete) {
+            delete task.runnable;
+        }
+
+        QMutexLocker l(&doneLock);
+        numActiveRunnables--;
+        KIS_SAFE_ASSERT_RECOVER_NOOP(numActiveRunnables >= 0);
+
+        if (numActiveRunnables <= 0) {
+            doneCondition.wakeAll();
+        }
+    }
+}
+
+void KisWorkStealingExecutor::Private::idleWait(Worker *self)
+{
+    for (int i = 0; i < IdleSpinCount; i++) {
+        if (numPending.load(std::memory_order_relaxed) > 0 ||
+            self->numPinned.load(std::memory_order_relaxed) > 0 ||
+            quit.load(std::memory_order_relaxed)) {
+
+            return;
+        }
+        QThread::yieldCurrentThread();
+    }
+
+    QMutexLocker l(&sleepLock);
+    numSleeping.fetch_add(1);
+
+    if (numPending.load() <= 0 && self->numPinned.load() <= 0 && !quit.load()) {
+        self->isSleeping = true;
+        self->wakeCondition.wait(&sleepLock);
+        self->isSleeping = false;
+    }
+
+    numSleeping.fetch_sub(1);
+}
+
+
+KisWorkStealingExecutor::KisWorkStealingExecutor()
+    : m_d(new Private)
+{
+    m_d->maxThreadCount = qMax(1, QThread::idealThreadCount());
+}
+
+KisWorkStealingExecutor::~KisWorkStealingExecutor()
+{
+    waitForDone();
+    m_d->stopWorkers();
+}
+
+void KisWorkStealingExecutor::start(QRunnable *runnable)
+{
+    m_d->ensureWorkersStarted();
+
+    {
+        QMutexLocker l(&m_d->doneLock);
+        m_d->numActiveRunnables++;
+    }
+
+    Worker *current = Worker::s_current;
+    if (current && current->executor != m_d.data()) {
+        current = nullptr;
+    }
+
+    Task task;
+    task.runnable = runnable;
+    m_d->pushTask(current, std::move(task));
+}
+
+void KisWorkStealingExecutor::start(QRunnable *runnable, int worker)
+{
+    m_d->ensureWorkersStarted();
+
+    {
+        QMutexLocker l(&m_d->doneLock);
+        m_d->numActiveRunnables++;
+    }
+
+    KIS_SAFE_ASSERT_RECOVER(worker >= 0) { worker = 0; }
+
+    Task task;
+    task.runnable = runnable;
+    task.pinned = true;
+    m_d->pushTask(m_d->workers[worker % m_d->workers.size()], std::move(task));
+}
+
+void KisWorkStealingExecutor::setMaxThreadCount(int value)
+{
+    value = qMax(1, value);
+    if (value == m_d->maxThreadCount) return;
+
+    waitForDone();
+    m_d->stopWorkers();
+    m_d->maxThreadCount = value;
+}
+
+int KisWorkStealingExecutor::maxThreadCount() const
+{
+    return m_d->maxThreadCount;
+}
+
+void KisWorkStealingExecutor::setBindWorkersToNumaNodes(bool value)
+{
+    if (value == m_d->bindWorkersToNumaNodes) return;
+
+    waitForDone();
+    m_d->stopWorkers();
+    m_d->bindWorkersToNumaNodes = value;
+}
+
+bool KisWorkStealingExecutor::bindWorkersToNumaNodes() const
+{
+    return m_d->bindWorkersToNumaNodes;
+}
+
+void KisWorkStealingExecutor::waitForDone()
+{
+    QMutexLocker l(&m_d->doneLock);
+
+    while (m_d->numActiveRunnables > 0) {
+        m_d->doneCondition.wait(&m_d->doneLock);
+    }
+}
+
+
+KisTaskGroup::KisTaskGroup()
+{
+}
+
+KisTaskGroup::~KisTaskGroup()
+{
+    wait();
+}
+
+void KisTaskGroup::run(std::function<void()> func)
+{
+    KisWorkStealingExecutor::Worker *worker = KisWorkStealingExecutor::Worker::s_current;
+
+    if (!worker) {
+        CurrentGroupScope scope(this);
+        func();
+        return;
+    }
+
+    m_numPending.fetch_add(1, std::memory_order_relaxed);
+
+    KisWorkStealingExecutor::Task task;
+    task.func = std::move(func);
+    task.group = this;
+    worker->executor->pushTask(worker, std::move(task));
+}
+
+void KisTaskGroup::wait()
+{
+    KisWorkStealingExecutor::Worker *worker = KisWorkStealingExecutor::Worker::s_current;
+
+    while (m_numPending.load(std::memory_order_acquire) > 0) {
+        KisWorkStealingExecutor::Task task;
+
+        if (worker && worker->executor->tryTakeTask(worker, task, true)) {
+            worker->executor->executeTask(task);
+        } else {
+            QThread::yieldCurrentThread();
+        }
+    }
+}
+
+KisTaskGroup* KisTaskGroup::current()
+{
+    return s_currentGroup;
+}
+
+KisTaskGroup::CurrentGroupScope::CurrentGroupScope(KisTaskGroup *group)
+    : m_oldGroup(s_currentGroup)
+{
+    s_currentGroup = group;
+}
+
+KisTaskGroup::CurrentGroupScope::~CurrentGroupScope()
+{
+    s_currentGroup = m_oldGroup;
+}
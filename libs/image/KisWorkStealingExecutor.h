@@ -0,0 +1,143 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISWORKSTEALINGEXECUTOR_H
+#define KISWORKSTEALINGEXECUTOR_H
+
+#include "kritaimage_export.h"
+
+#include <atomic>
+#include <functional>
+#include <QScopedPointer>
+
+#include <boost/utility.hpp>
+
+class QRunnable;
+
+/**
+ * A thread pool that keeps a separate queue (deque) of tasks for
+ * every worker thread.
+ *
+ * When a task is started from inside a worker thread, it is pushed
+ * into the queue of that very worker, so no other thread needs to be
+ * woken up if the worker finishes its current work quickly enough.
+ * The owner takes the tasks from the back of its queue (LIFO, the data
+ * is still hot in the cache), while the idle workers steal the tasks
+ * from the front of the queues of the busy ones (FIFO, the oldest and,
+ * usually, the biggest pieces of work).
+ *
+ * The idle workers spin for a short while before going to sleep, so
+ * the short jobs, which are typical for the updates scheduler, do not
+ * pay the price of a thread wake-up.
+ *
+ * Apart from the usual QRunnable-based tasks the executor supports
+ * fork-join subtasks, see KisTaskGroup.
+ *
+ * The interface mimics the relevant part of QThreadPool. The worker
+ * threads are created lazily on the first call to start().
+ */
+class KRITAIMAGE_EXPORT KisWorkStealingExecutor : private boost::noncopyable
+{
+public:
+    KisWorkStealingExecutor();
+    ~KisWorkStealingExecutor();
+
+    /**
+     * Queue \p runnable for execution. If runnable->autoDelete() is
+     * true, the executor takes ownership of the runnable.
+     */
+    void start(QRunnable *runnable);
+
+    /**
+     * Queue \p runnable for execution by the worker with index \p worker
+     * (modulo maxThreadCount()). The runnable is never stolen by the
+     * other workers, so the data it touches stays in the caches of
+     * that worker. The ownership rules are the same as in start().
+     */
+    void start(QRunnable *runnable, int worker);
+
+    /**
+     * Change the number of worker threads. The executor should be idle
+     * at the moment of the call, otherwise the call will wait until all
+     * the started runnables are finished.
+     */
+    void setMaxThreadCount(int value);
+    int maxThreadCount() const;
+
+    /**
+     * When enabled, the workers are spread evenly over the NUMA nodes
+     * of the machine and each of them runs on the CPUs of its node
+     * only. Has no effect on the machines with a single node. The
+     * same rules as for setMaxThreadCount() apply.
+     */
+    void setBindWorkersToNumaNodes(bool value);
+    bool bindWorkersToNumaNodes() const;
+
+    /**
+     * Block the caller until all the started runnables are finished
+     */
+    void waitForDone();
+
+private:
+    friend class KisTaskGroup;
+    struct Task;
+    class Worker;
+
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+/**
+ * A group of fork-join subtasks executed by KisWorkStealingExecutor.
+ *
+ * When run() is called from a worker thread of the executor, the task
+ * is pushed into the queue of that worker and may be stolen by any idle
+ * worker. When called from any other thread, the task is executed
+ * right away.
+ *
+ * While waiting for the subtasks, the caller does not sleep, but helps
+ * the executor with the pending subtasks. The waiter never picks up the
+ * top-level runnables, because they may need the locks that the waiter
+ * is currently holding.
+ *
+ * The subtasks may spawn nested subtasks via KisTaskGroup::current(),
+ * the group will wait for them as well.
+ */
+class KRITAIMAGE_EXPORT KisTaskGroup : private boost::noncopyable
+{
+public:
+    KisTaskGroup();
+    ~KisTaskGroup();
+
+    void run(std::function<void()> func);
+    void wait();
+
+    /**
+     * Returns the group the current thread is working for, that is, the
+     * group of the currently executed subtask or the group registered
+     * with CurrentGroupScope. Returns null if there is no such group.
+     */
+    static KisTaskGroup* current();
+
+    /**
+     * Makes \p group current for the calling thread until the scope is
+     * destroyed
+     */
+    class KRITAIMAGE_EXPORT CurrentGroupScope : private boost::noncopyable
+    {
+    public:
+        CurrentGroupScope(KisTaskGroup *group);
+        ~CurrentGroupScope();
+    private:
+        KisTaskGroup *m_oldGroup;
+    };
+
+private:
+    friend class KisWorkStealingExecutor;
+    std::atomic<int> m_numPending {0};
+};
+
+#endif // KISWORKSTEALINGEXECUTOR_H
@@ -32,7 +32,5 @@ KisUpdateCommandEx::KisUpdateCommandEx(KisBatchNodeUpdateSP updateData, KisUpdat
 void KisUpdateCommandEx::partB() {
     if (m_blockUpdatesCookie) return;
 
-    for (auto it = m_updateData->begin(); it != m_updateData->end(); ++it) {
-        m_updatesFacade->refreshGraphAsync(it->first, it->second);
-    }
+    m_updatesFacade->refreshGraphAsync(*m_updateData);
 }
@@ -19,21 +19,37 @@ KisSetLayerStyleCommand::KisSetLayerStyleCommand(KisLayerSP layer, KisPSDLayerSt
 {
 }
 
+KisSetLayerStyleCommand::KisSetLayerStyleCommand(KisLayerSP layer, KisPSDLayerStyleSP oldStyle, KisPSDLayerStyleSP newStyle, KisBatchNodeUpdateSP updateData, KUndo2Command *parent)
+    : KisSetLayerStyleCommand(layer, oldStyle, newStyle, parent)
+{
+    m_updateData = updateData;
+}
+
 void KisSetLayerStyleCommand::redo()
 {
-    updateLayerStyle(m_layer, m_newStyle);
+    updateLayerStyle(m_layer, m_newStyle, m_updateData.data());
 }
 
 void KisSetLayerStyleCommand::undo()
 {
-    updateLayerStyle(m_layer, m_oldStyle);
+    updateLayerStyle(m_layer, m_oldStyle, m_updateData.data());
 }
 
-void KisSetLayerStyleCommand::updateLayerStyle(KisLayerSP layer, KisPSDLayerStyleSP style)
+void KisSetLayerStyleCommand::updateLayerStyle(KisLayerSP layer, KisPSDLayerStyleSP style, KisBatchNodeUpdate *updateData)
 {
     QRect oldDirtyRect = layer->projectionPlane()->changeRect(layer->extent(), KisLayer::N_FILTHY);
     layer->setLayerStyle(style);
     QRect newDirtyRect = layer->projectionPlane()->changeRect(layer->extent(), KisLayer::N_FILTHY);
 
-    layer->setDirty(newDirtyRect | oldDirtyRect);
+    if (updateData) {
+        /**
+         * The command may be undone and redone multiple times, so
+         * merge the rects instead of adding a new record every time
+         */
+        KisBatchNodeUpdate update;
+        update.addUpdate(layer, newDirtyRect | oldDirtyRect);
+        *updateData |= update;
+    } else {
+        layer->setDirty(newDirtyRect | oldDirtyRect);
+    }
 }
@@ -12,21 +12,31 @@
 #include "kritaimage_export.h"
 #include "kis_types.h"
 #include "kis_psd_layer_style.h"
+#include "KisBatchNodeUpdate.h"
 
 class KRITAIMAGE_EXPORT KisSetLayerStyleCommand : public KUndo2Command
 {
 public:
     KisSetLayerStyleCommand(KisLayerSP layer, KisPSDLayerStyleSP oldStyle, KisPSDLayerStyleSP newStyle, KUndo2Command *parent = 0);
 
+    /**
+     * Instead of issuing the update of the layer directly, the command
+     * will add it to \p updateData. It is used for changing the style
+     * of multiple layers at once. The updates should be issued with
+     * KisUpdateCommandEx then.
+     */
+    KisSetLayerStyleCommand(KisLayerSP layer, KisPSDLayerStyleSP oldStyle, KisPSDLayerStyleSP newStyle, KisBatchNodeUpdateSP updateData, KUndo2Command *parent = 0);
+
     void undo() override;
     void redo() override;
 
-    static void updateLayerStyle(KisLayerSP layer, KisPSDLayerStyleSP style);
+    static void updateLayerStyle(KisLayerSP layer, KisPSDLayerStyleSP style, KisBatchNodeUpdate *updateData = 0);
 
 private:
     KisLayerSP m_layer;
     KisPSDLayerStyleSP m_oldStyle;
     KisPSDLayerStyleSP m_newStyle;
+    KisBatchNodeUpdateSP m_updateData;
 };
 
 #endif
@@ -8,6 +8,7 @@
 
 #include <kis_debug.h>
 #include <QBitArray>
+#include <QElapsedTimer>
 
 #include <KoChannelInfo.h>
 #include <KoCompositeOpRegistry.h>
@@ -33,6 +34,9 @@
 #include "kis_refresh_subtree_walker.h"
 
 #include "kis_abstract_projection_plane.h"
+#include "KisBelowStackCache.h"
+#include "KisWorkStealingExecutor.h"
+#include "KisTraceEvents.h"
 
 
 //#define DEBUG_MERGER
@@ -203,7 +207,62 @@ private:
 /*                     KisAsyncMerger                                */
 /*********************************************************************/
 
+namespace {
+/**
+ * Measures the time spent on a single leaf of the walker
+ */
+struct LeafCostRecorder
+{
+    LeafCostRecorder(KisUpdateCostEstimator::Samples *samples,
+                     const KisBaseRectsWalker::JobItem &item)
+        : m_samples(samples),
+          m_item(item)
+    {
+        if (m_samples) {
+            m_timer.start();
+        }
+    }
+
+    ~LeafCostRecorder() {
+        if (m_samples) {
+            m_samples->append(KisUpdateCostEstimator::createSample(m_item, m_timer.nsecsElapsed() + m_extraNsecs));
+        }
+    }
+
+    /**
+     * Accounts the work done on the leaf in advance, e.g. in
+     * another thread
+     */
+    void addNsecs(qint64 nsecs) {
+        m_extraNsecs += nsecs;
+    }
+
+private:
+    KisUpdateCostEstimator::Samples *m_samples;
+    const KisBaseRectsWalker::JobItem &m_item;
+    QElapsedTimer m_timer;
+    qint64 m_extraNsecs = 0;
+};
+}
+
+void KisAsyncMerger::setCostEstimator(KisUpdateCostEstimator *estimator)
+{
+    m_costEstimator = estimator;
+}
+
+void KisAsyncMerger::setUseBelowStackCache(bool value)
+{
+    m_useBelowStackCache = value;
+}
+
+void KisAsyncMerger::setRecalculateChildrenInParallel(bool value)
+{
+    m_recalculateChildrenInParallel = value;
+}
+
 void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
+    KIS_TRACE_SCOPE("merger", "merge");
+
     KisMergeWalker::LeafStack &leafStack = walker.leafStack();
 
     const bool useTempProjections = walker.needRectVaries();
@@ -223,6 +282,32 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
         // All the masks should be filtered by the walkers
         KIS_SAFE_ASSERT_RECOVER_RETURN(currentLeaf->isLayer());
 
+        /**
+         * The first leaf of every group comes when the projection
+         * is not set up yet
+         */
+        const bool isFirstLeafOfGroup =
+            !m_currentProjection &&
+            !currentLeaf->isRoot() &&
+            !(item.m_position & KisMergeWalker::N_EXTRA);
+
+        if (m_recalculateChildrenInParallel && isFirstLeafOfGroup) {
+            recalculateGroupChildren(leafStack, item, walker);
+        }
+
+        if (m_useBelowStackCache &&
+            isFirstLeafOfGroup &&
+            tryFetchBelowStack(leafStack, item, walker, useTempProjections)) {
+
+            KisTraceEvents::instant("merger", "below stack cache hit");
+            continue;
+        }
+
+        LeafCostRecorder costRecorder(m_costEstimator ? &m_costSamples : 0, item);
+        qint64 recalculationNsecs = 0;
+
+        KIS_TRACE_SCOPE("merger", "leaf");
+
         QRect applyRect = item.m_applyRect;
 
         if (currentLeaf->isRoot()) {
@@ -254,7 +339,9 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 
         if(item.m_position & KisMergeWalker::N_FILTHY) {
             DEBUG_NODE_ACTION("Updating", "N_FILTHY", currentLeaf, applyRect);
-            if (currentLeaf->shouldBeRendered()) {
+            if (takeRecalculatedLeaf(currentLeaf, &recalculationNsecs)) {
+                costRecorder.addNsecs(recalculationNsecs);
+            } else if (currentLeaf->shouldBeRendered()) {
                 currentLeaf->accept(originalVisitor);
                 currentLeaf->projectionPlane()->recalculate(applyRect, walker.startNode());
             }
@@ -270,7 +357,9 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
         }
         else if(item.m_position & KisMergeWalker::N_FILTHY_PROJECTION) {
             DEBUG_NODE_ACTION("Updating", "N_FILTHY_PROJECTION", currentLeaf, applyRect);
-            if (currentLeaf->shouldBeRendered()) {
+            if (takeRecalculatedLeaf(currentLeaf, &recalculationNsecs)) {
+                costRecorder.addNsecs(recalculationNsecs);
+            } else if (currentLeaf->shouldBeRendered()) {
                 currentLeaf->projectionPlane()->recalculate(applyRect, walker.startNode());
             }
         }
@@ -281,6 +370,12 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 
         compositeWithProjection(currentLeaf, applyRect);
 
+        if (m_belowStackCache && !--m_belowStackLeavesLeft) {
+            DEBUG_NODE_ACTION("Storing below stack", "", currentLeaf, applyRect);
+            m_belowStackCache->store(m_belowStackGeneration, m_currentProjection, applyRect);
+            m_belowStackCache = 0;
+        }
+
         if(item.m_position & KisMergeWalker::N_TOPMOST) {
             writeProjection(currentLeaf, useTempProjections, applyRect);
             resetProjection();
@@ -291,6 +386,11 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
                  walker.levelOfDetail());
     }
 
+    if (m_costEstimator && !m_costSamples.isEmpty()) {
+        m_costEstimator->addSamples(m_costSamples);
+        m_costSamples.clear();
+    }
+
     if(notifyClones) {
         doNotifyClones(walker);
     }
@@ -308,6 +408,183 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 void KisAsyncMerger::resetProjection() {
     m_currentProjection = 0;
     m_finalProjection = 0;
+    m_belowStackCache = 0;
+    m_recalculatedLeaves.clear();
+}
+
+namespace {
+/**
+ * The leaves that can be recalculated before the group is composited
+ * and concurrently with each other. Their original does not depend on
+ * the projection of the group, so only the projection plane (masks and
+ * layer styles) should be recalculated. The clone layers are excluded,
+ * because they recalculate their source, which may be a sibling.
+ */
+bool canRecalculateIndependently(const KisBaseRectsWalker::JobItem &item)
+{
+    if (!(item.m_position & (KisMergeWalker::N_FILTHY | KisMergeWalker::N_FILTHY_PROJECTION))) {
+        return false;
+    }
+
+    KisProjectionLeafSP leaf = item.m_leaf;
+
+    return leaf->shouldBeRendered() &&
+        !leaf->dependsOnLowerNodes() &&
+        !dynamic_cast<KisCloneLayer*>(leaf->node().data());
+}
+}
+
+/**
+ * Called for the lowest child of every composited group. Recalculates
+ * the projection planes of all the independent children of the group
+ * as a set of subtasks, so that the following sequential blending
+ * only composites them.
+ */
+void KisAsyncMerger::recalculateGroupChildren(const KisBaseRectsWalker::LeafStack &leafStack,
+                                              const KisBaseRectsWalker::JobItem &firstItem,
+                                              KisBaseRectsWalker &walker)
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_recalculatedLeaves.isEmpty());
+    m_recalculatedLeaves.clear();
+
+    QVector<const KisBaseRectsWalker::JobItem*> items;
+
+    /**
+     * The children of the group lie on the top of the stack in
+     * the order of their composition, the last one is N_TOPMOST.
+     * The nested groups have already been composited.
+     */
+    auto collectItem = [&items] (const KisBaseRectsWalker::JobItem &item) {
+        if (canRecalculateIndependently(item)) {
+            items.append(&item);
+        }
+        return !(item.m_position & KisMergeWalker::N_TOPMOST);
+    };
+
+    if (collectItem(firstItem)) {
+        for (int i = leafStack.size() - 1; i >= 0; i--) {
+            if (!collectItem(leafStack[i])) break;
+        }
+    }
+
+    // nothing to parallelize
+    if (items.size() < 2) return;
+
+    m_recalculatedLeaves.resize(items.size());
+
+    KisNodeSP filthyNode = walker.startNode();
+    KisTaskGroup subtasks;
+
+    for (int i = 0; i < items.size(); i++) {
+        const KisBaseRectsWalker::JobItem *item = items[i];
+        RecalculatedLeaf *result = &m_recalculatedLeaves[i];
+        result->leaf = item->m_leaf.data();
+
+        subtasks.run([item, result, filthyNode] () {
+            DEBUG_NODE_ACTION("Recalculating in parallel", "", item->m_leaf, item->m_applyRect);
+            KIS_TRACE_SCOPE("merger", "parallel leaf");
+
+            QElapsedTimer timer;
+            timer.start();
+
+            item->m_leaf->projectionPlane()->recalculate(item->m_applyRect, filthyNode);
+
+            result->nsecs = timer.nsecsElapsed();
+        });
+    }
+
+    subtasks.wait();
+}
+
+bool KisAsyncMerger::takeRecalculatedLeaf(KisProjectionLeafSP leaf, qint64 *nsecs)
+{
+    for (auto it = m_recalculatedLeaves.begin(); it != m_recalculatedLeaves.end(); ++it) {
+        if (it->leaf == leaf.data()) {
+            *nsecs = it->nsecs;
+            m_recalculatedLeaves.erase(it);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Called for the lowest child of every composited group. Checks
+ * that the cache of the group is still valid for the children lying
+ * below the filthy one and, if possible, copies their composition from
+ * the cache instead of blending them one by one. Otherwise arranges
+ * the composition to be saved into the cache when the last of these
+ * children is blended.
+ *
+ * Returns true if the lower children have been fetched from the cache
+ * and removed from \p leafStack
+ */
+bool KisAsyncMerger::tryFetchBelowStack(KisBaseRectsWalker::LeafStack &leafStack,
+                                        const KisBaseRectsWalker::JobItem &firstItem,
+                                        KisBaseRectsWalker &walker,
+                                        bool useTempProjection)
+{
+    /**
+     * The cache keeps the data of LoD0 only. LoD-strokes do not change
+     * the LoD0 data of the layers, so they need not invalidate it.
+     */
+    if (walker.levelOfDetail() > 0) return false;
+
+    KisProjectionLeafSP parentLeaf = firstItem.m_leaf->parent();
+    KisGroupLayer *group = parentLeaf ? qobject_cast<KisGroupLayer*>(parentLeaf->node().data()) : 0;
+    if (!group) return false;
+
+    /**
+     * The children of the group lie on the top of the stack, starting
+     * from the lowest one. They are followed by the filthy child, so
+     * the run of the N_BELOW_FILTHY leaves cannot leave the group.
+     */
+    KisBelowStackCache::LeafList belowLeaves;
+
+    if (firstItem.m_position & KisMergeWalker::N_BELOW_FILTHY) {
+        belowLeaves.append(firstItem.m_leaf.data());
+
+        for (int i = leafStack.size() - 1; i >= 0; i--) {
+            const KisBaseRectsWalker::JobItem &item = leafStack[i];
+            if (!(item.m_position & KisMergeWalker::N_BELOW_FILTHY)) break;
+
+            if (item.m_position & KisMergeWalker::N_TOPMOST) {
+                belowLeaves.clear();
+                break;
+            }
+
+            belowLeaves.append(item.m_leaf.data());
+        }
+    }
+
+    KisBelowStackCache *cache = group->belowStackCache();
+    const int generation = cache->validate(belowLeaves);
+
+    /**
+     * When the need rects of the leaves vary, the lower children are
+     * blended in different rects, so the composition cannot be reused
+     */
+    if (belowLeaves.isEmpty() || useTempProjection) return false;
+
+    setupProjection(firstItem.m_leaf, firstItem.m_applyRect, useTempProjection);
+    if (!m_currentProjection) return false;
+
+    if (cache->fetch(generation, m_currentProjection, firstItem.m_applyRect)) {
+        DEBUG_NODE_ACTION("Fetching below stack", "", firstItem.m_leaf, firstItem.m_applyRect);
+
+        for (int i = 1; i < belowLeaves.size(); i++) {
+            leafStack.pop();
+        }
+
+        return true;
+    }
+
+    m_belowStackCache = cache;
+    m_belowStackGeneration = generation;
+    m_belowStackLeavesLeft = belowLeaves.size();
+
+    return false;
 }
 
 void KisAsyncMerger::setupProjection(KisProjectionLeafSP currentLeaf, const QRect& rect, bool useTempProjection) {
@@ -354,6 +631,8 @@ bool KisAsyncMerger::compositeWithProjection(KisProjectionLeafSP leaf, const QRe
     if (!m_currentProjection) return true;
     if (!leaf->visible()) return true;
 
+    KIS_TRACE_SCOPE("merger", "composite");
+
     KisPainter gc(m_currentProjection);
     leaf->projectionPlane()->apply(&gc, rect);
 
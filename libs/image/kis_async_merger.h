@@ -8,21 +8,54 @@
 
 #include "kritaimage_export.h"
 #include "kis_types.h"
+#include "KisUpdateCostEstimator.h"
+#include "kis_base_rects_walker.h"
 
 class QRect;
-class KisBaseRectsWalker;
+class KisBelowStackCache;
 
 class KRITAIMAGE_EXPORT KisAsyncMerger
 {
 public:
     void startMerge(KisBaseRectsWalker &walker, bool notifyClones = true);
 
+    /**
+     * When set, the merger measures the time spent on every leaf
+     * of the walker and reports it to \p estimator
+     */
+    void setCostEstimator(KisUpdateCostEstimator *estimator);
+
+    /**
+     * When enabled, the composition of the layers lying below the
+     * filthy one is saved in the parent group and reused by the
+     * following updates of the same layer (see KisBelowStackCache)
+     */
+    void setUseBelowStackCache(bool value);
+
+    /**
+     * When enabled, the projection planes of the children of a group
+     * that don't depend on the lower nodes (their masks and layer
+     * styles) are recalculated concurrently before the group is
+     * composited. The subtasks are executed by the work-stealing
+     * executor when the merger runs inside a job of the updater
+     * context, otherwise they are executed sequentially.
+     */
+    void setRecalculateChildrenInParallel(bool value);
+
 private:
     inline void resetProjection();
     inline void setupProjection(KisProjectionLeafSP currentLeaf, const QRect& rect, bool useTempProjection);
     inline void writeProjection(KisProjectionLeafSP topmostLeaf, bool useTempProjection, const QRect &rect);
     inline bool compositeWithProjection(KisProjectionLeafSP leaf, const QRect &rect);
     inline void doNotifyClones(KisBaseRectsWalker &walker);
+    inline bool tryFetchBelowStack(KisBaseRectsWalker::LeafStack &leafStack,
+                                   const KisBaseRectsWalker::JobItem &firstItem,
+                                   KisBaseRectsWalker &walker,
+                                   bool useTempProjection);
+    inline void recalculateGroupChildren(const KisBaseRectsWalker::LeafStack &leafStack,
+                                         const KisBaseRectsWalker::JobItem &firstItem,
+                                         KisBaseRectsWalker &walker);
+    inline bool takeRecalculatedLeaf(KisProjectionLeafSP leaf, qint64 *nsecs);
 
 private:
     /**
@@ -49,6 +82,32 @@ private:
      * setupProjection()
      */
     KisPaintDeviceSP m_cachedPaintDevice;
+
+    KisUpdateCostEstimator *m_costEstimator = 0;
+    KisUpdateCostEstimator::Samples m_costSamples;
+
+    bool m_useBelowStackCache = false;
+
+    /**
+     * The cache that should receive the content of m_currentProjection
+     * after m_belowStackLeavesLeft more leaves are composited into it
+     */
+    KisBelowStackCache *m_belowStackCache = 0;
+    int m_belowStackGeneration = 0;
+    int m_belowStackLeavesLeft = 0;
+
+    bool m_recalculateChildrenInParallel = false;
+
+    struct RecalculatedLeaf {
+        KisProjectionLeaf *leaf = 0;
+        qint64 nsecs = 0;
+    };
+
+    /**
+     * The children of the current group whose projection planes have
+     * already been recalculated by recalculateGroupChildren()
+     */
+    QVector<RecalculatedLeaf> m_recalculatedLeaves;
 };
 
 
@@ -10,6 +10,7 @@
 #include <QStack>
 
 #include "kis_layer.h"
+#include "kis_paint_device.h"
 
 #include "kis_abstract_projection_plane.h"
 #include "kis_projection_leaf.h"
@@ -26,6 +27,7 @@ public:
         UPDATE_NO_FILTHY,
         FULL_REFRESH,
         FULL_REFRESH_NO_FILTHY,
+        BATCH_REFRESH,
         UNSUPPORTED
     };
 
@@ -174,6 +176,20 @@ public:
         return m_mergeTask;
     }
 
+    /**
+     * Asks the tile store to load the swapped-out tiles, which
+     * will be read by the merge task, in a background thread, so
+     * that they are already in memory when the job starts
+     */
+    void prefetchTiles() const {
+        for (const JobItem &item : m_mergeTask) {
+            KisPaintDeviceSP device = item.m_leaf->original();
+            if (device) {
+                device->prefetchRect(item.m_applyRect);
+            }
+        }
+    }
+
     // return a reference for efficiency reasons
     inline CloneNotificationsVector& cloneNotifications() {
         return m_cloneNotifications;
@@ -211,6 +227,19 @@ public:
         return m_levelOfDetail;
     }
 
+    /**
+     * The update queue never merges the walkers that are not
+     * joinable with other walkers, e.g. the batch walkers or the
+     * patches whose size has been chosen by the cost of the subtree
+     */
+    inline bool isJoinable() const {
+        return m_isJoinable;
+    }
+
+    inline void setJoinable(bool value) {
+        m_isJoinable = value;
+    }
+
     virtual UpdateType type() const = 0;
 
 protected:
@@ -500,6 +529,8 @@ private:
     QRect m_lastNeedRect;
 
     int m_levelOfDetail {0};
+
+    bool m_isJoinable {true};
 };
 
 #endif /* __KIS_BASE_RECTS_WALKER_H */
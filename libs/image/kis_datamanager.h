@@ -43,6 +43,14 @@ public:
      * defPixel array.
      */
 KisDataManager(quint32 pixelSize, const quint8 *defPixel) : ACTUAL_DATAMGR(pixelSize, defPixel) {}
+
+    /**
+     * Same as above, but the tiles of the data manager will have
+     * \p tileWidth x \p tileHeight pixels instead of the default size
+     */
+    KisDataManager(quint32 pixelSize, const quint8 *defPixel, qint32 tileWidth, qint32 tileHeight)
+        : ACTUAL_DATAMGR(pixelSize, defPixel, tileWidth, tileHeight) {}
+
     KisDataManager(const KisDataManager& dm) : ACTUAL_DATAMGR(dm) { }
 
     ~KisDataManager() override {
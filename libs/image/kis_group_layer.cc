@@ -25,6 +25,7 @@
 #include "kis_selection_mask.h"
 #include "kis_psd_layer_style.h"
 #include "kis_layer_properties_icons.h"
+#include "KisBelowStackCache.h"
 
 
 struct Q_DECL_HIDDEN KisGroupLayer::Private
@@ -42,6 +43,7 @@ public:
     qint32 x;
     qint32 y;
     bool passThroughMode;
+    KisBelowStackCache belowStackCache;
 };
 
 KisGroupLayer::KisGroupLayer(KisImageWSP image, const QString &name, quint8 opacity) :
@@ -188,6 +190,8 @@ void KisGroupLayer::resetCache(const KoColorSpace *colorSpace)
 
     Q_ASSERT(colorSpace);
 
+    m_d->belowStackCache.reset();
+
     if (!m_d->paintDevice) {
 
         KisPaintDeviceSP dev = new KisPaintDevice(this, colorSpace, new KisDefaultBounds(image()));
@@ -286,6 +290,11 @@ bool KisGroupLayer::projectionIsValid() const
     return !tryObligeChild();
 }
 
+KisBelowStackCache* KisGroupLayer::belowStackCache() const
+{
+    return &m_d->belowStackCache;
+}
+
 void KisGroupLayer::setDefaultProjectionColor(KoColor color)
 {
     m_d->paintDevice->setDefaultPixel(color);
@@ -11,6 +11,7 @@
 #include "kis_types.h"
 
 class KoColorSpace;
+class KisBelowStackCache;
 
 /**
  * A KisLayer that bundles child layers into a single layer.
@@ -95,6 +96,12 @@ public:
 
     bool projectionIsValid() const;
 
+    /**
+     * The composition of the children lying below the currently
+     * updated one, used by KisAsyncMerger
+     */
+    KisBelowStackCache* belowStackCache() const;
+
 protected:
     KisLayer* onlyMeaningfulChild() const;
     KisPaintDeviceSP tryObligeChild() const;
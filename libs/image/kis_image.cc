@@ -38,15 +38,18 @@
 #include "kis_paint_layer.h"
 #include "kis_projection_leaf.h"
 #include "kis_painter.h"
+#include "kis_paint_device.h"
 #include "kis_selection.h"
 #include "kis_transaction.h"
 #include "kis_meta_data_merge_strategy.h"
 #include "kis_memory_statistics_server.h"
+#include "tiles3/kis_tile_eviction_priority.h"
 #include "kis_node.h"
 #include "kis_types.h"
 
 #include "kis_image_config.h"
 #include "kis_update_scheduler.h"
+#include "KisBatchNodeUpdate.h"
 #include "kis_image_signal_router.h"
 #include "kis_image_animation_interface.h"
 #include "kis_keyframe_channel.h"
@@ -229,6 +232,8 @@ public:
     bool isolateLayer;
     bool isolateGroup;
 
+    KisNodeWSP memoryActiveNode;
+
     bool wrapAroundModePermitted = false;
 
     QScopedPointer<KisUndoStore> undoStore;
@@ -255,6 +260,8 @@ public:
 
     bool tryCancelCurrentStrokeAsync();
 
+    void updateEvictionPriority(KisNodeSP root);
+
     void notifyProjectionUpdatedInPatches(const QRect &rc, QVector<KisRunnableStrokeJobData *> &jobs);
 
     void convertImageColorSpaceImpl(const KoColorSpace *dstColorSpace,
@@ -533,6 +540,8 @@ void KisImage::nodeHasBeenAdded(KisNode *parent, int index)
 {
     KisNodeGraphListener::nodeHasBeenAdded(parent, index);
 
+    m_d->updateEvictionPriority(parent->at(index));
+
     KisLayerUtils::recursiveApplyNodes(KisSharedPtr<KisNode>(parent), [this](KisNodeSP node){
        QMap<QString, KisKeyframeChannel*> chans = node->keyframeChannels();
        Q_FOREACH(KisKeyframeChannel* chan, chans.values()) {
@@ -570,6 +579,9 @@ void KisImage::aboutToRemoveANode(KisNode *parent, int index)
 void KisImage::nodeChanged(KisNode* node)
 {
     KisNodeGraphListener::nodeChanged(node);
+
+    // the visibility of the node might have changed
+    m_d->updateEvictionPriority(node);
     requestStrokeEnd();
     m_d->signalRouter.emitNodeChanged(node);
 }
@@ -631,6 +643,69 @@ KisSelectionMaskSP KisImage::overlaySelectionMask() const
     return m_d->overlaySelectionMask;
 }
 
+void KisImage::setMemoryActiveNode(KisNodeSP node)
+{
+    KisNodeSP oldNode = m_d->memoryActiveNode.toStrongRef();
+    if (oldNode == node) return;
+
+    m_d->memoryActiveNode = node;
+
+    if (oldNode) {
+        m_d->updateEvictionPriority(oldNode);
+    }
+
+    if (node) {
+        m_d->updateEvictionPriority(node);
+    }
+}
+
+KisNodeSP KisImage::memoryActiveNode() const
+{
+    return m_d->memoryActiveNode.toStrongRef();
+}
+
+void KisImage::nodeMemoryStatistics(KisNodeSP node, qint64 &residentBytes, qint64 &swappedBytes) const
+{
+    residentBytes = 0;
+    swappedBytes = 0;
+
+    const KisPaintDeviceSP devices[] = {node->paintDevice(), node->original(), node->projection()};
+    QSet<KisPaintDevice*> visitedDevices;
+
+    for (KisPaintDeviceSP device : devices) {
+        if (!device || visitedDevices.contains(device.data())) continue;
+        visitedDevices.insert(device.data());
+
+        qint64 resident = 0;
+        qint64 swapped = 0;
+        device->memoryStatistics(resident, swapped);
+
+        residentBytes += resident;
+        swappedBytes += swapped;
+    }
+}
+
+void KisImage::KisImagePrivate::updateEvictionPriority(KisNodeSP root)
+{
+    KisNodeSP activeNode = memoryActiveNode.toStrongRef();
+
+    KisLayerUtils::recursiveApplyNodes(root, [activeNode] (KisNodeSP node) {
+        const KisTileEvictionPriority priority =
+            node == activeNode ? KisTileEvictionPriority::Protected :
+            !node->visible(true) ? KisTileEvictionPriority::Preferred :
+            KisTileEvictionPriority::Normal;
+
+        const KisPaintDeviceSP devices[] = {node->paintDevice(), node->original(), node->projection()};
+
+        for (KisPaintDeviceSP device : devices) {
+            // updating the priority means iterating through all the tiles
+            if (device && device->evictionPriority() != priority) {
+                device->setEvictionPriority(priority);
+            }
+        }
+    });
+}
+
 bool KisImage::hasOverlaySelectionMask() const
 {
     return m_d->overlaySelectionMask;
@@ -2140,6 +2215,50 @@ void KisImage::refreshGraphAsync(KisNodeSP root, const QVector<QRect> &rects, co
     }
 }
 
+void KisImage::refreshGraphAsync(const KisBatchNodeUpdate &update, UpdateFlags flags)
+{
+    /**
+     * In no-filthy mode the nodes are not recalculated, so there is
+     * nothing to share between them
+     */
+    if (flags & NoFilthyUpdate) {
+        for (auto it = update.begin(); it != update.end(); ++it) {
+            refreshGraphAsync(it->first, it->second, bounds(), flags);
+        }
+        return;
+    }
+
+    KisBatchNodeUpdate filteredUpdate;
+
+    for (auto it = update.begin(); it != update.end(); ++it) {
+        KisNodeSP root = it->first ? it->first : KisNodeSP(m_d->rootLayer);
+        const QVector<QRect> rects({it->second});
+
+        bool isFiltered = false;
+
+        // see a comment in refreshGraphAsync() about the order of the filters
+        for (auto filterIt = m_d->projectionUpdatesFilters.rbegin();
+             filterIt != m_d->projectionUpdatesFilters.rend();
+             ++filterIt) {
+
+            KIS_SAFE_ASSERT_RECOVER(*filterIt) { continue; }
+
+            if ((*filterIt)->filterRefreshGraph(this, root.data(), rects, bounds(), flags)) {
+                isFiltered = true;
+                break;
+            }
+        }
+
+        if (isFiltered) continue;
+
+        m_d->animationInterface->notifyNodeChanged(root.data(), rects, true);
+        filteredUpdate.addUpdate(root, it->second);
+    }
+
+    if (!filteredUpdate.empty()) {
+        m_d->scheduler.fullRefreshAsync(filteredUpdate, bounds());
+    }
+}
 
 void KisImage::requestProjectionUpdateNoFilthy(KisNodeSP pseudoFilthy, const QRect &rc, const QRect &cropRect)
 {
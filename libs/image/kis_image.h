@@ -205,6 +205,28 @@ public:
      */
     bool hasOverlaySelectionMask() const;
 
+    /**
+     * Sets the node the user is working with at the moment. The tiles
+     * of this node are swapped out only when there is nothing else left
+     * to swap, while the tiles of invisible layers and LoD planes are
+     * swapped out first.
+     *
+     * \see KisTileEvictionPriority
+     */
+    void setMemoryActiveNode(KisNodeSP node);
+
+    /**
+     * \see setMemoryActiveNode
+     */
+    KisNodeSP memoryActiveNode() const;
+
+    /**
+     * Counts the bytes of the paint devices owned by \p node (its paint
+     * device, original and projection) that are loaded into memory and
+     * that are swapped out at the moment. The child nodes are not counted.
+     */
+    void nodeMemoryStatistics(KisNodeSP node, qint64 &residentBytes, qint64 &swappedBytes) const;
+
     /**
      * @return the global selection object or 0 if there is none. The
      * global selection is always read-write.
@@ -1123,6 +1145,7 @@ public Q_SLOTS:
     void refreshGraphAsync(KisNodeSP root, const QRect &rc, UpdateFlags flags = None) override;
     void refreshGraphAsync(KisNodeSP root, const QRect &rc, const QRect &cropRect, UpdateFlags flags = None) override;
     void refreshGraphAsync(KisNodeSP root, const QVector<QRect> &rects, const QRect &cropRect, UpdateFlags flags = None) override;
+    void refreshGraphAsync(const KisBatchNodeUpdate &update, UpdateFlags flags = None) override;
 
     /**
      * Triggers synchronous recomposition of the projection
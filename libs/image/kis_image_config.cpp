@@ -108,6 +108,102 @@ void KisImageConfig::setUpdatePatchWidth(int value)
     m_config.writeEntry("updatePatchWidth", value);
 }
 
+bool KisImageConfig::useUpdateCostModel(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("useUpdateCostModel", true) : true;
+}
+
+void KisImageConfig::setUseUpdateCostModel(bool value)
+{
+    m_config.writeEntry("useUpdateCostModel", value);
+}
+
+qreal KisImageConfig::updateTargetJobCost(bool requestDefault) const
+{
+    /**
+     * The cost of merging a default-sized 512x512 patch of a plain
+     * paint layer stack, approximately 4 ns per pixel
+     */
+    const qreal defaultCost = 512 * 512 * 4.0;
+
+    const qreal cost = !requestDefault ?
+        m_config.readEntry("updateTargetJobCost", defaultCost) : defaultCost;
+
+    return cost > 0.0 ? cost : defaultCost;
+}
+
+void KisImageConfig::setUpdateTargetJobCost(qreal value)
+{
+    m_config.writeEntry("updateTargetJobCost", value);
+}
+
+bool KisImageConfig::useBelowStackCache(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("useBelowStackCache", true) : true;
+}
+
+void KisImageConfig::setUseBelowStackCache(bool value)
+{
+    m_config.writeEntry("useBelowStackCache", value);
+}
+
+bool KisImageConfig::useLayerStyleTileCache(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("useLayerStyleTileCache", true) : true;
+}
+
+void KisImageConfig::setUseLayerStyleTileCache(bool value)
+{
+    m_config.writeEntry("useLayerStyleTileCache", value);
+}
+
+bool KisImageConfig::recalculateChildrenInParallel(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("recalculateChildrenInParallel", true) : true;
+}
+
+void KisImageConfig::setRecalculateChildrenInParallel(bool value)
+{
+    m_config.writeEntry("recalculateChildrenInParallel", value);
+}
+
+int KisImageConfig::strokesReservedInteractiveSlots(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("strokesReservedInteractiveSlots", 1) : 1;
+}
+
+void KisImageConfig::setStrokesReservedInteractiveSlots(int value)
+{
+    m_config.writeEntry("strokesReservedInteractiveSlots", value);
+}
+
+qreal KisImageConfig::speculativeLod0Budget(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("speculativeLod0Budget", 0.5) : 0.5;
+}
+
+void KisImageConfig::setSpeculativeLod0Budget(qreal value)
+{
+    m_config.writeEntry("speculativeLod0Budget", value);
+}
+
+bool KisImageConfig::updaterTileAffinity(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("updaterTileAffinity", false) : false;
+}
+
+void KisImageConfig::setUpdaterTileAffinity(bool value)
+{
+    m_config.writeEntry("updaterTileAffinity", value);
+}
+
 qreal KisImageConfig::maxCollectAlpha() const
 {
     return m_config.readEntry("maxCollectAlpha", 2.5);
@@ -167,6 +263,17 @@ void KisImageConfig::setSwapWindowSize(int value)
     m_config.writeEntry("swapWindowSize", value);
 }
 
+QString KisImageConfig::swapCompression(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("swapCompression", "LZF") : "LZF";
+}
+
+void KisImageConfig::setSwapCompression(const QString &value)
+{
+    m_config.writeEntry("swapCompression", value);
+}
+
 int KisImageConfig::tilesHardLimit() const
 {
     qreal hp = qreal(memoryHardLimitPercent()) / 100.0;
@@ -31,6 +31,35 @@ public:
     int updatePatchWidth() const;
     void setUpdatePatchWidth(int value);
 
+    bool useUpdateCostModel(bool requestDefault = false) const;
+    void setUseUpdateCostModel(bool value);
+
+    /**
+     * The cost of merging a single patch of a big update the update
+     * queue tries to achieve when the cost model is enabled, in
+     * nanoseconds
+     */
+    qreal updateTargetJobCost(bool requestDefault = false) const;
+    void setUpdateTargetJobCost(qreal value);
+
+    bool useBelowStackCache(bool requestDefault = false) const;
+    void setUseBelowStackCache(bool value);
+
+    bool useLayerStyleTileCache(bool requestDefault = false) const;
+    void setUseLayerStyleTileCache(bool value);
+
+    bool recalculateChildrenInParallel(bool requestDefault = false) const;
+    void setRecalculateChildrenInParallel(bool value);
+
+    int strokesReservedInteractiveSlots(bool requestDefault = false) const;
+    void setStrokesReservedInteractiveSlots(int value);
+
+    qreal speculativeLod0Budget(bool requestDefault = false) const;
+    void setSpeculativeLod0Budget(qreal value);
+
+    bool updaterTileAffinity(bool requestDefault = false) const;
+    void setUpdaterTileAffinity(bool value);
+
     qreal maxCollectAlpha() const;
     qreal maxMergeAlpha() const;
     qreal maxMergeCollectAlpha() const;
@@ -46,6 +75,13 @@ public:
     int swapWindowSize() const;
     void setSwapWindowSize(int value);
 
+    /**
+     * The name of the algorithm used for compressing the swapped
+     * tiles, one of "LZF", "LZ4" or "ZSTD"
+     */
+    QString swapCompression(bool requestDefault = false) const;
+    void setSwapCompression(const QString &value);
+
     int tilesHardLimit() const; // MiB
     int tilesSoftLimit() const; // MiB
     int poolLimit() const; // MiB
@@ -14,6 +14,7 @@ class QRect;
 class KisStrokeStrategy;
 class KisStrokeJobData;
 class KisPostExecutionUndoAdapter;
+class KisBatchNodeUpdate;
 
 
 class KRITAIMAGE_EXPORT KisStrokesFacade
@@ -59,6 +60,12 @@ public:
     virtual void refreshGraphAsync(KisNodeSP root, const QRect &rc, const QRect &cropRect, UpdateFlags flags = None) = 0;
     virtual void refreshGraphAsync(KisNodeSP root, const QVector<QRect> &rc, const QRect &cropRect, UpdateFlags flags = None) = 0;
 
+    /**
+     * Refreshes all the nodes of \p update. The nodes with overlapping
+     * dirty rects are refreshed in a single traversal of the graph.
+     */
+    virtual void refreshGraphAsync(const KisBatchNodeUpdate &update, UpdateFlags flags = None) = 0;
+
     virtual KisProjectionUpdatesFilterCookie addProjectionUpdatesFilter(KisProjectionUpdatesFilterSP filter) = 0;
     virtual KisProjectionUpdatesFilterSP removeProjectionUpdatesFilter(KisProjectionUpdatesFilterCookie cookie) = 0;
     virtual KisProjectionUpdatesFilterCookie currentProjectionUpdatesFilter() const = 0;
@@ -125,7 +125,7 @@ qint64 calculateNodeMemoryHiBound(KisNodeSP node,
 
 
 KisMemoryStatisticsServer::Statistics
-KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
+KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image, KisNodeSP activeNode) const
 {
     KisTileDataStore::MemoryStatistics tileStats =
         KisTileDataStore::instance()->memoryStatistics();
@@ -137,6 +137,12 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
                                        stats.layersSize,
                                        stats.projectionsSize,
                                        stats.lodSize);
+
+        if (activeNode) {
+            image->nodeMemoryStatistics(activeNode,
+                                        stats.activeNodeResidentSize,
+                                        stats.activeNodeSwappedSize);
+        }
     }
     stats.totalMemorySize = tileStats.totalMemorySize;
     stats.realMemorySize = tileStats.realMemorySize;
@@ -144,6 +150,11 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
     stats.poolSize = tileStats.poolSize;
 
     stats.swapSize = tileStats.swapSize;
+    stats.swapFileSize = tileStats.swapFileSize;
+    stats.swapFragmentation = tileStats.swapFragmentation;
+
+    stats.deduplicatedSize = tileStats.deduplicatedSize;
+    stats.deduplicationRatio = tileStats.deduplicationRatio;
 
     KisImageConfig cfg(true);
 
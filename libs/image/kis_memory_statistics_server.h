@@ -27,12 +27,20 @@ public:
               projectionsSize(0),
               lodSize(0),
 
+              activeNodeResidentSize(0),
+              activeNodeSwappedSize(0),
+
               totalMemorySize(0),
               realMemorySize(0),
               historicalMemorySize(0),
               poolSize(0),
 
               swapSize(0),
+              swapFileSize(0),
+              swapFragmentation(0.0),
+
+              deduplicatedSize(0),
+              deduplicationRatio(0.0),
 
               totalMemoryLimit(0),
               tilesHardLimit(0),
@@ -46,12 +54,20 @@ public:
         qint64 projectionsSize;
         qint64 lodSize;
 
+        qint64 activeNodeResidentSize;
+        qint64 activeNodeSwappedSize;
+
         qint64 totalMemorySize;
         qint64 realMemorySize;
         qint64 historicalMemorySize;
         qint64 poolSize;
 
         qint64 swapSize;
+        qint64 swapFileSize;
+        qreal swapFragmentation;
+
+        qint64 deduplicatedSize;
+        qreal deduplicationRatio;
 
         qint64 totalMemoryLimit;
         qint64 tilesHardLimit;
@@ -66,7 +82,7 @@ public:
     ~KisMemoryStatisticsServer() override;
     static KisMemoryStatisticsServer* instance();
 
-    Statistics fetchMemoryStatistics(KisImageSP image) const;
+    Statistics fetchMemoryStatistics(KisImageSP image, KisNodeSP activeNode = 0) const;
 
 public Q_SLOTS:
     void notifyImageChanged();
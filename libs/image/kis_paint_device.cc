@@ -462,6 +462,35 @@ public:
     }
 
 
+    void memoryStatistics(qint64 &residentBytes, qint64 &swappedBytes) const {
+        residentBytes = 0;
+        swappedBytes = 0;
+
+        Q_FOREACH (Data *data, allDataObjects()) {
+            if (!data) continue;
+
+            qint64 resident = 0;
+            qint64 swapped = 0;
+            data->dataManager()->memoryStatistics(resident, swapped);
+
+            residentBytes += resident;
+            swappedBytes += swapped;
+        }
+    }
+
+    void setEvictionPriority(KisTileEvictionPriority priority) {
+        m_evictionPriority = priority;
+
+        Q_FOREACH (Data *data, allDataObjects()) {
+            if (!data || data == m_lodData.data()) continue;
+            data->dataManager()->setEvictionPriority(priority);
+        }
+    }
+
+    KisTileEvictionPriority evictionPriority() const {
+        return m_evictionPriority;
+    }
+
 private:
 
     inline DataSP currentFrameData() const
@@ -516,6 +545,7 @@ private:
             QMutexLocker l(&m_dataSwitchLock);
             if (!m_lodData) {
                 m_lodData.reset(new Data(q, srcData, false));
+                m_lodData->dataManager()->setEvictionPriority(KisTileEvictionPriority::Preferred);
             }
         }
     }
@@ -597,6 +627,8 @@ private:
     mutable QScopedPointer<Data> m_externalFrameData;
     mutable QMutex m_dataSwitchLock;
 
+    KisTileEvictionPriority m_evictionPriority = KisTileEvictionPriority::Normal;
+
     FramesHash m_frames;
     int m_nextFreeFrameId;
 };
@@ -691,6 +723,7 @@ KisPaintDevice::LodDataStruct* KisPaintDevice::Private::createLodDataStruct(int
     Data *srcData = currentNonLodData();
 
     Data *lodData = new Data(q, srcData, false);
+    lodData->dataManager()->setEvictionPriority(KisTileEvictionPriority::Preferred);
     LodDataStruct *lodStruct = new LodDataStructImpl(lodData);
 
     int expectedX = KisLodTransform::coordToLodCoord(srcData->x(), newLod);
@@ -1048,6 +1081,9 @@ void KisPaintDevice::Private::init(const KoColorSpace *cs, const quint8 *default
         if (!data) continue;
 
         KisDataManagerSP dataManager = new KisDataManager(cs->pixelSize(), defaultPixel);
+        dataManager->setEvictionPriority(data == m_lodData.data() ?
+                                         KisTileEvictionPriority::Preferred :
+                                         m_evictionPriority);
         data->init(cs, dataManager);
     }
 }
@@ -1203,6 +1239,21 @@ void KisPaintDevice::estimateMemoryStats(qint64 &imageData, qint64 &temporaryDat
     m_d->estimateMemoryStats(imageData, temporaryData, lodData);
 }
 
+void KisPaintDevice::memoryStatistics(qint64 &residentBytes, qint64 &swappedBytes) const
+{
+    m_d->memoryStatistics(residentBytes, swappedBytes);
+}
+
+void KisPaintDevice::setEvictionPriority(KisTileEvictionPriority priority)
+{
+    m_d->setEvictionPriority(priority);
+}
+
+KisTileEvictionPriority KisPaintDevice::evictionPriority() const
+{
+    return m_d->evictionPriority();
+}
+
 void KisPaintDevice::setParentNode(KisNodeWSP parent)
 {
     m_d->parent = parent;
@@ -1517,6 +1568,11 @@ void KisPaintDevice::purgeDefaultPixels()
     dm->purge(dm->extent());
 }
 
+void KisPaintDevice::prefetchRect(const QRect &rc) const
+{
+    m_d->dataManager()->prefetchRect(rc.translated(-m_d->x(), -m_d->y()));
+}
+
 void KisPaintDevice::setDefaultPixel(const KoColor &defPixel)
 {
     KoColor color(defPixel);
@@ -43,6 +43,8 @@ class KisRasterKeyframeChannel;
 class KisPaintDeviceFramesInterface;
 
 class KisInterstrokeData;
+
+enum class KisTileEvictionPriority;
 using KisInterstrokeDataSP = QSharedPointer<KisInterstrokeData>;
 
 typedef KisSharedPtr<KisDataManager> KisDataManagerSP;
@@ -283,6 +285,13 @@ public:
      */
     void purgeDefaultPixels();
 
+    /**
+     * Hints the tile store that the area \p rc is going to be accessed
+     * soon. If some of its tiles are swapped out, they will be loaded
+     * in a background thread. The call is cheap when nothing is swapped.
+     */
+    void prefetchRect(const QRect &rc) const;
+
     /**
      * Sets the default pixel. New data will be initialised with this pixel. The pixel is copied: the
      * caller still owns the pointer and needs to delete it to avoid memory leaks.
@@ -809,6 +818,23 @@ public:
 
     void estimateMemoryStats(qint64 &imageData, qint64 &temporaryData, qint64 &lodData) const;
 
+    /**
+     * Counts the bytes of the device's tiles that are loaded into
+     * memory and that are swapped out at the moment. Unlike
+     * estimateMemoryStats(), the real tiles are counted, not the
+     * extent of the device.
+     */
+    void memoryStatistics(qint64 &residentBytes, qint64 &swappedBytes) const;
+
+    /**
+     * Sets the hint for the swapper telling how eagerly the tiles of
+     * the device should be swapped out when the memory is low. The
+     * LoD plane of the device always stays
+     * KisTileEvictionPriority::Preferred.
+     */
+    void setEvictionPriority(KisTileEvictionPriority priority);
+    KisTileEvictionPriority evictionPriority() const;
+
 public:
 
     KisHLineIteratorSP createHLineIteratorNG(qint32 x, qint32 y, qint32 w);
@@ -65,6 +65,7 @@ public:
           m_levelOfDetail(rhs->m_levelOfDetail),
           m_cacheInvalidator(this)
         {
+            m_dataManager->setEvictionPriority(rhs->m_dataManager->evictionPriority());
             m_cache.setupCache();
             // WARNING: interstroke data is **not** copied while cloning, that is expected behavior!
         }
@@ -181,6 +182,7 @@ public:
         m_colorSpace->convertPixelsTo(m_dataManager->defaultPixel(), dstDefaultPixel.data(), dstColorSpace, 1, renderingIntent, conversionFlags);
 
         KisDataManagerSP dstDataManager = new KisDataManager(dstPixelSize, dstDefaultPixel.data());
+        dstDataManager->setEvictionPriority(m_dataManager->evictionPriority());
 
 
         if (!rc.isEmpty()) {
@@ -258,6 +260,7 @@ public:
                     copyContent ?
                     new KisDataManager(*this->dataManager()) :
                     new KisDataManager(this->dataManager()->pixelSize(), this->dataManager()->defaultPixel());
+                newDm->setEvictionPriority(this->dataManager()->evictionPriority());
                 return new SwitchDataManager(this, this->dataManager(), newDm);
             });
     }
@@ -266,14 +269,18 @@ public:
         m_x = srcData->x();
         m_y = srcData->y();
 
+        const KisTileEvictionPriority evictionPriority = m_dataManager->evictionPriority();
+
         if (copyContent) {
             m_dataManager = new KisDataManager(*srcData->dataManager());
+            m_dataManager->setEvictionPriority(evictionPriority);
         } else if (m_dataManager->pixelSize() !=
                    srcData->dataManager()->pixelSize()) {
             // NOTE: we don't check default pixel value! it is the task of
             //       the higher level!
 
             m_dataManager = new KisDataManager(srcData->dataManager()->pixelSize(), srcData->dataManager()->defaultPixel());
+            m_dataManager->setEvictionPriority(evictionPriority);
             m_cache.setupCache();
         } else {
             m_dataManager->clear();
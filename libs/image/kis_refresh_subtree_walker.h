@@ -133,7 +133,7 @@ protected:
 
         KisProjectionLeafSP currentLeaf = startWith->lastChild();
         while(currentLeaf) {
-            NodePosition pos = (m_flags & NoFilthyMode ? N_ABOVE_FILTHY : N_FILTHY) |
+            NodePosition pos = positionToFilthy(currentLeaf) |
                 calculateNodePosition(currentLeaf);
             registerNeedRect(currentLeaf, pos);
 
@@ -150,13 +150,32 @@ protected:
 
         currentLeaf = startWith->lastChild();
         while(currentLeaf) {
-            if(currentLeaf->canHaveChildLayers()) {
+            if(currentLeaf->canHaveChildLayers() && needsSubtreeRefresh(currentLeaf)) {
                 startTrip(currentLeaf);
             }
             currentLeaf = currentLeaf->prevSibling();
         }
     }
 
+    /**
+     * Returns the position of the child \p leaf of the refreshed
+     * subtree relative to the filthy nodes. By default all the
+     * children are considered filthy.
+     */
+    virtual NodePosition positionToFilthy(KisProjectionLeafSP leaf) const {
+        Q_UNUSED(leaf);
+        return m_flags & NoFilthyMode ? N_ABOVE_FILTHY : N_FILTHY;
+    }
+
+    /**
+     * Returns true if the walker should descend into the child
+     * group \p leaf. By default all the groups are refreshed.
+     */
+    virtual bool needsSubtreeRefresh(KisProjectionLeafSP leaf) const {
+        Q_UNUSED(leaf);
+        return true;
+    }
+
 private:
     Flags m_flags = None;
 };
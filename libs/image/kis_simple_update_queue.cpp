@@ -7,10 +7,14 @@
 #include "kis_simple_update_queue.h"
 
 #include <QMutexLocker>
+#include <QSet>
 #include <QVector>
+#include <QtMath>
+#include <algorithm>
 
 #include "kis_image_config.h"
 #include "kis_full_refresh_walker.h"
+#include "KisBatchRefreshWalker.h"
 #include "kis_spontaneous_job.h"
 
 
@@ -42,7 +46,9 @@
 
 
 KisSimpleUpdateQueue::KisSimpleUpdateQueue()
-    : m_overrideLevelOfDetail(-1)
+    : m_overrideLevelOfDetail(-1),
+      m_useCostModel(true),
+      m_costEstimator(0)
 {
     updateSettings();
 }
@@ -68,6 +74,11 @@ void KisSimpleUpdateQueue::updateSettings()
     m_maxCollectAlpha = config.maxCollectAlpha();
     m_maxMergeAlpha = config.maxMergeAlpha();
     m_maxMergeCollectAlpha = config.maxMergeCollectAlpha();
+
+    m_useCostModel = config.useUpdateCostModel();
+    m_targetJobCost = config.updateTargetJobCost();
+
+    rebuildRectsIndex();
 }
 
 int KisSimpleUpdateQueue::overrideLevelOfDetail() const
@@ -75,6 +86,11 @@ int KisSimpleUpdateQueue::overrideLevelOfDetail() const
     return m_overrideLevelOfDetail;
 }
 
+void KisSimpleUpdateQueue::setCostEstimator(KisUpdateCostEstimator *estimator)
+{
+    m_costEstimator = estimator;
+}
+
 void KisSimpleUpdateQueue::processQueue(KisUpdaterContext &updaterContext)
 {
     updaterContext.lock();
@@ -110,6 +126,7 @@ bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
             updaterContext.isJobAllowed(item)) {
 
             updaterContext.addMergeJob(item);
+            m_rectsIndex.remove(item.data());
             iter.remove();
             jobAdded = true;
             break;
@@ -191,34 +208,42 @@ void KisSimpleUpdateQueue::addJob(KisNodeSP node, const QVector<QRect> &rects,
     Q_FOREACH (const QRect &rc, rects) {
         if (rc.isEmpty()) continue;
 
-        KisBaseRectsWalkerSP walker;
-
         if(trySplitJob(node, rc, cropRect, levelOfDetail, type)) continue;
         if(tryMergeJob(node, rc, cropRect, levelOfDetail, type)) continue;
 
-        if (type == KisBaseRectsWalker::UPDATE) {
-            walker = new KisMergeWalker(cropRect, KisMergeWalker::DEFAULT);
-        }
-        else if (type == KisBaseRectsWalker::FULL_REFRESH)  {
-            walker = new KisFullRefreshWalker(cropRect);
-        }
-        else if (type == KisBaseRectsWalker::UPDATE_NO_FILTHY) {
-            walker = new KisMergeWalker(cropRect, KisMergeWalker::NO_FILTHY);
-        }
-        else if (type == KisBaseRectsWalker::FULL_REFRESH_NO_FILTHY)  {
-            walker = new KisFullRefreshWalker(cropRect, KisFullRefreshWalker::NoFilthyMode);
-        }
-        /* else if(type == KisBaseRectsWalker::UNSUPPORTED) fatalKrita; */
-
-        walker->collectRects(node, rc);
+        KisBaseRectsWalkerSP walker = createWalker(node, rc, cropRect, type);
+        walker->prefetchTiles();
         walkers.append(walker);
     }
 
     if (!walkers.isEmpty()) {
-        m_lock.lock();
-        m_updatesList.append(walkers);
-        m_lock.unlock();
+        QMutexLocker locker(&m_lock);
+        appendWalkers(walkers);
+    }
+}
+
+KisBaseRectsWalkerSP KisSimpleUpdateQueue::createWalker(KisNodeSP node, const QRect& rc,
+                                                       const QRect& cropRect,
+                                                       KisBaseRectsWalker::UpdateType type)
+{
+    KisBaseRectsWalkerSP walker;
+
+    if (type == KisBaseRectsWalker::UPDATE) {
+        walker = new KisMergeWalker(cropRect, KisMergeWalker::DEFAULT);
+    }
+    else if (type == KisBaseRectsWalker::FULL_REFRESH)  {
+        walker = new KisFullRefreshWalker(cropRect);
     }
+    else if (type == KisBaseRectsWalker::UPDATE_NO_FILTHY) {
+        walker = new KisMergeWalker(cropRect, KisMergeWalker::NO_FILTHY);
+    }
+    else if (type == KisBaseRectsWalker::FULL_REFRESH_NO_FILTHY)  {
+        walker = new KisFullRefreshWalker(cropRect, KisFullRefreshWalker::NoFilthyMode);
+    }
+    /* else if(type == KisBaseRectsWalker::UNSUPPORTED) fatalKrita; */
+
+    walker->collectRects(node, rc);
+    return walker;
 }
 
 void KisSimpleUpdateQueue::addSpontaneousJob(KisSpontaneousJob *spontaneousJob)
@@ -242,6 +267,44 @@ void KisSimpleUpdateQueue::addSpontaneousJob(KisSpontaneousJob *spontaneousJob)
     m_spontaneousJobsList.append(spontaneousJob);
 }
 
+void KisSimpleUpdateQueue::addBatchRefreshJob(const KisBatchNodeUpdate &update,
+                                              const QRect& cropRect,
+                                              int levelOfDetail)
+{
+    QList<KisBaseRectsWalkerSP> walkers;
+
+    Q_FOREACH (const KisBatchNodeUpdate::SharedTraversal &traversal, update.sharedTraversals()) {
+        if (traversal.dirtyNodes.size() == 1) {
+            addJob(traversal.commonAncestor, {traversal.dirtyRect}, cropRect,
+                   levelOfDetail, KisBaseRectsWalker::FULL_REFRESH);
+            continue;
+        }
+
+        /**
+         * The shared walkers are never merged with the other ones,
+         * so just split them into the patches of the default size
+         */
+        const QRect &rc = traversal.dirtyRect;
+        const QVector<QRect> patches =
+            rc.width() <= m_patchWidth || rc.height() <= m_patchHeight ?
+                QVector<QRect>({rc}) :
+                splitRect(rc, QSize(m_patchWidth, m_patchHeight));
+
+        Q_FOREACH (const QRect &patch, patches) {
+            KisBaseRectsWalkerSP walker =
+                new KisBatchRefreshWalker(cropRect, traversal.dirtyNodes);
+            walker->collectRects(traversal.commonAncestor, patch);
+            walker->prefetchTiles();
+            walkers.append(walker);
+        }
+    }
+
+    if (!walkers.isEmpty()) {
+        QMutexLocker locker(&m_lock);
+        appendWalkers(walkers);
+    }
+}
+
 bool KisSimpleUpdateQueue::isEmpty() const
 {
     QMutexLocker locker(&m_lock);
@@ -262,29 +325,119 @@ bool KisSimpleUpdateQueue::trySplitJob(KisNodeSP node, const QRect& rc,
     if(rc.width() <= m_patchWidth || rc.height() <= m_patchHeight)
         return false;
 
+    const bool useCostModel =
+        m_useCostModel && m_costEstimator && m_costEstimator->hasSamples();
+
+    const QSize patchSize = useCostModel ?
+        costBasedPatchSize(node, rc, cropRect, type) :
+        QSize(m_patchWidth, m_patchHeight);
+
     // a bit of recursive splitting...
 
-    qint32 firstCol = rc.x() / m_patchWidth;
-    qint32 firstRow = rc.y() / m_patchHeight;
+    QVector<QRect> splitRects = splitRect(rc, patchSize);
 
-    qint32 lastCol = (rc.x() + rc.width()) / m_patchWidth;
-    qint32 lastRow = (rc.y() + rc.height()) / m_patchHeight;
+    KIS_SAFE_ASSERT_RECOVER_NOOP(!splitRects.isEmpty());
+
+    if (useCostModel) {
+        addSplitJobsByCost(node, splitRects, cropRect, type);
+    } else {
+        addJob(node, splitRects, cropRect, levelOfDetail, type);
+    }
+
+    return true;
+}
+
+QVector<QRect> KisSimpleUpdateQueue::splitRect(const QRect& rc, const QSize& patchSize) const
+{
+    qint32 firstCol = rc.x() / patchSize.width();
+    qint32 firstRow = rc.y() / patchSize.height();
+
+    qint32 lastCol = (rc.x() + rc.width()) / patchSize.width();
+    qint32 lastRow = (rc.y() + rc.height()) / patchSize.height();
 
     QVector<QRect> splitRects;
 
     for(qint32 i = firstRow; i <= lastRow; i++) {
         for(qint32 j = firstCol; j <= lastCol; j++) {
-            QRect maxPatchRect(j * m_patchWidth, i * m_patchHeight,
-                               m_patchWidth, m_patchHeight);
+            QRect maxPatchRect(j * patchSize.width(), i * patchSize.height(),
+                               patchSize.width(), patchSize.height());
             QRect patchRect = rc & maxPatchRect;
+            if (patchRect.isEmpty()) continue;
+
             splitRects.append(patchRect);
         }
     }
 
-    KIS_SAFE_ASSERT_RECOVER_NOOP(!splitRects.isEmpty());
-    addJob(node, splitRects, cropRect, levelOfDetail, type);
+    return splitRects;
+}
 
-    return true;
+/**
+ * Chooses the patch size so that the merge of a single patch takes
+ * approximately m_targetJobCost nanoseconds. The expensive
+ * subtrees (e.g. filter masks over big groups) get smaller patches, so
+ * the work is spread evenly over all the threads, and the cheap ones
+ * get bigger patches to avoid the per-job overhead. The size is changed
+ * in powers of two only, so the patches stay aligned to the tiles.
+ */
+QSize KisSimpleUpdateQueue::costBasedPatchSize(KisNodeSP node, const QRect& rc,
+                                               const QRect& cropRect,
+                                               KisBaseRectsWalker::UpdateType type)
+{
+    KisBaseRectsWalkerSP probeWalker = createWalker(node, rc, cropRect, type);
+
+    const qreal defaultPatchArea = qreal(m_patchWidth) * m_patchHeight;
+    const qreal costPerPixel =
+        m_costEstimator->estimateCost(*probeWalker) / (qreal(rc.width()) * rc.height());
+
+    if (costPerPixel <= 0.0) {
+        return QSize(m_patchWidth, m_patchHeight);
+    }
+
+    const qreal idealScale =
+        std::sqrt(m_targetJobCost / (costPerPixel * defaultPatchArea));
+
+    const int scaleLog2 = qBound(-2, qRound(std::log2(idealScale)), 1);
+    const qreal scale = std::pow(2.0, scaleLog2);
+
+    return QSize(qMax(64, qRound(m_patchWidth * scale)),
+                 qMax(64, qRound(m_patchHeight * scale)));
+}
+
+/**
+ * The patches are queued as non-joinable walkers, since merging them
+ * with other jobs (either on adding or in optimize()) would undo the
+ * cost-based sizing and the ordering. The most expensive patches go
+ * first, so that all the threads finish their work at approximately
+ * the same time.
+ */
+void KisSimpleUpdateQueue::addSplitJobsByCost(KisNodeSP node, const QVector<QRect> &rects,
+                                              const QRect& cropRect,
+                                              KisBaseRectsWalker::UpdateType type)
+{
+    QVector<QPair<qreal, KisBaseRectsWalkerSP>> costedWalkers;
+    costedWalkers.reserve(rects.size());
+
+    Q_FOREACH (const QRect &rc, rects) {
+        KisBaseRectsWalkerSP walker = createWalker(node, rc, cropRect, type);
+        walker->setJoinable(false);
+        costedWalkers.append(qMakePair(m_costEstimator->estimateCost(*walker), walker));
+    }
+
+    std::stable_sort(costedWalkers.begin(), costedWalkers.end(),
+                     [] (const QPair<qreal, KisBaseRectsWalkerSP> &lhs,
+                         const QPair<qreal, KisBaseRectsWalkerSP> &rhs) {
+                         return lhs.first > rhs.first;
+                     });
+
+    QList<KisBaseRectsWalkerSP> walkers;
+
+    for (auto it = costedWalkers.begin(); it != costedWalkers.end(); ++it) {
+        it->second->prefetchTiles();
+        walkers.append(it->second);
+    }
+
+    QMutexLocker locker(&m_lock);
+    appendWalkers(walkers);
 }
 
 bool KisSimpleUpdateQueue::tryMergeJob(KisNodeSP node, const QRect& rc,
@@ -297,18 +450,20 @@ bool KisSimpleUpdateQueue::tryMergeJob(KisNodeSP node, const QRect& rc,
     QRect baseRect = rc;
 
     KisBaseRectsWalkerSP goodCandidate;
-    KisBaseRectsWalkerSP item;
-    KisWalkersListIterator iter(m_updatesList);
+
+    /**
+     * Only the walkers lying close enough to the new rect can be
+     * joined with it, so there is no need to check the whole list
+     */
+    const QVector<KisBaseRectsWalker*> candidates = m_rectsIndex.joinCandidates(baseRect);
 
     /**
      * We add new jobs to the tail of the list,
      * so it's more probable to find a good candidate here.
      */
 
-    iter.toBack();
-
-    while(iter.hasPrevious()) {
-        item = iter.previous();
+    for (auto it = candidates.crbegin(); it != candidates.crend(); ++it) {
+        KisBaseRectsWalker *item = *it;
 
         if(item->startNode() != node) continue;
         if(item->type() != type) continue;
@@ -334,6 +489,8 @@ void KisSimpleUpdateQueue::optimize()
     if(m_updatesList.size() <= 1) return;
 
     KisBaseRectsWalkerSP baseWalker = m_updatesList.first();
+    if (!baseWalker->isJoinable()) return;
+
     QRect baseRect = baseWalker->requestedRect();
 
     collectJobs(baseWalker, baseRect, m_maxCollectAlpha);
@@ -343,25 +500,39 @@ void KisSimpleUpdateQueue::collectJobs(KisBaseRectsWalkerSP &baseWalker,
                                        QRect baseRect,
                                        const qreal maxAlpha)
 {
-    KisBaseRectsWalkerSP item;
-    KisMutableWalkersListIterator iter(m_updatesList);
+    /**
+     * The base rect only grows while collecting, so the set of the
+     * walkers that can be joined with it only shrinks. Hence it is
+     * enough to fetch the candidates for the initial rect.
+     */
+    const QVector<KisBaseRectsWalker*> candidates = m_rectsIndex.joinCandidates(baseRect);
 
-    while(iter.hasNext()) {
-        item = iter.next();
+    QSet<KisBaseRectsWalker*> joinedWalkers;
 
-        if(item == baseWalker) continue;
+    Q_FOREACH (KisBaseRectsWalker *item, candidates) {
+        if(baseWalker == item) continue;
         if(item->type() != baseWalker->type()) continue;
         if(item->startNode() != baseWalker->startNode()) continue;
         if(item->cropRect() != baseWalker->cropRect()) continue;
         if(item->levelOfDetail() != baseWalker->levelOfDetail()) continue;
 
         if(joinRects(baseRect, item->requestedRect(), maxAlpha)) {
-            iter.remove();
+            m_rectsIndex.remove(item);
+            joinedWalkers.insert(item);
         }
     }
 
+    if (!joinedWalkers.isEmpty()) {
+        auto newEnd = std::remove_if(m_updatesList.begin(), m_updatesList.end(),
+                                     [&joinedWalkers] (const KisBaseRectsWalkerSP &walker) {
+                                         return joinedWalkers.contains(walker.data());
+                                     });
+        m_updatesList.erase(newEnd, m_updatesList.end());
+    }
+
     if(baseWalker->requestedRect() != baseRect) {
         baseWalker->collectRects(baseWalker->startNode(), baseRect);
+        m_rectsIndex.update(baseWalker.data());
     }
 }
 
@@ -394,6 +565,30 @@ bool KisSimpleUpdateQueue::joinRects(QRect& baseRect,
     return result;
 }
 
+void KisSimpleUpdateQueue::appendWalkers(const KisWalkersList &walkers)
+{
+    /**
+     * The walkers that cannot be joined with other ones
+     * are not indexed
+     */
+    Q_FOREACH (const KisBaseRectsWalkerSP &walker, walkers) {
+        if (!walker->isJoinable()) continue;
+        m_rectsIndex.insert(walker.data());
+    }
+
+    m_updatesList.append(walkers);
+}
+
+void KisSimpleUpdateQueue::rebuildRectsIndex()
+{
+    m_rectsIndex.resetPatchSize(QSize(m_patchWidth, m_patchHeight));
+
+    Q_FOREACH (const KisBaseRectsWalkerSP &walker, m_updatesList) {
+        if (!walker->isJoinable()) continue;
+        m_rectsIndex.insert(walker.data());
+    }
+}
+
 KisWalkersList& KisTestableSimpleUpdateQueue::getWalkersList()
 {
     return m_updatesList;
@@ -9,6 +9,8 @@
 
 #include <QMutex>
 #include "kis_updater_context.h"
+#include "KisUpdateRectsIndex.h"
+#include "KisBatchNodeUpdate.h"
 
 typedef QList<KisBaseRectsWalkerSP> KisWalkersList;
 typedef QListIterator<KisBaseRectsWalkerSP> KisWalkersListIterator;
@@ -36,6 +38,15 @@ public:
     void addFullRefreshNoFilthyJob(KisNodeSP node, const QVector<QRect> &rects, const QRect& cropRect, int levelOfDetail);
     void addSpontaneousJob(KisSpontaneousJob *spontaneousJob);
 
+    /**
+     * Adds a full refresh of all the nodes of \p update. The nodes
+     * with overlapping dirty rects are refreshed with a single walker
+     * started at their common ancestor.
+     *
+     * \see KisBatchNodeUpdate::sharedTraversals()
+     */
+    void addBatchRefreshJob(const KisBatchNodeUpdate &update, const QRect& cropRect, int levelOfDetail);
+
 
     void optimize();
 
@@ -46,22 +57,45 @@ public:
 
     int overrideLevelOfDetail() const;
 
+    /**
+     * When the estimator is set, the big updates are split into patches
+     * of the size adjusted to the cost of the updated subtree and the
+     * most expensive patches are queued first
+     */
+    void setCostEstimator(KisUpdateCostEstimator *estimator);
+
 protected:
     void addJob(KisNodeSP node, const QVector<QRect> &rects, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
 
     bool processOneJob(KisUpdaterContext &updaterContext);
 
+    KisBaseRectsWalkerSP createWalker(KisNodeSP node, const QRect& rc, const QRect& cropRect, KisBaseRectsWalker::UpdateType type);
+
     bool trySplitJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
+    QVector<QRect> splitRect(const QRect& rc, const QSize& patchSize) const;
+    QSize costBasedPatchSize(KisNodeSP node, const QRect& rc, const QRect& cropRect, KisBaseRectsWalker::UpdateType type);
+    void addSplitJobsByCost(KisNodeSP node, const QVector<QRect> &rects, const QRect& cropRect, KisBaseRectsWalker::UpdateType type);
     bool tryMergeJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
 
     void collectJobs(KisBaseRectsWalkerSP &baseWalker, QRect baseRect,
                      const qreal maxAlpha);
     bool joinRects(QRect& baseRect, const QRect& newRect, qreal maxAlpha);
 
+    void appendWalkers(const KisWalkersList &walkers);
+    void rebuildRectsIndex();
+
 protected:
 
     mutable QMutex m_lock;
     KisWalkersList m_updatesList;
+
+    /**
+     * The walkers of m_updatesList that can be joined with other
+     * ones, used to find the merge candidates without scanning
+     * the whole list
+     */
+    KisUpdateRectsIndex m_rectsIndex;
+
     KisSpontaneousJobsList m_spontaneousJobsList;
 
     /**
@@ -94,6 +128,19 @@ protected:
     qreal m_maxMergeCollectAlpha;
 
     int m_overrideLevelOfDetail;
+
+    /**
+     * Adjust the size and the order of the split patches
+     * to the cost of the updated subtree
+     */
+    bool m_useCostModel;
+    KisUpdateCostEstimator *m_costEstimator;
+
+    /**
+     * The desired cost of merging of a single split patch,
+     * in nanoseconds
+     */
+    qreal m_targetJobCost;
 };
 
 class KRITAIMAGE_EXPORT KisTestableSimpleUpdateQueue : public KisSimpleUpdateQueue
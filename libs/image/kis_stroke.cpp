@@ -265,6 +265,26 @@ qreal KisStroke::balancingRatioOverride() const
     return m_strokeStrategy->balancingRatioOverride();
 }
 
+KisStrokeStrategy::Priority KisStroke::priority() const
+{
+    return m_strokeStrategy->priority();
+}
+
+bool KisStroke::supportsSpeculativeLod0Replay() const
+{
+    return m_strokeStrategy->supportsSpeculativeLod0Replay();
+}
+
+bool KisStroke::canBePreempted() const
+{
+    /**
+     * LoD strokes are bound to their buddies and to the LoD
+     * synchronization strokes, so they are never reordered
+     */
+    return m_type == LEGACY &&
+        m_strokeStrategy->priority() == KisStrokeStrategy::BACKGROUND;
+}
+
 KisStrokeJobData::Sequentiality KisStroke::nextJobSequentiality() const
 {
     return !m_jobsQueue.isEmpty() ?
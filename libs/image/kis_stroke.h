@@ -13,6 +13,7 @@
 #include <kis_types.h>
 #include "kritaimage_export.h"
 #include "kis_stroke_job.h"
+#include "kis_stroke_strategy.h"
 
 class KisStrokeStrategy;
 class KUndo2MagicString;
@@ -60,6 +61,15 @@ public:
     int worksOnLevelOfDetail() const;
     bool canForgetAboutMe() const;
     qreal balancingRatioOverride() const;
+    KisStrokeStrategy::Priority priority() const;
+    bool supportsSpeculativeLod0Replay() const;
+
+    /**
+     * Returns true if the strokes of higher priority may be put in
+     * front of this stroke in the strokes queue, even when it has
+     * already started its execution
+     */
+    bool canBePreempted() const;
 
     KisStrokeJobData::Sequentiality nextJobSequentiality() const;
 
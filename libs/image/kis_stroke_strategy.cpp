@@ -19,6 +19,8 @@ KisStrokeStrategy::KisStrokeStrategy(const QLatin1String &id, const KUndo2MagicS
       m_needsExplicitCancel(false),
       m_forceLodModeIfPossible(false),
       m_balancingRatioOverride(-1.0),
+      m_priority(INTERACTIVE),
+      m_supportsSpeculativeLod0Replay(false),
       m_id(id),
       m_name(name),
       m_mutatedJobsInterface(0)
@@ -34,6 +36,8 @@ KisStrokeStrategy::KisStrokeStrategy(const KisStrokeStrategy &rhs)
       m_needsExplicitCancel(rhs.m_needsExplicitCancel),
       m_forceLodModeIfPossible(rhs.m_forceLodModeIfPossible),
       m_balancingRatioOverride(rhs.m_balancingRatioOverride),
+      m_priority(rhs.m_priority),
+      m_supportsSpeculativeLod0Replay(rhs.m_supportsSpeculativeLod0Replay),
       m_id(rhs.m_id),
       m_name(rhs.m_name),
       m_mutatedJobsInterface(0)
@@ -231,3 +235,23 @@ void KisStrokeStrategy::setBalancingRatioOverride(qreal value)
 {
     m_balancingRatioOverride = value;
 }
+
+KisStrokeStrategy::Priority KisStrokeStrategy::priority() const
+{
+    return m_priority;
+}
+
+void KisStrokeStrategy::setPriority(Priority value)
+{
+    m_priority = value;
+}
+
+bool KisStrokeStrategy::supportsSpeculativeLod0Replay() const
+{
+    return m_supportsSpeculativeLod0Replay;
+}
+
+void KisStrokeStrategy::setSupportsSpeculativeLod0Replay(bool value)
+{
+    m_supportsSpeculativeLod0Replay = value;
+}
@@ -19,6 +19,29 @@ class KisStrokesQueueMutatedJobInterface;
 
 class KRITAIMAGE_EXPORT KisStrokeStrategy
 {
+public:
+    /**
+     * Priority class of the stroke:
+     *
+     * INTERACTIVE: the stroke is started by the user and should
+     *              be executed as fast as possible (default)
+     *
+     * PREVIEW: the stroke is not latency-critical, its jobs never
+     *          occupy the updater context slots reserved for the
+     *          interactive strokes
+     *
+     * BACKGROUND: same as PREVIEW, but the stroke can also be preempted
+     *             at job boundaries by the strokes of higher priority
+     *             started after it. Only the strokes that do not modify
+     *             the image and tolerate it being changed between their
+     *             jobs may have this priority.
+     */
+    enum Priority {
+        INTERACTIVE,
+        PREVIEW,
+        BACKGROUND
+    };
+
 public:
     KisStrokeStrategy(const QLatin1String &id, const KUndo2MagicString &name = KUndo2MagicString());
     virtual ~KisStrokeStrategy();
@@ -98,6 +121,21 @@ public:
      */
     qreal balancingRatioOverride() const;
 
+    /**
+     * \see Priority for details
+     */
+    Priority priority() const;
+
+    /**
+     * Returns true if the LoD0 stroke may be replayed on the spare cores
+     * while its LodN buddy is still being painted by the user. Only the
+     * strategies, whose LoD0 and LodN jobs do not share any state (e.g.
+     * the temporary target of the node), may allow that.
+     *
+     * Default is 'false'.
+     */
+    bool supportsSpeculativeLod0Replay() const;
+
     QString id() const;
     KUndo2MagicString name() const;
 
@@ -165,6 +203,18 @@ protected:
      */
     void setBalancingRatioOverride(qreal value);
 
+    /**
+     * Sets the priority class of the stroke. Default is INTERACTIVE.
+     *
+     * \see Priority for details
+     */
+    void setPriority(Priority value);
+
+    /**
+     * \see supportsSpeculativeLod0Replay() for details
+     */
+    void setSupportsSpeculativeLod0Replay(bool value);
+
 protected:
     /**
      * Protected c-tor, used for cloning of hi-level strategies
@@ -181,6 +231,8 @@ private:
     bool m_needsExplicitCancel;
     bool m_forceLodModeIfPossible;
     qreal m_balancingRatioOverride;
+    Priority m_priority;
+    bool m_supportsSpeculativeLod0Replay;
 
     QLatin1String m_id;
     KUndo2MagicString m_name;
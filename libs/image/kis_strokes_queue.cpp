@@ -9,6 +9,7 @@
 #include <QQueue>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QtMath>
 #include "kis_stroke.h"
 #include "kis_updater_context.h"
 #include "kis_stroke_job_strategy.h"
@@ -16,6 +17,7 @@
 #include "kis_undo_stores.h"
 #include "kis_post_execution_undo_adapter.h"
 #include "KisCppQuirks.h"
+#include "KisTraceEvents.h"
 
 typedef QQueue<KisStrokeSP> StrokesQueue;
 typedef QQueue<KisStrokeSP>::iterator StrokesQueueIterator;
@@ -67,6 +69,9 @@ struct Q_DECL_HIDDEN KisStrokesQueue::Private {
           wrapAroundModeSupported(false),
           balancingRatioOverride(-1.0),
           currentStrokeLoaded(false),
+          reservedInteractiveSlots(1),
+          speculativeLod0Budget(0.5),
+          waitingForPreemptedJobs(false),
           lodNNeedsSynchronization(true),
           desiredLevelOfDetail(0),
           nextDesiredLevelOfDetail(0),
@@ -81,6 +86,16 @@ struct Q_DECL_HIDDEN KisStrokesQueue::Private {
     qreal balancingRatioOverride;
     bool currentStrokeLoaded;
 
+    int reservedInteractiveSlots;
+    qreal speculativeLod0Budget;
+
+    /**
+     * Set when the head of the queue has been preempted by a stroke
+     * of higher priority. The new head should not start until all
+     * the jobs of the preempted stroke are completed.
+     */
+    bool waitingForPreemptedJobs;
+
     bool lodNNeedsSynchronization;
     int desiredLevelOfDetail;
     int nextDesiredLevelOfDetail;
@@ -99,6 +114,7 @@ struct Q_DECL_HIDDEN KisStrokesQueue::Private {
     std::pair<StrokesQueueIterator, StrokesQueueIterator> currentLodRange();
     StrokesQueueIterator findNewLod0Pos();
     StrokesQueueIterator findNewLodNPos(KisStrokeSP lodN);
+    StrokesQueueIterator findNewLegacyPos(KisStrokeSP stroke);
     bool shouldWrapInSuspendUpdatesStroke();
 
     void switchDesiredLevelOfDetail(bool forced);
@@ -258,6 +274,42 @@ StrokesQueueIterator KisStrokesQueue::Private::findNewLodNPos(KisStrokeSP lodN)
     return it;
 }
 
+StrokesQueueIterator KisStrokesQueue::Private::findNewLegacyPos(KisStrokeSP stroke)
+{
+    StrokesQueueIterator it = strokesQueue.end();
+
+    /**
+     * The stroke jumps over all the preemptible strokes of lower
+     * priority waiting in the tail of the queue
+     */
+    while (it != strokesQueue.begin()) {
+        KisStrokeSP prevStroke = *std::prev(it);
+
+        if (!prevStroke->canBePreempted() ||
+            prevStroke->priority() <= stroke->priority()) {
+
+            break;
+        }
+
+        --it;
+    }
+
+    if (it == strokesQueue.begin() && it != strokesQueue.end()) {
+        /**
+         * The head of the queue might have already been loaded
+         * and even have some jobs running, so the new head should
+         * be loaded from scratch and wait for these jobs to complete
+         */
+        needsExclusiveAccess = false;
+        wrapAroundModeSupported = false;
+        balancingRatioOverride = -1.0;
+        currentStrokeLoaded = false;
+        waitingForPreemptedJobs = true;
+    }
+
+    return it;
+}
+
 KisStrokeId KisStrokesQueue::startLodNUndoStroke(KisStrokeStrategy *strokeStrategy)
 {
     QMutexLocker locker(&m_d->mutex);
@@ -321,7 +373,7 @@ KisStrokeId KisStrokesQueue::startStroke(KisStrokeStrategy *strokeStrategy)
 
     } else {
         stroke = KisStrokeSP(new KisStroke(strokeStrategy, KisStroke::LEGACY, 0));
-        m_d->strokesQueue.enqueue(stroke);
+        m_d->strokesQueue.insert(m_d->findNewLegacyPos(stroke), stroke);
     }
 
     KisStrokeId id(stroke);
@@ -572,6 +624,8 @@ void KisStrokesQueue::Private::forceResetLodAndCloseCurrentLodRange()
 void KisStrokesQueue::processQueue(KisUpdaterContext &updaterContext,
                                    bool externalJobsPending)
 {
+    KIS_TRACE_SCOPE("strokes", "process queue");
+
     updaterContext.lock();
     m_d->mutex.lock();
 
@@ -598,6 +652,30 @@ qreal KisStrokesQueue::balancingRatioOverride() const
     return m_d->balancingRatioOverride;
 }
 
+void KisStrokesQueue::setReservedInteractiveSlots(int value)
+{
+    QMutexLocker locker(&m_d->mutex);
+    m_d->reservedInteractiveSlots = qMax(0, value);
+}
+
+int KisStrokesQueue::reservedInteractiveSlots() const
+{
+    QMutexLocker locker(&m_d->mutex);
+    return m_d->reservedInteractiveSlots;
+}
+
+void KisStrokesQueue::setSpeculativeLod0Budget(qreal value)
+{
+    QMutexLocker locker(&m_d->mutex);
+    m_d->speculativeLod0Budget = qBound(0.0, value, 1.0);
+}
+
+qreal KisStrokesQueue::speculativeLod0Budget() const
+{
+    QMutexLocker locker(&m_d->mutex);
+    return m_d->speculativeLod0Budget;
+}
+
 KisLodPreferences KisStrokesQueue::lodPreferences() const
 {
     QMutexLocker locker(&m_d->mutex);
@@ -726,18 +804,123 @@ bool KisStrokesQueue::processOneJob(KisUpdaterContext &updaterContext,
                                  snapshot == HasMergeJob);
     const bool hasMergeJobs = snapshot & HasMergeJob;
 
+    if (m_d->waitingForPreemptedJobs) {
+        if (hasStrokeJobs) return false;
+        m_d->waitingForPreemptedJobs = false;
+    }
+
     if(checkStrokeState(hasStrokeJobs, levelOfDetail) &&
        checkExclusiveProperty(hasMergeJobs, hasStrokeJobs) &&
-       checkSequentialProperty(snapshot, externalJobsPending)) {
+       checkSequentialProperty(m_d->strokesQueue.head(), snapshot, externalJobsPending) &&
+       checkPriorityProperty(updaterContext)) {
 
         KisStrokeSP stroke = m_d->strokesQueue.head();
         updaterContext.addStrokeJob(stroke->popOneJob());
         result = true;
+    } else if (m_d->speculativeLod0Budget > 0.0) {
+        result = processOneSpeculativeJob(updaterContext, snapshot,
+                                          levelOfDetail, externalJobsPending);
     }
 
     return result;
 }
 
+bool KisStrokesQueue::processOneSpeculativeJob(KisUpdaterContext &updaterContext,
+                                               KisUpdaterContextSnapshotEx snapshot,
+                                               int runningLevelOfDetail,
+                                               bool externalJobsPending)
+{
+    if (m_d->strokesQueue.size() < 2) return false;
+
+    /**
+     * The speculation happens only in the gaps between the jobs of
+     * the LodN stroke being painted by the user. The LoD0 and LodN
+     * jobs cannot run simultaneously, because the paint devices select
+     * their data by the level of detail of the updater context, so a
+     * new LodN job has to wait for the speculative ones. That is why
+     * their number is limited by the budget.
+     */
+    KisStrokeSP head = m_d->strokesQueue.head();
+
+    if (head->type() != KisStroke::LODN ||
+        head->isCancelled() ||
+        head->hasJobs() ||
+        runningLevelOfDetail > 0) {
+
+        return false;
+    }
+
+    /**
+     * The pending walkers belong to the LodN stroke (its preview
+     * updates) and they cannot start while LoD0 jobs are running.
+     * The concurrent jobs don't check the sequential property, so
+     * the pending walkers should be checked explicitly, otherwise
+     * the speculation could delay the preview indefinitely.
+     */
+    if (externalJobsPending) return false;
+
+    /**
+     * The queue looks like [LODN][SUSPEND][LOD0][RESUME] here. The
+     * suspend stroke is executed first, so that the updates of the
+     * replayed stroke were not shown to the user until the resume
+     * stroke is reached.
+     */
+    KisStrokeSP candidate;
+
+    for (auto it = std::next(m_d->strokesQueue.begin()); it != m_d->strokesQueue.end(); ++it) {
+        KisStrokeSP stroke = *it;
+
+        if (stroke->type() == KisStroke::SUSPEND) {
+            if (!candidate && !(stroke->isEnded() && !stroke->hasJobs())) {
+                candidate = stroke;
+            }
+        } else if (stroke->type() == KisStroke::LOD0) {
+            if (!stroke->supportsSpeculativeLod0Replay() ||
+                stroke->isCancelled() ||
+                stroke->isExclusive()) {
+
+                return false;
+            }
+
+            if (!candidate) {
+                candidate = stroke;
+            }
+            break;
+        } else {
+            return false;
+        }
+    }
+
+    if (!candidate ||
+        !candidate->hasJobs() ||
+        candidate->nextJobLevelOfDetail() != 0 ||
+        !checkSequentialProperty(candidate, snapshot, externalJobsPending)) {
+
+        return false;
+    }
+
+    qint32 numMergeJobs = 0;
+    qint32 numStrokeJobs = 0;
+    updaterContext.getJobsSnapshot(numMergeJobs, numStrokeJobs);
+
+    const int threadsLimit = updaterContext.threadsLimit();
+    const int numSpareThreads = threadsLimit - numMergeJobs - numStrokeJobs;
+    const int reservedSlots = qMin(m_d->reservedInteractiveSlots, threadsLimit - 1);
+    const int maxSpeculativeJobs =
+        qMax(1, qFloor(threadsLimit * m_d->speculativeLod0Budget));
+
+    if (numStrokeJobs >= maxSpeculativeJobs ||
+        numSpareThreads <= reservedSlots) {
+
+        return false;
+    }
+
+    KisTraceEvents::instant("strokes", "speculative lod0 job");
+
+    updaterContext.addStrokeJob(candidate->popOneJob());
+    return true;
+}
+
 bool KisStrokesQueue::checkStrokeState(bool hasStrokeJobsRunning,
                                        int runningLevelOfDetail)
 {
@@ -817,11 +1000,10 @@ bool KisStrokesQueue::checkExclusiveProperty(bool hasMergeJobs,
     return hasMergeJobs == 0;
 }
 
-bool KisStrokesQueue::checkSequentialProperty(KisUpdaterContextSnapshotEx snapshot,
+bool KisStrokesQueue::checkSequentialProperty(KisStrokeSP stroke,
+                                              KisUpdaterContextSnapshotEx snapshot,
                                               bool externalJobsPending)
 {
-    KisStrokeSP stroke = m_d->strokesQueue.head();
-
     if (snapshot & HasSequentialJob ||
         snapshot & HasBarrierJob) {
         return false;
@@ -862,3 +1044,25 @@ bool KisStrokesQueue::checkLevelOfDetailProperty(int runningLevelOfDetail)
     return runningLevelOfDetail < 0 ||
         stroke->nextJobLevelOfDetail() == runningLevelOfDetail;
 }
+
+bool KisStrokesQueue::checkPriorityProperty(KisUpdaterContext &updaterContext)
+{
+    KisStrokeSP stroke = m_d->strokesQueue.head();
+
+    if (stroke->priority() == KisStrokeStrategy::INTERACTIVE) return true;
+
+    qint32 numMergeJobs = 0;
+    qint32 numStrokeJobs = 0;
+    updaterContext.getJobsSnapshot(numMergeJobs, numStrokeJobs);
+
+    const int threadsLimit = updaterContext.threadsLimit();
+    const int numSpareThreads = threadsLimit - numMergeJobs - numStrokeJobs;
+
+    /**
+     * Let the stroke progress even when the context has
+     * fewer threads than the number of the reserved slots
+     */
+    const int reservedSlots = qMin(m_d->reservedInteractiveSlots, threadsLimit - 1);
+
+    return numSpareThreads > reservedSlots;
+}
@@ -53,6 +53,28 @@ public:
     bool wrapAroundModeSupported() const;
     qreal balancingRatioOverride() const;
 
+    /**
+     * The number of the updater context slots reserved for the
+     * interactive strokes. The jobs of the strokes with lower
+     * priority never occupy these slots (unless the context has
+     * no more threads).
+     *
+     * \see KisStrokeStrategy::Priority
+     */
+    void setReservedInteractiveSlots(int value);
+    int reservedInteractiveSlots() const;
+
+    /**
+     * The share of the updater context threads the LoD0 stroke may
+     * occupy while being replayed speculatively, i.e. while its LodN
+     * buddy is still being painted by the user. Zero disables the
+     * speculation.
+     *
+     * \see KisStrokeStrategy::supportsSpeculativeLod0Replay()
+     */
+    void setSpeculativeLod0Budget(qreal value);
+    qreal speculativeLod0Budget() const;
+
     KisLodPreferences lodPreferences() const override;
     void setLodPreferences(const KisLodPreferences &value);
     void explicitRegenerateLevelOfDetail();
@@ -75,13 +97,18 @@ public:
 private:
     bool processOneJob(KisUpdaterContext &updaterContext,
                        bool externalJobsPending);
+    bool processOneSpeculativeJob(KisUpdaterContext &updaterContext,
+                                  KisUpdaterContextSnapshotEx snapshot,
+                                  int runningLevelOfDetail,
+                                  bool externalJobsPending);
     bool checkStrokeState(bool hasStrokeJobsRunning,
                           int runningLevelOfDetail);
     bool checkExclusiveProperty(bool hasMergeJobs, bool hasStrokeJobs);
-    bool checkSequentialProperty(KisUpdaterContextSnapshotEx snapshot, bool externalJobsPending);
+    bool checkSequentialProperty(KisStrokeSP stroke, KisUpdaterContextSnapshotEx snapshot, bool externalJobsPending);
     bool checkBarrierProperty(bool hasMergeJobs, bool hasStrokeJobs,
                               bool externalJobsPending);
     bool checkLevelOfDetailProperty(int runningLevelOfDetail);
+    bool checkPriorityProperty(KisUpdaterContext &updaterContext);
 
     class LodNUndoStrokesFacade;
     KisStrokeId startLodNUndoStroke(KisStrokeStrategy *strokeStrategy);
@@ -17,6 +17,8 @@
 #include "kis_base_rects_walker.h"
 #include "kis_async_merger.h"
 #include "kis_updater_context.h"
+#include "KisWorkStealingExecutor.h"
+#include "KisTraceEvents.h"
 #include <KoAlwaysInline.h>
 
 //#define DEBUG_JOBS_SEQUENCE
@@ -39,6 +41,8 @@ public:
     {
         setAutoDelete(false);
         KIS_SAFE_ASSERT_RECOVER_NOOP(m_atomicType.is_lock_free());
+
+        m_merger.setCostEstimator(&m_updaterContext->costEstimator());
     }
     ~KisUpdateJobItem() override
     {
@@ -80,26 +84,10 @@ private:
                 m_updaterContext->m_exclusiveJobLock.lockForRead();
             }
 
-            if(m_atomicType == Type::MERGE) {
-                runMergeJob();
-            } else {
-                KIS_ASSERT(m_atomicType == Type::STROKE ||
-                           m_atomicType == Type::SPONTANEOUS);
+            runCurrentJob();
 
-                if (m_runnableJob) {
-#ifdef DEBUG_JOBS_SEQUENCE
-                    if (m_atomicType == Type::STROKE) {
-                        qDebug() << "running: stroke" << m_runnableJob->debugName();
-                    } else if (m_atomicType == Type::SPONTANEOUS) {
-                        qDebug() << "running: spont " << m_runnableJob->debugName();
-                    } else {
-                        qDebug() << "running: unkn. " << m_runnableJob->debugName();
-                    }
-#endif
-
-                    m_runnableJob->run();
-                }
-            }
+            // the job is not finished until all its subtasks are done
+            m_subtasks.wait();
 
             setDone();
 
@@ -119,6 +107,40 @@ private:
         }
     }
 
+    ALWAYS_INLINE void runCurrentJob() {
+        /**
+         * The job may split itself into subtasks (see spawnSubtask()),
+         * which are executed by the idle workers of the context
+         */
+        KisTaskGroup::CurrentGroupScope subtasksScope(&m_subtasks);
+
+        if(m_atomicType == Type::MERGE) {
+            KIS_TRACE_SCOPE("updater", "merge job");
+            runMergeJob();
+        } else {
+            KIS_ASSERT(m_atomicType == Type::STROKE ||
+                       m_atomicType == Type::SPONTANEOUS);
+
+            if (m_runnableJob) {
+#ifdef DEBUG_JOBS_SEQUENCE
+                if (m_atomicType == Type::STROKE) {
+                    qDebug() << "running: stroke" << m_runnableJob->debugName();
+                } else if (m_atomicType == Type::SPONTANEOUS) {
+                    qDebug() << "running: spont " << m_runnableJob->debugName();
+                } else {
+                    qDebug() << "running: unkn. " << m_runnableJob->debugName();
+                }
+#endif
+
+                KIS_TRACE_SCOPE("updater",
+                                m_atomicType == Type::STROKE ?
+                                    "stroke job" : "spontaneous job");
+
+                m_runnableJob->run();
+            }
+        }
+    }
+
 public:
 
     inline void runMergeJob() {
@@ -132,12 +154,24 @@ public:
 
 #endif
 
+        m_merger.setUseBelowStackCache(m_updaterContext->useBelowStackCache());
+        m_merger.setRecalculateChildrenInParallel(m_updaterContext->recalculateChildrenInParallel());
         m_merger.startMerge(*m_walker);
 
         QRect changeRect = m_walker->changeRect();
         m_updaterContext->continueUpdate(changeRect);
     }
 
+    /**
+     * Runs \p func as a part of the currently executed job. The
+     * subtask may be picked up by any idle worker of the context,
+     * the job is considered finished only when all its subtasks
+     * are completed.
+     */
+    inline void spawnSubtask(std::function<void()> func) {
+        m_subtasks.run(std::move(func));
+    }
+
     // return true if the thread should actually be started
     inline bool setWalker(KisBaseRectsWalkerSP walker) {
         KIS_ASSERT(m_atomicType <= Type::WAITING);
@@ -253,6 +287,11 @@ private:
     KisBaseRectsWalkerSP m_walker;
     KisAsyncMerger m_merger;
 
+    /**
+     * Subtasks spawned by the currently running job
+     */
+    KisTaskGroup m_subtasks;
+
     /**
      * These rects cache actual values from the walker
      * to eliminate concurrent access to a walker structure
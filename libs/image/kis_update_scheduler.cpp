@@ -40,7 +40,9 @@ struct Q_DECL_HIDDEN KisUpdateScheduler::Private {
         : q(_q)
         , updaterContext(KisImageConfig(true).maxNumberOfThreads(), q)
         , projectionUpdateListener(p)
-    {}
+    {
+        updatesQueue.setCostEstimator(&updaterContext.costEstimator());
+    }
 
     KisUpdateScheduler *q;
 
@@ -97,6 +99,26 @@ void KisUpdateScheduler::setThreadsLimit(int value)
     unlock(false);
 }
 
+void KisUpdateScheduler::setUseTileAffinity(bool value)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!m_d->processingBlocked);
+
+    {
+        std::lock_guard<KisUpdaterContext> l(m_d->updaterContext);
+        if (m_d->updaterContext.useTileAffinity() == value) return;
+    }
+
+    /**
+     * The same as for the threads limit, we should just ensure
+     * there is no more jobs in the updater context
+     */
+    immediateLockForReadOnly();
+    m_d->updaterContext.lock();
+    m_d->updaterContext.setUseTileAffinity(value);
+    m_d->updaterContext.unlock();
+    unlock(false);
+}
+
 int KisUpdateScheduler::threadsLimit() const
 {
     std::lock_guard<KisUpdaterContext> l(m_d->updaterContext);
@@ -174,6 +196,12 @@ void KisUpdateScheduler::fullRefreshAsyncNoFilthy(KisNodeSP root, const QVector<
     processQueues();
 }
 
+void KisUpdateScheduler::fullRefreshAsync(const KisBatchNodeUpdate &update, const QRect &cropRect)
+{
+    m_d->updatesQueue.addBatchRefreshJob(update, cropRect, currentLevelOfDetail());
+    processQueues();
+}
+
 void KisUpdateScheduler::fullRefresh(KisNodeSP root, const QRect& rc, const QRect &cropRect)
 {
     KisBaseRectsWalkerSP walker = new KisFullRefreshWalker(cropRect);
@@ -313,7 +341,12 @@ void KisUpdateScheduler::updateSettings()
     m_d->updatesQueue.updateSettings();
     KisImageConfig config(true);
     m_d->defaultBalancingRatio = config.schedulerBalancingRatio();
+    m_d->updaterContext.setUseBelowStackCache(config.useBelowStackCache());
+    m_d->updaterContext.setRecalculateChildrenInParallel(config.recalculateChildrenInParallel());
+    m_d->strokesQueue.setReservedInteractiveSlots(config.strokesReservedInteractiveSlots());
+    m_d->strokesQueue.setSpeculativeLod0Budget(config.speculativeLod0Budget());
     setThreadsLimit(config.maxNumberOfThreads());
+    setUseTileAffinity(config.updaterTileAffinity());
 }
 
 void KisUpdateScheduler::immediateLockForReadOnly()
@@ -21,6 +21,7 @@ class KoProgressProxy;
 class KisProjectionUpdateListener;
 class KisSpontaneousJob;
 class KisPostExecutionUndoAdapter;
+class KisBatchNodeUpdate;
 
 
 class KRITAIMAGE_EXPORT KisUpdateScheduler : public QObject, public KisStrokesFacade
@@ -41,6 +42,14 @@ public:
      */
     int threadsLimit() const;
 
+    /**
+     * Enable mapping of the merge jobs to the threads by the tile
+     * coordinates of their rects
+     *
+     * \see KisUpdaterContext::setUseTileAffinity()
+     */
+    void setUseTileAffinity(bool value);
+
     /**
      * Sets the proxy that is going to be notified about the progress
      * of processing of the queues. If you want to switch the proxy
@@ -130,6 +139,7 @@ public:
     void updateProjectionNoFilthy(KisNodeSP node, const QRect& rc, const QRect &cropRect);
     void fullRefreshAsync(KisNodeSP root, const QVector<QRect>& rc, const QRect &cropRect);
     void fullRefreshAsyncNoFilthy(KisNodeSP root, const QVector<QRect>& rects, const QRect &cropRect);
+    void fullRefreshAsync(const KisBatchNodeUpdate &update, const QRect &cropRect);
     void fullRefresh(KisNodeSP root, const QRect& rc, const QRect &cropRect);
     void addSpontaneousJob(KisSpontaneousJob *spontaneousJob);
 
@@ -7,10 +7,10 @@
 #include "kis_updater_context.h"
 
 #include <QThread>
-#include <QThreadPool>
 
 #include "kis_update_job_item.h"
 #include "kis_stroke_job.h"
+#include "tiles3/kis_tile_data.h"
 
 const int KisUpdaterContext::useIdealThreadCountTag = -1;
 
@@ -27,7 +27,7 @@ KisUpdaterContext::KisUpdaterContext(qint32 threadCount, KisUpdateScheduler *par
 
 KisUpdaterContext::~KisUpdaterContext()
 {
-    m_threadPool.waitForDone();
+    m_executor.waitForDone();
 
     if (m_testingMode) {
         clear();
@@ -124,7 +124,11 @@ void KisUpdaterContext::startThread(int index)
         m_numRunningThreads++;
     }
 
-    m_threadPool.start(m_jobs[index]);
+    if (m_useTileAffinity) {
+        m_executor.start(m_jobs[index], index);
+    } else {
+        m_executor.start(m_jobs[index]);
+    }
 }
 
 /**
@@ -138,7 +142,8 @@ void KisUpdaterContext::startThread(int index)
 void KisUpdaterContext::addMergeJob(KisBaseRectsWalkerSP walker)
 {
     m_lodCounter.addLod(walker->levelOfDetail());
-    qint32 jobIndex = findSpareThread();
+    qint32 jobIndex = m_useTileAffinity ?
+        findAffineSpareThread(walker->requestedRect()) : findSpareThread();
     Q_ASSERT(jobIndex >= 0);
 
     const bool shouldStartThread = m_jobs[jobIndex]->setWalker(walker);
@@ -210,6 +215,30 @@ qint32 KisUpdaterContext::findSpareThread()
     return -1;
 }
 
+qint32 KisUpdaterContext::findAffineSpareThread(const QRect &rc)
+{
+    /**
+     * Every thread is bound to its own worker, so the rects are
+     * mapped to the workers by the tile containing their center
+     */
+    auto floorDiv = [] (int value, int divisor) {
+        return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+    };
+
+    const QPoint center = rc.center();
+    const int col = floorDiv(center.x(), KisTileData::WIDTH);
+    const int row = floorDiv(center.y(), KisTileData::HEIGHT);
+
+    const quint32 hash = quint32(col) * 73856093U ^ quint32(row) * 19349663U;
+    const qint32 index = hash % quint32(m_jobs.size());
+
+    /**
+     * If the thread is busy, prefer starting the job right away to
+     * waiting for the thread
+     */
+    return !m_jobs[index]->isRunning() ? index : findSpareThread();
+}
+
 void KisUpdaterContext::lock()
 {
     m_lock.lock();
@@ -222,7 +251,7 @@ void KisUpdaterContext::unlock()
 
 void KisUpdaterContext::setThreadsLimit(int value)
 {
-    m_threadPool.setMaxThreadCount(value);
+    m_executor.setMaxThreadCount(value);
 
     for (int i = 0; i < m_jobs.size(); i++) {
         KIS_SAFE_ASSERT_RECOVER_RETURN(!m_jobs[i]->isRunning());
@@ -242,10 +271,50 @@ void KisUpdaterContext::setThreadsLimit(int value)
 
 int KisUpdaterContext::threadsLimit() const
 {
-    KIS_SAFE_ASSERT_RECOVER_NOOP(m_jobs.size() == m_threadPool.maxThreadCount());
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_jobs.size() == m_executor.maxThreadCount());
     return m_jobs.size();
 }
 
+KisUpdateCostEstimator& KisUpdaterContext::costEstimator()
+{
+    return m_costEstimator;
+}
+
+void KisUpdaterContext::setUseBelowStackCache(bool value)
+{
+    m_useBelowStackCache = value;
+}
+
+bool KisUpdaterContext::useBelowStackCache() const
+{
+    return m_useBelowStackCache;
+}
+
+void KisUpdaterContext::setRecalculateChildrenInParallel(bool value)
+{
+    m_recalculateChildrenInParallel = value;
+}
+
+bool KisUpdaterContext::recalculateChildrenInParallel() const
+{
+    return m_recalculateChildrenInParallel;
+}
+
+void KisUpdaterContext::setUseTileAffinity(bool value)
+{
+    for (int i = 0; i < m_jobs.size(); i++) {
+        KIS_SAFE_ASSERT_RECOVER_RETURN(!m_jobs[i]->isRunning());
+    }
+
+    m_executor.setBindWorkersToNumaNodes(value);
+    m_useTileAffinity = value;
+}
+
+bool KisUpdaterContext::useTileAffinity() const
+{
+    return m_useTileAffinity;
+}
+
 void KisUpdaterContext::continueUpdate(const QRect& rc)
 {
     if (m_scheduler) m_scheduler->continueUpdate(rc);
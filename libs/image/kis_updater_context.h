@@ -7,9 +7,10 @@
 #ifndef __KIS_UPDATER_CONTEXT_H
 #define __KIS_UPDATER_CONTEXT_H
 
+#include <atomic>
+
 #include <QMutex>
 #include <QReadWriteLock>
-#include <QThreadPool>
 #include <QWaitCondition>
 
 #include "kis_base_rects_walker.h"
@@ -17,6 +18,8 @@
 #include "kis_lock_free_lod_counter.h"
 
 #include "KisUpdaterContextSnapshotEx.h"
+#include "KisWorkStealingExecutor.h"
+#include "KisUpdateCostEstimator.h"
 #include "kis_update_scheduler.h"
 
 class KisUpdateJobItem;
@@ -127,6 +130,38 @@ public:
      */
     int threadsLimit() const;
 
+    /**
+     * The estimator collects the time spent by the merge jobs
+     * executed in this context
+     */
+    KisUpdateCostEstimator& costEstimator();
+
+    /**
+     * Enables caching of the layers lying below the updated
+     * one in the merge jobs (see KisBelowStackCache)
+     */
+    void setUseBelowStackCache(bool value);
+    bool useBelowStackCache() const;
+
+    /**
+     * Enables concurrent recalculation of the children of the
+     * groups in the merge jobs (see KisAsyncMerger)
+     */
+    void setRecalculateChildrenInParallel(bool value);
+    bool recalculateChildrenInParallel() const;
+
+    /**
+     * Enables the tile affinity mode. In this mode the merge jobs are
+     * distributed over the threads according to the tile coordinates
+     * of their rects, so consecutive updates of the same region are
+     * executed by the same thread and find the tiles in its cache.
+     * The threads are also bound to the NUMA nodes of the machine.
+     *
+     * The same rules as for setThreadsLimit() apply.
+     */
+    void setUseTileAffinity(bool value);
+    bool useTileAffinity() const;
+
     void continueUpdate(const QRect& rc);
     void doSomeUsefulWork();
     void jobFinished();
@@ -138,6 +173,7 @@ protected:
     static bool walkerIntersectsJob(KisBaseRectsWalkerSP walker,
                                     const KisUpdateJobItem* job);
     qint32 findSpareThread();
+    qint32 findAffineSpareThread(const QRect &rc);
 
 protected:
     /**
@@ -153,8 +189,12 @@ protected:
     int m_numRunningThreads = 0;
     QWaitCondition m_waitForDoneCondition;
     QVector<KisUpdateJobItem*> m_jobs;
-    QThreadPool m_threadPool;
+    KisWorkStealingExecutor m_executor;
     KisLockFreeLodCounter m_lodCounter;
+    KisUpdateCostEstimator m_costEstimator;
+    std::atomic<bool> m_useBelowStackCache {false};
+    std::atomic<bool> m_recalculateChildrenInParallel {false};
+    bool m_useTileAffinity = false;
     KisUpdateScheduler *m_scheduler;
     bool m_testingMode = false;
 
@@ -0,0 +1,151 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisLayerStyleTileCache.h"
+
+#include <KoColor.h>
+#include <KisRegion.h>
+
+#include "kis_paint_device.h"
+#include "kis_datamanager.h"
+
+
+namespace {
+inline qint32 floorDiv(qint32 value, qint32 divisor)
+{
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+inline quint64 tileKey(qint32 col, qint32 row)
+{
+    return (quint64(quint32(col)) << 32) | quint32(row);
+}
+
+inline void hashCombine(quint64 &seed, quint64 value)
+{
+    seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 12) + (seed >> 4);
+}
+}
+
+KisLayerStyleTileCache::KisLayerStyleTileCache()
+{
+}
+
+KisLayerStyleTileCache::~KisLayerStyleTileCache()
+{
+}
+
+QVector<QRect> KisLayerStyleTileCache::takeDirtyRects(const QRect &rect,
+                                                      KisPaintDeviceSP source,
+                                                      const QRect &defaultBounds,
+                                                      const NeedRectFunction &needRect)
+{
+    QVector<QRect> dirtyRects;
+    if (rect.isEmpty()) return dirtyRects;
+
+    const quint64 newSourceKey = sourceKey(source, defaultBounds);
+    const QPoint sourceOffset(source->x(), source->y());
+    KisDataManagerSP dataManager = source->dataManager();
+
+    QMutexLocker l(&m_mutex);
+
+    if (newSourceKey != m_sourceKey) {
+        m_tileRevisions.clear();
+        m_sourceKey = newSourceKey;
+    }
+
+    const qint32 firstCol = floorDiv(rect.left(), TileSize);
+    const qint32 lastCol = floorDiv(rect.right(), TileSize);
+    const qint32 firstRow = floorDiv(rect.top(), TileSize);
+    const qint32 lastRow = floorDiv(rect.bottom(), TileSize);
+
+    bool hasValidTiles = false;
+
+    for (qint32 row = firstRow; row <= lastRow; row++) {
+        for (qint32 col = firstCol; col <= lastCol; col++) {
+            const QRect tileRect(col * TileSize, row * TileSize, TileSize, TileSize);
+            const QRect dirtyRect = tileRect & rect;
+            const bool isCompleteTile = dirtyRect == tileRect;
+
+            auto it = m_tileRevisions.find(tileKey(col, row));
+
+            /**
+             * A tile which is not covered completely can be reused,
+             * but cannot become valid, so we shouldn't even bother
+             * fetching the revision for it
+             */
+            if (it == m_tileRevisions.end() && !isCompleteTile) {
+                dirtyRects.append(dirtyRect);
+                continue;
+            }
+
+            const quint64 revision =
+                dataManager->contentRevision(needRect(tileRect).translated(-sourceOffset));
+
+            if (it != m_tileRevisions.end() && *it == revision) {
+                hasValidTiles = true;
+                continue;
+            }
+
+            if (isCompleteTile) {
+                m_tileRevisions.insert(tileKey(col, row), revision);
+            } else {
+                m_tileRevisions.erase(it);
+            }
+
+            dirtyRects.append(dirtyRect);
+        }
+    }
+
+    /**
+     * Every call to the filter processes the needed rect around the
+     * dirty one, so we should pass as few rects as possible
+     */
+    if (!hasValidTiles) {
+        dirtyRects.clear();
+        dirtyRects.append(rect);
+    } else if (!dirtyRects.isEmpty()) {
+        auto endIt = KisRegion::mergeSparseRects(dirtyRects.begin(), dirtyRects.end());
+        dirtyRects.erase(endIt, dirtyRects.end());
+    }
+
+    return dirtyRects;
+}
+
+void KisLayerStyleTileCache::invalidate()
+{
+    QMutexLocker l(&m_mutex);
+    m_tileRevisions.clear();
+    m_sourceKey = 0;
+}
+
+int KisLayerStyleTileCache::numValidTiles() const
+{
+    QMutexLocker l(&m_mutex);
+    return m_tileRevisions.size();
+}
+
+quint64 KisLayerStyleTileCache::sourceKey(KisPaintDeviceSP source, const QRect &defaultBounds)
+{
+    quint64 key = quint64(reinterpret_cast<quintptr>(source->colorSpace()));
+
+    hashCombine(key, quint32(source->x()));
+    hashCombine(key, quint32(source->y()));
+
+    hashCombine(key, quint32(defaultBounds.x()));
+    hashCombine(key, quint32(defaultBounds.y()));
+    hashCombine(key, quint32(defaultBounds.width()));
+    hashCombine(key, quint32(defaultBounds.height()));
+
+    const KoColor defaultPixel = source->defaultPixel();
+    const int pixelSize = source->pixelSize();
+
+    for (int i = 0; i < pixelSize; i++) {
+        hashCombine(key, defaultPixel.data()[i]);
+    }
+
+    return key;
+}
@@ -0,0 +1,81 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISLAYERSTYLETILECACHE_H
+#define KISLAYERSTYLETILECACHE_H
+
+#include <functional>
+
+#include <QHash>
+#include <QMutex>
+#include <QRect>
+#include <QVector>
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+
+/**
+ * Keeps track of which parts of a layer style projection are still
+ * up-to-date with the source device.
+ *
+ * The projection of a style filter is split into square tiles. For
+ * every calculated tile the cache remembers the content revision of
+ * the source pixels the tile depends on, that is, of its needed rect
+ * (see KisTiledDataManager::contentRevision()). When the style is
+ * asked to recalculate a rect, only the tiles whose source has
+ * changed since the last calculation are returned to the caller, the
+ * rest of the projection is reused as it is.
+ *
+ * It means that the style doesn't have to re-blur the whole need-rect
+ * when the update rect is bigger than the actually changed area of the
+ * source, e.g. when the updates are merged by the queue, split into
+ * patches, or when the layer is updated because of a change of its
+ * opacity or visibility.
+ *
+ * The cache is valid only for the filters whose result depends on the
+ * source pixels in the needed rect only, see
+ * KisLayerStyleFilter::supportsTileCaching().
+ */
+class KRITAIMAGE_EXPORT KisLayerStyleTileCache
+{
+public:
+    static const int TileSize = 64;
+
+    using NeedRectFunction = std::function<QRect (const QRect&)>;
+
+public:
+    KisLayerStyleTileCache();
+    ~KisLayerStyleTileCache();
+
+    /**
+     * Returns the parts of \p rect that should be recalculated from
+     * \p source. The tiles which are completely covered by \p rect are
+     * considered to be valid after the call, so the caller must
+     * recalculate all the returned rects.
+     *
+     * \p needRect maps a rect of the projection to the rect of the
+     * source it depends on. \p defaultBounds are the bounds of the
+     * image, the cache is reset when they change.
+     */
+    QVector<QRect> takeDirtyRects(const QRect &rect,
+                                  KisPaintDeviceSP source,
+                                  const QRect &defaultBounds,
+                                  const NeedRectFunction &needRect);
+
+    void invalidate();
+
+    int numValidTiles() const;
+
+private:
+    static quint64 sourceKey(KisPaintDeviceSP source, const QRect &defaultBounds);
+
+private:
+    mutable QMutex m_mutex;
+    quint64 m_sourceKey = 0;
+    QHash<quint64, quint64> m_tileRevisions;
+};
+
+#endif // KISLAYERSTYLETILECACHE_H
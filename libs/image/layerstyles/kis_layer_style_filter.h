@@ -51,6 +51,16 @@ public:
      */
     virtual QRect changedRect(const QRect & rect, KisPSDLayerStyleSP style, KisLayerStyleFilterEnvironment *env) const = 0;
 
+    /**
+     * \return true if the result of the filter in a rect depends on the
+     * pixels of the source device inside neededRect() of this rect only,
+     * but not on the bounds of the layer or anything else. The result
+     * of such filters is reused until the source pixels change.
+     *
+     * \see KisLayerStyleTileCache
+     */
+    virtual bool supportsTileCaching(KisPSDLayerStyleSP style) const;
+
 protected:
     KisLayerStyleFilter(const KisLayerStyleFilter &rhs);
 
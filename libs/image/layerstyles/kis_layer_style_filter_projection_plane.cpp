@@ -17,13 +17,16 @@
 #include "kis_painter.h"
 #include "kis_multiple_projection.h"
 #include "KisLayerStyleKnockoutBlower.h"
+#include "KisLayerStyleTileCache.h"
+#include "kis_image_config.h"
 
 
 struct KisLayerStyleFilterProjectionPlane::Private
 {
     Private(KisLayer *_sourceLayer)
         : sourceLayer(_sourceLayer),
-          environment(new KisLayerStyleFilterEnvironment(_sourceLayer))
+          environment(new KisLayerStyleFilterEnvironment(_sourceLayer)),
+          useTileCache(KisImageConfig(true).useLayerStyleTileCache())
     {
         KIS_SAFE_ASSERT_RECOVER_NOOP(_sourceLayer);
     }
@@ -34,7 +37,8 @@ struct KisLayerStyleFilterProjectionPlane::Private
           style(clonedStyle),
           environment(new KisLayerStyleFilterEnvironment(_sourceLayer)),
           knockoutBlower(rhs.knockoutBlower),
-          projection(rhs.projection)
+          projection(rhs.projection),
+          useTileCache(rhs.useTileCache)
     {
         KIS_SAFE_ASSERT_RECOVER_NOOP(_sourceLayer);
     }
@@ -48,8 +52,36 @@ struct KisLayerStyleFilterProjectionPlane::Private
     KisLayerStyleKnockoutBlower knockoutBlower;
 
     KisMultipleProjection projection;
+
+    /**
+     * The cloned plane has a different source device, so the
+     * tile cache is never copied
+     */
+    KisLayerStyleTileCache tileCache;
+    bool useTileCache = true;
+
+    QVector<QRect> dirtyRects(const QRect &rect, KisPaintDeviceSP source);
 };
 
+QVector<QRect> KisLayerStyleFilterProjectionPlane::Private::dirtyRects(const QRect &rect, KisPaintDeviceSP source)
+{
+    /**
+     * The cache tracks the revisions of the source in LoD0 only,
+     * the preview of a LoD stroke is always calculated from scratch
+     */
+    if (!useTileCache ||
+        environment->currentLevelOfDetail() > 0 ||
+        !filter->supportsTileCaching(style)) {
+
+        return {rect};
+    }
+
+    return tileCache.takeDirtyRects(rect, source, environment->defaultBounds(),
+                                    [this] (const QRect &rc) {
+                                        return filter->neededRect(rc, style, environment.data());
+                                    });
+}
+
 KisLayerStyleFilterProjectionPlane::
 KisLayerStyleFilterProjectionPlane(KisLayer *sourceLayer)
     : m_d(new Private(sourceLayer))
@@ -69,6 +101,7 @@ void KisLayerStyleFilterProjectionPlane::setStyle(KisLayerStyleFilter *filter, K
 {
     m_d->filter.reset(filter);
     m_d->style = style;
+    m_d->tileCache.invalidate();
 }
 
 QRect KisLayerStyleFilterProjectionPlane::recalculate(const QRect& rect, KisNodeSP filthyNode)
@@ -80,13 +113,18 @@ QRect KisLayerStyleFilterProjectionPlane::recalculate(const QRect& rect, KisNode
         return QRect();
     }
 
-    m_d->projection.clear(rect);
-    m_d->filter->processDirectly(m_d->sourceLayer->projection(),
-                                 &m_d->projection,
-                                 &m_d->knockoutBlower,
-                                 rect,
-                                 m_d->style,
-                                 m_d->environment.data());
+    KisPaintDeviceSP source = m_d->sourceLayer->projection();
+
+    Q_FOREACH (const QRect &dirtyRect, m_d->dirtyRects(rect, source)) {
+        m_d->projection.clear(dirtyRect);
+        m_d->filter->processDirectly(source,
+                                     &m_d->projection,
+                                     &m_d->knockoutBlower,
+                                     dirtyRect,
+                                     m_d->style,
+                                     m_d->environment.data());
+    }
+
     return rect;
 }
 
@@ -504,3 +504,12 @@ QRect KisLsBevelEmbossFilter::changedRect(const QRect &rect, KisPSDLayerStyleSP
     BevelEmbossRectCalculator d(rect, w.config);
     return d.totalChangeRect(rect, w.config);
 }
+
+bool KisLsBevelEmbossFilter::supportsTileCaching(KisPSDLayerStyleSP style) const
+{
+    const psd_layer_effects_bevel_emboss *config = style->bevelAndEmboss();
+
+    // the texture aligned with the layer depends on the layer's bounds
+    return config->effectEnabled() &&
+        !(config->textureEnabled() && config->textureAlignWithLayer());
+}
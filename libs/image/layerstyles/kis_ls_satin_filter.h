@@ -31,6 +31,8 @@ public:
     QRect neededRect(const QRect & rect, KisPSDLayerStyleSP style, KisLayerStyleFilterEnvironment *env) const override;
     QRect changedRect(const QRect & rect, KisPSDLayerStyleSP style, KisLayerStyleFilterEnvironment *env) const override;
 
+    bool supportsTileCaching(KisPSDLayerStyleSP style) const override;
+
 private:
     KisLsSatinFilter(const KisLsSatinFilter &rhs);
 
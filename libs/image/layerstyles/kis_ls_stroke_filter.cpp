@@ -162,6 +162,15 @@ QRect KisLsStrokeFilter::changedRect(const QRect &rect, KisPSDLayerStyleSP style
     return neededRect(rect, style, env);
 }
 
+bool KisLsStrokeFilter::supportsTileCaching(KisPSDLayerStyleSP style) const
+{
+    const psd_layer_effects_stroke *config = style->stroke();
+
+    // the fill aligned with the layer depends on the layer's bounds
+    return config->effectEnabled() &&
+        (config->fillType() == psd_fill_solid_color || !config->alignWithLayer());
+}
+
 KritaUtils::ThresholdMode KisLsStrokeFilter::sourcePlaneOpacityThresholdRequirement(KisPSDLayerStyleSP style) const
 {
     const psd_layer_effects_stroke *config = style->stroke();
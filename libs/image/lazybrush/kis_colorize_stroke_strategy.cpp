@@ -88,6 +88,7 @@ KisColorizeStrokeStrategy::KisColorizeStrokeStrategy(KisPaintDeviceSP src,
     setNeedsExplicitCancel(true);
     setRequestsOtherStrokesToEnd(false);
     setClearsRedoOnStart(false);
+    setPriority(KisStrokeStrategy::PREVIEW);
 }
 
 KisColorizeStrokeStrategy::KisColorizeStrokeStrategy(const KisColorizeStrokeStrategy &rhs, int levelOfDetail)
@@ -13,6 +13,7 @@
 #include <simpletest.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorSpace.h>
+#include <KoColor.h>
 #include "kis_image.h"
 #include "kis_paint_layer.h"
 #include "kis_group_layer.h"
@@ -30,6 +31,9 @@
 #include "../../sdk/tests/testutil.h"
 
 #include "kis_image_config.h"
+#include "KisWorkStealingExecutor.h"
+
+#include <QRunnable>
 #include "KisImageConfigNotifier.h"
 
 void KisAsyncMergerTest::init()
@@ -497,5 +501,198 @@ void KisAsyncMergerTest::testFilterMaskOnFilterLayer()
 }
 
 
+    /*
+      +-----------+
+      |root       |
+      | paint 4   |
+      | paint 3   |
+      | paint 2   |
+      | paint 1   |
+      +-----------+
+     */
+
+void KisAsyncMergerTest::testBelowStackCache()
+{
+    const KoColorSpace * colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 640, 441, colorSpace, "merger test");
+    const QRect cropRect(image->bounds());
+
+    KisPaintLayerSP paintLayer1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    KisPaintLayerSP paintLayer2 = new KisPaintLayer(image, "paint2", 128);
+    KisPaintLayerSP paintLayer3 = new KisPaintLayer(image, "paint3", 200);
+    KisPaintLayerSP paintLayer4 = new KisPaintLayer(image, "paint4", 100);
+
+    image->addNode(paintLayer1, image->rootLayer());
+    image->addNode(paintLayer2, image->rootLayer());
+    image->addNode(paintLayer3, image->rootLayer());
+    image->addNode(paintLayer4, image->rootLayer());
+    image->waitForDone();
+
+    paintLayer1->paintDevice()->fill(QRect(0,0,640,441), KoColor(Qt::red, colorSpace));
+    paintLayer2->paintDevice()->fill(QRect(100,100,300,200), KoColor(Qt::green, colorSpace));
+    paintLayer4->paintDevice()->fill(QRect(200,0,100,441), KoColor(Qt::white, colorSpace));
+
+    KisAsyncMerger merger;
+    merger.setUseBelowStackCache(true);
+
+    KisAsyncMerger referenceMerger;
+
+    /**
+     * Merges the update with the cache enabled and compares the result
+     * with a full refresh of the image made without the cache
+     */
+    auto mergeMatchesReference = [&] (KisNodeSP node, const QRect &rc) {
+        KisMergeWalker walker(cropRect);
+        walker.collectRects(node, rc);
+        merger.startMerge(walker);
+
+        const QImage result = image->projection()->convertToQImage(0);
+
+        KisFullRefreshWalker refreshWalker(cropRect);
+        refreshWalker.collectRects(image->rootLayer(), cropRect);
+        referenceMerger.startMerge(refreshWalker);
+
+        return result == image->projection()->convertToQImage(0);
+    };
+
+    const QRect strokeRect(50,50,200,200);
+
+    // fills the cache
+    paintLayer3->paintDevice()->fill(strokeRect, KoColor(Qt::blue, colorSpace));
+    QVERIFY(mergeMatchesReference(paintLayer3, strokeRect));
+
+    // uses the cache
+    paintLayer3->paintDevice()->fill(strokeRect, KoColor(Qt::yellow, colorSpace));
+    QVERIFY(mergeMatchesReference(paintLayer3, strokeRect));
+
+    /**
+     * The lower layers are not read while the cache is valid, so
+     * their changes that have not been merged yet are not visible
+     */
+    paintLayer2->paintDevice()->fill(strokeRect, KoColor(Qt::black, colorSpace));
+    paintLayer3->paintDevice()->fill(strokeRect, KoColor(Qt::cyan, colorSpace));
+    QVERIFY(!mergeMatchesReference(paintLayer3, strokeRect));
+
+    // the update of the lower layer resets the cache
+    QVERIFY(mergeMatchesReference(paintLayer2, strokeRect));
+    QVERIFY(mergeMatchesReference(paintLayer3, strokeRect));
+
+    // the cache is built for the layers below paint 4 now
+    paintLayer4->paintDevice()->fill(strokeRect, KoColor(Qt::magenta, colorSpace));
+    QVERIFY(mergeMatchesReference(paintLayer4, strokeRect));
+    QVERIFY(mergeMatchesReference(paintLayer4, strokeRect));
+
+    // hide one of the cached layers
+    paintLayer3->setVisible(false);
+    image->waitForDone();
+
+    QVERIFY(mergeMatchesReference(paintLayer3, strokeRect));
+    QVERIFY(mergeMatchesReference(paintLayer4, strokeRect));
+}
+
+/*
+  +---------------+
+  |root           |
+  | group         |
+  |  paint 4      |
+  |   blur_mask 4 |
+  |  invert       |
+  |  clone of 2   |
+  |  paint 3      |
+  |   blur_mask 3 |
+  |  paint 2      |
+  |   blur_mask 2 |
+  | paint 1       |
+  +---------------+
+ */
+
+void KisAsyncMergerTest::testRecalculateChildrenInParallel()
+{
+    const KoColorSpace * colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 640, 441, colorSpace, "merger test");
+    const QRect cropRect(image->bounds());
+
+    KisFilterSP blurFilter = KisFilterRegistry::instance()->value("blur");
+    KisFilterConfigurationSP blurConfig = blurFilter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+
+    KisFilterSP invertFilter = KisFilterRegistry::instance()->value("invert");
+    KisFilterConfigurationSP invertConfig = invertFilter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+
+    KisPaintLayerSP paintLayer1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    KisGroupLayerSP groupLayer = new KisGroupLayer(image, "group", OPACITY_OPAQUE_U8);
+
+    image->addNode(paintLayer1, image->rootLayer());
+    image->addNode(groupLayer, image->rootLayer());
+
+    paintLayer1->paintDevice()->fill(cropRect, KoColor(Qt::white, colorSpace));
+
+    QVector<KisPaintLayerSP> paintLayers;
+
+    for (int i = 2; i <= 4; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("paint%1").arg(i), 200);
+        layer->paintDevice()->fill(QRect(i * 100, i * 50, 150, 200), KoColor(QColor::fromHsv(i * 90, 255, 255), colorSpace));
+
+        KisFilterMaskSP mask = new KisFilterMask(image, QString("blur_mask%1").arg(i));
+        mask->initSelection(layer);
+        mask->setFilter(blurConfig->cloneWithResourcesSnapshot());
+
+        image->addNode(layer, groupLayer);
+        image->addNode(mask, layer);
+
+        paintLayers << layer;
+
+        if (i == 3) {
+            KisLayerSP cloneLayer = new KisCloneLayer(paintLayers.first(), image, "clone_of_2", OPACITY_OPAQUE_U8);
+            cloneLayer->setX(20);
+            image->addNode(cloneLayer, groupLayer);
+
+            KisLayerSP invertLayer = new KisAdjustmentLayer(image, "invert", invertConfig->cloneWithResourcesSnapshot(), 0);
+            image->addNode(invertLayer, groupLayer);
+        }
+    }
+
+    image->waitForDone();
+
+    KisAsyncMerger referenceMerger;
+
+    KisFullRefreshWalker referenceWalker(cropRect);
+    referenceWalker.collectRects(image->rootLayer(), cropRect);
+    referenceMerger.startMerge(referenceWalker);
+    const QImage reference = image->projection()->convertToQImage(0);
+
+    image->projection()->clear();
+
+    /**
+     * Run the merger inside the executor to make the
+     * subtasks actually executed in parallel
+     */
+    struct MergeRunnable : public QRunnable {
+        MergeRunnable(KisImageSP image, const QRect &cropRect)
+            : m_image(image), m_cropRect(cropRect)
+        {
+        }
+
+        void run() override {
+            KisAsyncMerger merger;
+            merger.setRecalculateChildrenInParallel(true);
+
+            KisFullRefreshWalker walker(m_cropRect);
+            walker.collectRects(m_image->rootLayer(), m_cropRect);
+            merger.startMerge(walker);
+        }
+
+        KisImageSP m_image;
+        QRect m_cropRect;
+    };
+
+    KisWorkStealingExecutor executor;
+    executor.setMaxThreadCount(4);
+    executor.start(new MergeRunnable(image, cropRect));
+    executor.waitForDone();
+
+    QPoint pt;
+    QVERIFY(TestUtil::compareQImages(pt, image->projection()->convertToQImage(0), reference));
+}
+
 SIMPLE_TEST_MAIN(KisAsyncMergerTest)
 
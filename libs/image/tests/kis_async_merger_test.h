@@ -29,6 +29,10 @@ private Q_SLOTS:
 
     void testFilterMaskOnFilterLayer();
 
+    void testBelowStackCache();
+
+    void testRecalculateChildrenInParallel();
+
 };
 
 #endif /* KIS_ASYNC_MERGER_TEST_H */
@@ -1296,4 +1296,139 @@ void KisImageTest::testPaintOverlayMask()
     KIS_DUMP_DEVICE_2(p.image->projection(), refRect, "03_deactivated", "dd");
 }
 
+#include "kis_processing_applicator.h"
+#include "commands_new/kis_set_layer_style_command.h"
+#include "commands_new/KisUpdateCommandEx.h"
+
+void KisImageTest::testBatchLayerStyleUpdate()
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 300, 300, cs, "batch test");
+
+    KisGroupLayerSP group = new KisGroupLayer(image, "group", OPACITY_OPAQUE_U8);
+    KisPaintLayerSP layer1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    KisPaintLayerSP layer2 = new KisPaintLayer(image, "paint2", OPACITY_OPAQUE_U8);
+    KisPaintLayerSP layer3 = new KisPaintLayer(image, "paint3", OPACITY_OPAQUE_U8);
+
+    layer1->paintDevice()->fill(QRect(50, 50, 100, 100), KoColor(Qt::red, cs));
+    layer2->paintDevice()->fill(QRect(80, 80, 100, 100), KoColor(Qt::blue, cs));
+    layer3->paintDevice()->fill(QRect(120, 120, 100, 100), KoColor(Qt::green, cs));
+
+    layer2->setCompositeOpId(COMPOSITE_ADD);
+
+    image->addNode(group);
+    image->addNode(layer1, group);
+    image->addNode(layer2, group);
+    image->addNode(layer3, group);
+    image->initialRefreshGraph();
+
+    KisPSDLayerStyleSP style(new KisPSDLayerStyle());
+    style->dropShadow()->setEffectEnabled(true);
+    style->dropShadow()->setDistance(10.0);
+    style->dropShadow()->setSpread(80.0);
+    style->dropShadow()->setSize(10);
+    style->dropShadow()->setNoise(0);
+    style->dropShadow()->setKnocksOut(false);
+    style->dropShadow()->setOpacity(80.0);
+
+    KisBatchNodeUpdateSP updateData(new KisBatchNodeUpdate());
+
+    KisCommandUtils::CompositeCommand *cmd = new KisCommandUtils::CompositeCommand();
+    cmd->addCommand(new KisUpdateCommandEx(updateData, image.data(), KisUpdateCommandEx::INITIALIZING));
+    cmd->addCommand(new KisSetLayerStyleCommand(layer1, layer1->layerStyle(), style->clone().dynamicCast<KisPSDLayerStyle>(), updateData));
+    cmd->addCommand(new KisSetLayerStyleCommand(layer3, layer3->layerStyle(), style->clone().dynamicCast<KisPSDLayerStyle>(), updateData));
+    cmd->addCommand(new KisUpdateCommandEx(updateData, image.data(), KisUpdateCommandEx::FINALIZING));
+
+    KisProcessingApplicator::runSingleCommandStroke(image, cmd);
+    image->waitForDone();
+
+    QCOMPARE(int(updateData->size()), 2);
+
+    /**
+     * The batched update should give exactly the same result as
+     * the full refresh of the image
+     */
+    KisPaintDeviceSP batchedProjection = new KisPaintDevice(*image->projection());
+
+    image->refreshGraphAsync();
+    image->waitForDone();
+
+    QPoint pt;
+    if (!TestUtil::comparePaintDevices(pt, batchedProjection, image->projection())) {
+        QFAIL(QString("Batched update differs from the full refresh at %1,%2").arg(pt.x()).arg(pt.y()).toLatin1());
+    }
+}
+
+#include "kis_transaction.h"
+#include "kis_transform_worker.h"
+#include "kis_filter_strategy.h"
+
+void KisImageTest::testBatchTransformUpdate()
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 300, 300, cs, "batch test");
+
+    KisGroupLayerSP group = new KisGroupLayer(image, "group", OPACITY_OPAQUE_U8);
+    KisPaintLayerSP layer1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    KisPaintLayerSP layer2 = new KisPaintLayer(image, "paint2", OPACITY_OPAQUE_U8);
+    KisPaintLayerSP layer3 = new KisPaintLayer(image, "paint3", OPACITY_OPAQUE_U8);
+
+    layer1->paintDevice()->fill(QRect(50, 50, 100, 100), KoColor(Qt::red, cs));
+    layer2->paintDevice()->fill(QRect(80, 80, 100, 100), KoColor(Qt::blue, cs));
+    layer3->paintDevice()->fill(QRect(120, 120, 100, 100), KoColor(Qt::green, cs));
+
+    layer2->setCompositeOpId(COMPOSITE_ADD);
+
+    image->addNode(group);
+    image->addNode(layer1, group);
+    image->addNode(layer2, group);
+    image->addNode(layer3, group);
+    image->initialRefreshGraph();
+
+    /**
+     * Transform two of the layers the way the transform stroke does it:
+     * the commands record their dirty rects into the shared batch and
+     * the finalizing command issues all the updates at once
+     */
+    KisBatchNodeUpdateSP updateData(new KisBatchNodeUpdate());
+
+    auto transformLayer = [updateData] (KisPaintLayerSP layer, qreal angle, qreal dx, qreal dy) {
+        return new KisCommandUtils::LambdaCommand(
+            [updateData, layer, angle, dx, dy] () {
+                KisPaintDeviceSP dev = layer->paintDevice();
+                const QRect oldExtent = dev->extent();
+
+                KisTransaction transaction(dev);
+                KisTransformWorker worker(dev, 1.0, 1.0, 0.0, 0.0, 0.0, 0.0,
+                                          angle, dx, dy, 0,
+                                          KisFilterStrategyRegistry::instance()->get("Bicubic"));
+                worker.run();
+
+                updateData->addUpdate(layer, oldExtent | dev->extent());
+                return transaction.endAndTake();
+            });
+    };
+
+    KisCommandUtils::CompositeCommand *cmd = new KisCommandUtils::CompositeCommand();
+    cmd->addCommand(new KisUpdateCommandEx(updateData, image.data(), KisUpdateCommandEx::INITIALIZING));
+    cmd->addCommand(transformLayer(layer1, 0.3, 20, -10));
+    cmd->addCommand(transformLayer(layer3, -0.2, -30, 15));
+    cmd->addCommand(new KisUpdateCommandEx(updateData, image.data(), KisUpdateCommandEx::FINALIZING));
+
+    KisProcessingApplicator::runSingleCommandStroke(image, cmd);
+    image->waitForDone();
+
+    QCOMPARE(int(updateData->size()), 2);
+
+    KisPaintDeviceSP batchedProjection = new KisPaintDevice(*image->projection());
+
+    image->refreshGraphAsync();
+    image->waitForDone();
+
+    QPoint pt;
+    if (!TestUtil::comparePaintDevices(pt, batchedProjection, image->projection())) {
+        QFAIL(QString("Batched update differs from the full refresh at %1,%2").arg(pt.x()).arg(pt.y()).toLatin1());
+    }
+}
+
 KISTEST_MAIN(KisImageTest)
@@ -47,6 +47,9 @@ private Q_SLOTS:
     void testMergePassThroughOverPaintLayer();
 
     void testPaintOverlayMask();
+
+    void testBatchLayerStyleUpdate();
+    void testBatchTransformUpdate();
 };
 
 #endif
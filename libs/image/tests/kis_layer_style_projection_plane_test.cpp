@@ -25,6 +25,9 @@
 #include "kis_pixel_selection.h"
 
 #include "layerstyles/kis_layer_style_projection_plane.h"
+#include "layerstyles/KisLayerStyleTileCache.h"
+#include "kis_global.h"
+#include <KisRegion.h>
 #include "kis_psd_layer_style.h"
 #include "kis_paint_device_debug_utils.h"
 #include <KisGlobalResourcesInterface.h>
@@ -659,4 +662,124 @@ void KisLayerStyleProjectionPlaneTest::testBlending()
     KIS_DUMP_DEVICE_2(originalBg, rc, "04_knockout", "dd");
 }
 
+void KisLayerStyleProjectionPlaneTest::testTileCache()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect imageRect(0, 0, 256, 256);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->fill(QRect(40, 40, 100, 60), KoColor(Qt::red, cs));
+
+    auto needRect = [] (const QRect &rc) { return kisGrowRect(rc, 10); };
+
+    auto dirtyArea = [] (const QVector<QRect> &rects) {
+        int area = 0;
+        Q_FOREACH (const QRect &rc, rects) {
+            area += rc.width() * rc.height();
+        }
+        return area;
+    };
+
+    KisLayerStyleTileCache cache;
+
+    // nothing is cached yet
+    QCOMPARE(cache.takeDirtyRects(imageRect, dev, imageRect, needRect),
+             QVector<QRect>({imageRect}));
+    QCOMPARE(cache.numValidTiles(), 16);
+
+    // nothing has changed
+    QVERIFY(cache.takeDirtyRects(imageRect, dev, imageRect, needRect).isEmpty());
+    QVERIFY(cache.takeDirtyRects(QRect(10, 10, 20, 20), dev, imageRect, needRect).isEmpty());
+
+    // the dab changes the source tile (1, 1), which is needed by 3x3 tiles around it
+    dev->fill(QRect(70, 70, 5, 5), KoColor(Qt::blue, cs));
+
+    QVector<QRect> dirtyRects = cache.takeDirtyRects(imageRect, dev, imageRect, needRect);
+    QCOMPARE(dirtyArea(dirtyRects), 192 * 192);
+    QVERIFY(QRect(0, 0, 192, 192).contains(KisRegion(dirtyRects).boundingRect()));
+    QVERIFY(cache.takeDirtyRects(imageRect, dev, imageRect, needRect).isEmpty());
+
+    // a partially covered tile is returned, but is not validated
+    dev->fill(QRect(200, 200, 5, 5), KoColor(Qt::blue, cs));
+
+    QCOMPARE(cache.takeDirtyRects(QRect(200, 200, 10, 10), dev, imageRect, needRect),
+             QVector<QRect>({QRect(200, 200, 10, 10)}));
+    QCOMPARE(cache.takeDirtyRects(QRect(200, 200, 10, 10), dev, imageRect, needRect),
+             QVector<QRect>({QRect(200, 200, 10, 10)}));
+
+    // moving the device invalidates everything
+    cache.takeDirtyRects(imageRect, dev, imageRect, needRect);
+    dev->setX(5);
+
+    QCOMPARE(cache.takeDirtyRects(imageRect, dev, imageRect, needRect),
+             QVector<QRect>({imageRect}));
+
+    cache.invalidate();
+    QCOMPARE(cache.numValidTiles(), 0);
+}
+
+void KisLayerStyleProjectionPlaneTest::testTileCacheConsistency()
+{
+    KisPSDLayerStyleSP style(new KisPSDLayerStyle());
+    style->dropShadow()->setSize(10);
+    style->dropShadow()->setDistance(8);
+    style->dropShadow()->setOpacity(70);
+    style->dropShadow()->setEffectEnabled(true);
+
+    style->stroke()->setColor(KoColor::fromXML("<color channeldepth='U8'><sRGB r='0.0' g='0.0' b='1.0'/></color>"));
+    style->stroke()->setSize(3);
+    style->stroke()->setPosition(psd_stroke_outside);
+    style->stroke()->setEffectEnabled(true);
+
+    const QRect imageRect(0, 0, 256, 256);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "styles test");
+
+    KisPaintLayerSP layer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+    image->addNode(layer);
+
+    layer->paintDevice()->fill(QRect(40, 40, 100, 60), KoColor(Qt::red, cs));
+
+    KisLayerStyleProjectionPlane plane(layer.data(), style);
+    plane.recalculate(imageRect, layer);
+
+    auto applyPlane = [imageRect, cs] (KisLayerStyleProjectionPlane *plane) {
+        KisPaintDeviceSP dst = new KisPaintDevice(cs);
+        KisPainter painter(dst);
+        plane->apply(&painter, imageRect);
+        return dst;
+    };
+
+    // the result of the partially cached plane should be the same
+    // as the result of a plane calculated from scratch
+    auto checkPlane = [&] (const QString &testName) {
+        plane.recalculate(imageRect, layer);
+        KisPaintDeviceSP result = applyPlane(&plane);
+
+        KisLayerStyleProjectionPlane referencePlane(layer.data(), style);
+        referencePlane.recalculate(imageRect, layer);
+        KisPaintDeviceSP reference = applyPlane(&referencePlane);
+
+        QPoint pt;
+        if (!TestUtil::comparePaintDevices(pt, result, reference)) {
+            KIS_DUMP_DEVICE_2(result, imageRect, "result", testName);
+            KIS_DUMP_DEVICE_2(reference, imageRect, "reference", testName);
+            return false;
+        }
+        return true;
+    };
+
+    QVERIFY(checkPlane("unchanged"));
+
+    layer->paintDevice()->fill(QRect(130, 90, 20, 20), KoColor(Qt::red, cs));
+    QVERIFY(checkPlane("dab"));
+
+    layer->paintDevice()->clear(QRect(40, 40, 30, 30));
+    QVERIFY(checkPlane("erased"));
+
+    layer->paintDevice()->setX(10);
+    QVERIFY(checkPlane("moved"));
+}
+
 KISTEST_MAIN(KisLayerStyleProjectionPlaneTest)
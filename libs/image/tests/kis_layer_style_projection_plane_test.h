@@ -36,6 +36,9 @@ private Q_SLOTS:
 
     void testBlending();
 
+    void testTileCache();
+    void testTileCacheConsistency();
+
 private:
     void test(KisPSDLayerStyleSP style, const QString testName);
 
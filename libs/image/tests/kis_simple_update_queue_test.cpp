@@ -7,6 +7,8 @@
 #include "kis_simple_update_queue_test.h"
 #include <simpletest.h>
 
+#include <limits>
+
 #include "kistest.h"
 
 #include <KoColorSpace.h>
@@ -22,6 +24,7 @@
 
 #include "kis_update_job_item.h"
 #include "kis_simple_update_queue.h"
+#include "KisUpdateCostEstimator.h"
 #include "scheduler_utils.h"
 #include <KisGlobalResourcesInterface.h>
 
@@ -140,6 +143,87 @@ void KisSimpleUpdateQueueTest::testSplit(bool useFullRefresh)
     QVERIFY(checkWalker(walkersList[3], QRect(512,512,488,488)));
 }
 
+void KisSimpleUpdateQueueTest::testCostBasedSplit()
+{
+    QRect imageRect(0,0,1024,1024);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    QRect dirtyRect1(0,0,1000,1000);
+
+    auto averageCostSample = [] (qreal costPerPixel) {
+        KisUpdateCostEstimator::Sample sample;
+        sample.numPixels = 1024 * 1024;
+        sample.nsecs = qint64(costPerPixel * sample.numPixels);
+        return sample;
+    };
+
+    // very expensive subtree --- the patches should become smaller
+    {
+        KisUpdateCostEstimator estimator;
+        estimator.addSamples({averageCostSample(1000.0)});
+
+        KisTestableSimpleUpdateQueue queue;
+        queue.setCostEstimator(&estimator);
+        KisWalkersList& walkersList = queue.getWalkersList();
+
+        queue.addUpdateJob(paintLayer, dirtyRect1, imageRect, 0);
+
+        QCOMPARE(walkersList.size(), 64);
+
+        qreal lastCost = std::numeric_limits<qreal>::max();
+        QRect coveredRect;
+
+        Q_FOREACH (KisBaseRectsWalkerSP walker, walkersList) {
+            QVERIFY(walker->requestedRect().width() <= 128);
+            QVERIFY(walker->requestedRect().height() <= 128);
+            coveredRect |= walker->requestedRect();
+
+            // the most expensive patches go first
+            const qreal cost = estimator.estimateCost(*walker);
+            QVERIFY(cost <= lastCost);
+            lastCost = cost;
+        }
+
+        QCOMPARE(coveredRect, dirtyRect1);
+
+        // the patches are never merged back into the bigger ones
+        queue.addUpdateJob(paintLayer, QRect(10,10,20,20), imageRect, 0);
+        queue.optimize();
+
+        QCOMPARE(walkersList.size(), 65);
+
+        Q_FOREACH (KisBaseRectsWalkerSP walker, walkersList) {
+            QVERIFY(walker->requestedRect().width() <= 128);
+            QVERIFY(walker->requestedRect().height() <= 128);
+        }
+
+        QVERIFY(checkWalker(walkersList.last(), QRect(10,10,20,20)));
+    }
+
+    // very cheap subtree --- the patches should become bigger
+    {
+        KisUpdateCostEstimator estimator;
+        estimator.addSamples({averageCostSample(0.001)});
+
+        KisTestableSimpleUpdateQueue queue;
+        queue.setCostEstimator(&estimator);
+        KisWalkersList& walkersList = queue.getWalkersList();
+
+        queue.addUpdateJob(paintLayer, dirtyRect1, imageRect, 0);
+
+        QCOMPARE(walkersList.size(), 1);
+        QVERIFY(checkWalker(walkersList[0], dirtyRect1));
+    }
+}
+
 void KisSimpleUpdateQueueTest::testChecksum()
 {
     QRect imageRect(0,0,512,512);
@@ -234,6 +318,162 @@ void KisSimpleUpdateQueueTest::testMixingTypes()
     QCOMPARE(walkersList[3]->type(), KisBaseRectsWalker::FULL_REFRESH_NO_FILTHY);
 }
 
+void KisSimpleUpdateQueueTest::testBatchRefresh()
+{
+    QRect imageRect(0,0,1024,1024);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisGroupLayerSP group = new KisGroupLayer(image, "group", OPACITY_OPAQUE_U8);
+    KisPaintLayerSP paintLayer1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    KisPaintLayerSP paintLayer2 = new KisPaintLayer(image, "paint2", OPACITY_OPAQUE_U8);
+    KisPaintLayerSP paintLayer3 = new KisPaintLayer(image, "paint3", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(group);
+    image->addNode(paintLayer1, group);
+    image->addNode(paintLayer2, group);
+    image->addNode(paintLayer3);
+    image->unlock();
+
+    {
+        KisTestableSimpleUpdateQueue queue;
+        KisWalkersList& walkersList = queue.getWalkersList();
+
+        /**
+         * The overlapping updates of the siblings share a single
+         * walker started at their parent
+         */
+        KisBatchNodeUpdate update;
+        update.addUpdate(paintLayer1, QRect(0,0,100,100));
+        update.addUpdate(paintLayer2, QRect(50,50,100,100));
+
+        queue.addBatchRefreshJob(update, imageRect, 0);
+
+        QCOMPARE(walkersList.size(), 1);
+        QVERIFY(checkWalker(walkersList[0], QRect(0,0,150,150)));
+        QCOMPARE(walkersList[0]->type(), KisBaseRectsWalker::BATCH_REFRESH);
+        QCOMPARE(walkersList[0]->startNode(), KisNodeSP(group));
+    }
+
+    {
+        KisTestableSimpleUpdateQueue queue;
+        KisWalkersList& walkersList = queue.getWalkersList();
+
+        /**
+         * The common ancestor of the layers in different groups
+         * is the root layer
+         */
+        KisBatchNodeUpdate update;
+        update.addUpdate(paintLayer1, QRect(0,0,100,100));
+        update.addUpdate(paintLayer3, QRect(50,50,100,100));
+
+        queue.addBatchRefreshJob(update, imageRect, 0);
+
+        QCOMPARE(walkersList.size(), 1);
+        QCOMPARE(walkersList[0]->type(), KisBaseRectsWalker::BATCH_REFRESH);
+        QCOMPARE(walkersList[0]->startNode(), KisNodeSP(image->rootLayer()));
+    }
+
+    {
+        KisTestableSimpleUpdateQueue queue;
+        KisWalkersList& walkersList = queue.getWalkersList();
+
+        /**
+         * The updates that don't overlap are refreshed separately
+         */
+        KisBatchNodeUpdate update;
+        update.addUpdate(paintLayer1, QRect(0,0,100,100));
+        update.addUpdate(paintLayer2, QRect(200,200,100,100));
+
+        queue.addBatchRefreshJob(update, imageRect, 0);
+
+        QCOMPARE(walkersList.size(), 2);
+        QCOMPARE(walkersList[0]->type(), KisBaseRectsWalker::FULL_REFRESH);
+        QCOMPARE(walkersList[1]->type(), KisBaseRectsWalker::FULL_REFRESH);
+    }
+
+    {
+        KisTestableSimpleUpdateQueue queue;
+        KisWalkersList& walkersList = queue.getWalkersList();
+
+        /**
+         * The child update is compressed into the parent's one
+         */
+        KisBatchNodeUpdate update;
+        update.addUpdate(group, QRect(0,0,100,100));
+        update.addUpdate(paintLayer2, QRect(50,50,100,100));
+
+        queue.addBatchRefreshJob(update, imageRect, 0);
+
+        QCOMPARE(walkersList.size(), 1);
+        QVERIFY(checkWalker(walkersList[0], QRect(0,0,150,150)));
+        QCOMPARE(walkersList[0]->type(), KisBaseRectsWalker::FULL_REFRESH);
+        QCOMPARE(walkersList[0]->startNode(), KisNodeSP(group));
+    }
+}
+
+void KisSimpleUpdateQueueTest::testMergeStrokes()
+{
+    KisTestableUpdaterContext context(2);
+
+    QRect imageRect(0,0,1024,1024);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    KisTestableSimpleUpdateQueue queue;
+    KisWalkersList& walkersList = queue.getWalkersList();
+
+    /**
+     * Two interleaved strokes of overlapping dabs, each of them
+     * should be merged into a single patch-wide walker
+     */
+    for (int i = 0; i <= 30; i++) {
+        queue.addUpdateJob(paintLayer, QRect(i * 16, 0, 32, 32), imageRect, 0);
+        queue.addUpdateJob(paintLayer, QRect(i * 16, 900, 32, 32), imageRect, 0);
+    }
+
+    QCOMPARE(walkersList.size(), 2);
+    QVERIFY(checkWalker(walkersList[0], QRect(0,0,512,32)));
+    QVERIFY(checkWalker(walkersList[1], QRect(0,900,512,32)));
+
+    // doesn't fit into the patch anymore
+    queue.addUpdateJob(paintLayer, QRect(496,0,32,32), imageRect, 0);
+
+    // the dabs outside the image
+    queue.addUpdateJob(paintLayer, QRect(-24,0,32,32), imageRect, 0);
+    queue.addUpdateJob(paintLayer, QRect(-40,0,32,32), imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 4);
+    QVERIFY(checkWalker(walkersList[2], QRect(496,0,32,32)));
+    QVERIFY(checkWalker(walkersList[3], QRect(-40,0,48,32)));
+
+    queue.optimize();
+    QCOMPARE(walkersList.size(), 4);
+
+    queue.processQueue(context);
+
+    QVector<KisUpdateJobItem*> jobs = context.getJobs();
+    QCOMPARE(jobs.size(), 2);
+    QVERIFY(checkWalker(jobs[0]->walker(), QRect(0,0,512,32)));
+    QVERIFY(checkWalker(jobs[1]->walker(), QRect(0,900,512,32)));
+
+    // the walkers taken by the context must not be merge candidates anymore
+    queue.addUpdateJob(paintLayer, QRect(480,0,32,32), imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 2);
+    QVERIFY(checkWalker(walkersList[0], QRect(480,0,48,32)));
+    QVERIFY(checkWalker(walkersList[1], QRect(-40,0,48,32)));
+}
+
 void KisSimpleUpdateQueueTest::testSpontaneousJobsCompression()
 {
     KisTestableSimpleUpdateQueue queue;
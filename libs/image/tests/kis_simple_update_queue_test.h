@@ -21,8 +21,11 @@ private Q_SLOTS:
     void testJobProcessing();
     void testSplitUpdate();
     void testSplitFullRefresh();
+    void testCostBasedSplit();
     void testChecksum();
     void testMixingTypes();
+    void testBatchRefresh();
+    void testMergeStrokes();
     void testSpontaneousJobsCompression();
 };
 
@@ -7,6 +7,9 @@
 #include "kis_strokes_queue_test.h"
 #include <simpletest.h>
 
+#include <algorithm>
+#include <QtMath>
+
 #include "kistest.h"
 
 #include "scheduler_utils.h"
@@ -428,9 +431,9 @@ struct KisStrokesQueueTest::LodStrokesQueueTester {
         }
     }
 
-    void processQueue() {
+    void processQueue(bool externalJobsPending = false) {
         processQueueNoAdd();
-        queue.processQueue(context, false);
+        queue.processQueue(context, externalJobsPending);
 
         if (&context == &realContext) {
             context.waitForDone();
@@ -1127,4 +1130,386 @@ void KisStrokesQueueTest::testUniquelyConcurrentJobs()
 }
 
 
+void KisStrokesQueueTest::testBackgroundStrokePreemption()
+{
+    KisStrokesQueue queue;
+    KisTestableUpdaterContext context(2);
+    QVector<KisUpdateJobItem*> jobs;
+
+    KisTestingStrokeStrategy *backgroundStrategy = new KisTestingStrokeStrategy(QLatin1String("bg_"));
+    backgroundStrategy->setStrokePriority(KisStrokeStrategy::BACKGROUND);
+
+    KisStrokeId bg = queue.startStroke(backgroundStrategy);
+    queue.addJob(bg, new KisStrokeJobData(KisStrokeJobData::CONCURRENT));
+    queue.addJob(bg, new KisStrokeJobData(KisStrokeJobData::CONCURRENT));
+    queue.addJob(bg, new KisStrokeJobData(KisStrokeJobData::CONCURRENT));
+    queue.endStroke(bg);
+
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "bg_init");
+    VERIFY_EMPTY(jobs[1]);
+
+    // one slot is reserved for the interactive strokes
+    context.clear();
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "bg_dab");
+    VERIFY_EMPTY(jobs[1]);
+
+    KisStrokeId fg = queue.startStroke(new KisTestingStrokeStrategy(QLatin1String("fg_")));
+    queue.addJob(fg, new KisStrokeJobData(KisStrokeJobData::CONCURRENT));
+    queue.endStroke(fg);
+
+    // the preempting stroke waits for the running jobs to complete
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "bg_dab");
+    VERIFY_EMPTY(jobs[1]);
+
+    context.clear();
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "fg_init");
+    VERIFY_EMPTY(jobs[1]);
+
+    context.clear();
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "fg_dab");
+    VERIFY_EMPTY(jobs[1]);
+
+    context.clear();
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "fg_finish");
+    VERIFY_EMPTY(jobs[1]);
+
+    // the background stroke continues from where it was preempted
+    context.clear();
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "bg_dab");
+    VERIFY_EMPTY(jobs[1]);
+
+    context.clear();
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "bg_dab");
+    VERIFY_EMPTY(jobs[1]);
+
+    context.clear();
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "bg_finish");
+    VERIFY_EMPTY(jobs[1]);
+
+    context.clear();
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    VERIFY_EMPTY(jobs[0]);
+    VERIFY_EMPTY(jobs[1]);
+    QVERIFY(queue.isEmpty());
+}
+
+void KisStrokesQueueTest::testReservedInteractiveSlots()
+{
+    KisStrokesQueue queue;
+    KisTestableUpdaterContext context(3);
+    QVector<KisUpdateJobItem*> jobs;
+
+    KisTestingStrokeStrategy *previewStrategy = new KisTestingStrokeStrategy(QLatin1String("pv_"), false, true);
+    previewStrategy->setStrokePriority(KisStrokeStrategy::PREVIEW);
+
+    KisStrokeId pv = queue.startStroke(previewStrategy);
+    for (int i = 0; i < 7; i++) {
+        queue.addJob(pv, new KisStrokeJobData(KisStrokeJobData::CONCURRENT));
+    }
+    queue.endStroke(pv);
+
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "pv_dab");
+    COMPARE_NAME(jobs[1], "pv_dab");
+    VERIFY_EMPTY(jobs[2]);
+
+    KisStrokeId fg = queue.startStroke(new KisTestingStrokeStrategy(QLatin1String("fg_"), false, true));
+    queue.addJob(fg, new KisStrokeJobData(KisStrokeJobData::CONCURRENT));
+    queue.endStroke(fg);
+
+    // preview strokes are never preempted
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    VERIFY_EMPTY(jobs[2]);
+
+    context.clear();
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "pv_dab");
+    COMPARE_NAME(jobs[1], "pv_dab");
+    VERIFY_EMPTY(jobs[2]);
+
+    queue.setReservedInteractiveSlots(0);
+
+    context.clear();
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "pv_dab");
+    COMPARE_NAME(jobs[1], "pv_dab");
+    COMPARE_NAME(jobs[2], "pv_dab");
+
+    context.clear();
+    queue.processQueue(context, false);
+
+    jobs = context.getJobs();
+    COMPARE_NAME(jobs[0], "fg_dab");
+    VERIFY_EMPTY(jobs[1]);
+    VERIFY_EMPTY(jobs[2]);
+}
+
+void KisStrokesQueueTest::measureInteractiveLatency(KisStrokeStrategy::Priority longStrokePriority,
+                                                    QVector<int> &latencies)
+{
+    const int numThreads = 4;
+    const int numLongStrokeJobs = 128;
+
+    for (int startCycle = 0; startCycle < numLongStrokeJobs / numThreads; startCycle++) {
+        KisStrokesQueue queue;
+        KisTestableUpdaterContext context(numThreads);
+
+        KisTestingStrokeStrategy *longStrategy =
+            new KisTestingStrokeStrategy(QLatin1String("long_"), false, true);
+        longStrategy->setStrokePriority(longStrokePriority);
+
+        KisStrokeId longStroke = queue.startStroke(longStrategy);
+        for (int i = 0; i < numLongStrokeJobs; i++) {
+            queue.addJob(longStroke, new KisStrokeJobData(KisStrokeJobData::CONCURRENT));
+        }
+        queue.endStroke(longStroke);
+
+        int interactiveStartCycle = -1;
+        int numExecutedLongJobs = 0;
+
+        for (int cycle = 0; cycle < 1000 && !queue.isEmpty(); cycle++) {
+            context.clear();
+            queue.processQueue(context, false);
+
+            Q_FOREACH (KisUpdateJobItem *item, context.getJobs()) {
+                if (item->type() != KisUpdateJobItem::Type::STROKE) continue;
+
+                const QString name = getJobName(item->strokeJob());
+
+                if (name == "long_dab") {
+                    numExecutedLongJobs++;
+                } else if (name == "fg_dab") {
+                    latencies << cycle - interactiveStartCycle;
+                }
+            }
+
+            if (cycle == startCycle) {
+                KisStrokeId id = queue.startStroke(new KisTestingStrokeStrategy(QLatin1String("fg_"), false, true));
+                queue.addJob(id, new KisStrokeJobData(KisStrokeJobData::CONCURRENT));
+                queue.endStroke(id);
+
+                interactiveStartCycle = cycle;
+            }
+        }
+
+        QVERIFY(queue.isEmpty());
+        QCOMPARE(numExecutedLongJobs, numLongStrokeJobs);
+    }
+}
+
+namespace {
+int latencyPercentile(QVector<int> samples, qreal percentile)
+{
+    std::sort(samples.begin(), samples.end());
+
+    const int index = qBound(0, qCeil(percentile * samples.size()) - 1, samples.size() - 1);
+    return samples[index];
+}
+}
+
+void KisStrokesQueueTest::testInteractiveLatencyPercentiles()
+{
+    /**
+     * The latency is measured in the number of queue processing
+     * cycles the interactive stroke waits for its first job
+     */
+
+    QVector<int> fifoLatencies;
+    measureInteractiveLatency(KisStrokeStrategy::INTERACTIVE, fifoLatencies);
+
+    QVector<int> preemptedLatencies;
+    measureInteractiveLatency(KisStrokeStrategy::BACKGROUND, preemptedLatencies);
+
+    QCOMPARE(fifoLatencies.size(), preemptedLatencies.size());
+
+    qDebug() << "Interactive stroke latency (cycles)";
+    qDebug() << "    after interactive stroke:"
+             << "p50" << latencyPercentile(fifoLatencies, 0.5)
+             << "p90" << latencyPercentile(fifoLatencies, 0.9)
+             << "p99" << latencyPercentile(fifoLatencies, 0.99);
+    qDebug() << "    after background stroke: "
+             << "p50" << latencyPercentile(preemptedLatencies, 0.5)
+             << "p90" << latencyPercentile(preemptedLatencies, 0.9)
+             << "p99" << latencyPercentile(preemptedLatencies, 0.99);
+
+    // the background stroke is preempted at the nearest job boundary
+    QCOMPARE(latencyPercentile(preemptedLatencies, 0.99), 1);
+    QVERIFY(latencyPercentile(fifoLatencies, 0.5) > latencyPercentile(preemptedLatencies, 0.5));
+}
+
+void KisStrokesQueueTest::testSpeculativeLod0Replay()
+{
+    LodStrokesQueueTester t;
+    KisStrokesQueue &queue = t.queue;
+
+    // create a stroke with LOD0 + LOD2
+    queue.setLodPreferences(KisLodPreferences(2));
+
+    // process sync-lodn-planes stroke
+    t.processQueue();
+    t.checkOnlyJob("sync_u_init");
+
+    KisTestingStrokeStrategy *strategy = new KisTestingStrokeStrategy(QLatin1String("lod_"), false, true);
+    strategy->setSpeculativeLod0Replay(true);
+
+    KisStrokeId id = queue.startStroke(strategy);
+    queue.addJob(id, new KisTestingStrokeJobData(KisStrokeJobData::CONCURRENT));
+
+    t.processQueue();
+    t.checkOnlyJob("clone2_lod_dab");
+
+    // the user is still painting, but the LodN stroke has nothing to do
+    t.processQueue();
+    t.checkOnlyJob("susp_u_init");
+
+    t.processQueue();
+    t.checkOnlyJob("lod_dab");
+
+    // the LodN jobs are never mixed with the speculative ones
+    queue.addJob(id, new KisTestingStrokeJobData(KisStrokeJobData::CONCURRENT));
+
+    t.processQueue();
+    t.checkOnlyJob("clone2_lod_dab");
+
+    queue.endStroke(id);
+
+    // only the last job is left for the end of the stroke
+    t.processQueue();
+    t.checkOnlyJob("lod_dab");
+
+    t.processQueue();
+    t.checkOnlyJob("resu_u_init");
+
+    t.processQueue();
+    t.checkNothing();
+}
+
+void KisStrokesQueueTest::testCancelSpeculativeLod0Replay()
+{
+    LodStrokesQueueTester t;
+    KisStrokesQueue &queue = t.queue;
+
+    // create a stroke with LOD0 + LOD2
+    queue.setLodPreferences(KisLodPreferences(2));
+
+    t.processQueue();
+    t.checkOnlyJob("sync_u_init");
+
+    KisTestingStrokeStrategy *strategy = new KisTestingStrokeStrategy(QLatin1String("lod_"), false, true, false, true);
+    strategy->setSpeculativeLod0Replay(true);
+
+    KisStrokeId id = queue.startStroke(strategy);
+    queue.addJob(id, new KisTestingStrokeJobData(KisStrokeJobData::CONCURRENT));
+
+    t.processQueue();
+    t.checkOnlyJob("clone2_lod_dab");
+
+    t.processQueue();
+    t.checkOnlyJob("susp_u_init");
+
+    t.processQueue();
+    t.checkOnlyJob("lod_dab");
+
+    queue.addJob(id, new KisTestingStrokeJobData(KisStrokeJobData::CONCURRENT));
+
+    // the stroke has already done some work, so it should be reverted
+    queue.cancelStroke(id);
+
+    t.processQueue();
+    t.checkOnlyJob("clone2_lod_cancel");
+
+    t.processQueue();
+    t.checkOnlyJob("lod_cancel");
+
+    t.processQueue();
+    t.checkOnlyJob("resu_u_init");
+
+    t.processQueue();
+    t.checkNothing();
+}
+
+void KisStrokesQueueTest::testSpeculativeLod0ReplayWaitsForLodNWalkers()
+{
+    LodStrokesQueueTester t;
+    KisStrokesQueue &queue = t.queue;
+
+    // create a stroke with LOD0 + LOD2
+    queue.setLodPreferences(KisLodPreferences(2));
+
+    t.processQueue();
+    t.checkOnlyJob("sync_u_init");
+
+    KisTestingStrokeStrategy *strategy = new KisTestingStrokeStrategy(QLatin1String("lod_"), false, true);
+    strategy->setSpeculativeLod0Replay(true);
+
+    KisStrokeId id = queue.startStroke(strategy);
+    queue.addJob(id, new KisTestingStrokeJobData(KisStrokeJobData::CONCURRENT));
+
+    t.processQueue();
+    t.checkOnlyJob("clone2_lod_dab");
+
+    // the LodN stroke has generated a walker, which is still pending
+    t.processQueue(true);
+    t.checkNothing();
+
+    t.processQueue(true);
+    t.checkNothing();
+
+    // the walker has been processed, so the speculation can start
+    t.processQueue();
+    t.checkOnlyJob("susp_u_init");
+
+    t.processQueue(true);
+    t.checkNothing();
+
+    t.processQueue();
+    t.checkOnlyJob("lod_dab");
+
+    queue.endStroke(id);
+
+    t.processQueue();
+    t.checkOnlyJob("resu_u_init");
+
+    t.processQueue();
+    t.checkNothing();
+}
+
+
 KISTEST_MAIN(KisStrokesQueueTest)
@@ -10,6 +10,7 @@
 #include <simpletest.h>
 #include "kis_types.h"
 #include "kis_stroke_job_strategy.h"
+#include "kis_stroke_strategy.h"
 
 class KisStrokesQueueTest : public QObject
 {
@@ -35,10 +36,17 @@ private Q_SLOTS:
     void testLodUndoBase2();
     void testMutatedJobs();
     void testUniquelyConcurrentJobs();
+    void testBackgroundStrokePreemption();
+    void testReservedInteractiveSlots();
+    void testInteractiveLatencyPercentiles();
+    void testSpeculativeLod0Replay();
+    void testCancelSpeculativeLod0Replay();
+    void testSpeculativeLod0ReplayWaitsForLodNWalkers();
 
 private:
     struct LodStrokesQueueTester;
     static void checkJobsOverlapping(LodStrokesQueueTester &t, KisStrokeId id, KisStrokeJobData::Sequentiality first, KisStrokeJobData::Sequentiality second, bool allowed);
+    static void measureInteractiveLatency(KisStrokeStrategy::Priority longStrokePriority, QVector<int> &latencies);
 };
 
 #endif /* __KIS_STROKES_QUEUE_TEST_H */
@@ -10,6 +10,7 @@
 #include "kistest.h"
 
 #include <QAtomicInt>
+#include <QSet>
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 
@@ -17,7 +18,9 @@
 
 #include "kis_merge_walker.h"
 #include "kis_updater_context.h"
+#include "kis_update_job_item.h"
 #include "kis_image.h"
+#include "KisRunnableStrokeJobData.h"
 
 #include "scheduler_utils.h"
 
@@ -235,5 +238,156 @@ void KisUpdaterContextTest::stressTestExclusiveJobs()
              << "/" << NUM_CHECKS * NUM_JOBS;
 }
 
+#define NUM_SUBTASKS 64
+#define NUM_SUBTASK_JOBS 100
+
+class SubtasksCompletionData : public KisStrokeJobData
+{
+public:
+    SubtasksCompletionData(QAtomicInt &counter, QAtomicInt &numIncompleteJobs)
+        : KisStrokeJobData(KisStrokeJobData::CONCURRENT),
+          m_counter(counter),
+          m_numIncompleteJobs(numIncompleteJobs)
+    {
+    }
+
+    ~SubtasksCompletionData() override {
+        // the job data is destroyed only when the job is completed
+        if (m_counter.loadAcquire() != 2 * NUM_SUBTASKS) {
+            m_numIncompleteJobs.ref();
+        }
+    }
+
+    QAtomicInt &m_counter;
+    QAtomicInt &m_numIncompleteJobs;
+};
+
+class SubtasksSpawningStrategy : public KisStrokeJobStrategy
+{
+public:
+    void run(KisStrokeJobData *data) override {
+        SubtasksCompletionData *d = dynamic_cast<SubtasksCompletionData*>(data);
+        QAtomicInt *counter = &d->m_counter;
+
+        for (int i = 0; i < NUM_SUBTASKS; i++) {
+            KisRunnableStrokeJobData::spawnSubtask([counter] () {
+                // nested subtasks belong to the same job
+                KisRunnableStrokeJobData::spawnSubtask([counter] () {
+                    counter->ref();
+                });
+
+                QTest::qSleep(1);
+                counter->ref();
+            });
+        }
+    }
+
+    QString debugId() const override {
+        return "SubtasksSpawningStrategy";
+    }
+};
+
+void KisUpdaterContextTest::testSubtasks()
+{
+    KisUpdaterContext context(4);
+    SubtasksSpawningStrategy strategy;
+
+    QVector<QAtomicInt> counters(NUM_SUBTASK_JOBS);
+    QAtomicInt numIncompleteJobs;
+
+    for (int i = 0; i < NUM_SUBTASK_JOBS; i++) {
+        while (true) {
+            context.lock();
+            if (context.hasSpareThread()) break;
+            context.unlock();
+
+            QTest::qSleep(1);
+        }
+
+        KisStrokeJobData *data = new SubtasksCompletionData(counters[i], numIncompleteJobs);
+        context.addStrokeJob(new KisStrokeJob(&strategy, data, 0, true));
+        context.unlock();
+    }
+
+    context.waitForDone();
+
+    QCOMPARE(int(numIncompleteJobs), 0);
+
+    for (int i = 0; i < NUM_SUBTASK_JOBS; i++) {
+        QCOMPARE(int(counters[i]), 2 * NUM_SUBTASKS);
+    }
+
+    // outside the context the subtasks are executed right away
+    QAtomicInt counter;
+    KisRunnableStrokeJobData::spawnSubtask([&counter] () { counter.ref(); });
+    QCOMPARE(int(counter), 1);
+}
+
+void KisUpdaterContextTest::testTileAffinity()
+{
+    KisTestableUpdaterContext context(4);
+    context.setUseTileAffinity(true);
+
+    QRect imageRect(0,0,1024,1024);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "affinity test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    auto addJob = [&] (const QRect &rc) {
+        KisBaseRectsWalkerSP walker = new KisMergeWalker(imageRect);
+        walker->collectRects(paintLayer, rc);
+
+        context.lock();
+        context.addMergeJob(walker);
+        context.unlock();
+
+        const QVector<KisUpdateJobItem*> jobs = context.getJobs();
+        for (int i = 0; i < jobs.size(); i++) {
+            if (jobs[i]->isRunning() && jobs[i]->walker() == walker) {
+                return i;
+            }
+        }
+        return -1;
+    };
+
+    // consecutive updates of the same region go to the same thread
+    const QRect rc(128,128,64,64);
+
+    const int index = addJob(rc);
+    QVERIFY(index >= 0);
+    context.clear();
+
+    QCOMPARE(addJob(rc), index);
+    context.clear();
+
+    // the other regions are spread over all the threads
+    QSet<int> usedThreads;
+
+    for (int y = 0; y < imageRect.height(); y += 64) {
+        for (int x = 0; x < imageRect.width(); x += 64) {
+            usedThreads.insert(addJob(QRect(x, y, 64, 64)));
+            context.clear();
+        }
+    }
+
+    QCOMPARE(usedThreads.size(), 4);
+    QVERIFY(!usedThreads.contains(-1));
+
+    // a busy thread doesn't delay the job
+    QCOMPARE(addJob(rc), index);
+
+    const int fallbackIndex = addJob(rc);
+    QVERIFY(fallbackIndex >= 0);
+    QVERIFY(fallbackIndex != index);
+
+    context.clear();
+}
+
 KISTEST_MAIN(KisUpdaterContextTest)
 
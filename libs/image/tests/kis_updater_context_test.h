@@ -17,6 +17,8 @@ private Q_SLOTS:
     void testJobInterference();
     void testSnapshot();
     void stressTestExclusiveJobs();
+    void testSubtasks();
+    void testTileAffinity();
 };
 
 #endif /* KIS_UPDATER_CONTEXT_TEST_H */
@@ -9,6 +9,7 @@
 #include "kis_base_rects_walker.h"
 #include "kis_refresh_subtree_walker.h"
 #include "kis_full_refresh_walker.h"
+#include "KisBatchRefreshWalker.h"
 
 #include <simpletest.h>
 #include <KoColorSpaceRegistry.h>
@@ -807,6 +808,88 @@ void KisWalkersTest::testFullRefreshVisiting()
     }
 }
 
+    /*
+      +----------+
+      |root      |
+      | paint 5  |
+      | group2   |
+      |  paint 6 |
+      | group    |
+      |  paint 4 |
+      |  paint 3 |
+      |  paint 2 |
+      | paint 1  |
+      +----------+
+     */
+
+void KisWalkersTest::testBatchRefreshVisiting()
+{
+    const KoColorSpace * colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 512, 512, colorSpace, "walker test");
+
+    KisLayerSP paintLayer1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    KisLayerSP paintLayer2 = new KisPaintLayer(image, "paint2", OPACITY_OPAQUE_U8);
+    KisLayerSP paintLayer3 = new KisPaintLayer(image, "paint3", OPACITY_OPAQUE_U8);
+    KisLayerSP paintLayer4 = new KisPaintLayer(image, "paint4", OPACITY_OPAQUE_U8);
+    KisLayerSP paintLayer5 = new KisPaintLayer(image, "paint5", OPACITY_OPAQUE_U8);
+    KisLayerSP paintLayer6 = new KisPaintLayer(image, "paint6", OPACITY_OPAQUE_U8);
+
+    KisLayerSP groupLayer = new KisGroupLayer(image, "group", OPACITY_OPAQUE_U8);
+    KisLayerSP groupLayer2 = new KisGroupLayer(image, "group2", OPACITY_OPAQUE_U8);
+
+    image->addNode(paintLayer1, image->rootLayer());
+    image->addNode(groupLayer, image->rootLayer());
+    image->addNode(groupLayer2, image->rootLayer());
+    image->addNode(paintLayer5, image->rootLayer());
+
+    image->addNode(paintLayer2, groupLayer);
+    image->addNode(paintLayer3, groupLayer);
+    image->addNode(paintLayer4, groupLayer);
+
+    image->addNode(paintLayer6, groupLayer2);
+
+    QRect testRect(10,10,10,10);
+    // Empty rect to show we don't need any cropping
+    QRect cropRect;
+
+    auto walkerOrder = [] (KisBaseRectsWalker &walker) {
+        QStringList order;
+        Q_FOREACH (const KisMergeWalker::JobItem &item, walker.leafStack()) {
+            order << item.m_leaf->node()->name() + nodeTypePostfix(item.m_position);
+        }
+        return order.join(',');
+    };
+
+    {
+        reportStartWith("group");
+
+        KisBatchRefreshWalker walker(cropRect, {paintLayer4, paintLayer2});
+        walker.collectRects(groupLayer, testRect);
+
+        /**
+         * Only the dirty layers are recalculated, the layer between
+         * them is just composited
+         */
+        QCOMPARE(walkerOrder(walker),
+                 QString("root_TF,paint5_TA,group2_NA,group_NF,paint1_BB,"
+                         "group_NE,paint4_TF,paint3_NA,paint2_BF"));
+    }
+
+    {
+        reportStartWith("root");
+
+        KisBatchRefreshWalker walker(cropRect, {paintLayer4, paintLayer6});
+        walker.collectRects(image->rootLayer(), testRect);
+
+        /**
+         * Both groups are entered, but only once per traversal
+         */
+        QCOMPARE(walkerOrder(walker),
+                 QString("root_TF,root_TE,paint5_TA,group2_NF,group_NF,paint1_BB,"
+                         "paint6_TF,paint4_TF,paint3_NB,paint2_BB"));
+    }
+}
+
     /*
       +----------+
       |root      |
@@ -234,6 +234,7 @@ private Q_SLOTS:
     void testCloneNotificationsVisiting();
     void testRefreshSubtreeVisiting();
     void testFullRefreshVisiting();
+    void testBatchRefreshVisiting();
     void testCachedVisiting();
     void testMasksVisiting();
     void testMasksVisitingNoFilthy();
@@ -261,6 +261,14 @@ public:
         m_isLegacyStroke = value;
     }
 
+    void setStrokePriority(Priority value) {
+        setPriority(value);
+    }
+
+    void setSpeculativeLod0Replay(bool value) {
+        setSupportsSpeculativeLod0Replay(value);
+    }
+
 protected:
     QString m_prefix;
     bool m_inhibitServiceJobs;
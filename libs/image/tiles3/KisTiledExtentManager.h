@@ -55,6 +55,7 @@ class KRITAIMAGE_EXPORT KisTiledExtentManager
 
 public:
     KisTiledExtentManager();
+    KisTiledExtentManager(qint32 tileWidth, qint32 tileHeight);
 
     void notifyTileAdded(qint32 col, qint32 row);
     void notifyTileRemoved(qint32 col, qint32 row);
@@ -69,6 +70,8 @@ private:
 private:
     mutable QReadWriteLock m_extentLock;
     QRect m_currentExtent;
+    qint32 m_tileWidth;
+    qint32 m_tileHeight;
     Data m_colsData;
     Data m_rowsData;
 };
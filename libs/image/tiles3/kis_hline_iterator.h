@@ -49,7 +49,6 @@ private:
     qint32 m_y {0};        // current y position
     qint32 m_row {0};    // current row in tilemgr
     quint32 m_index {0};    // current col in tilemgr
-    quint32 m_tileWidth {0};
     quint8 *m_data {nullptr};
     quint8 *m_oldData {nullptr};
     bool m_havePixels {false};
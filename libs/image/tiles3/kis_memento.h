@@ -85,11 +85,11 @@ public:
 private:
     friend class KisMementoManager;
 
-    inline void updateExtent(qint32 col, qint32 row, QMutex *currentMementoExtentLock) {
-        const qint32 tileMinX = col * KisTileData::WIDTH;
-        const qint32 tileMinY = row * KisTileData::HEIGHT;
-        const qint32 tileMaxX = tileMinX + KisTileData::WIDTH - 1;
-        const qint32 tileMaxY = tileMinY + KisTileData::HEIGHT - 1;
+    inline void updateExtent(const QRect &tileRect, QMutex *currentMementoExtentLock) {
+        const qint32 tileMinX = tileRect.left();
+        const qint32 tileMinY = tileRect.top();
+        const qint32 tileMaxX = tileRect.right();
+        const qint32 tileMaxY = tileRect.bottom();
 
         {
             /**
@@ -97,8 +97,7 @@ private:
              * manager to avoid too many locks to be created.
              * Anyway, a memento manager can have only one
              * "current memento". And it would not be nice to
-             * do KisTileData::WIDTH/HEIGHT multiplication
-             * under the lock held.
+             * calculate the tile rect under the lock held.
              */
             QMutexLocker l(currentMementoExtentLock);
             m_extentMinX = qMin(m_extentMinX, tileMinX);
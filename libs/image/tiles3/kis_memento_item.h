@@ -36,13 +36,22 @@ public:
             m_col(rhs.m_col),
             m_row(rhs.m_row),
             m_next(0),
-            m_parent(0) {
+            m_parent(0),
+            m_packedData(rhs.m_packedData),
+            m_packedPixelSize(rhs.m_packedPixelSize),
+            m_packedWidth(rhs.m_packedWidth),
+            m_packedHeight(rhs.m_packedHeight),
+            m_deltaBase(rhs.m_deltaBase),
+            m_deltaDepth(rhs.m_deltaDepth) {
         if (m_tileData) {
             if (m_committedFlag)
                 m_tileData->acquire();
             else
                 m_tileData->ref();
         }
+        if (isPacked()) {
+            KisTileDataStore::instance()->registerTileDeltaMemory(m_packedData.size());
+        }
     }
 
     /**
@@ -84,6 +93,7 @@ public:
 
     ~KisMementoItem() {
         releaseTileData();
+        releasePackedData();
     }
 
     void notifyDetachedFromDataManager() {
@@ -102,6 +112,7 @@ public:
 
     void reset() {
         releaseTileData();
+        releasePackedData();
         m_tileData = 0;
         m_committedFlag = false;
     }
@@ -141,6 +152,92 @@ public:
         m_committedFlag = true;
     }
 
+    /**
+     * Replaces the tile data of a committed item with its difference
+     * from the data of the parent item, compressed with the swap
+     * compression algorithm. It is done only when the item is the
+     * only user of the tile data, otherwise no memory would be saved.
+     *
+     * The parent is kept alive by the item until it is unpacked,
+     * even when the history is purged. To keep the reconstruction
+     * cheap, the length of the chain of packed items is limited,
+     * the item that would exceed the limit is kept as is.
+     *
+     * \return true if the item has been packed
+     */
+    bool packDelta() {
+        static const int maxDeltaDepth = 8;
+
+        if (!m_committedFlag || m_type != CHANGED ||
+            !m_tileData || !m_parent ||
+            m_tileData->numUsers() > 1 ||
+            m_parent->m_deltaDepth >= maxDeltaDepth ||
+            m_parent->pixelSize() != m_tileData->pixelSize() ||
+            m_parent->tileWidth() != m_tileData->width() ||
+            m_parent->tileHeight() != m_tileData->height()) {
+
+            return false;
+        }
+
+        const qint32 pixelSize = m_tileData->pixelSize();
+        const qint32 width = m_tileData->width();
+        const qint32 height = m_tileData->height();
+        const qint32 dataSize = m_tileData->dataSize();
+
+        QByteArray baseData(dataSize, 0);
+        m_parent->readData(reinterpret_cast<quint8*>(baseData.data()), dataSize);
+
+        m_tileData->blockSwapping();
+        QByteArray delta =
+            KisTileDataStore::instance()->compressTileDelta(m_tileData->data(),
+                                                            reinterpret_cast<const quint8*>(baseData.constData()),
+                                                            dataSize);
+        m_tileData->unblockSwapping();
+
+        if (delta.isEmpty()) return false;
+
+        releaseTileData();
+        m_tileData = 0;
+
+        m_packedData = delta;
+        m_packedPixelSize = pixelSize;
+        m_packedWidth = width;
+        m_packedHeight = height;
+        m_deltaBase = m_parent;
+        m_deltaDepth = m_parent->m_deltaDepth + 1;
+
+        KisTileDataStore::instance()->registerTileDeltaMemory(m_packedData.size());
+
+        return true;
+    }
+
+    /**
+     * Reconstructs the full tile data of a packed item. Should be
+     * called before the item becomes a head of the history again,
+     * that is on undo and redo.
+     */
+    void unpackDelta() {
+        if (!isPacked()) return;
+
+        const qint32 dataSize = m_packedPixelSize * m_packedWidth * m_packedHeight;
+
+        QByteArray data(dataSize, 0);
+        readData(reinterpret_cast<quint8*>(data.data()), dataSize);
+
+        m_tileData =
+            KisTileDataStore::instance()->createTileData(m_packedPixelSize,
+                                                         m_packedWidth, m_packedHeight,
+                                                         reinterpret_cast<const quint8*>(data.constData()));
+        m_tileData->acquire();
+        m_tileData->setMementoed(true);
+
+        releasePackedData();
+    }
+
+    inline bool isPacked() const {
+        return !m_packedData.isEmpty();
+    }
+
     inline KisTileSP tile(KisMementoManager *mm) {
         Q_ASSERT(m_tileData);
         return KisTileSP(new KisTile(m_col, m_row, m_tileData, mm));
@@ -194,6 +291,52 @@ public:
     }
 
 protected:
+    inline qint32 pixelSize() const {
+        return m_tileData ? m_tileData->pixelSize() : m_packedPixelSize;
+    }
+
+    inline qint32 tileWidth() const {
+        return m_tileData ? m_tileData->width() : m_packedWidth;
+    }
+
+    inline qint32 tileHeight() const {
+        return m_tileData ? m_tileData->height() : m_packedHeight;
+    }
+
+    /**
+     * Copies the full data of the item into \p data, reconstructing
+     * it from the chain of deltas if needed
+     */
+    void readData(quint8 *data, qint32 dataSize) {
+        if (m_tileData) {
+            m_tileData->blockSwapping();
+            memcpy(data, m_tileData->data(), dataSize);
+            m_tileData->unblockSwapping();
+        } else {
+            KIS_SAFE_ASSERT_RECOVER_RETURN(m_deltaBase);
+
+            QByteArray baseData(dataSize, 0);
+            m_deltaBase->readData(reinterpret_cast<quint8*>(baseData.data()), dataSize);
+
+            KisTileDataStore::instance()->decompressTileDelta(m_packedData,
+                                                              reinterpret_cast<const quint8*>(baseData.constData()),
+                                                              data, dataSize);
+        }
+    }
+
+    void releasePackedData() {
+        if (!isPacked()) return;
+
+        KisTileDataStore::instance()->registerTileDeltaMemory(-m_packedData.size());
+
+        m_packedData.clear();
+        m_packedPixelSize = 0;
+        m_packedWidth = 0;
+        m_packedHeight = 0;
+        m_deltaBase = 0;
+        m_deltaDepth = 0;
+    }
+
     void releaseTileData() {
         if (m_tileData) {
             if (m_committedFlag) {
@@ -216,6 +359,17 @@ protected:
 
     KisMementoItemSP m_next;
     KisMementoItemSP m_parent;
+
+    /**
+     * The compressed difference from the data of m_deltaBase,
+     * present instead of m_tileData when the item is packed
+     */
+    QByteArray m_packedData;
+    qint32 m_packedPixelSize {0};
+    qint32 m_packedWidth {0};
+    qint32 m_packedHeight {0};
+    KisMementoItemSP m_deltaBase;
+    int m_deltaDepth {0};
 private:
 };
 
@@ -64,7 +64,8 @@
 KisMementoManager::KisMementoManager()
     : m_index(0),
       m_headsHashTable(0),
-      m_registrationBlocked(false)
+      m_registrationBlocked(false),
+      m_evictionPriority(KisTileEvictionPriority::Normal)
 {
     /**
      * Tile change/delete registration is enabled for all
@@ -78,7 +79,8 @@ KisMementoManager::KisMementoManager(const KisMementoManager& rhs)
         m_cancelledRevisions(rhs.m_cancelledRevisions),
         m_headsHashTable(rhs.m_headsHashTable, 0),
         m_currentMemento(rhs.m_currentMemento),
-        m_registrationBlocked(rhs.m_registrationBlocked)
+        m_registrationBlocked(rhs.m_registrationBlocked),
+        m_evictionPriority(rhs.m_evictionPriority.load(std::memory_order_relaxed))
 {
     Q_ASSERT_X(!m_registrationBlocked,
                "KisMementoManager", "(impossible happened) "
@@ -124,7 +126,7 @@ void KisMementoManager::registerTileChange(KisTile *tile)
         m_index.addTile(mi);
 
         if(namedTransactionInProgress()) {
-            m_currentMemento->updateExtent(mi->col(), mi->row(), &m_currentMementoExtentLock);
+            m_currentMemento->updateExtent(tile->extent(), &m_currentMementoExtentLock);
         }
     }
     else {
@@ -151,7 +153,7 @@ void KisMementoManager::registerTileDeleted(KisTile *tile)
         m_index.addTile(mi);
 
         if(namedTransactionInProgress()) {
-            m_currentMemento->updateExtent(mi->col(), mi->row(), &m_currentMementoExtentLock);
+            m_currentMemento->updateExtent(tile->extent(), &m_currentMementoExtentLock);
         }
     }
     else {
@@ -196,6 +198,13 @@ void KisMementoManager::commit()
 
         iter.moveCurrentToHashTable(&m_headsHashTable);
         //iter.next(); // previous line does this for us
+
+        /**
+         * The parent is not a head of the history anymore, so it
+         * will be needed on undo only. Keep its difference from
+         * the previous revision instead of the full data.
+         */
+        parentMI->packDelta();
     }
 
     KisHistoryItem hItem;
@@ -212,6 +221,37 @@ void KisMementoManager::commit()
     KisTileDataStore::instance()->kickPooler();
 }
 
+void KisMementoManager::deduplicateChangedTiles(KisTileHashTable *ht)
+{
+    /**
+     * Collect the items first, the tiles may want to register
+     * new changes while we are working with them
+     */
+    QVector<KisMementoItemSP> changedItems;
+
+    {
+        KisMementoItemHashTableIteratorConst iter(&m_index);
+        KisMementoItemSP mi;
+
+        while (!iter.isDone()) {
+            mi = iter.tile();
+            if (mi->type() == KisMementoItem::CHANGED) {
+                changedItems.append(mi);
+            }
+            iter.next();
+        }
+    }
+
+    Q_FOREACH (KisMementoItemSP mi, changedItems) {
+        KisTileSP tile = ht->getExistingTile(mi->col(), mi->row());
+
+        if (tile && tile->tileData() == mi->tileData() && tile->deduplicateData()) {
+            mi->reset();
+            mi->changeTile(tile);
+        }
+    }
+}
+
 KisTileSP KisMementoManager::getCommitedTile(qint32 col, qint32 row, bool &existingTile)
 {
     /**
@@ -283,6 +323,9 @@ void KisMementoManager::rollback(KisTileHashTable *ht, KisMementoSP memento)
         mi=*iter;
         parentMI = mi->parent();
 
+        // the parent becomes a head of the history again
+        parentMI->unpackDelta();
+
         if (mi->type() == KisMementoItem::CHANGED)
             ht->deleteTile(mi->col(), mi->row());
         if (parentMI->type() == KisMementoItem::CHANGED)
@@ -335,6 +378,8 @@ void KisMementoManager::rollforward(KisTileHashTable *ht, KisMementoSP memento)
 
     blockRegistration();
     Q_FOREACH (mi, changeList.itemList) {
+        mi->unpackDelta();
+
         if (mi->parent()->type() == KisMementoItem::CHANGED)
             ht->deleteTile(mi->col(), mi->row());
         if (mi->type() == KisMementoItem::CHANGED)
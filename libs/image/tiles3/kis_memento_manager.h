@@ -9,7 +9,10 @@
 
 #include <QList>
 
+#include <atomic>
+
 #include "kis_memento_item.h"
+#include "kis_tile_eviction_priority.h"
 #include "config-hash-table-implementation.h"
 
 typedef QList<KisMementoItemSP> KisMementoItemList;
@@ -75,6 +78,14 @@ public:
      */
     void commit();
 
+    /**
+     * Called right before commit(). Replaces the tile data of the
+     * tiles changed in the current transaction with identical tile
+     * data objects already existing in the store (if any), so that
+     * both the tiles and the revision share them.
+     */
+    void deduplicateChangedTiles(KisTileHashTable *ht);
+
     /**
      * Undo and Redo stuff respectively.
      *
@@ -102,6 +113,22 @@ public:
 
     void setDefaultTileData(KisTileData *defaultTileData);
 
+    /**
+     * The eviction priority of the data manager owning the tiles.
+     * The tiles stamp it onto the tile data they get through
+     * copy-on-write, so the new data doesn't fall back to
+     * KisTileEvictionPriority::Normal.
+     *
+     * \see KisTiledDataManager::setEvictionPriority()
+     */
+    void setEvictionPriority(KisTileEvictionPriority priority) {
+        m_evictionPriority.store(priority, std::memory_order_relaxed);
+    }
+
+    KisTileEvictionPriority evictionPriority() const {
+        return m_evictionPriority.load(std::memory_order_relaxed);
+    }
+
     void debugPrintInfo();
 
 
@@ -158,6 +185,8 @@ protected:
      * \see rollforward()
      */
     bool m_registrationBlocked;
+
+    std::atomic<KisTileEvictionPriority> m_evictionPriority;
 };
 
 #endif /* KIS_MEMENTO_MANAGER_ */
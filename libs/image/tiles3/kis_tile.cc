@@ -13,18 +13,34 @@
 #include "kis_debug.h"
 
 
+namespace {
+std::atomic<quint64> s_lastRevisionSeed(0);
+
+/**
+ * The seed takes the higher half of the revision, the lower half
+ * is incremented on every write
+ */
+inline quint64 newRevisionSeed()
+{
+    return (s_lastRevisionSeed.fetch_add(1, std::memory_order_relaxed) + 1) << 32;
+}
+}
+
 void KisTile::init(qint32 col, qint32 row,
                    KisTileData *defaultTileData, KisMementoManager* mm)
 {
     m_col = col;
     m_row = row;
     m_lockCounter = 0;
+    m_revision.store(newRevisionSeed(), std::memory_order_relaxed);
 
-    m_extent = QRect(m_col * KisTileData::WIDTH, m_row * KisTileData::HEIGHT,
-                     KisTileData::WIDTH, KisTileData::HEIGHT);
+    const qint32 width = defaultTileData->width();
+    const qint32 height = defaultTileData->height();
+    m_extent = QRect(m_col * width, m_row * height, width, height);
 
     m_tileData = defaultTileData;
     m_tileData->acquire();
+    m_hasDeduplicatedData = false;
 
     if (mm) {
         mm->registerTileChange(this);
@@ -76,6 +92,10 @@ KisTile::~KisTile()
     }
 #endif
 
+    if (m_hasDeduplicatedData) {
+        KisTileDataStore::instance()->releaseDeduplicatedUser(m_tileData);
+    }
+
     m_tileData->release();
 }
 
@@ -239,13 +259,30 @@ void KisTile::lockForWrite()
             KisTileData *tileData = m_tileData->clone();
             tileData->acquire();
             tileData->blockSwapping();
+
+            KisMementoManager *mm = m_mementoManager.load();
+
+            /**
+             * The source data may be the default tile or be shared
+             * with another device, so the priority should be taken
+             * from the owner of the tile
+             */
+            if (mm) {
+                tileData->setEvictionPriority(mm->evictionPriority());
+            }
+
             KisTileData *oldTileData = m_tileData;
             m_tileData = tileData;
+
+            if (m_hasDeduplicatedData) {
+                KisTileDataStore::instance()->releaseDeduplicatedUser(oldTileData);
+                m_hasDeduplicatedData = false;
+            }
+
             safeReleaseOldTileData(oldTileData);
 
             DEBUG_COWING(tileData);
 
-            KisMementoManager *mm = m_mementoManager.load();
             if (mm) {
                 mm->registerTileChange(this);
             }
@@ -262,6 +299,12 @@ void KisTile::lockForWrite()
 
 void KisTile::unlockForWrite()
 {
+    /**
+     * The revision is changed on unlocking, so that anyone who has
+     * read it while the tile was being written will notice the change
+     */
+    m_revision.fetch_add(1, std::memory_order_release);
+
     unblockSwapping();
     DEBUG_LOG_ACTION("unlock [W]");
 
@@ -283,6 +326,50 @@ void KisTile::unlockForRead() const
 }
 
 
+bool KisTile::deduplicateData()
+{
+    /**
+     * The COW mutex may be held by a writer that is waiting for the
+     * memento manager, which in its turn may be busy with us, so
+     * don't try to wait for it.
+     */
+    if (!m_COWMutex.tryLock()) return false;
+
+    bool result = false;
+
+    {
+        QMutexLocker locker(&m_swapBarrierLock);
+
+        /**
+         * If the tile data is already shared via COW, there is
+         * nothing to gain from deduplication
+         */
+        if (!m_lockCounter && m_tileData->numUsers() == 1) {
+            KisTileData *tileData =
+                KisTileDataStore::instance()->deduplicateTileData(m_tileData);
+
+            if (tileData) {
+                KisTileData *oldTileData = m_tileData;
+                m_tileData = tileData;
+
+                if (m_hasDeduplicatedData) {
+                    KisTileDataStore::instance()->releaseDeduplicatedUser(oldTileData);
+                }
+                m_hasDeduplicatedData = true;
+
+                oldTileData->release();
+
+                DEBUG_COWING(tileData);
+                result = true;
+            }
+        }
+    }
+
+    m_COWMutex.unlock();
+
+    return result;
+}
+
 #include <stdio.h>
 void KisTile::debugPrintInfo()
 {
@@ -298,9 +385,12 @@ void KisTile::debugDumpTile()
     lockForRead();
     quint8 *data = this->data();
 
-    for (int i = 0; i < KisTileData::HEIGHT; i++) {
-        for (int j = 0; j < KisTileData::WIDTH; j++) {
-            dbgTiles << data[(i*KisTileData::WIDTH+j)*pixelSize()];
+    const qint32 width = m_extent.width();
+    const qint32 height = m_extent.height();
+
+    for (int i = 0; i < height; i++) {
+        for (int j = 0; j < width; j++) {
+            dbgTiles << data[(i*width+j)*pixelSize()];
         }
     }
     unlockForRead();
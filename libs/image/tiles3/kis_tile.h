@@ -15,6 +15,8 @@
 #include <QRect>
 #include <QStack>
 
+#include <atomic>
+
 #include <kis_shared.h>
 #include <kis_shared_ptr.h>
 
@@ -70,6 +72,17 @@ public:
      */
     void notifyAttachedToDataManager(KisMementoManager *mm);
 
+    /**
+     * Tries to replace the tile data of the tile with an identical
+     * tile data object that already exists in the store. Does nothing
+     * if the tile is locked by someone at the moment.
+     *
+     * \return true if the tile data has been replaced
+     *
+     * \see KisTileDataStore::deduplicateTileData()
+     */
+    bool deduplicateData();
+
 public:
 
     void debugPrintInfo();
@@ -119,6 +132,20 @@ public:
         return m_tileData;
     }
 
+    /**
+     * The revision of the tile's content. It changes every time
+     * the tile is unlocked after writing. Every new tile object
+     * gets its own range of revisions, so the revisions of two
+     * different tiles never match, even when they were created at
+     * the same position.
+     *
+     * Used by the caches that want to know whether the data they
+     * have been calculated from has changed.
+     */
+    inline quint64 revision() const {
+        return m_revision.load(std::memory_order_acquire);
+    }
+
 private:
     void init(qint32 col, qint32 row,
               KisTileData *defaultTileData, KisMementoManager* mm);
@@ -136,6 +163,8 @@ private:
     qint32 m_col;
     qint32 m_row;
 
+    std::atomic<quint64> m_revision;
+
     /**
      * Added for faster retrieving by processors
      */
@@ -156,6 +185,14 @@ private:
      */
     QMutex m_COWMutex;
 
+    /**
+     * Set when the tile has switched to a shared tile data object
+     * in deduplicateData(), so that the saved memory could be
+     * accounted back when the tile stops using it. Guarded by
+     * m_COWMutex.
+     */
+    bool m_hasDeduplicatedData;
+
     /**
      * This lock is used to ensure no one will read the tile data
      * before it has been loaded from to the memory.
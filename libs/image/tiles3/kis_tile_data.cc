@@ -51,18 +51,27 @@ void SimpleCache::clear()
 
 
 KisTileData::KisTileData(qint32 pixelSize, const quint8 *defPixel, KisTileDataStore *store, bool checkFreeMemory)
+    : KisTileData(pixelSize, WIDTH, HEIGHT, defPixel, store, checkFreeMemory)
+{
+}
+
+KisTileData::KisTileData(qint32 pixelSize, qint32 width, qint32 height,
+                         const quint8 *defPixel, KisTileDataStore *store, bool checkFreeMemory)
     : m_state(NORMAL),
       m_mementoFlag(0),
       m_age(0),
+      m_evictionPriority(KisTileEvictionPriority::Normal),
       m_usersCount(0),
       m_refCount(0),
       m_pixelSize(pixelSize),
+      m_width(width),
+      m_height(height),
       m_store(store)
 {
     if (checkFreeMemory) {
         m_store->checkFreeMemory();
     }
-    m_data = allocateData(m_pixelSize);
+    m_data = allocateData(m_pixelSize, m_width, m_height);
 
     fillWithPixel(defPixel);
 }
@@ -83,17 +92,20 @@ KisTileData::KisTileData(const KisTileData& rhs, bool checkFreeMemory)
     : m_state(NORMAL),
       m_mementoFlag(0),
       m_age(0),
+      m_evictionPriority(rhs.m_evictionPriority),
       m_usersCount(0),
       m_refCount(0),
       m_pixelSize(rhs.m_pixelSize),
+      m_width(rhs.m_width),
+      m_height(rhs.m_height),
       m_store(rhs.m_store)
 {
     if (checkFreeMemory) {
         m_store->checkFreeMemory();
     }
-    m_data = allocateData(m_pixelSize);
+    m_data = allocateData(m_pixelSize, m_width, m_height);
 
-    memcpy(m_data, rhs.data(), m_pixelSize * WIDTH * HEIGHT);
+    memcpy(m_data, rhs.data(), dataSize());
 }
 
 
@@ -106,7 +118,7 @@ void KisTileData::fillWithPixel(const quint8 *defPixel)
 {
     quint8 *it = m_data;
 
-    for (int i = 0; i < WIDTH * HEIGHT; i++, it += m_pixelSize) {
+    for (int i = 0; i < m_width * m_height; i++, it += m_pixelSize) {
         memcpy(it, defPixel, m_pixelSize);
     }
 }
@@ -114,7 +126,7 @@ void KisTileData::fillWithPixel(const quint8 *defPixel)
 void KisTileData::releaseMemory()
 {
     if (m_data) {
-        freeData(m_data, m_pixelSize);
+        freeData(m_data, m_pixelSize, m_width, m_height);
         m_data = 0;
     }
 
@@ -129,13 +141,21 @@ void KisTileData::releaseMemory()
 void KisTileData::allocateMemory()
 {
     Q_ASSERT(!m_data);
-    m_data = allocateData(m_pixelSize);
+    m_data = allocateData(m_pixelSize, m_width, m_height);
 }
 
-quint8* KisTileData::allocateData(const qint32 pixelSize)
+quint8* KisTileData::allocateData(const qint32 pixelSize, const qint32 width, const qint32 height)
 {
     quint8 *ptr = 0;
 
+    /**
+     * The pools are tuned for the default tile size only,
+     * the rest goes directly to the system allocator
+     */
+    if (width != WIDTH || height != HEIGHT) {
+        return (quint8*) malloc(pixelSize * width * height);
+    }
+
     if (!m_cache.pop(pixelSize, ptr)) {
         switch (pixelSize) {
         case 4:
@@ -153,8 +173,13 @@ quint8* KisTileData::allocateData(const qint32 pixelSize)
     return ptr;
 }
 
-void KisTileData::freeData(quint8* ptr, const qint32 pixelSize)
+void KisTileData::freeData(quint8* ptr, const qint32 pixelSize, const qint32 width, const qint32 height)
 {
+    if (width != WIDTH || height != HEIGHT) {
+        free(ptr);
+        return;
+    }
+
     if (!m_cache.push(pixelSize, ptr)) {
         switch (pixelSize) {
         case 4:
@@ -198,8 +223,9 @@ void KisTileData::releaseInternalPools()
             }
 
             // check if the tile data has actually been pooled
-            if (item->m_pixelSize != 4 &&
-                item->m_pixelSize != 8) {
+            if ((item->m_pixelSize != 4 &&
+                 item->m_pixelSize != 8) ||
+                !item->hasDefaultSize()) {
 
                 continue;
             }
@@ -212,7 +238,7 @@ void KisTileData::releaseInternalPools()
                     break;
                 }
 
-                const int chunkSize = item->m_pixelSize * WIDTH * HEIGHT;
+                const int chunkSize = item->dataSize();
                 dataObjects << item;
                 memoryChunks << QByteArray((const char*)item->m_data, chunkSize);
             }
@@ -230,9 +256,9 @@ void KisTileData::releaseInternalPools()
 
             for (; it != dataObjects.end(); ++it, ++chunkIt) {
                 KisTileData *item = *it;
-                const int chunkSize = item->m_pixelSize * WIDTH * HEIGHT;
+                const int chunkSize = item->dataSize();
 
-                item->m_data = allocateData(item->m_pixelSize);
+                item->m_data = allocateData(item->m_pixelSize, item->m_width, item->m_height);
                 memcpy(item->m_data, chunkIt->data(), chunkSize);
 
                 item->m_swapLock.unlock();
@@ -25,13 +25,33 @@ inline quint8* KisTileData::data() const {
 
 void KisTileData::setData(const quint8 *data) {
     Q_ASSERT(m_data);
-    memcpy(m_data, data, m_pixelSize*WIDTH*HEIGHT);
+    memcpy(m_data, data, dataSize());
 }
 
 inline quint32 KisTileData::pixelSize() const {
     return m_pixelSize;
 }
 
+inline qint32 KisTileData::width() const {
+    return m_width;
+}
+
+inline qint32 KisTileData::height() const {
+    return m_height;
+}
+
+inline qint32 KisTileData::dataSize() const {
+    return m_pixelSize * m_width * m_height;
+}
+
+inline qint32 KisTileData::memoryMetric() const {
+    return (dataSize() + WIDTH * HEIGHT - 1) / (WIDTH * HEIGHT);
+}
+
+inline bool KisTileData::hasDefaultSize() const {
+    return m_width == WIDTH && m_height == HEIGHT;
+}
+
 inline bool KisTileData::acquire() {
     /**
      * We need to ensure the clones in the stack are
@@ -52,8 +72,25 @@ inline bool KisTileData::acquire() {
     return _ref;
 }
 
+inline bool KisTileData::tryAcquire() {
+    int refCount;
+
+    do {
+        refCount = m_refCount.loadAcquire();
+        if (!refCount) return false;
+    } while (!m_refCount.testAndSetOrdered(refCount, refCount + 1));
+
+    m_usersCount.ref();
+    return true;
+}
+
 inline bool KisTileData::release() {
-    m_usersCount.deref();
+    const int numUsers = m_usersCount.fetchAndAddOrdered(-1) - 1;
+
+    if (m_numDeduplicatedUsers.loadAcquire() > qMax(0, numUsers - 1)) {
+        m_store->limitDeduplicatedUsers(this, qMax(0, numUsers - 1));
+    }
+
     bool _ref = deref();
     return _ref;
 }
@@ -117,6 +154,13 @@ inline void KisTileData::markOld() {
     m_age++;
 }
 
+inline KisTileEvictionPriority KisTileData::evictionPriority() const {
+    return m_evictionPriority;
+}
+inline void KisTileData::setEvictionPriority(KisTileEvictionPriority value) {
+    m_evictionPriority = value;
+}
+
 inline qint32 KisTileData::numUsers() const {
     return m_usersCount;
 }
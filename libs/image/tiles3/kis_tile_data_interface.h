@@ -13,6 +13,7 @@
 
 #include "kis_lockless_stack.h"
 #include "swap/kis_chunk_allocator.h"
+#include "kis_tile_eviction_priority.h"
 
 class KisTileData;
 class KisTileDataStore;
@@ -90,6 +91,14 @@ class KRITAIMAGE_EXPORT KisTileData
 public:
     KisTileData(qint32 pixelSize, const quint8 *defPixel, KisTileDataStore *store, bool checkFreeMemory = true);
 
+    /**
+     * Creates a tile data of non-default dimensions. Such tile
+     * data objects are not pooled, their memory is allocated
+     * directly from the system.
+     */
+    KisTileData(qint32 pixelSize, qint32 width, qint32 height,
+                const quint8 *defPixel, KisTileDataStore *store, bool checkFreeMemory = true);
+
 private:
     KisTileData(const KisTileData& rhs, bool checkFreeMemory = true);
 
@@ -109,12 +118,45 @@ public:
     inline void setData(const quint8 *data);
     inline quint32 pixelSize() const;
 
+    /**
+     * Dimensions of the tile in pixels. They are equal to
+     * WIDTH and HEIGHT unless the tile data belongs to a data
+     * manager with a custom tile size.
+     */
+    inline qint32 width() const;
+    inline qint32 height() const;
+
+    /**
+     * The size of the pixel data in bytes
+     */
+    inline qint32 dataSize() const;
+
+    /**
+     * The amount of memory occupied by the tile data in the units
+     * used by the memory metrics of KisTileDataStore, that is in
+     * pixels of a default-sized tile. Rounded up.
+     */
+    inline qint32 memoryMetric() const;
+
+    /**
+     * Returns true if the tile data has the default dimensions
+     */
+    inline bool hasDefaultSize() const;
+
     /**
      * Increments usersCount of a TD and refs shared pointer counter
      * Used by KisTile for COW
      */
     inline bool acquire();
 
+    /**
+     * Same as acquire(), but fails if the shared pointer counter
+     * has already dropped to zero, that is the tile data is being
+     * destroyed at the moment. Used by the deduplication index
+     * of KisTileDataStore, which doesn't own its tile data objects.
+     */
+    inline bool tryAcquire();
+
     /**
      * Decrements usersCount of a TD and derefs shared pointer counter
      * Used by KisTile for COW
@@ -166,6 +208,13 @@ public:
     inline void resetAge();
     inline void markOld();
 
+    /**
+     * A hint for the swapper, which tile data should be
+     * swapped out first
+     */
+    inline KisTileEvictionPriority evictionPriority() const;
+    inline void setEvictionPriority(KisTileEvictionPriority value);
+
     /**
      * Returns number of tiles (or memento items),
      * referencing the tile data.
@@ -211,8 +260,8 @@ public:
 private:
     void fillWithPixel(const quint8 *defPixel);
 
-    static quint8* allocateData(const qint32 pixelSize);
-    static void freeData(quint8 *ptr, const qint32 pixelSize);
+    static quint8* allocateData(const qint32 pixelSize, const qint32 width, const qint32 height);
+    static void freeData(quint8 *ptr, const qint32 pixelSize, const qint32 width, const qint32 height);
 private:
     friend class KisTileDataPooler;
     friend class KisTileDataPoolerTest;
@@ -270,6 +319,29 @@ private:
     //FIXME: make memory aligned
     int m_age;
 
+    /**
+     * Set by KisTiledDataManager for all its tiles. Reading
+     * and writing it is not synchronized, because it is
+     * just a hint for the swapper.
+     */
+    KisTileEvictionPriority m_evictionPriority;
+
+    /**
+     * The hash of the content the tile data had when it was put
+     * into the deduplication index of KisTileDataStore. Both the
+     * fields are guarded by the index lock.
+     */
+    uint m_contentHash = 0;
+    bool m_deduplicationIndexed = false;
+
+    /**
+     * How many of the users have switched to this tile data in
+     * KisTileDataStore::deduplicateTileData(). It never exceeds
+     * the number of the other users, so it is the number of the
+     * copies the sharing saves at the moment.
+     */
+    QAtomicInt m_numDeduplicatedUsers;
+
 
     /**
      * The primitive for controlling swapping of the tile.
@@ -302,6 +374,8 @@ private:
 
 
     qint32 m_pixelSize;
+    qint32 m_width;
+    qint32 m_height;
     //qint32 m_timeStamp;
 
     KisTileDataStore *m_store;
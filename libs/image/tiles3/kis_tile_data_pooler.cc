@@ -254,11 +254,11 @@ qint64 KisTileDataPooler::lastHistoricalMemoryMetric() const
 }
 
 inline int KisTileDataPooler::clonesMetric(KisTileData *td, int numClones) {
-    return numClones * td->pixelSize();
+    return numClones * td->memoryMetric();
 }
 
 inline int KisTileDataPooler::clonesMetric(KisTileData *td) {
-    return td->m_clonesStack.size() * td->pixelSize();
+    return td->m_clonesStack.size() * td->memoryMetric();
 }
 
 inline void KisTileDataPooler::tryFreeOrphanedClones(KisTileData *td)
@@ -319,9 +319,9 @@ void KisTileDataPooler::getLists(Iter *iter,
 
         // statistics gathering
         if (item->historical()) {
-            statHistoricalMemory += item->pixelSize();
+            statHistoricalMemory += item->memoryMetric();
         } else {
-            statRealMemory += item->pixelSize();
+            statRealMemory += item->memoryMetric();
         }
     }
 
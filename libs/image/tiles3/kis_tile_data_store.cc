@@ -16,6 +16,10 @@
 
 #include "kis_tile_data_store_iterators.h"
 
+#include "kis_image_config.h"
+#include "swap/kis_abstract_compression.h"
+#include "swap/kis_compression_factory.h"
+
 Q_GLOBAL_STATIC(KisTileDataStore, s_instance)
 
 //#define DEBUG_PRECLONE
@@ -58,17 +62,30 @@ qint64 __preclone_miss_age = 0;
 KisTileDataStore::KisTileDataStore()
     : m_pooler(this),
       m_swapper(this),
+      m_prefetcher(this),
       m_numTiles(0),
       m_memoryMetric(0),
       m_counter(1),
-      m_clockIndex(1)
+      m_clockIndex(1),
+      m_deduplicatedMemorySize(0),
+      m_deltaMemorySize(0)
 {
+    KisImageConfig config(true);
+    m_deltaCompression.reset(KisCompressionFactory::create(
+        KisCompressionFactory::fromName(config.swapCompression())));
+
+    if (!m_deltaCompression) {
+        m_deltaCompression.reset(KisCompressionFactory::create(KisCompressionFactory::LZF));
+    }
+
     m_pooler.start();
     m_swapper.start();
+    m_prefetcher.start();
 }
 
 KisTileDataStore::~KisTileDataStore()
 {
+    m_prefetcher.terminatePrefetcher();
     m_pooler.terminatePooler();
     m_swapper.terminateSwapper();
 
@@ -96,13 +113,28 @@ KisTileDataStore::MemoryStatistics KisTileDataStore::memoryStatistics()
     stats.historicalMemorySize = m_pooler.lastHistoricalMemoryMetric() * metricCoeff;
     stats.poolSize = m_pooler.lastPoolMemoryMetric() * metricCoeff;
 
-    stats.totalMemorySize = memoryMetric() * metricCoeff + stats.poolSize;
+    stats.historicalDeltaSize = m_deltaMemorySize.loadAcquire();
+    stats.historicalMemorySize += stats.historicalDeltaSize;
+
+    stats.totalMemorySize = memoryMetric() * metricCoeff + stats.poolSize +
+        stats.historicalDeltaSize;
 
     stats.swapSize = m_swappedStore.totalMemoryMetric() * metricCoeff;
+    stats.swapFileSize = m_swappedStore.swapFileSize();
+    stats.swapFragmentation = m_swappedStore.fragmentation();
+
+    stats.deduplicatedSize = m_deduplicatedMemorySize.loadAcquire();
+    stats.deduplicationRatio =
+        stats.realMemorySize > 0 ? qreal(stats.deduplicatedSize) / stats.realMemorySize : 0.0;
 
     return stats;
 }
 
+KisTileDataPrefetcher::Statistics KisTileDataStore::prefetchStatistics() const
+{
+    return m_prefetcher.statistics();
+}
+
 void KisTileDataStore::tryForceUpdateMemoryStatisticsWhileIdle()
 {
     // in case the pooler is disabled, we should force it
@@ -120,12 +152,12 @@ inline void KisTileDataStore::registerTileDataImp(KisTileData *td)
     // make sure that access to the hash table is guarded by GC block
     // (it avoids removal of the referenced cells caused by concurrent
     // migrations)
-    m_tileDataMap.getGC().lockRawPointerAccess();
+    const int ticket = m_tileDataMap.getGC().lockRawPointerAccess();
     m_tileDataMap.assign(index, td);
-    m_tileDataMap.getGC().unlockRawPointerAccess();
+    m_tileDataMap.getGC().unlockRawPointerAccess(ticket);
 
     m_numTiles.ref();
-    m_memoryMetric += td->pixelSize();
+    m_memoryMetric += td->memoryMetric();
 }
 
 void KisTileDataStore::registerTileData(KisTileData *td)
@@ -139,7 +171,7 @@ inline void KisTileDataStore::unregisterTileDataImp(KisTileData *td)
     // make sure that access to the hash table is guarded by GC block
     // (it avoids removal of the referenced cells caused by concurrent
     // migrations)
-    m_tileDataMap.getGC().lockRawPointerAccess();
+    const int ticket = m_tileDataMap.getGC().lockRawPointerAccess();
 
     if (m_clockIndex == td->m_tileNumber) {
         do {
@@ -151,9 +183,9 @@ inline void KisTileDataStore::unregisterTileDataImp(KisTileData *td)
     td->m_tileNumber = -1;
     m_tileDataMap.erase(index);
     m_numTiles.deref();
-    m_memoryMetric -= td->pixelSize();
+    m_memoryMetric -= td->memoryMetric();
 
-    m_tileDataMap.getGC().unlockRawPointerAccess();
+    m_tileDataMap.getGC().unlockRawPointerAccess(ticket);
 }
 
 void KisTileDataStore::unregisterTileData(KisTileData *td)
@@ -162,9 +194,17 @@ void KisTileDataStore::unregisterTileData(KisTileData *td)
     unregisterTileDataImp(td);
 }
 
-KisTileData *KisTileDataStore::allocTileData(qint32 pixelSize, const quint8 *defPixel)
+KisTileData *KisTileDataStore::allocTileData(qint32 pixelSize, qint32 width, qint32 height, const quint8 *defPixel)
 {
-    KisTileData *td = new KisTileData(pixelSize, defPixel, this);
+    KisTileData *td = new KisTileData(pixelSize, width, height, defPixel, this);
+    registerTileData(td);
+    return td;
+}
+
+KisTileData *KisTileDataStore::createTileData(qint32 pixelSize, qint32 width, qint32 height, const quint8 *data)
+{
+    KisTileData *td = new KisTileData(pixelSize, width, height, data, this);
+    td->setData(data);
     registerTileData(td);
     return td;
 }
@@ -194,6 +234,12 @@ void KisTileDataStore::freeTileData(KisTileData *td)
 
     DEBUG_FREE_ACTION(td);
 
+    if (td->m_deduplicationIndexed) {
+        unregisterFromDeduplication(td);
+    }
+
+    limitDeduplicatedUsers(td, 0);
+
     m_iteratorLock.lockForRead();
     td->m_swapLock.lockForWrite();
 
@@ -209,6 +255,188 @@ void KisTileDataStore::freeTileData(KisTileData *td)
     delete td;
 }
 
+QByteArray KisTileDataStore::compressTileDelta(const quint8 *data, const quint8 *base, qint32 size)
+{
+    QMutexLocker locker(&m_deltaLock);
+
+    const qint32 compressedBufferSize = m_deltaCompression->outputBufferSize(size);
+    if (m_deltaBuffer.size() < size + compressedBufferSize) {
+        m_deltaBuffer.resize(size + compressedBufferSize);
+    }
+
+    quint8 *deltaBuffer = reinterpret_cast<quint8*>(m_deltaBuffer.data());
+    quint8 *compressedBuffer = deltaBuffer + size;
+
+    for (qint32 i = 0; i < size; i++) {
+        deltaBuffer[i] = data[i] ^ base[i];
+    }
+
+    const qint32 compressedSize =
+        m_deltaCompression->compress(deltaBuffer, size,
+                                     compressedBuffer, compressedBufferSize);
+
+    /**
+     * Decompressing the delta is not free, so keep it only if it
+     * saves at least a half of the memory
+     */
+    if (!compressedSize || compressedSize > size / 2) {
+        return QByteArray();
+    }
+
+    return QByteArray(reinterpret_cast<const char*>(compressedBuffer), compressedSize);
+}
+
+void KisTileDataStore::decompressTileDelta(const QByteArray &delta, const quint8 *base, quint8 *data, qint32 size)
+{
+    QMutexLocker locker(&m_deltaLock);
+
+    if (m_deltaBuffer.size() < size) {
+        m_deltaBuffer.resize(size);
+    }
+
+    quint8 *deltaBuffer = reinterpret_cast<quint8*>(m_deltaBuffer.data());
+
+    const qint32 bytesRead =
+        m_deltaCompression->decompress(reinterpret_cast<const quint8*>(delta.constData()),
+                                       delta.size(), deltaBuffer, size);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(bytesRead == size);
+
+    for (qint32 i = 0; i < size; i++) {
+        data[i] = base[i] ^ deltaBuffer[i];
+    }
+}
+
+inline uint tileContentHash(KisTileData *td)
+{
+    return qHashBits(td->data(), td->dataSize(), td->pixelSize());
+}
+
+void KisTileDataStore::registerForDeduplication(KisTileData *td)
+{
+    const uint hash = tileContentHash(td);
+
+    QMutexLocker locker(&m_deduplicationLock);
+
+    if (!m_deduplicationIndex.contains(hash)) {
+        m_deduplicationIndex.insert(hash, td);
+        td->m_contentHash = hash;
+        td->m_deduplicationIndexed = true;
+    }
+}
+
+void KisTileDataStore::unregisterFromDeduplication(KisTileData *td)
+{
+    QMutexLocker locker(&m_deduplicationLock);
+
+    auto it = m_deduplicationIndex.find(td->m_contentHash);
+    if (it != m_deduplicationIndex.end() && it.value() == td) {
+        m_deduplicationIndex.erase(it);
+    }
+    td->m_deduplicationIndexed = false;
+}
+
+KisTileData* KisTileDataStore::deduplicateTileData(KisTileData *td)
+{
+    if (!td->m_swapLock.tryLockForRead()) return 0;
+
+    if (!td->data()) {
+        td->m_swapLock.unlock();
+        return 0;
+    }
+
+    const qint32 dataSize = td->dataSize();
+    const uint hash = tileContentHash(td);
+
+    KisTileData *result = 0;
+
+    {
+        QMutexLocker locker(&m_deduplicationLock);
+
+        KisTileData *candidate = m_deduplicationIndex.value(hash, 0);
+        bool candidateIsStale = !candidate;
+
+        /**
+         * The content of the candidate may have changed since it
+         * has been put into the index, so compare the data itself.
+         * Holding the swap lock of the candidate for writing ensures
+         * that no tile is writing into it at the moment. And as soon
+         * as we acquire it, all the tiles will have to COW it before
+         * writing.
+         */
+        if (candidate && candidate != td &&
+            candidate->pixelSize() == td->pixelSize() &&
+            candidate->width() == td->width() &&
+            candidate->height() == td->height() &&
+            candidate->m_swapLock.tryLockForWrite()) {
+
+            if (candidate->data()) {
+                if (!memcmp(candidate->data(), td->data(), dataSize)) {
+                    if (candidate->tryAcquire()) {
+                        result = candidate;
+                    }
+                } else {
+                    candidateIsStale = true;
+                }
+            }
+
+            candidate->m_swapLock.unlock();
+        }
+
+        if (result) {
+            result->m_numDeduplicatedUsers.ref();
+            m_deduplicatedMemorySize.fetchAndAddOrdered(dataSize);
+        } else if (candidateIsStale) {
+            if (candidate) {
+                candidate->m_deduplicationIndexed = false;
+            }
+
+            // every tile data object is present in the index only once
+            if (td->m_deduplicationIndexed &&
+                m_deduplicationIndex.value(td->m_contentHash, 0) == td) {
+
+                m_deduplicationIndex.remove(td->m_contentHash);
+            }
+
+            m_deduplicationIndex.insert(hash, td);
+            td->m_contentHash = hash;
+            td->m_deduplicationIndexed = true;
+        }
+    }
+
+    td->m_swapLock.unlock();
+
+    return result;
+}
+
+void KisTileDataStore::releaseDeduplicatedUser(KisTileData *td)
+{
+    int numUsers = td->m_numDeduplicatedUsers.loadAcquire();
+
+    /**
+     * The user may have already been dropped by
+     * limitDeduplicatedUsers() when the data stopped being shared
+     */
+    while (numUsers > 0) {
+        if (td->m_numDeduplicatedUsers.testAndSetOrdered(numUsers, numUsers - 1)) {
+            m_deduplicatedMemorySize.fetchAndSubOrdered(td->dataSize());
+            break;
+        }
+        numUsers = td->m_numDeduplicatedUsers.loadAcquire();
+    }
+}
+
+void KisTileDataStore::limitDeduplicatedUsers(KisTileData *td, int maxUsers)
+{
+    int numUsers = td->m_numDeduplicatedUsers.loadAcquire();
+
+    while (numUsers > maxUsers) {
+        if (td->m_numDeduplicatedUsers.testAndSetOrdered(numUsers, numUsers - 1)) {
+            m_deduplicatedMemorySize.fetchAndSubOrdered(td->dataSize());
+        }
+        numUsers = td->m_numDeduplicatedUsers.loadAcquire();
+    }
+}
+
 void KisTileDataStore::ensureTileDataLoaded(KisTileData *td)
 {
 //    dbgKrita << "#### SWAP MISS! ####" << td << ppVar(td->mementoed()) << ppVar(td->age()) << ppVar(td->numUsers());
@@ -243,6 +471,7 @@ void KisTileDataStore::ensureTileDataLoaded(KisTileData *td)
 
             m_swappedStore.swapInTileData(td);
             registerTileDataImp(td);
+            m_prefetcher.registerSwapIn();
 
             td->m_swapLock.unlock();
         }
@@ -277,6 +506,46 @@ bool KisTileDataStore::trySwapTileData(KisTileData *td)
     return result;
 }
 
+bool KisTileDataStore::compactSwap(int maxTiles)
+{
+    /**
+     * Don't disturb the file if the holes are not big enough,
+     * they will be reused by the allocator anyway
+     */
+    const qreal fragmentationThreshold = 0.25;
+
+    if (!hasSwappedTiles() ||
+        m_swappedStore.fragmentation() < fragmentationThreshold) {
+
+        return false;
+    }
+
+    int numRelocated = 0;
+
+    /**
+     * Holding m_iteratorLock guarantees that no tile data is
+     * swapped in, swapped out or deleted while we are working,
+     * so the candidates are valid until the lock is released.
+     */
+    m_iteratorLock.lockForWrite();
+
+    Q_FOREACH (KisTileData *td, m_swappedStore.relocationCandidates(maxTiles)) {
+        if (!td->m_swapLock.tryLockForWrite()) continue;
+
+        if (!td->data() && m_swappedStore.tryRelocateTileData(td)) {
+            numRelocated++;
+        }
+
+        td->m_swapLock.unlock();
+    }
+
+    m_iteratorLock.unlock();
+
+    m_swappedStore.shrinkSwapFile();
+
+    return numRelocated > 0;
+}
+
 KisTileDataStoreIterator* KisTileDataStore::beginIteration()
 {
     m_iteratorLock.lockForWrite();
@@ -368,6 +637,11 @@ void KisTileDataStore::testingRereadConfig()
     kickPooler();
 }
 
+void KisTileDataStore::testingResetPrefetchStatistics()
+{
+    m_prefetcher.resetStatistics();
+}
+
 void KisTileDataStore::testingSuspendPooler()
 {
     m_pooler.terminatePooler();
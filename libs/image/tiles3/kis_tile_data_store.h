@@ -11,16 +11,21 @@
 #include "kritaimage_export.h"
 
 #include <QReadWriteLock>
+#include <QMutex>
+#include <QHash>
+#include <QScopedPointer>
 #include "kis_tile_data_interface.h"
 
 #include "kis_tile_data_pooler.h"
 #include "swap/kis_tile_data_swapper.h"
+#include "swap/kis_tile_data_prefetcher.h"
 #include "swap/kis_swapped_data_store.h"
 #include "3rdparty/lock_free_map/concurrent_map.h"
 
 class KisTileDataStoreIterator;
 class KisTileDataStoreReverseIterator;
 class KisTileDataStoreClockIterator;
+class KisAbstractCompression;
 
 /**
  * Stores tileData objects. When needed compresses them and swaps.
@@ -42,6 +47,28 @@ public:
         qint64 poolSize;
 
         qint64 swapSize;
+
+        /**
+         * The size of the swap file on disk and the ratio of
+         * unused holes in it
+         */
+        qint64 swapFileSize;
+        qreal swapFragmentation;
+
+        /**
+         * The size of the tile data objects that are currently
+         * shared because of the deduplication, that is the memory
+         * saved by sharing, and its ratio to realMemorySize
+         */
+        qint64 deduplicatedSize;
+        qreal deduplicationRatio;
+
+        /**
+         * The memory occupied by the compressed deltas of the
+         * historical tiles. It is already included into
+         * historicalMemorySize and totalMemorySize.
+         */
+        qint64 historicalDeltaSize;
     };
 
     MemoryStatistics memoryStatistics();
@@ -69,6 +96,43 @@ public:
         m_swapper.checkFreeMemory();
     }
 
+    /**
+     * Returns true if at least one tile data is swapped out at the
+     * moment. It is a cheap check, so the clients can avoid
+     * preparing the prefetch requests when there is nothing to fetch.
+     */
+    inline bool hasSwappedTiles() const
+    {
+        return m_swappedStore.numTiles() > 0;
+    }
+
+    /**
+     * Queues the tiles for loading from the swap in a background
+     * thread.
+     *
+     * \see KisTileDataPrefetcher
+     */
+    inline void prefetchTiles(const QVector<KisSharedPtr<KisTile>> &tiles)
+    {
+        m_prefetcher.prefetch(tiles);
+    }
+
+    KisTileDataPrefetcher::Statistics prefetchStatistics() const;
+
+    /**
+     * Moves up to \p maxTiles swapped out tile data objects from
+     * the tail of the swap file into the holes closer to its
+     * beginning and shrinks the file afterwards. Does nothing if
+     * the fragmentation of the swap file is low.
+     *
+     * The tile data objects which are being accessed at the moment
+     * are skipped, so the call never blocks on a tile.
+     *
+     * \return true if some data has been relocated and the swap
+     *         file may still be compacted further
+     */
+    bool compactSwap(int maxTiles);
+
     /**
      * \see m_memoryMetric
      */
@@ -86,11 +150,75 @@ public:
     KisTileDataStoreClockIterator* beginClockIteration();
     void endIteration(KisTileDataStoreClockIterator* iterator);
 
-    inline KisTileData* createDefaultTileData(qint32 pixelSize, const quint8 *defPixel)
+    inline KisTileData* createDefaultTileData(qint32 pixelSize, const quint8 *defPixel,
+                                              qint32 width = KisTileData::WIDTH,
+                                              qint32 height = KisTileData::HEIGHT)
     {
-        return allocTileData(pixelSize, defPixel);
+        KisTileData *td = allocTileData(pixelSize, width, height, defPixel);
+        registerForDeduplication(td);
+        return td;
     }
 
+    /**
+     * Creates a new tile data object filled with a copy of \p data
+     */
+    KisTileData* createTileData(qint32 pixelSize, qint32 width, qint32 height, const quint8 *data);
+
+    /**
+     * Compresses the difference between \p data and \p base (both
+     * are \p size bytes long) with the swap compression algorithm.
+     *
+     * \return the compressed difference or an empty array if the
+     *         difference doesn't compress well enough to be worth
+     *         keeping instead of the data itself
+     *
+     * \see KisMementoItem::packDelta()
+     */
+    QByteArray compressTileDelta(const quint8 *data, const quint8 *base, qint32 size);
+
+    /**
+     * Restores the data compressed by compressTileDelta() into \p data
+     */
+    void decompressTileDelta(const QByteArray &delta, const quint8 *base, quint8 *data, qint32 size);
+
+    /**
+     * Accounts the memory occupied by the compressed deltas in
+     * the memory statistics. Called by the owners of the deltas.
+     */
+    inline void registerTileDeltaMemory(qint64 size)
+    {
+        m_deltaMemorySize.fetchAndAddOrdered(size);
+    }
+
+    /**
+     * Looks for a tile data object with exactly the same content
+     * as \p td. If found, it is returned acquired by the caller,
+     * so the caller can drop \p td and use the found object
+     * instead. Otherwise \p td becomes a candidate for the following
+     * lookups and null is returned.
+     *
+     * Only the resident tile data not accessed by anyone at the
+     * moment is considered, so the call never blocks on a tile.
+     *
+     * PRECONDITIONS: td->m_swapLock is *unlocked*
+     */
+    KisTileData* deduplicateTileData(KisTileData *td);
+
+    /**
+     * Called by a tile that has switched to \p td in
+     * deduplicateTileData() when it stops using \p td, either
+     * because of COW or because the tile is destroyed
+     */
+    void releaseDeduplicatedUser(KisTileData *td);
+
+    /**
+     * Makes sure that no more than \p maxUsers users of \p td
+     * are accounted as deduplicated, that is the memory is
+     * counted as saved only while the data is really shared.
+     * Called by KisTileData when it loses a user.
+     */
+    void limitDeduplicatedUsers(KisTileData *td, int maxUsers);
+
     // Called by The Memento Manager after every commit
     inline void kickPooler()
     {
@@ -133,12 +261,15 @@ public:
     void unregisterTileData(KisTileData *td);
 
 private:
-    KisTileData *allocTileData(qint32 pixelSize, const quint8 *defPixel);
+    KisTileData *allocTileData(qint32 pixelSize, qint32 width, qint32 height, const quint8 *defPixel);
 
     inline void registerTileDataImp(KisTileData *td);
     inline void unregisterTileDataImp(KisTileData *td);
     void freeRegisteredTiles();
 
+    void registerForDeduplication(KisTileData *td);
+    void unregisterFromDeduplication(KisTileData *td);
+
     friend class DeadlockyThread;
     friend class KisLowMemoryTests;
     void debugSwapAll();
@@ -150,9 +281,11 @@ private:
 
     friend class KisLowMemoryBenchmark;
     void testingRereadConfig();
+    void testingResetPrefetchStatistics();
 private:
     KisTileDataPooler m_pooler;
     KisTileDataSwapper m_swapper;
+    KisTileDataPrefetcher m_prefetcher;
 
     friend class KisTileDataStoreTest;
     friend class KisTileDataPoolerTest;
@@ -169,6 +302,31 @@ private:
     QAtomicInt m_clockIndex;
     ConcurrentMap<int, KisTileData*> m_tileDataMap;
     QReadWriteLock m_iteratorLock;
+
+    /**
+     * Maps content hashes to the tile data objects that can be
+     * shared by the tiles with the same content. The index doesn't
+     * own the objects, they are removed from it on destruction.
+     */
+    QHash<uint, KisTileData*> m_deduplicationIndex;
+    QMutex m_deduplicationLock;
+
+    /**
+     * The memory saved by the deduplicated users of all the tile
+     * data objects. It is stored in bytes, not as a metric, so it
+     * needs 64 bits.
+     */
+    QAtomicInteger<qint64> m_deduplicatedMemorySize;
+
+    /**
+     * The state of the compressor of the historical tile deltas.
+     * The compression object and the buffer are shared, so the
+     * access is serialized with m_deltaLock.
+     */
+    QMutex m_deltaLock;
+    QScopedPointer<KisAbstractCompression> m_deltaCompression;
+    QByteArray m_deltaBuffer;
+    QAtomicInteger<qint64> m_deltaMemorySize;
 };
 
 template<typename T>
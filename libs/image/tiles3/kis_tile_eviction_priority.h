@@ -0,0 +1,35 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_TILE_EVICTION_PRIORITY_H
+#define __KIS_TILE_EVICTION_PRIORITY_H
+
+/**
+ * A hint for KisTileDataSwapper telling which tile data should be
+ * swapped out first when the memory limit is reached. The hint is
+ * set per paint device (see KisPaintDevice::setEvictionPriority())
+ * and is stored in every tile data object of the device.
+ */
+enum class KisTileEvictionPriority {
+    /**
+     * Regular layer data. Swapped out in the order of its age.
+     */
+    Normal = 0,
+
+    /**
+     * The data nobody is going to look at soon: invisible layers
+     * and LoD planes. Swapped out before anything else.
+     */
+    Preferred,
+
+    /**
+     * The data of the node the user is working on. It is swapped
+     * out only when nothing else is left.
+     */
+    Protected
+};
+
+#endif /* __KIS_TILE_EVICTION_PRIORITY_H */
@@ -9,6 +9,7 @@
 
 #include "kis_shared.h"
 #include "kis_shared_ptr.h"
+#include "KisStripedReadWriteLock.h"
 #include "3rdparty/lock_free_map/concurrent_map.h"
 #include "kis_tile.h"
 #include "kis_debug.h"
@@ -156,10 +157,11 @@ private:
     {
         TileTypeSP::ref(&item, item.data());
         TileType *tile = 0;
+        int ticket = 0;
 
         {
-            QReadLocker locker(&m_iteratorLock);
-            m_map.getGC().lockRawPointerAccess();
+            KisStripedReadLocker locker(&m_iteratorLock);
+            ticket = m_map.getGC().lockRawPointerAccess();
             tile = m_map.assign(idx, item.data());
         }
 
@@ -170,14 +172,14 @@ private:
             m_numTiles.fetchAndAddRelaxed(1);
         }
 
-        m_map.getGC().unlockRawPointerAccess();
+        m_map.getGC().unlockRawPointerAccess(ticket);
 
         m_map.getGC().update();
     }
 
     inline bool erase(quint32 idx)
     {
-        m_map.getGC().lockRawPointerAccess();
+        const int ticket = m_map.getGC().lockRawPointerAccess();
 
         bool wasDeleted = false;
         TileType *tile = m_map.erase(idx);
@@ -190,7 +192,7 @@ private:
             m_map.getGC().enqueue(&MemoryReclaimer::destroy, new MemoryReclaimer(tile));
         }
 
-        m_map.getGC().unlockRawPointerAccess();
+        m_map.getGC().unlockRawPointerAccess(ticket);
 
         m_map.getGC().update();
         return wasDeleted;
@@ -204,9 +206,14 @@ private:
     /**
      * We still need something to guard changes in m_defaultTileData,
      * otherwise there will be concurrent read/writes, resulting in broken memory.
+     *
+     * Both the locks are taken for writing very rarely (when the default
+     * pixel is changed or the table is iterated), while the readers come
+     * from all the threads, so we use striped locks to avoid the readers
+     * contending on a single atomic counter.
      */
-    QReadWriteLock m_defaultPixelDataLock;
-    mutable QReadWriteLock m_iteratorLock;
+    KisStripedReadWriteLock m_defaultPixelDataLock;
+    mutable KisStripedReadWriteLock m_iteratorLock;
 
     QAtomicInt m_numTiles;
     KisTileData *m_defaultTileData;
@@ -229,7 +236,7 @@ public:
 
     ~KisTileHashTableIteratorTraits2()
     {
-        m_ht->m_iteratorLock.unlock();
+        m_ht->m_iteratorLock.unlockWrite();
     }
 
     void next()
@@ -280,7 +287,7 @@ KisTileHashTableTraits2<T>::KisTileHashTableTraits2(const KisTileHashTableTraits
 {
     setDefaultTileData(ht.m_defaultTileData);
 
-    QWriteLocker locker(&ht.m_iteratorLock);
+    KisStripedWriteLocker locker(&ht.m_iteratorLock);
     typename ConcurrentMap<quint32, TileType*>::Iterator iter(ht.m_map);
 
     while (iter.isValid()) {
@@ -312,9 +319,9 @@ typename KisTileHashTableTraits2<T>::TileTypeSP KisTileHashTableTraits2<T>::getE
         return TileTypeSP();
     }
 
-    m_map.getGC().lockRawPointerAccess();
+    const int ticket = m_map.getGC().lockRawPointerAccess();
     TileTypeSP tile = m_map.get(idx);
-    m_map.getGC().unlockRawPointerAccess();
+    m_map.getGC().unlockRawPointerAccess(ticket);
 
     m_map.getGC().update();
     return tile;
@@ -334,23 +341,23 @@ typename KisTileHashTableTraits2<T>::TileTypeSP KisTileHashTableTraits2<T>::getT
         /// manager
         newTile = false;
 
-        QReadLocker locker(&m_defaultPixelDataLock);
+        KisStripedReadLocker locker(&m_defaultPixelDataLock);
         return new TileType(col, row, m_defaultTileData, 0);
     }
 
     // we are going to assign a raw-pointer tile from the table
     // to a shared pointer...
-    m_map.getGC().lockRawPointerAccess();
+    int ticket = m_map.getGC().lockRawPointerAccess();
 
     TileTypeSP tile = m_map.get(idx);
 
     while (!tile) {
         // we shouldn't try to acquire **any** lock with
         // raw-pointer lock held
-        m_map.getGC().unlockRawPointerAccess();
+        m_map.getGC().unlockRawPointerAccess(ticket);
 
         {
-            QReadLocker locker(&m_defaultPixelDataLock);
+            KisStripedReadLocker locker(&m_defaultPixelDataLock);
             tile = new TileType(col, row, m_defaultTileData, 0);
         }
 
@@ -359,10 +366,10 @@ typename KisTileHashTableTraits2<T>::TileTypeSP KisTileHashTableTraits2<T>::getT
 
         // iterator lock should be taken **before**
         // the pointers are locked
-        m_iteratorLock.lockForRead();
+        const int iteratorTicket = m_iteratorLock.lockForRead();
 
         // and now lock raw-pointers again
-        m_map.getGC().lockRawPointerAccess();
+        ticket = m_map.getGC().lockRawPointerAccess();
 
         // mutator might have become invalidated when
         // we released raw pointers, so we need to reinitialize it
@@ -373,7 +380,7 @@ typename KisTileHashTableTraits2<T>::TileTypeSP KisTileHashTableTraits2<T>::getT
             discardedTile = tile.data();
         }
 
-        m_iteratorLock.unlock();
+        m_iteratorLock.unlockRead(iteratorTicket);
 
         if (discardedTile) {
             // we've got our tile back, it didn't manage to
@@ -394,7 +401,7 @@ typename KisTileHashTableTraits2<T>::TileTypeSP KisTileHashTableTraits2<T>::getT
             tile->notifyAttachedToDataManager(m_mementoManager);
         }
     }
-    m_map.getGC().unlockRawPointerAccess();
+    m_map.getGC().unlockRawPointerAccess(ticket);
 
     m_map.getGC().update();
     return tile;
@@ -414,18 +421,18 @@ typename KisTileHashTableTraits2<T>::TileTypeSP KisTileHashTableTraits2<T>::getR
         /// getTileLazy())
         existingTile = false;
 
-        QReadLocker locker(&m_defaultPixelDataLock);
+        KisStripedReadLocker locker(&m_defaultPixelDataLock);
         return new TileType(col, row, m_defaultTileData, 0);
     }
 
-    m_map.getGC().lockRawPointerAccess();
+    const int ticket = m_map.getGC().lockRawPointerAccess();
     TileTypeSP tile = m_map.get(idx);
-    m_map.getGC().unlockRawPointerAccess();
+    m_map.getGC().unlockRawPointerAccess(ticket);
 
     existingTile = tile;
 
     if (!existingTile) {
-        QReadLocker locker(&m_defaultPixelDataLock);
+        KisStripedReadLocker locker(&m_defaultPixelDataLock);
         tile = new TileType(col, row, m_defaultTileData, 0);
     }
 
@@ -462,20 +469,20 @@ template<class T>
 void KisTileHashTableTraits2<T>::clear()
 {
     {
-        QWriteLocker locker(&m_iteratorLock);
+        KisStripedWriteLocker locker(&m_iteratorLock);
 
         typename ConcurrentMap<quint32, TileType*>::Iterator iter(m_map);
         TileType *tile = 0;
 
         while (iter.isValid()) {
-            m_map.getGC().lockRawPointerAccess();
+            const int ticket = m_map.getGC().lockRawPointerAccess();
             tile = m_map.erase(iter.getKey());
 
             if (tile) {
                 tile->notifyDetachedFromDataManager();
                 m_map.getGC().enqueue(&MemoryReclaimer::destroy, new MemoryReclaimer(tile));
             }
-            m_map.getGC().unlockRawPointerAccess();
+            m_map.getGC().unlockRawPointerAccess(ticket);
 
             iter.next();
         }
@@ -490,7 +497,7 @@ void KisTileHashTableTraits2<T>::clear()
 template <class T>
 inline void KisTileHashTableTraits2<T>::setDefaultTileData(KisTileData *defaultTileData)
 {
-    QWriteLocker locker(&m_defaultPixelDataLock);
+    KisStripedWriteLocker locker(&m_defaultPixelDataLock);
 
     if (m_defaultTileData) {
         m_defaultTileData->release();
@@ -506,14 +513,14 @@ inline void KisTileHashTableTraits2<T>::setDefaultTileData(KisTileData *defaultT
 template <class T>
 inline KisTileData* KisTileHashTableTraits2<T>::defaultTileData()
 {
-    QReadLocker locker(&m_defaultPixelDataLock);
+    KisStripedReadLocker locker(&m_defaultPixelDataLock);
     return m_defaultTileData;
 }
 
 template <class T>
 inline KisTileData* KisTileHashTableTraits2<T>::refAndFetchDefaultTileData()
 {
-    QReadLocker locker(&m_defaultPixelDataLock);
+    KisStripedReadLocker locker(&m_defaultPixelDataLock);
     m_defaultTileData->ref();
     return m_defaultTileData;
 }
@@ -8,6 +8,7 @@
 
 #include <QRect>
 #include <QVector>
+#include <QScopedPointer>
 
 #include "kis_tile.h"
 #include "kis_tiled_data_manager.h"
@@ -20,9 +21,10 @@
 #include "kis_paint_device_writer.h"
 
 #include "kis_global.h"
+#include "kis_assert.h"
 
 
-/* The data area is divided into tiles each say 64x64 pixels (defined at compiletime)
+/* The data area is divided into tiles each say 64x64 pixels (defined per data manager)
  * The tiles are laid out in a matrix that can have negative indexes.
  * The matrix grows automatically if needed (a call for writeacces to a tile
  * outside the current extent)
@@ -32,7 +34,21 @@
 
 KisTiledDataManager::KisTiledDataManager(quint32 pixelSize,
                                          const quint8 *defaultPixel)
+    : KisTiledDataManager(pixelSize, defaultPixel,
+                          KisTileData::WIDTH, KisTileData::HEIGHT)
 {
+}
+
+KisTiledDataManager::KisTiledDataManager(quint32 pixelSize,
+                                         const quint8 *defaultPixel,
+                                         qint32 tileWidth, qint32 tileHeight)
+    : m_tileWidth(isValidTileSize(tileWidth) ? tileWidth : KisTileData::WIDTH),
+      m_tileHeight(isValidTileSize(tileHeight) ? tileHeight : KisTileData::HEIGHT),
+      m_extentManager(m_tileWidth, m_tileHeight),
+      m_evictionPriority(KisTileEvictionPriority::Normal)
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(isValidTileSize(tileWidth) && isValidTileSize(tileHeight));
+
     /* See comment in destructor for details */
     m_mementoManager = new KisMementoManager();
     m_hashTable = new KisTileHashTable(m_mementoManager);
@@ -43,7 +59,11 @@ KisTiledDataManager::KisTiledDataManager(quint32 pixelSize,
 }
 
 KisTiledDataManager::KisTiledDataManager(const KisTiledDataManager &dm)
-    : KisShared()
+    : KisShared(),
+      m_tileWidth(dm.m_tileWidth),
+      m_tileHeight(dm.m_tileHeight),
+      m_extentManager(m_tileWidth, m_tileHeight),
+      m_evictionPriority(KisTileEvictionPriority::Normal)
 {
     /* See comment in destructor for details */
 
@@ -82,6 +102,12 @@ KisTiledDataManager::~KisTiledDataManager()
     delete[] m_defaultPixel;
 }
 
+bool KisTiledDataManager::isValidTileSize(qint32 size)
+{
+    return size >= MIN_TILE_SIZE && size <= MAX_TILE_SIZE &&
+        !(size & (size - 1));
+}
+
 void KisTiledDataManager::setDefaultPixel(const quint8 *defaultPixel)
 {
     QWriteLocker locker(&m_lock);
@@ -90,7 +116,10 @@ void KisTiledDataManager::setDefaultPixel(const quint8 *defaultPixel)
 
 void KisTiledDataManager::setDefaultPixelImpl(const quint8 *defaultPixel)
 {
-    KisTileData *td = KisTileDataStore::instance()->createDefaultTileData(pixelSize(), defaultPixel);
+    KisTileData *td =
+        KisTileDataStore::instance()->createDefaultTileData(pixelSize(), defaultPixel,
+                                                            m_tileWidth, m_tileHeight);
+    td->setEvictionPriority(m_evictionPriority);
     m_hashTable->setDefaultTileData(td);
     m_mementoManager->setDefaultTileData(td);
 
@@ -149,6 +178,10 @@ bool KisTiledDataManager::read(QIODevice *stream)
     quint32 numTiles;
     qint32 tilesVersion = LEGACY_VERSION;
 
+    // legacy files have no header and always use the default tile size
+    qint32 streamTileWidth = KisTileData::WIDTH;
+    qint32 streamTileHeight = KisTileData::HEIGHT;
+
     if (line[0] == 'V') {
         QList<QByteArray> lineItems = line.split(' ');
 
@@ -157,7 +190,7 @@ bool KisTiledDataManager::read(QIODevice *stream)
 
         tilesVersion = lineItems.takeFirst().toInt();
 
-        if(!processTilesHeader(stream, numTiles))
+        if(!processTilesHeader(stream, numTiles, streamTileWidth, streamTileHeight))
             return false;
     }
     else {
@@ -167,13 +200,30 @@ bool KisTiledDataManager::read(QIODevice *stream)
     KisAbstractTileCompressorSP compressor =
         KisTileCompressorFactory::create(tilesVersion);
 
+    /**
+     * If the tiles in the stream have a different size, read them
+     * into a temporary data manager first and then copy the pixels
+     */
+    const bool tileSizeMatches =
+        streamTileWidth == m_tileWidth && streamTileHeight == m_tileHeight;
+
+    QScopedPointer<KisTiledDataManager> streamDM;
+    if (!tileSizeMatches) {
+        streamDM.reset(new KisTiledDataManager(m_pixelSize, m_defaultPixel,
+                                               streamTileWidth, streamTileHeight));
+    }
+
     bool readSuccess = true;
     for (quint32 i = 0; i < numTiles; i++) {
-        if (!compressor->readTile(stream, this)) {
+        if (!compressor->readTile(stream, tileSizeMatches ? this : streamDM.data())) {
             readSuccess = false;
         }
     }
 
+    if (streamDM) {
+        bitBltCopyImpl<false>(streamDM.data(), streamDM->extent());
+    }
+
     m_mementoManager->commit();
     return readSuccess;
 }
@@ -188,8 +238,8 @@ bool KisTiledDataManager::writeTilesHeader(KisPaintDeviceWriter &store, quint32
                      "PIXELSIZE %4\n"
                      "DATA %5\n")
         .arg(CURRENT_VERSION)
-        .arg(KisTileData::WIDTH)
-        .arg(KisTileData::HEIGHT)
+        .arg(m_tileWidth)
+        .arg(m_tileHeight)
         .arg(pixelSize())
         .arg(numTiles);
 
@@ -206,7 +256,8 @@ bool KisTiledDataManager::writeTilesHeader(KisPaintDeviceWriter &store, quint32
     } while(0)                                                  \
 
 
-bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTiles)
+bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTiles,
+                                             qint32 &tileWidth, qint32 &tileHeight)
 {
     /**
      * We assume that there is only one version of this header
@@ -226,12 +277,14 @@ bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTile
         takeOneLine(stream, maxLineLength, keyword, value);
 
         if (keyword == "TILEWIDTH") {
-            if(value != KisTileData::WIDTH)
+            if(!isValidTileSize(value))
                 goto wrongString;
+            tileWidth = value;
         }
         else if (keyword == "TILEHEIGHT") {
-            if(value != KisTileData::HEIGHT)
+            if(!isValidTileSize(value))
                 goto wrongString;
+            tileHeight = value;
         }
         else if (keyword == "PIXELSIZE") {
             if((quint32)value != pixelSize())
@@ -264,7 +317,7 @@ void KisTiledDataManager::purge(const QRect& area)
 {
     QList<KisTileSP> tilesToDelete;
     {
-        const qint32 tileDataSize = KisTileData::HEIGHT * KisTileData::WIDTH * pixelSize();
+        const qint32 tileDataSize = m_tileWidth * m_tileHeight * pixelSize();
         KisTileData *tileData = m_hashTable->refAndFetchDefaultTileData();
         tileData->blockSwapping();
         const quint8 *defaultData = tileData->data();
@@ -293,6 +346,88 @@ void KisTiledDataManager::purge(const QRect& area)
     }
 }
 
+void KisTiledDataManager::prefetchRect(const QRect &rect)
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+    if (rect.isEmpty() || !store->hasSwappedTiles()) return;
+
+    QReadLocker locker(&m_lock);
+
+    const qint32 firstColumn = xToCol(rect.left());
+    const qint32 lastColumn = xToCol(rect.right());
+    const qint32 firstRow = yToRow(rect.top());
+    const qint32 lastRow = yToRow(rect.bottom());
+
+    QVector<KisTileSP> tiles;
+
+    for (qint32 row = firstRow; row <= lastRow; row++) {
+        for (qint32 column = firstColumn; column <= lastColumn; column++) {
+            KisTileSP tile = m_hashTable->getExistingTile(column, row);
+
+            /**
+             * We don't take any locks here, so the check is just a
+             * hint. The prefetcher will do the proper locking itself.
+             */
+            if (tile && !tile->tileData()->data()) {
+                tiles.append(tile);
+            }
+        }
+    }
+
+    store->prefetchTiles(tiles);
+}
+
+void KisTiledDataManager::setEvictionPriority(KisTileEvictionPriority priority)
+{
+    QReadLocker locker(&m_lock);
+
+    m_evictionPriority = priority;
+
+    /**
+     * The new tiles get the priority from the memento manager on
+     * copy-on-write, the default tile data is marked just in case
+     * it is ever swapped out itself
+     */
+    m_mementoManager->setEvictionPriority(priority);
+
+    KisTileData *defaultTileData = m_hashTable->refAndFetchDefaultTileData();
+    defaultTileData->setEvictionPriority(priority);
+    defaultTileData->deref();
+
+    KisTileHashTableConstIterator iter(m_hashTable);
+    KisTileSP tile;
+
+    while ((tile = iter.tile())) {
+        tile->tileData()->setEvictionPriority(priority);
+        iter.next();
+    }
+}
+
+KisTileEvictionPriority KisTiledDataManager::evictionPriority() const
+{
+    return m_evictionPriority;
+}
+
+void KisTiledDataManager::memoryStatistics(qint64 &residentBytes, qint64 &swappedBytes) const
+{
+    residentBytes = 0;
+    swappedBytes = 0;
+
+    const qint64 tileDataSize = qint64(m_tileWidth) * m_tileHeight * pixelSize();
+
+    KisTileHashTableConstIterator iter(m_hashTable);
+    KisTileSP tile;
+
+    while ((tile = iter.tile())) {
+        if (tile->tileData()->data()) {
+            residentBytes += tileDataSize;
+        } else {
+            swappedBytes += tileDataSize;
+        }
+        iter.next();
+    }
+}
+
 quint8* KisTiledDataManager::duplicatePixel(qint32 num, const quint8 *pixel)
 {
     const qint32 pixelSize = this->pixelSize();
@@ -336,27 +471,29 @@ void KisTiledDataManager::clear(QRect clearRect, const quint8 *clearPixel)
     qint32 firstRow = yToRow(clearRect.top());
     qint32 lastRow = yToRow(clearRect.bottom());
 
-    const quint32 rowStride = KisTileData::WIDTH * pixelSize;
+    const quint32 rowStride = m_tileWidth * pixelSize;
 
     // Generate one row
     quint8 *clearPixelData = 0;
-    quint32 maxRunLength = qMin(clearRect.width(), KisTileData::WIDTH);
+    quint32 maxRunLength = qMin(clearRect.width(), m_tileWidth);
     clearPixelData = duplicatePixel(maxRunLength, clearPixel);
 
     KisTileData *td = 0;
     if (!pixelBytesAreDefault &&
-        clearRect.width() >= KisTileData::WIDTH &&
-        clearRect.height() >= KisTileData::HEIGHT) {
+        clearRect.width() >= m_tileWidth &&
+        clearRect.height() >= m_tileHeight) {
 
-        td = KisTileDataStore::instance()->createDefaultTileData(pixelSize, clearPixel);
+        td = KisTileDataStore::instance()->createDefaultTileData(pixelSize, clearPixel,
+                                                                 m_tileWidth, m_tileHeight);
+        td->setEvictionPriority(m_evictionPriority);
         td->acquire();
     }
 
     for (qint32 row = firstRow; row <= lastRow; ++row) {
         for (qint32 column = firstColumn; column <= lastColumn; ++column) {
 
-            QRect tileRect(column*KisTileData::WIDTH, row*KisTileData::HEIGHT,
-                           KisTileData::WIDTH, KisTileData::HEIGHT);
+            QRect tileRect(column*m_tileWidth, row*m_tileHeight,
+                           m_tileWidth, m_tileHeight);
             QRect clearTileRect = clearRect & tileRect;
 
             if (clearTileRect == tileRect) {
@@ -434,11 +571,18 @@ void KisTiledDataManager::bitBltImpl(KisTiledDataManager *srcDM, const QRect &re
 {
     if (rect.isEmpty()) return;
 
+    if (srcDM->tileWidth() != m_tileWidth ||
+        srcDM->tileHeight() != m_tileHeight) {
+
+        bitBltCopyImpl<useOldSrcData>(srcDM, rect);
+        return;
+    }
+
     const qint32 pixelSize = this->pixelSize();
     const bool defaultPixelsCoincide =
         !memcmp(srcDM->defaultPixel(), m_defaultPixel, pixelSize);
 
-    const quint32 rowStride = KisTileData::WIDTH * pixelSize;
+    const quint32 rowStride = m_tileWidth * pixelSize;
 
     qint32 firstColumn = xToCol(rect.left());
     qint32 lastColumn = xToCol(rect.right());
@@ -456,8 +600,8 @@ void KisTiledDataManager::bitBltImpl(KisTiledDataManager *srcDM, const QRect &re
                 srcDM->getOldTile(column, row, srcTileExists) :
                 srcDM->getReadOnlyTileLazy(column, row, srcTileExists);
 
-            QRect tileRect(column*KisTileData::WIDTH, row*KisTileData::HEIGHT,
-                           KisTileData::WIDTH, KisTileData::HEIGHT);
+            QRect tileRect(column*m_tileWidth, row*m_tileHeight,
+                           m_tileWidth, m_tileHeight);
             QRect cloneTileRect = rect & tileRect;
 
             if (cloneTileRect == tileRect) {
@@ -511,6 +655,13 @@ void KisTiledDataManager::bitBltRoughImpl(KisTiledDataManager *srcDM, const QRec
 {
     if (rect.isEmpty()) return;
 
+    if (srcDM->tileWidth() != m_tileWidth ||
+        srcDM->tileHeight() != m_tileHeight) {
+
+        bitBltCopyImpl<useOldSrcData>(srcDM, rect);
+        return;
+    }
+
     const qint32 pixelSize = this->pixelSize();
     const bool defaultPixelsCoincide =
         !memcmp(srcDM->defaultPixel(), m_defaultPixel, pixelSize);
@@ -557,6 +708,61 @@ void KisTiledDataManager::bitBltRoughImpl(KisTiledDataManager *srcDM, const QRec
     }
 }
 
+template<bool useOldSrcData>
+void KisTiledDataManager::bitBltCopyImpl(KisTiledDataManager *srcDM, const QRect &rect)
+{
+    /**
+     * The tiles of the two data managers have different sizes, so
+     * they cannot be shared. Just copy the data tile-by-tile of the
+     * source data manager.
+     */
+
+    const qint32 pixelSize = this->pixelSize();
+    const bool defaultPixelsCoincide =
+        !memcmp(srcDM->defaultPixel(), m_defaultPixel, pixelSize);
+
+    const qint32 srcTileWidth = srcDM->tileWidth();
+    const qint32 srcRowStride = srcTileWidth * pixelSize;
+
+    qint32 firstColumn = srcDM->xToCol(rect.left());
+    qint32 lastColumn = srcDM->xToCol(rect.right());
+
+    qint32 firstRow = srcDM->yToRow(rect.top());
+    qint32 lastRow = srcDM->yToRow(rect.bottom());
+
+    for (qint32 row = firstRow; row <= lastRow; ++row) {
+        for (qint32 column = firstColumn; column <= lastColumn; ++column) {
+
+            bool srcTileExists = false;
+
+            KisTileSP srcTile = useOldSrcData ?
+                srcDM->getOldTile(column, row, srcTileExists) :
+                srcDM->getReadOnlyTileLazy(column, row, srcTileExists);
+
+            const QRect srcTileRect = srcTile->extent();
+            const QRect copyRect = rect & srcTileRect;
+
+            if (!srcTileExists && defaultPixelsCoincide) {
+                clear(copyRect, m_defaultPixel);
+                continue;
+            }
+
+            srcTile->lockForRead();
+
+            const quint8 *srcTileIt = srcTile->data() +
+                ((copyRect.top() - srcTileRect.top()) * srcTileWidth +
+                 copyRect.left() - srcTileRect.left()) * pixelSize;
+
+            writeBytesBody(srcTileIt,
+                           copyRect.x(), copyRect.y(),
+                           copyRect.width(), copyRect.height(),
+                           srcRowStride);
+
+            srcTile->unlockForRead();
+        }
+    }
+}
+
 void KisTiledDataManager::bitBlt(KisTiledDataManager *srcDM, const QRect &rect)
 {
     bitBltImpl<false>(srcDM, rect);
@@ -614,10 +820,10 @@ void KisTiledDataManager::setExtent(QRect newRect)
                 quint8* ptr;
 
                 /* FIXME: make it faster */
-                for (int y = 0; y < KisTileData::HEIGHT; y++) {
-                    for (int x = 0; x < KisTileData::WIDTH; x++) {
+                for (int y = 0; y < m_tileHeight; y++) {
+                    for (int x = 0; x < m_tileWidth; x++) {
                         if (!intersection.contains(x, y)) {
-                            ptr = data + pixelSize * (y * KisTileData::WIDTH + x);
+                            ptr = data + pixelSize * (y * m_tileWidth + x);
                             memcpy(ptr, m_defaultPixel, pixelSize);
                         }
                     }
@@ -660,6 +866,31 @@ QRect KisTiledDataManager::extent() const
     return m_extentManager.extent();
 }
 
+quint64 KisTiledDataManager::contentRevision(const QRect &rect) const
+{
+    if (rect.isEmpty()) return 0;
+
+    const qint32 firstCol = xToCol(rect.left());
+    const qint32 lastCol = xToCol(rect.right());
+    const qint32 firstRow = yToRow(rect.top());
+    const qint32 lastRow = yToRow(rect.bottom());
+
+    quint64 result = 0;
+
+    for (qint32 row = firstRow; row <= lastRow; row++) {
+        for (qint32 col = firstCol; col <= lastCol; col++) {
+            KisTileSP tile = m_hashTable->getExistingTile(col, row);
+            const quint64 revision = tile ? tile->revision() : 0;
+
+            // the order of the tiles is fixed, so the position of
+            // the missing tiles is encoded as well
+            result ^= revision + 0x9e3779b97f4a7c15ULL + (result << 12) + (result >> 4);
+        }
+    }
+
+    return result;
+}
+
 KisRegion KisTiledDataManager::region() const
 {
     QVector<QRect> rects;
@@ -744,9 +975,9 @@ qint32 KisTiledDataManager::numContiguousColumns(qint32 x, qint32 minY, qint32 m
     Q_UNUSED(maxY);
 
     if (x >= 0) {
-        numColumns = KisTileData::WIDTH - (x % KisTileData::WIDTH);
+        numColumns = m_tileWidth - (x % m_tileWidth);
     } else {
-        numColumns = ((-x - 1) % KisTileData::WIDTH) + 1;
+        numColumns = ((-x - 1) % m_tileWidth) + 1;
     }
 
     return numColumns;
@@ -760,9 +991,9 @@ qint32 KisTiledDataManager::numContiguousRows(qint32 y, qint32 minX, qint32 maxX
     Q_UNUSED(maxX);
 
     if (y >= 0) {
-        numRows = KisTileData::HEIGHT - (y % KisTileData::HEIGHT);
+        numRows = m_tileHeight - (y % m_tileHeight);
     } else {
-        numRows = ((-y - 1) % KisTileData::HEIGHT) + 1;
+        numRows = ((-y - 1) % m_tileHeight) + 1;
     }
 
     return numRows;
@@ -773,7 +1004,7 @@ qint32 KisTiledDataManager::rowStride(qint32 x, qint32 y) const
     Q_UNUSED(x);
     Q_UNUSED(y);
 
-    return KisTileData::WIDTH * pixelSize();
+    return m_tileWidth * pixelSize();
 }
 
 void KisTiledDataManager::releaseInternalPools()
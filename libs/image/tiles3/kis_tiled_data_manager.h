@@ -27,6 +27,7 @@
 #include "kis_memento_manager.h"
 #include "kis_memento.h"
 #include "KisTiledExtentManager.h"
+#include "kis_tile_eviction_priority.h"
 
 class KisTiledDataManager;
 typedef KisSharedPtr<KisTiledDataManager> KisTiledDataManagerSP;
@@ -62,6 +63,21 @@ protected:
     /*FIXME:*/
 public:
     KisTiledDataManager(quint32 pixelSize, const quint8 *defPixel);
+
+    /**
+     * Creates a data manager with tiles of \p tileWidth x \p tileHeight
+     * pixels instead of the default KisTileData::WIDTH x
+     * KisTileData::HEIGHT. Bigger tiles reduce the per-tile overhead
+     * for large uniform documents, smaller ones waste less memory on
+     * sparse data. The sizes must be powers of two in range
+     * [MIN_TILE_SIZE, MAX_TILE_SIZE].
+     *
+     * Data managers with different tile sizes cannot share their
+     * tiles, so bitBlt() between them falls back to copying.
+     */
+    KisTiledDataManager(quint32 pixelSize, const quint8 *defPixel,
+                        qint32 tileWidth, qint32 tileHeight);
+
     virtual ~KisTiledDataManager();
     KisTiledDataManager(const KisTiledDataManager &dm);
     KisTiledDataManager & operator=(const KisTiledDataManager &dm);
@@ -77,6 +93,19 @@ protected:
     friend class KisStressJob;
 
 public:
+    static const qint32 MIN_TILE_SIZE = 16;
+    static const qint32 MAX_TILE_SIZE = 512;
+
+    static bool isValidTileSize(qint32 size);
+
+    inline qint32 tileWidth() const {
+        return m_tileWidth;
+    }
+
+    inline qint32 tileHeight() const {
+        return m_tileHeight;
+    }
+
     void setDefaultPixel(const quint8 *defPixel);
     const quint8 *defaultPixel() const {
         return m_defaultPixel;
@@ -149,6 +178,7 @@ public:
             memento->saveNewDefaultPixel(m_defaultPixel, m_pixelSize);
         }
 
+        m_mementoManager->deduplicateChangedTiles(m_hashTable);
         m_mementoManager->commit();
     }
 
@@ -214,6 +244,45 @@ public:
     QRect extent() const;
     void  setExtent(QRect newRect);
 
+    /**
+     * Asks the tile data store to load the swapped-out tiles
+     * intersecting \p rect in a background thread. Does nothing
+     * if no tiles are swapped out.
+     *
+     * \see KisTileDataPrefetcher
+     */
+    void prefetchRect(const QRect &rect);
+
+    /**
+     * Marks all the tiles of the data manager with the eviction
+     * \p priority hint for the swapper. The priority is remembered,
+     * so the tiles created or copied-on-write afterwards get it
+     * as well.
+     *
+     * \see KisTileEvictionPriority
+     */
+    void setEvictionPriority(KisTileEvictionPriority priority);
+    KisTileEvictionPriority evictionPriority() const;
+
+    /**
+     * Counts the bytes of the tile data which is loaded into memory
+     * and which is swapped out at the moment. The tiles shared with
+     * other devices are counted in full. No locks on the tiles are
+     * taken, so the result is approximate.
+     */
+    void memoryStatistics(qint64 &residentBytes, qint64 &swappedBytes) const;
+
+    /**
+     * Returns a hash of the revisions of all the tiles intersecting
+     * \p rect. The value changes whenever any of these tiles is
+     * written into, created or removed, so the caches can use it to
+     * check whether the data they were calculated from is still the
+     * same. The default pixel is not taken into account.
+     *
+     * \see KisTile::revision()
+     */
+    quint64 contentRevision(const QRect &rect) const;
+
     KisRegion region() const;
 
     void clear(QRect clearRect, quint8 clearValue);
@@ -336,7 +405,10 @@ private:
     KisMementoManager *m_mementoManager;
     quint8* m_defaultPixel;
     qint32 m_pixelSize;
+    qint32 m_tileWidth;
+    qint32 m_tileHeight;
     KisTiledExtentManager m_extentManager;
+    KisTileEvictionPriority m_evictionPriority;
 
     mutable QReadWriteLock m_lock;
 
@@ -347,18 +419,19 @@ private:
     friend class KisTileDataWrapper;
     inline qint32 xToCol(qint32 x) const
     {
-        return divideRoundDown(x, KisTileData::WIDTH);
+        return divideRoundDown(x, m_tileWidth);
     }
     inline qint32 yToRow(qint32 y) const
     {
-        return divideRoundDown(y, KisTileData::HEIGHT);
+        return divideRoundDown(y, m_tileHeight);
     }
 
 private:
     void setDefaultPixelImpl(const quint8 *defPixel);
 
     bool writeTilesHeader(KisPaintDeviceWriter &store, quint32 numTiles);
-    bool processTilesHeader(QIODevice *stream, quint32 &numTiles);
+    bool processTilesHeader(QIODevice *stream, quint32 &numTiles,
+                            qint32 &tileWidth, qint32 &tileHeight);
 
     inline qint32 divideRoundDown(qint32 x, const qint32 y) const
     {
@@ -378,6 +451,8 @@ private:
         void bitBltImpl(KisTiledDataManager *srcDM, const QRect &rect);
     template<bool useOldSrcData>
         void bitBltRoughImpl(KisTiledDataManager *srcDM, const QRect &rect);
+    template<bool useOldSrcData>
+        void bitBltCopyImpl(KisTiledDataManager *srcDM, const QRect &rect);
 
     void writeBytesBody(const quint8 *data,
                         qint32 x, qint32 y,
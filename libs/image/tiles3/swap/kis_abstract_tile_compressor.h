@@ -90,6 +90,10 @@ protected:
     inline qint32 pixelSize(KisTiledDataManager *dm) {
         return dm->pixelSize();
     }
+
+    inline qint32 tileDataSize(KisTiledDataManager *dm) {
+        return dm->pixelSize() * dm->tileWidth() * dm->tileHeight();
+    }
 };
 
 #endif /* __KIS_ABSTRACT_TILE_COMPRESSOR_H */
@@ -25,6 +25,7 @@ KisChunkAllocator::KisChunkAllocator(quint64 slabSize, quint64 storeSize)
 
     m_iterator = m_list.begin();
     m_storeSize = m_storeSlabSize;
+    m_allocatedSize = 0;
     INIT_FAIL_COUNTER();
 }
 
@@ -95,21 +96,96 @@ bool KisChunkAllocator::tryInsertChunk(KisChunkDataList &list,
 
     if(GAP_SIZE(lowBound, highBound) >= size) {
         list.insert(iterator, KisChunkData(lowBound + shift, size));
+        m_allocatedSize += size;
         result = true;
     }
 
     return result;
 }
 
-void KisChunkAllocator::freeChunk(KisChunk chunk)
+KisChunkData KisChunkAllocator::freeChunk(KisChunk chunk)
 {
+    m_allocatedSize -= chunk.size();
+
     if(m_iterator != m_list.end() && m_iterator == chunk.position()) {
         m_iterator = m_list.erase(m_iterator);
-        return;
+        return freeGapAt(m_iterator);
     }
 
     Q_ASSERT(chunk.position()->m_begin == chunk.begin());
-    m_list.erase(chunk.position());
+    return freeGapAt(m_list.erase(chunk.position()));
+}
+
+KisChunkData KisChunkAllocator::freeGapAt(KisChunkDataListIterator iterator)
+{
+    /**
+     * The list keeps allocated chunks only, so adjacent free
+     * areas are always coalesced into a single gap
+     */
+
+    quint64 lowBound = 0;
+    quint64 highBound = m_storeSize;
+
+    if(HAS_PREVIOUS(m_list, iterator))
+        lowBound = PEEK_PREVIOUS(iterator).m_end + 1;
+
+    if(HAS_NEXT(m_list, iterator))
+        highBound = PEEK_NEXT(iterator).m_begin;
+
+    return KisChunkData(lowBound, highBound > lowBound ? highBound - lowBound : 0);
+}
+
+bool KisChunkAllocator::tryGetChunkBelow(quint64 size, quint64 limit, KisChunk &chunk)
+{
+    KisChunkDataListIterator iterator = m_list.begin();
+
+    while(iterator != m_list.end()) {
+        quint64 lowBound = 0;
+        quint64 shift = 0;
+
+        if(HAS_PREVIOUS(m_list, iterator)) {
+            lowBound = PEEK_PREVIOUS(iterator).m_end;
+            shift = 1;
+        }
+
+        if(lowBound + shift + size > limit)
+            break;
+
+        if(tryInsertChunk(m_list, iterator, size)) {
+            chunk = WRAP_PREVIOUS_CHUNK_DATA(iterator);
+            return true;
+        }
+
+        iterator++;
+    }
+
+    return false;
+}
+
+quint64 KisChunkAllocator::storeUsedSize() const
+{
+    return !m_list.isEmpty() ? m_list.last().m_end + 1 : 0;
+}
+
+bool KisChunkAllocator::shrinkStore()
+{
+    const quint64 usedSize = storeUsedSize();
+    const quint64 numSlabs = qMax(quint64(1), (usedSize + m_storeSlabSize - 1) / m_storeSlabSize);
+    const quint64 newStoreSize = numSlabs * m_storeSlabSize;
+
+    if(newStoreSize >= m_storeSize)
+        return false;
+
+    m_storeSize = newStoreSize;
+    return true;
+}
+
+qreal KisChunkAllocator::fragmentation() const
+{
+    const quint64 usedSize = storeUsedSize();
+    if(!usedSize) return 0.0;
+
+    return qreal(usedSize - m_allocatedSize) / usedSize;
 }
 
 
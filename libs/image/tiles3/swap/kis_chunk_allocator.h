@@ -125,7 +125,46 @@ public:
     }
 
     KisChunk getChunk(quint64 size);
-    void freeChunk(KisChunk chunk);
+
+    /**
+     * Frees the \p chunk and returns the free gap the chunk
+     * has been merged into. The gap may be used for releasing
+     * the underlying disk space.
+     */
+    KisChunkData freeChunk(KisChunk chunk);
+
+    /**
+     * Tries to allocate a chunk of \p size bytes that ends before
+     * \p limit. The free gaps are checked in the order of their
+     * position in the store, so the chunk is allocated as close
+     * to the beginning of the store as possible. Used for
+     * relocating the chunks during compaction.
+     *
+     * \return true if the chunk has been allocated
+     */
+    bool tryGetChunkBelow(quint64 size, quint64 limit, KisChunk &chunk);
+
+    /**
+     * The offset of the end of the last allocated chunk,
+     * that is the minimal size of the store that can keep
+     * all the chunks
+     */
+    quint64 storeUsedSize() const;
+
+    /**
+     * Reduces the reserved size of the store to the minimal
+     * number of slabs, which can hold all the allocated chunks
+     *
+     * \return true if the size of the store has changed
+     */
+    bool shrinkStore();
+
+    /**
+     * The ratio of the free space between the chunks to the
+     * used size of the store. 0.0 means there are no holes at
+     * all, 1.0 means the store is empty.
+     */
+    qreal fragmentation() const;
 
     void debugChunks();
     bool sanityCheck(bool pleaseCrash = true);
@@ -136,6 +175,8 @@ private:
                         KisChunkDataListIterator &iterator,
                         quint64 size);
 
+    KisChunkData freeGapAt(KisChunkDataListIterator iterator);
+
 private:
     quint64 m_storeMaxSize;
     quint64 m_storeSlabSize;
@@ -144,6 +185,7 @@ private:
     KisChunkDataList m_list;
     KisChunkDataListIterator m_iterator;
     quint64 m_storeSize;
+    quint64 m_allocatedSize;
     DECLARE_FAIL_COUNTER()
 };
 
@@ -0,0 +1,109 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_compression_factory.h"
+
+#include <config-tile-compression.h>
+
+#include "kis_lzf_compression.h"
+
+#ifdef HAVE_LZ4
+#include "kis_lz4_compression.h"
+#endif
+
+#ifdef HAVE_ZSTD
+#include "kis_zstd_compression.h"
+#endif
+
+
+KisAbstractCompression* KisCompressionFactory::create(Type type)
+{
+    switch (type) {
+    case LZF:
+        return new KisLzfCompression();
+#ifdef HAVE_LZ4
+    case LZ4:
+        return new KisLz4Compression();
+#endif
+#ifdef HAVE_ZSTD
+    case ZSTD:
+        return new KisZstdCompression();
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+bool KisCompressionFactory::isAvailable(Type type)
+{
+    switch (type) {
+    case LZF:
+        return true;
+    case LZ4:
+#ifdef HAVE_LZ4
+        return true;
+#else
+        return false;
+#endif
+    case ZSTD:
+#ifdef HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    return false;
+}
+
+QVector<KisCompressionFactory::Type> KisCompressionFactory::availableTypes()
+{
+    QVector<Type> result;
+
+    for (Type type : {LZF, LZ4, ZSTD}) {
+        if (isAvailable(type)) {
+            result << type;
+        }
+    }
+
+    return result;
+}
+
+QString KisCompressionFactory::name(Type type)
+{
+    switch (type) {
+    case LZF:
+        return "LZF";
+    case LZ4:
+        return "LZ4";
+    case ZSTD:
+        return "ZSTD";
+    }
+
+    return "LZF";
+}
+
+KisCompressionFactory::Type KisCompressionFactory::fromName(const QString &name, bool *ok)
+{
+    Type result = LZF;
+    bool found = true;
+
+    if (name == "LZF") {
+        result = LZF;
+    } else if (name == "LZ4") {
+        result = LZ4;
+    } else if (name == "ZSTD") {
+        result = ZSTD;
+    } else {
+        found = false;
+    }
+
+    if (ok) {
+        *ok = found;
+    }
+
+    return result;
+}
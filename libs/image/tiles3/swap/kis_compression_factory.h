@@ -0,0 +1,62 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_COMPRESSION_FACTORY_H
+#define __KIS_COMPRESSION_FACTORY_H
+
+#include "kritaimage_export.h"
+#include <QString>
+#include <QVector>
+
+class KisAbstractCompression;
+
+/**
+ * Creates the compression backends used by KisTileCompressor2
+ * for the swap and for the .kra layer blobs.
+ *
+ * LZF is always available, LZ4 and Zstd are available only
+ * when Krita is built with the corresponding libraries.
+ *
+ * NOTE: the numeric values of Type are stored in the swap
+ * file headers, so don't renumber them!
+ */
+class KRITAIMAGE_EXPORT KisCompressionFactory
+{
+public:
+    enum Type {
+        LZF = 0,
+        LZ4 = 1,
+        ZSTD = 2
+    };
+
+    /**
+     * \return a new compression object of type \p type or nullptr
+     * if the type is not available in this build. The caller takes
+     * the ownership of the object.
+     */
+    static KisAbstractCompression* create(Type type);
+
+    static bool isAvailable(Type type);
+    static QVector<Type> availableTypes();
+
+    /**
+     * The name of the algorithm as it is written into the
+     * tile headers of the .kra files ("LZF", "LZ4", "ZSTD")
+     */
+    static QString name(Type type);
+
+    /**
+     * Parses the name of the algorithm written by name(). If
+     * the name is unknown, \p ok is set to false and LZF is
+     * returned.
+     */
+    static Type fromName(const QString &name, bool *ok = nullptr);
+
+private:
+    KisCompressionFactory();
+};
+
+#endif /* __KIS_COMPRESSION_FACTORY_H */
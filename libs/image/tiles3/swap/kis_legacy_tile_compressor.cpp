@@ -8,8 +8,6 @@
 #include "kis_paint_device_writer.h"
 #include <QIODevice>
 
-#define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
-
 KisLegacyTileCompressor::KisLegacyTileCompressor()
 {
 }
@@ -20,7 +18,7 @@ KisLegacyTileCompressor::~KisLegacyTileCompressor()
 
 bool KisLegacyTileCompressor::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
 {
-    const qint32 tileDataSize = TILE_DATA_SIZE(tile->pixelSize());
+    const qint32 tileDataSize = tile->tileData()->dataSize();
 
     const qint32 bufferSize = maxHeaderLength() + 1;
     QScopedArrayPointer<quint8> headerBuffer(new quint8[bufferSize]);
@@ -42,7 +40,7 @@ bool KisLegacyTileCompressor::writeTile(KisTileSP tile, KisPaintDeviceWriter &st
 
 bool KisLegacyTileCompressor::readTile(QIODevice *stream, KisTiledDataManager *dm)
 {
-    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize(dm));
+    const qint32 dataSize = tileDataSize(dm);
 
     const qint32 bufferSize = maxHeaderLength() + 1;
     quint8 *headerBuffer = new quint8[bufferSize];
@@ -59,7 +57,7 @@ bool KisLegacyTileCompressor::readTile(QIODevice *stream, KisTiledDataManager *d
     KisTileSP tile = dm->getTile(col, row, true);
 
     tile->lockForWrite();
-    stream->read((char *)tile->data(), tileDataSize);
+    stream->read((char *)tile->data(), dataSize);
     tile->unlockForWrite();
 
     return true;
@@ -71,7 +69,7 @@ void KisLegacyTileCompressor::compressTileData(KisTileData *tileData,
                                                qint32 &bytesWritten)
 {
     bytesWritten = 0;
-    const qint32 tileDataSize = TILE_DATA_SIZE(tileData->pixelSize());
+    const qint32 tileDataSize = tileData->dataSize();
     Q_UNUSED(bufferSize);
     Q_ASSERT(bufferSize >= tileDataSize);
     memcpy(buffer, tileData->data(), tileDataSize);
@@ -82,7 +80,7 @@ bool KisLegacyTileCompressor::decompressTileData(quint8 *buffer,
                                                  qint32 bufferSize,
                                                  KisTileData *tileData)
 {
-    const qint32 tileDataSize = TILE_DATA_SIZE(tileData->pixelSize());
+    const qint32 tileDataSize = tileData->dataSize();
     if (bufferSize >= tileDataSize) {
         memcpy(tileData->data(), buffer, tileDataSize);
         return true;
@@ -92,7 +90,7 @@ bool KisLegacyTileCompressor::decompressTileData(quint8 *buffer,
 
 qint32 KisLegacyTileCompressor::tileDataBufferSize(KisTileData *tileData)
 {
-    return TILE_DATA_SIZE(tileData->pixelSize());
+    return tileData->dataSize();
 }
 
 inline qint32 KisLegacyTileCompressor::maxHeaderLength()
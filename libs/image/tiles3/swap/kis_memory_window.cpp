@@ -9,6 +9,11 @@
 
 #include <QDir>
 
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <linux/falloc.h>
+#endif
+
 #define SWP_PREFIX "KRITA_SWAP_FILE_XXXXXX"
 
 KisMemoryWindow::KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize)
@@ -16,6 +21,7 @@ KisMemoryWindow::KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize
       m_writeWindowEx(writeWindowSize)
 {
     m_valid = true;
+    m_canReleaseRanges = true;
 
     // swapDir will never be empty, as KisImageConfig::swapDir() always provides
     // us with a (platform specific) default directory, even if none is explicitly
@@ -65,6 +71,57 @@ quint8* KisMemoryWindow::getWriteChunkPtr(const KisChunkData &writeChunk)
     return m_writeWindowEx.calculatePointer(writeChunk);
 }
 
+void KisMemoryWindow::releaseRange(const KisChunkData &range)
+{
+#if defined(Q_OS_LINUX) && defined(FALLOC_FL_PUNCH_HOLE)
+    if (!m_valid || !m_canReleaseRanges) return;
+
+    const quint64 pageSize = 4096;
+    const quint64 begin = (range.m_begin + pageSize - 1) & ~(pageSize - 1);
+    const quint64 end = (range.m_end + 1) & ~(pageSize - 1);
+
+    if (end <= begin) return;
+
+    if (fallocate(m_file.handle(), FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                  begin, end - begin) != 0) {
+
+        /**
+         * The file system doesn't support sparse files,
+         * so there is no reason to try again
+         */
+        m_canReleaseRanges = false;
+    }
+#else
+    Q_UNUSED(range);
+#endif
+}
+
+bool KisMemoryWindow::truncate(quint64 size)
+{
+    if (!m_valid || size >= quint64(m_file.size())) return true;
+
+    /**
+     * Just reset both the mappings, they will be recreated
+     * on the next access. It also makes Windows happy, because
+     * it cannot resize the file while there are views on it.
+     */
+    MappingWindow *windows[] = {&m_readWindowEx, &m_writeWindowEx};
+    for (MappingWindow *window : windows) {
+        if (window->window) {
+            m_file.unmap(window->window);
+            window->window = 0;
+            window->chunk.setChunk(0, 0);
+        }
+    }
+
+    return m_file.resize(size);
+}
+
+quint64 KisMemoryWindow::fileSize() const
+{
+    return m_valid ? quint64(m_file.size()) : 0;
+}
+
 bool KisMemoryWindow::adjustWindow(const KisChunkData &requestedChunk,
                                    MappingWindow *adjustingWindow,
                                    MappingWindow *otherWindow)
@@ -35,6 +35,29 @@ public:
     quint8* getReadChunkPtr(const KisChunkData &readChunk);
     quint8* getWriteChunkPtr(const KisChunkData &writeChunk);
 
+    /**
+     * Returns the disk space occupied by the \p range back to the
+     * file system. The file is kept sparse, so the size of the file
+     * is not changed and the range will read as zeroes afterwards.
+     * Only the pages lying completely inside the range are released.
+     *
+     * Currently, it is implemented on Linux only (fallocate() with
+     * FALLOC_FL_PUNCH_HOLE), on other systems the call is a noop.
+     */
+    void releaseRange(const KisChunkData &range);
+
+    /**
+     * Shrinks the swap file to \p size bytes. All the mappings
+     * are reset, so the pointers previously returned by
+     * getReadChunkPtr() and getWriteChunkPtr() become invalid.
+     */
+    bool truncate(quint64 size);
+
+    /**
+     * The current size of the swap file
+     */
+    quint64 fileSize() const;
+
 private:
     struct MappingWindow {
         MappingWindow(quint64 _defaultSize)
@@ -63,6 +86,7 @@ private:
     QTemporaryFile m_file;
 
     bool m_valid;
+    bool m_canReleaseRanges;
     MappingWindow m_readWindowEx;
     MappingWindow m_writeWindowEx;
 };
@@ -4,7 +4,7 @@
  *  SPDX-License-Identifier: GPL-2.0-or-later
  */
 
-//#include "kis_debug.h"
+#include "kis_debug.h"
 #include "kis_swapped_data_store.h"
 #include "kis_memory_window.h"
 #include "kis_image_config.h"
@@ -24,8 +24,11 @@ KisSwappedDataStore::KisSwappedDataStore()
     m_allocator = new KisChunkAllocator(swapSlabSize, maxSwapSize);
     m_swapSpace = new KisMemoryWindow(config.swapDir(), swapWindowSize);
 
+    const KisCompressionFactory::Type compressionType =
+        KisCompressionFactory::fromName(config.swapCompression());
+
     // FIXME: use a factory after the patch is committed
-    m_compressor = new KisTileCompressor2();
+    m_compressor = new KisTileCompressor2(compressionType);
 }
 
 KisSwappedDataStore::~KisSwappedDataStore()
@@ -71,8 +74,9 @@ bool KisSwappedDataStore::trySwapOutTileData(KisTileData *td)
 
     td->releaseMemory();
     td->setSwapChunk(chunk);
+    m_tilesByOffset.insert(chunk.begin(), td);
 
-    m_memoryMetric += td->pixelSize();
+    m_memoryMetric += td->memoryMetric();
 
     return true;
 }
@@ -92,19 +96,106 @@ void KisSwappedDataStore::swapInTileData(KisTileData *td)
     quint8 *ptr = m_swapSpace->getReadChunkPtr(chunk);
     Q_ASSERT(ptr);
     m_compressor->decompressTileData(ptr, chunk.size(), td);
-    m_allocator->freeChunk(chunk);
+    m_tilesByOffset.remove(chunk.begin());
+    m_swapSpace->releaseRange(m_allocator->freeChunk(chunk));
 
-    m_memoryMetric -= td->pixelSize();
+    m_memoryMetric -= td->memoryMetric();
 }
 
 void KisSwappedDataStore::forgetTileData(KisTileData *td)
 {
     QMutexLocker locker(&m_lock);
 
-    m_allocator->freeChunk(td->swapChunk());
+    KisChunk chunk = td->swapChunk();
+    m_tilesByOffset.remove(chunk.begin());
+    m_swapSpace->releaseRange(m_allocator->freeChunk(chunk));
     td->setSwapChunk(KisChunk());
 
-    m_memoryMetric -= td->pixelSize();
+    m_memoryMetric -= td->memoryMetric();
+}
+
+QVector<KisTileData*> KisSwappedDataStore::relocationCandidates(int maxCount)
+{
+    QMutexLocker locker(&m_lock);
+
+    QVector<KisTileData*> result;
+    result.reserve(qMin(maxCount, m_tilesByOffset.size()));
+
+    auto it = m_tilesByOffset.constEnd();
+    while (it != m_tilesByOffset.constBegin() && result.size() < maxCount) {
+        --it;
+        result.append(it.value());
+    }
+
+    return result;
+}
+
+bool KisSwappedDataStore::tryRelocateTileData(KisTileData *td)
+{
+    Q_ASSERT(!td->data());
+    QMutexLocker locker(&m_lock);
+
+    KisChunk oldChunk = td->swapChunk();
+    KisChunk newChunk;
+
+    if (!m_allocator->tryGetChunkBelow(oldChunk.size(), oldChunk.begin(), newChunk)) {
+        return false;
+    }
+
+    /**
+     * The read and write windows may overlap, so copy the data
+     * through the intermediate buffer
+     */
+    const qint32 size = oldChunk.size();
+    if (m_buffer.size() < size)
+        m_buffer.resize(size);
+
+    quint8 *ptr = m_swapSpace->getReadChunkPtr(oldChunk);
+    KIS_SAFE_ASSERT_RECOVER(ptr) {
+        m_allocator->freeChunk(newChunk);
+        return false;
+    }
+    memcpy(m_buffer.data(), ptr, size);
+
+    ptr = m_swapSpace->getWriteChunkPtr(newChunk);
+    KIS_SAFE_ASSERT_RECOVER(ptr) {
+        m_allocator->freeChunk(newChunk);
+        return false;
+    }
+    memcpy(ptr, m_buffer.data(), size);
+
+    m_tilesByOffset.remove(oldChunk.begin());
+    m_tilesByOffset.insert(newChunk.begin(), td);
+    td->setSwapChunk(newChunk);
+
+    m_swapSpace->releaseRange(m_allocator->freeChunk(oldChunk));
+
+    return true;
+}
+
+void KisSwappedDataStore::shrinkSwapFile()
+{
+    QMutexLocker locker(&m_lock);
+
+    m_allocator->shrinkStore();
+
+    const quint64 pageSize = 4096;
+    const quint64 usedSize =
+        (m_allocator->storeUsedSize() + pageSize - 1) & ~(pageSize - 1);
+
+    m_swapSpace->truncate(usedSize);
+}
+
+qreal KisSwappedDataStore::fragmentation() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_allocator->fragmentation();
+}
+
+quint64 KisSwappedDataStore::swapFileSize() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_swapSpace->fileSize();
 }
 
 qint64 KisSwappedDataStore::totalMemoryMetric() const
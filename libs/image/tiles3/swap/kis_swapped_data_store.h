@@ -11,6 +11,8 @@
 
 #include <QMutex>
 #include <QByteArray>
+#include <QMap>
+#include <QVector>
 
 
 class QMutex;
@@ -53,6 +55,41 @@ public:
      */
     void forgetTileData(KisTileData *td);
 
+    /**
+     * Returns up to \p maxCount tile data objects, whose chunks are
+     * placed closest to the end of the swap file. Relocating them
+     * into the holes at the beginning of the file lets us shrink it.
+     */
+    QVector<KisTileData*> relocationCandidates(int maxCount);
+
+    /**
+     * Moves the swapped data of \a td into the first free gap
+     * closer to the beginning of the swap file, if there is any.
+     * LOCKING: the lock on the tile data should be taken
+     *          by the caller before making a call.
+     *
+     * \return true if the data has been moved
+     */
+    bool tryRelocateTileData(KisTileData *td);
+
+    /**
+     * Cuts the unused tail of the swap file off and returns the
+     * space to the file system
+     */
+    void shrinkSwapFile();
+
+    /**
+     * The ratio of unused holes in the swap file, from 0.0
+     * (no holes at all) to 1.0 (no data is stored)
+     */
+    qreal fragmentation() const;
+
+    /**
+     * The size of the swap file on disk (including the
+     * holes, which can be sparse)
+     */
+    quint64 swapFileSize() const;
+
     /**
      * Retorns the metric of the total memory stored in the swap
      * in *uncompressed* form!
@@ -71,7 +108,13 @@ private:
     KisChunkAllocator *m_allocator;
     KisMemoryWindow *m_swapSpace;
 
-    QMutex m_lock;
+    mutable QMutex m_lock;
+
+    /**
+     * Swapped out tile data objects sorted by the offset
+     * of their chunks in the swap file
+     */
+    QMap<quint64, KisTileData*> m_tilesByOffset;
 
     qint64 m_memoryMetric;
 };
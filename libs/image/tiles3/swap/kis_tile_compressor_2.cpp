@@ -5,27 +5,63 @@
  */
 
 #include "kis_tile_compressor_2.h"
-#include "kis_lzf_compression.h"
+#include "kis_abstract_compression.h"
+#include "kis_tile_linearizer_factory.h"
 #include <QIODevice>
 #include "kis_paint_device_writer.h"
-#define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
 
-const QString KisTileCompressor2::m_compressionName = "LZF";
 
-
-KisTileCompressor2::KisTileCompressor2()
+KisTileCompressor2::KisTileCompressor2(KisCompressionFactory::Type compressionType)
+    : m_compressionType(compressionType)
 {
-    m_compression = new KisLzfCompression();
+    if (!KisCompressionFactory::isAvailable(m_compressionType)) {
+        warnTiles << "Tile compression" << KisCompressionFactory::name(m_compressionType)
+                  << "is not available in this build, falling back to LZF";
+        m_compressionType = KisCompressionFactory::LZF;
+    }
+
+    m_compression = compressionForType(m_compressionType);
 }
 
 KisTileCompressor2::~KisTileCompressor2()
 {
-    delete m_compression;
+    for (KisAbstractCompression *compression : m_compressions) {
+        delete compression;
+    }
+
+    qDeleteAll(m_linearizers);
+}
+
+KisCompressionFactory::Type KisTileCompressor2::compressionType() const
+{
+    return m_compressionType;
+}
+
+KisAbstractCompression* KisTileCompressor2::compressionForType(KisCompressionFactory::Type type)
+{
+    KisAbstractCompression *&compression = m_compressions[type];
+
+    if (!compression) {
+        compression = KisCompressionFactory::create(type);
+    }
+
+    return compression;
+}
+
+KisTileLinearizerBase* KisTileCompressor2::linearizerForPixelSize(qint32 pixelSize)
+{
+    KisTileLinearizerBase *&linearizer = m_linearizers[pixelSize];
+
+    if (!linearizer) {
+        linearizer = KisTileLinearizerFactory::create(pixelSize);
+    }
+
+    return linearizer;
 }
 
 bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
 {
-    const qint32 tileDataSize = TILE_DATA_SIZE(tile->pixelSize());
+    const qint32 tileDataSize = tile->tileData()->dataSize();
     prepareStreamingBuffer(tileDataSize);
 
     qint32 bytesWritten;
@@ -50,8 +86,7 @@ bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
 
 bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
 {
-    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize(dm));
-    prepareStreamingBuffer(tileDataSize);
+    prepareStreamingBuffer(tileDataSize(dm));
 
     QByteArray header = stream->readLine(maxHeaderLength());
 
@@ -63,15 +98,28 @@ bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
         qint32 dataSize = headerItems.takeFirst().toInt();
 
         Q_ASSERT(headerItems.isEmpty());
-        Q_ASSERT(compressionName == m_compressionName);
+
+        if (dataSize > m_streamingBuffer.size()) {
+            warnFile << "Corrupted tile data size:" << dataSize;
+            return false;
+        }
+
+        bool compressionKnown = false;
+        const KisCompressionFactory::Type type =
+            KisCompressionFactory::fromName(compressionName, &compressionKnown);
+
+        stream->read(m_streamingBuffer.data(), dataSize);
+
+        if (!compressionKnown || !KisCompressionFactory::isAvailable(type)) {
+            warnFile << "Unsupported tile compression:" << compressionName;
+            return false;
+        }
 
         qint32 row = yToRow(dm, y);
         qint32 col = xToCol(dm, x);
 
         KisTileSP tile = dm->getTile(col, row, true);
 
-        stream->read(m_streamingBuffer.data(), dataSize);
-
         tile->lockForWrite();
         bool res = decompressTileData((quint8*)m_streamingBuffer.data(), dataSize, tile->tileData());
         tile->unlockForWrite();
@@ -108,7 +156,7 @@ void KisTileCompressor2::compressTileData(KisTileData *tileData,
                                           qint32 &bytesWritten)
 {
     const qint32 pixelSize = tileData->pixelSize();
-    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize);
+    const qint32 tileDataSize = tileData->dataSize();
     qint32 compressedBytes;
 
     Q_UNUSED(bufferSize);
@@ -116,14 +164,15 @@ void KisTileCompressor2::compressTileData(KisTileData *tileData,
 
     prepareWorkBuffers(tileDataSize);
 
-    KisAbstractCompression::linearizeColors(tileData->data(), (quint8*)m_linearizationBuffer.data(),
-                                            tileDataSize, pixelSize);
+    linearizerForPixelSize(pixelSize)->linearizeColors(tileData->data(),
+                                                       (quint8*)m_linearizationBuffer.data(),
+                                                       tileDataSize);
 
     compressedBytes = m_compression->compress((quint8*)m_linearizationBuffer.data(), tileDataSize,
                                               (quint8*)m_compressionBuffer.data(), m_compressionBuffer.size());
 
-    if(compressedBytes < tileDataSize) {
-        buffer[0] = COMPRESSED_DATA_FLAG;
+    if(compressedBytes > 0 && compressedBytes < tileDataSize) {
+        buffer[0] = COMPRESSED_DATA_FLAG + m_compressionType;
         memcpy(buffer + 1, m_compressionBuffer.data(), compressedBytes);
         bytesWritten = compressedBytes + 1;
     }
@@ -139,18 +188,30 @@ bool KisTileCompressor2::decompressTileData(quint8 *buffer,
                                             KisTileData *tileData)
 {
     const qint32 pixelSize = tileData->pixelSize();
-    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize);
+    const qint32 tileDataSize = tileData->dataSize();
+
+    if(buffer[0] >= COMPRESSED_DATA_FLAG) {
+        const int type = buffer[0] - COMPRESSED_DATA_FLAG;
+
+        if (type > KisCompressionFactory::ZSTD ||
+            !KisCompressionFactory::isAvailable(KisCompressionFactory::Type(type))) {
+
+            warnTiles << "Tile data is compressed with an unsupported algorithm:" << type;
+            return false;
+        }
+
+        KisAbstractCompression *compression =
+            compressionForType(KisCompressionFactory::Type(type));
 
-    if(buffer[0] == COMPRESSED_DATA_FLAG) {
         prepareWorkBuffers(tileDataSize);
 
         qint32 bytesWritten;
-        bytesWritten = m_compression->decompress(buffer + 1, bufferSize - 1,
-                                                 (quint8*)m_linearizationBuffer.data(), tileDataSize);
+        bytesWritten = compression->decompress(buffer + 1, bufferSize - 1,
+                                               (quint8*)m_linearizationBuffer.data(), tileDataSize);
         if (bytesWritten == tileDataSize) {
-            KisAbstractCompression::delinearizeColors((quint8*)m_linearizationBuffer.data(),
-                                                      tileData->data(),
-                                                      tileDataSize, pixelSize);
+            linearizerForPixelSize(pixelSize)->delinearizeColors((quint8*)m_linearizationBuffer.data(),
+                                                                 tileData->data(),
+                                                                 tileDataSize);
             return true;
         }
         return false;
@@ -165,7 +226,7 @@ bool KisTileCompressor2::decompressTileData(quint8 *buffer,
 
 qint32 KisTileCompressor2::tileDataBufferSize(KisTileData *tileData)
 {
-    return TILE_DATA_SIZE(tileData->pixelSize()) + 1;
+    return tileData->dataSize() + 1;
 }
 
 inline qint32 KisTileCompressor2::maxHeaderLength()
@@ -184,5 +245,5 @@ inline QString KisTileCompressor2::getHeader(KisTileSP tile,
     qint32 width, height;
     tile->extent().getRect(&x, &y, &width, &height);
 
-    return QString("%1,%2,%3,%4\n").arg(x).arg(y).arg(m_compressionName).arg(compressedSize);
+    return QString("%1,%2,%3,%4\n").arg(x).arg(y).arg(KisCompressionFactory::name(m_compressionType)).arg(compressedSize);
 }
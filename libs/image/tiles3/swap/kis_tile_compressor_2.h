@@ -7,14 +7,28 @@
 #ifndef __KIS_TILE_COMPRESSOR_2_H
 #define __KIS_TILE_COMPRESSOR_2_H
 
+#include <QHash>
+
 #include "kis_abstract_tile_compressor.h"
+#include "kis_compression_factory.h"
 
 class KisAbstractCompression;
+class KisTileLinearizerBase;
 
+/**
+ * Compresses the tiles with one of the algorithms provided by
+ * KisCompressionFactory after splitting the pixel data into
+ * separate byte planes.
+ *
+ * The first byte of every compressed tile data buffer tells
+ * which algorithm has been used to write it, so the compressor
+ * can read the tiles written with any of the available algorithms,
+ * not only with the one it was created with.
+ */
 class KRITAIMAGE_EXPORT KisTileCompressor2 : public KisAbstractTileCompressor
 {
 public:
-    KisTileCompressor2();
+    KisTileCompressor2(KisCompressionFactory::Type compressionType = KisCompressionFactory::LZF);
     ~KisTileCompressor2() override;
 
     bool writeTile(KisTileSP tile, KisPaintDeviceWriter &store) override;
@@ -26,6 +40,8 @@ public:
     bool decompressTileData(quint8 *buffer, qint32 bufferSize, KisTileData *tileData) override;
     qint32 tileDataBufferSize(KisTileData *tileData) override;
 
+    KisCompressionFactory::Type compressionType() const;
+
 private:
     /**
      * Quite self describing
@@ -37,7 +53,16 @@ private:
     void prepareWorkBuffers(qint32 tileDataSize);
     void prepareStreamingBuffer(qint32 tileDataSize);
 
+    KisAbstractCompression* compressionForType(KisCompressionFactory::Type type);
+    KisTileLinearizerBase* linearizerForPixelSize(qint32 pixelSize);
+
 private:
+    /**
+     * The data flag is the first byte of the buffer. For the
+     * compressed data it is COMPRESSED_DATA_FLAG plus the value
+     * of KisCompressionFactory::Type, so the tiles written by the
+     * older versions of Krita (LZF only) are still readable.
+     */
     static const qint8 RAW_DATA_FLAG = 0;
     static const qint8 COMPRESSED_DATA_FLAG = 1;
 
@@ -45,8 +70,22 @@ private:
     QByteArray m_linearizationBuffer;
     QByteArray m_compressionBuffer;
     QByteArray m_streamingBuffer;
+
+    KisCompressionFactory::Type m_compressionType;
     KisAbstractCompression *m_compression;
-    static const QString m_compressionName;
+
+    /**
+     * Owns all the compression objects, indexed by their type. The
+     * ones that differ from m_compressionType are created lazily,
+     * when a tile written with them is being read.
+     */
+    KisAbstractCompression *m_compressions[3] = {nullptr, nullptr, nullptr};
+
+    /**
+     * The byte plane splitters optimized for the current CPU,
+     * created lazily for every pixel size we meet
+     */
+    QHash<qint32, KisTileLinearizerBase*> m_linearizers;
 };
 
 #endif /* __KIS_TILE_COMPRESSOR_2_H */
@@ -0,0 +1,147 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "tiles3/swap/kis_tile_data_prefetcher.h"
+
+#include <QMutex>
+#include <QQueue>
+#include <QSemaphore>
+
+#include "tiles3/kis_tile.h"
+#include "kis_debug.h"
+
+/**
+ * The queue is bounded to avoid pulling the whole swap file back
+ * when a huge update comes. The oldest requests are dropped first,
+ * because the update threads have most probably already fetched them.
+ */
+const int KisTileDataPrefetcher::MAX_QUEUE_SIZE = 4096;
+
+
+struct Q_DECL_HIDDEN KisTileDataPrefetcher::Private
+{
+    QSemaphore semaphore;
+    QAtomicInt shouldExitFlag;
+    KisTileDataStore *store;
+
+    QMutex queueLock;
+    QQueue<KisTileSP> queue;
+
+    QAtomicInteger<qint64> numRequested;
+    QAtomicInteger<qint64> numDropped;
+    QAtomicInteger<qint64> numHits;
+    QAtomicInteger<qint64> numMisses;
+};
+
+KisTileDataPrefetcher::KisTileDataPrefetcher(KisTileDataStore *store)
+    : QThread(),
+      m_d(new Private())
+{
+    m_d->shouldExitFlag = 0;
+    m_d->store = store;
+}
+
+KisTileDataPrefetcher::~KisTileDataPrefetcher()
+{
+    delete m_d;
+}
+
+void KisTileDataPrefetcher::prefetch(const QVector<KisTileSP> &tiles)
+{
+    if (tiles.isEmpty()) return;
+
+    {
+        QMutexLocker l(&m_d->queueLock);
+
+        Q_FOREACH (KisTileSP tile, tiles) {
+            m_d->queue.enqueue(tile);
+        }
+
+        while (m_d->queue.size() > MAX_QUEUE_SIZE) {
+            m_d->queue.dequeue();
+            m_d->numDropped.ref();
+        }
+    }
+
+    m_d->numRequested.fetchAndAddRelaxed(tiles.size());
+    m_d->semaphore.release();
+}
+
+void KisTileDataPrefetcher::terminatePrefetcher()
+{
+    {
+        QMutexLocker l(&m_d->queueLock);
+        m_d->queue.clear();
+    }
+
+    unsigned long exitTimeout = 100;
+    do {
+        m_d->shouldExitFlag = true;
+        m_d->semaphore.release();
+    } while(!wait(exitTimeout));
+}
+
+void KisTileDataPrefetcher::registerSwapIn()
+{
+    if (QThread::currentThread() == this) {
+        m_d->numHits.ref();
+    } else {
+        m_d->numMisses.ref();
+    }
+}
+
+KisTileDataPrefetcher::Statistics KisTileDataPrefetcher::statistics() const
+{
+    Statistics stats;
+
+    stats.numRequested = m_d->numRequested.loadAcquire();
+    stats.numDropped = m_d->numDropped.loadAcquire();
+    stats.numHits = m_d->numHits.loadAcquire();
+    stats.numMisses = m_d->numMisses.loadAcquire();
+
+    return stats;
+}
+
+void KisTileDataPrefetcher::resetStatistics()
+{
+    m_d->numRequested = 0;
+    m_d->numDropped = 0;
+    m_d->numHits = 0;
+    m_d->numMisses = 0;
+}
+
+void KisTileDataPrefetcher::waitForWork()
+{
+    m_d->semaphore.acquire();
+}
+
+void KisTileDataPrefetcher::run()
+{
+    while (1) {
+        waitForWork();
+
+        if (m_d->shouldExitFlag)
+            return;
+
+        while (!m_d->shouldExitFlag) {
+            KisTileSP tile;
+
+            {
+                QMutexLocker l(&m_d->queueLock);
+                if (m_d->queue.isEmpty()) break;
+                tile = m_d->queue.dequeue();
+            }
+
+            /**
+             * Locking the tile for reading makes the store to
+             * swap the data in. The age of the tile data is reset,
+             * so the swapper will not throw it away immediately.
+             */
+            tile->lockForRead();
+            tile->unlockForRead();
+        }
+    }
+}
@@ -0,0 +1,94 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KIS_TILE_DATA_PREFETCHER_H_
+#define KIS_TILE_DATA_PREFETCHER_H_
+
+#include <QObject>
+#include <QThread>
+#include <QVector>
+
+#include <kis_shared_ptr.h>
+
+#include "kritaimage_export.h"
+
+
+class KisTile;
+class KisTileDataStore;
+
+/**
+ * A background thread that reads swapped-out tiles back into
+ * memory before the update threads access them.
+ *
+ * The walkers and the strokes feed the prefetcher with the tiles
+ * they are going to touch soon (see KisTiledDataManager::prefetchRect()).
+ * The prefetcher thread locks every queued tile for reading, which
+ * makes KisTileDataStore load and decompress it in the background,
+ * instead of doing that in the paint thread.
+ */
+class KRITAIMAGE_EXPORT KisTileDataPrefetcher : public QThread
+{
+    Q_OBJECT
+
+public:
+    struct Statistics {
+        /**
+         * The number of tiles passed to prefetch()
+         */
+        qint64 numRequested = 0;
+
+        /**
+         * The number of requested tiles dropped because
+         * the queue was full
+         */
+        qint64 numDropped = 0;
+
+        /**
+         * The number of tiles swapped-in by the prefetcher thread
+         */
+        qint64 numHits = 0;
+
+        /**
+         * The number of tiles swapped-in synchronously by the
+         * threads that actually needed the data
+         */
+        qint64 numMisses = 0;
+    };
+
+public:
+    KisTileDataPrefetcher(KisTileDataStore *store);
+    ~KisTileDataPrefetcher() override;
+
+    /**
+     * Queues the tiles for loading into memory. The queue holds
+     * references to the tiles, so they cannot be destroyed while
+     * waiting in the queue.
+     */
+    void prefetch(const QVector<KisSharedPtr<KisTile>> &tiles);
+
+    void terminatePrefetcher();
+
+    /**
+     * Called by KisTileDataStore every time it reads a tile from
+     * the swap file
+     */
+    void registerSwapIn();
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    void waitForWork();
+    void run() override;
+
+private:
+    static const int MAX_QUEUE_SIZE;
+
+private:
+    struct Private;
+    Private * const m_d;
+};
+
+#endif /* KIS_TILE_DATA_PREFETCHER_H_ */
@@ -12,11 +12,14 @@
 #include "tiles3/kis_tile_data_store.h"
 #include "tiles3/kis_tile_data_store_iterators.h"
 #include "kis_debug.h"
+#include "KisTraceEvents.h"
 
 #define SEC 1000
 
 const qint32 KisTileDataSwapper::TIMEOUT = -1;
 const qint32 KisTileDataSwapper::DELAY = 0.7 * SEC;
+const qint32 KisTileDataSwapper::IDLE_TIMEOUT = 5 * SEC;
+const qint32 KisTileDataSwapper::COMPACTION_BATCH_SIZE = 64;
 
 //#define DEBUG_SWAPPER
 
@@ -28,6 +31,7 @@ const qint32 KisTileDataSwapper::DELAY = 0.7 * SEC;
 #define DEBUG_VALUE(value)
 #endif
 
+class PreferredSwapStrategy;
 class SoftSwapStrategy;
 class AggressiveSwapStrategy;
 
@@ -48,6 +52,8 @@ KisTileDataSwapper::KisTileDataSwapper(KisTileDataStore *store)
 {
     m_d->shouldExitFlag = 0;
     m_d->store = store;
+
+    setObjectName("KisTileDataSwapper");
 }
 
 KisTileDataSwapper::~KisTileDataSwapper()
@@ -69,25 +75,54 @@ void KisTileDataSwapper::terminateSwapper()
     } while(!wait(exitTimeout));
 }
 
-void KisTileDataSwapper::waitForWork()
+bool KisTileDataSwapper::waitForWork()
 {
-    m_d->semaphore.tryAcquire(1, TIMEOUT);
+    /**
+     * While there is something in the swap, wake up from time
+     * to time to compact the swap file
+     */
+    const qint32 timeout =
+        m_d->store->hasSwappedTiles() ? IDLE_TIMEOUT : TIMEOUT;
+
+    return m_d->semaphore.tryAcquire(1, timeout);
 }
 
 void KisTileDataSwapper::run()
 {
     while (1) {
-        waitForWork();
+        const bool hasWork = waitForWork();
 
         if (m_d->shouldExitFlag)
             return;
 
+        if (!hasWork) {
+            compactSwap();
+            continue;
+        }
+
         QThread::msleep(DELAY);
 
         doJob();
     }
 }
 
+void KisTileDataSwapper::compactSwap()
+{
+    /**
+     * Relocate the tiles in small batches to avoid blocking
+     * the store for a long time, and stop as soon as some
+     * real work arrives
+     */
+    KIS_TRACE_SCOPE("swapper", "compact swap");
+
+    while (!m_d->shouldExitFlag &&
+           !m_d->semaphore.available() &&
+           m_d->store->compactSwap(COMPACTION_BATCH_SIZE)) {
+
+        QThread::yieldCurrentThread();
+    }
+}
+
 void KisTileDataSwapper::checkFreeMemory()
 {
 //    dbgKrita <<"check memory: high limit -" << m_d->limits.emergencyThreshold() <<"in mem -" << m_d->store->numTilesInMemory();
@@ -103,6 +138,8 @@ void KisTileDataSwapper::doJob()
      */
     QMutexLocker locker(&m_d->cycleLock);
 
+    KIS_TRACE_SCOPE("swapper", "swap cycle");
+
     qint32 memoryMetric = m_d->store->memoryMetric();
 
     DEBUG_ACTION("Started swap cycle");
@@ -118,9 +155,16 @@ void KisTileDataSwapper::doJob()
         qint32 softFree =  memoryMetric - m_d->limits.softLimit();
         DEBUG_VALUE(softFree);
         DEBUG_ACTION("\t pass0");
-        memoryMetric -= pass<SoftSwapStrategy>(softFree);
+        qint64 freedMetric = pass<PreferredSwapStrategy>(softFree);
+        memoryMetric -= freedMetric;
         DEBUG_VALUE(memoryMetric);
 
+        if (freedMetric < softFree) {
+            DEBUG_ACTION("\t pass0.5");
+            memoryMetric -= pass<SoftSwapStrategy>(softFree - freedMetric);
+            DEBUG_VALUE(memoryMetric);
+        }
+
         if(memoryMetric > m_d->limits.hardLimitThreshold()) {
             qint32 hardFree =  memoryMetric - m_d->limits.hardLimit();
             DEBUG_VALUE(hardFree);
@@ -132,6 +176,29 @@ void KisTileDataSwapper::doJob()
 }
 
 
+class PreferredSwapStrategy
+{
+public:
+    typedef KisTileDataStoreIterator iterator;
+
+    static inline iterator* beginIteration(KisTileDataStore *store) {
+        return store->beginIteration();
+    }
+
+    static inline void endIteration(KisTileDataStore *store, iterator *iter) {
+        store->endIteration(iter);
+    }
+
+    static inline bool isInteresting(KisTileData *td) {
+        // Invisible layers and LoD planes go first...
+        return td->evictionPriority() == KisTileEvictionPriority::Preferred;
+    }
+
+    static inline bool swapOutFirst(KisTileData *td) {
+        return td->age() > 0;
+    }
+};
+
 class SoftSwapStrategy
 {
 public:
@@ -175,7 +242,9 @@ public:
     }
 
     static inline bool swapOutFirst(KisTileData *td) {
-        return td->age() > 0;
+        // ...but keep the active node as long as possible
+        return td->age() > 0 &&
+            td->evictionPriority() != KisTileEvictionPriority::Protected;
     }
 };
 
@@ -183,6 +252,8 @@ public:
 template<class strategy>
 qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
 {
+    KIS_TRACE_SCOPE("swapper", "swap pass");
+
     qint64 freedMetric = 0;
     QList<KisTileData*> additionalCandidates;
 
@@ -200,7 +271,7 @@ qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
 
         if (strategy::swapOutFirst(item)) {
             if (iter->trySwapOut(item)) {
-                freedMetric += item->pixelSize();
+                freedMetric += item->memoryMetric();
             }
         }
         else {
@@ -214,7 +285,7 @@ qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
         if (freedMetric >= needToFreeMetric) break;
 
         if (iter->trySwapOut(item)) {
-            freedMetric += item->pixelSize();
+            freedMetric += item->memoryMetric();
         }
     }
 
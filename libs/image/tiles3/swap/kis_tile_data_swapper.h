@@ -31,15 +31,19 @@ public:
     void testingRereadConfig();
 
 private:
-    void waitForWork();
+    bool waitForWork();
     void run() override;
 
+    void compactSwap();
+
     void doJob();
     template<class strategy> qint64 pass(qint64 needToFreeMetric);
 
 private:
     static const qint32 TIMEOUT;
     static const qint32 DELAY;
+    static const qint32 IDLE_TIMEOUT;
+    static const qint32 COMPACTION_BATCH_SIZE;
 
 private:
     struct Private;
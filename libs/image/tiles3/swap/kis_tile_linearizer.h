@@ -0,0 +1,194 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_TILE_LINEARIZER_H
+#define __KIS_TILE_LINEARIZER_H
+
+#include "kis_tile_linearizer_base.h"
+#include "kis_abstract_compression.h"
+
+#include <cstring>
+
+#include <xsimd_extensions/xsimd.hpp>
+
+/**
+ * Splitting the pixels into byte planes is a transposition of
+ * a (numPixels x pixelSize) matrix of bytes. For the pixel sizes
+ * that are powers of two it can be done with a series of zip
+ * operations: if we load pixelSize vectors and zip every vector
+ * from the first half with the corresponding vector from the
+ * second half, the bits of the byte addresses get rotated by one
+ * position. So to split the pixels we need log2(vectorSize)
+ * rotations, and to merge them back, log2(pixelSize) rotations.
+ *
+ * We use 128-bit vectors even when AVX2 is available: its unpack
+ * instructions work within the 128-bit lanes, so the wider version
+ * would need an extra cross-lane permutation, and the operation is
+ * limited by the memory bandwidth anyway.
+ */
+template<typename _impl = xsimd::current_arch>
+class KisTileLinearizer : public KisTileLinearizerBase
+{
+public:
+    KisTileLinearizer(qint32 pixelSize)
+        : KisTileLinearizerBase(pixelSize)
+    {
+    }
+
+    void linearizeColors(const quint8 *input, quint8 *output, qint32 dataSize) const override
+    {
+        switch (m_pixelSize) {
+        case 1:
+            memcpy(output, input, dataSize);
+            break;
+#if XSIMD_WITH_SSE2 || XSIMD_WITH_NEON || XSIMD_WITH_NEON64
+        case 2:
+            linearizeImpl<2>(input, output, dataSize);
+            break;
+        case 4:
+            linearizeImpl<4>(input, output, dataSize);
+            break;
+        case 8:
+            linearizeImpl<8>(input, output, dataSize);
+            break;
+        case 16:
+            linearizeImpl<16>(input, output, dataSize);
+            break;
+#endif
+        default:
+            KisAbstractCompression::linearizeColors(const_cast<quint8*>(input), output,
+                                                    dataSize, m_pixelSize);
+        }
+    }
+
+    void delinearizeColors(const quint8 *input, quint8 *output, qint32 dataSize) const override
+    {
+        switch (m_pixelSize) {
+        case 1:
+            memcpy(output, input, dataSize);
+            break;
+#if XSIMD_WITH_SSE2 || XSIMD_WITH_NEON || XSIMD_WITH_NEON64
+        case 2:
+            delinearizeImpl<2>(input, output, dataSize);
+            break;
+        case 4:
+            delinearizeImpl<4>(input, output, dataSize);
+            break;
+        case 8:
+            delinearizeImpl<8>(input, output, dataSize);
+            break;
+        case 16:
+            delinearizeImpl<16>(input, output, dataSize);
+            break;
+#endif
+        default:
+            KisAbstractCompression::delinearizeColors(const_cast<quint8*>(input), output,
+                                                      dataSize, m_pixelSize);
+        }
+    }
+
+private:
+#if XSIMD_WITH_SSE2 || XSIMD_WITH_NEON || XSIMD_WITH_NEON64
+#if XSIMD_WITH_SSE2
+    using uint8_v = xsimd::batch<uint8_t, xsimd::sse2>;
+#elif XSIMD_WITH_NEON64
+    using uint8_v = xsimd::batch<uint8_t, xsimd::neon64>;
+#else
+    using uint8_v = xsimd::batch<uint8_t, xsimd::neon>;
+#endif
+
+    static_assert(uint8_v::size == 16, "the linearizer expects 128-bit vectors");
+
+    static constexpr int log2(int value) {
+        return value > 1 ? 1 + log2(value / 2) : 0;
+    }
+
+    /**
+     * Zips the first half of the vectors with the second one,
+     * which rotates the bits of the byte addresses by one
+     */
+    template<int pixelSize>
+    static inline void zipRound(uint8_v *v)
+    {
+        uint8_v result[pixelSize];
+
+        for (int i = 0; i < pixelSize / 2; i++) {
+            result[2 * i] = xsimd::zip_lo(v[i], v[i + pixelSize / 2]);
+            result[2 * i + 1] = xsimd::zip_hi(v[i], v[i + pixelSize / 2]);
+        }
+
+        for (int i = 0; i < pixelSize; i++) {
+            v[i] = result[i];
+        }
+    }
+
+    template<int pixelSize>
+    static void linearizeImpl(const quint8 *input, quint8 *output, qint32 dataSize)
+    {
+        const qint32 numPixels = dataSize / pixelSize;
+        const qint32 numBlocks = numPixels / uint8_v::size;
+
+        uint8_v v[pixelSize];
+
+        for (qint32 block = 0; block < numBlocks; block++) {
+            const qint32 pixel = block * uint8_v::size;
+            const quint8 *src = input + pixel * pixelSize;
+
+            for (int i = 0; i < pixelSize; i++) {
+                v[i] = uint8_v::load_unaligned(src + i * uint8_v::size);
+            }
+
+            for (int round = 0; round < log2(uint8_v::size); round++) {
+                zipRound<pixelSize>(v);
+            }
+
+            for (int i = 0; i < pixelSize; i++) {
+                v[i].store_unaligned(output + i * numPixels + pixel);
+            }
+        }
+
+        for (qint32 pixel = numBlocks * uint8_v::size; pixel < numPixels; pixel++) {
+            for (int i = 0; i < pixelSize; i++) {
+                output[i * numPixels + pixel] = input[pixel * pixelSize + i];
+            }
+        }
+    }
+
+    template<int pixelSize>
+    static void delinearizeImpl(const quint8 *input, quint8 *output, qint32 dataSize)
+    {
+        const qint32 numPixels = dataSize / pixelSize;
+        const qint32 numBlocks = numPixels / uint8_v::size;
+
+        uint8_v v[pixelSize];
+
+        for (qint32 block = 0; block < numBlocks; block++) {
+            const qint32 pixel = block * uint8_v::size;
+            quint8 *dst = output + pixel * pixelSize;
+
+            for (int i = 0; i < pixelSize; i++) {
+                v[i] = uint8_v::load_unaligned(input + i * numPixels + pixel);
+            }
+
+            for (int round = 0; round < log2(pixelSize); round++) {
+                zipRound<pixelSize>(v);
+            }
+
+            for (int i = 0; i < pixelSize; i++) {
+                v[i].store_unaligned(dst + i * uint8_v::size);
+            }
+        }
+
+        for (qint32 pixel = numBlocks * uint8_v::size; pixel < numPixels; pixel++) {
+            for (int i = 0; i < pixelSize; i++) {
+                output[pixel * pixelSize + i] = input[i * numPixels + pixel];
+            }
+        }
+    }
+#endif
+};
+
+#endif /* __KIS_TILE_LINEARIZER_H */
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_linearizer_base.h"
+
+KisTileLinearizerBase::KisTileLinearizerBase(qint32 pixelSize)
+    : m_pixelSize(pixelSize)
+{
+}
+
+KisTileLinearizerBase::~KisTileLinearizerBase()
+{
+}
+
+qint32 KisTileLinearizerBase::pixelSize() const
+{
+    return m_pixelSize;
+}
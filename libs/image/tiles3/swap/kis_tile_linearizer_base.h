@@ -0,0 +1,52 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_TILE_LINEARIZER_BASE_H
+#define __KIS_TILE_LINEARIZER_BASE_H
+
+#include <QtGlobal>
+#include "kritaimage_export.h"
+
+/**
+ * Splits the pixel data of a tile into separate byte planes before
+ * compression and merges them back after decompression, that is
+ * does exactly the same thing as KisAbstractCompression::linearizeColors()
+ * and KisAbstractCompression::delinearizeColors(), but much faster.
+ *
+ * The actual implementation is placed in class `KisTileLinearizer`.
+ * Use KisTileLinearizerFactory to create a version of the linearizer
+ * optimized for your CPU architecture.
+ *
+ * \code{.cpp}
+ * QScopedPointer<KisTileLinearizerBase> linearizer(
+ *     KisTileLinearizerFactory::create(pixelSize));
+ *
+ * // e.g. RGBARGBARGBA -> RRRGGGBBBAAA
+ * linearizer->linearizeColors(src, dst, dataSize);
+ *
+ * // e.g. RRRGGGBBBAAA -> RGBARGBARGBA
+ * linearizer->delinearizeColors(src, dst, dataSize);
+ * \endcode
+ */
+class KRITAIMAGE_EXPORT KisTileLinearizerBase
+{
+public:
+    KisTileLinearizerBase(qint32 pixelSize);
+    virtual ~KisTileLinearizerBase();
+
+    virtual void linearizeColors(const quint8 *input, quint8 *output,
+                                 qint32 dataSize) const = 0;
+
+    virtual void delinearizeColors(const quint8 *input, quint8 *output,
+                                   qint32 dataSize) const = 0;
+
+    qint32 pixelSize() const;
+
+protected:
+    qint32 m_pixelSize;
+};
+
+#endif /* __KIS_TILE_LINEARIZER_BASE_H */
@@ -0,0 +1,15 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_linearizer_factory.h"
+
+#include "kis_tile_linearizer_factory_impl.h"
+
+
+KisTileLinearizerBase* KisTileLinearizerFactory::create(qint32 pixelSize)
+{
+    return createOptimizedClass<KisTileLinearizerFactoryImpl>(pixelSize);
+}
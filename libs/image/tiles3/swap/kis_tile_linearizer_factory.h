@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_TILE_LINEARIZER_FACTORY_H
+#define __KIS_TILE_LINEARIZER_FACTORY_H
+
+#include "kis_tile_linearizer_base.h"
+
+/**
+ * \see KisTileLinearizerBase
+ */
+class KRITAIMAGE_EXPORT KisTileLinearizerFactory
+{
+public:
+    static KisTileLinearizerBase* create(qint32 pixelSize);
+};
+
+#endif /* __KIS_TILE_LINEARIZER_FACTORY_H */
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_linearizer_factory_impl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "kis_tile_linearizer.h"
+
+template<typename _impl>
+KisTileLinearizerBase* KisTileLinearizerFactoryImpl::create(qint32 pixelSize)
+{
+    return new KisTileLinearizer<_impl>(pixelSize);
+}
+
+template KisTileLinearizerBase*
+KisTileLinearizerFactoryImpl::create<xsimd::current_arch>(qint32);
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_TILE_LINEARIZER_FACTORY_IMPL_H
+#define __KIS_TILE_LINEARIZER_FACTORY_IMPL_H
+
+#include "kis_tile_linearizer_base.h"
+#include <compositeops/KoMultiArchBuildSupport.h>
+
+class KRITAIMAGE_EXPORT KisTileLinearizerFactoryImpl
+{
+public:
+    using ParamType = qint32;
+    using ReturnType = KisTileLinearizerBase *;
+
+    template<typename _impl>
+    static KisTileLinearizerBase* create(qint32 pixelSize);
+};
+
+#endif /* __KIS_TILE_LINEARIZER_FACTORY_IMPL_H */
@@ -11,6 +11,9 @@
 
 #include "../../../sdk/tests/testutil.h"
 #include "tiles3/swap/kis_lzf_compression.h"
+#include "tiles3/swap/kis_compression_factory.h"
+#include "tiles3/swap/kis_tile_linearizer_factory.h"
+#include "tiles3/kis_tile_data.h"
 #include <kis_debug.h>
 
 #define TEST_FILE "tile.png"
@@ -250,5 +253,195 @@ void KisCompressionTests::benchmarkDecompressionLzfTwoPass()
     delete compression;
 }
 
+void addCompressionTypesRows()
+{
+    QTest::addColumn<int>("type");
+
+    Q_FOREACH (KisCompressionFactory::Type type, KisCompressionFactory::availableTypes()) {
+        QTest::newRow(KisCompressionFactory::name(type).toLatin1()) << int(type);
+    }
+}
+
+void KisCompressionTests::testRoundTrip_data()
+{
+    addCompressionTypesRows();
+}
+
+void KisCompressionTests::testRoundTrip()
+{
+    QFETCH(int, type);
+
+    QScopedPointer<KisAbstractCompression> compression(
+        KisCompressionFactory::create(KisCompressionFactory::Type(type)));
+
+    roundTrip(compression.data());
+    roundTripTwoPass(compression.data());
+}
+
+void KisCompressionTests::testOverflow_data()
+{
+    addCompressionTypesRows();
+}
+
+void KisCompressionTests::testOverflow()
+{
+    QFETCH(int, type);
+
+    QScopedPointer<KisAbstractCompression> compression(
+        KisCompressionFactory::create(KisCompressionFactory::Type(type)));
+
+    testOverflow(compression.data());
+}
+
+void KisCompressionTests::benchmarkCompression_data()
+{
+    addCompressionTypesRows();
+}
+
+void KisCompressionTests::benchmarkCompression()
+{
+    QFETCH(int, type);
+
+    QScopedPointer<KisAbstractCompression> compression(
+        KisCompressionFactory::create(KisCompressionFactory::Type(type)));
+
+    benchmarkCompressionTwoPass(compression.data());
+}
+
+void KisCompressionTests::benchmarkDecompression_data()
+{
+    addCompressionTypesRows();
+}
+
+void KisCompressionTests::benchmarkDecompression()
+{
+    QFETCH(int, type);
+
+    QScopedPointer<KisAbstractCompression> compression(
+        KisCompressionFactory::create(KisCompressionFactory::Type(type)));
+
+    benchmarkDecompressionTwoPass(compression.data());
+}
+
+void KisCompressionTests::testLinearization_data()
+{
+    QTest::addColumn<int>("pixelSize");
+    QTest::addColumn<int>("numPixels");
+
+    const int pixelSizes[] = {1, 2, 3, 4, 5, 8, 10, 16};
+
+    for (int pixelSize : pixelSizes) {
+        QTest::newRow(qPrintable(QString("%1 bytes, tile").arg(pixelSize)))
+            << pixelSize << KisTileData::WIDTH * KisTileData::HEIGHT;
+        QTest::newRow(qPrintable(QString("%1 bytes, unaligned").arg(pixelSize)))
+            << pixelSize << 1000 + 7;
+    }
+}
+
+void KisCompressionTests::testLinearization()
+{
+    QFETCH(int, pixelSize);
+    QFETCH(int, numPixels);
+
+    const qint32 dataSize = pixelSize * numPixels;
+
+    QVector<quint8> source(dataSize);
+    for (int i = 0; i < dataSize; i++) {
+        source[i] = (i * 7 + i / 13) % 256;
+    }
+
+    QVector<quint8> reference(dataSize);
+    KisAbstractCompression::linearizeColors(source.data(), reference.data(),
+                                            dataSize, pixelSize);
+
+    QScopedPointer<KisTileLinearizerBase> linearizer(
+        KisTileLinearizerFactory::create(pixelSize));
+
+    QVector<quint8> linearized(dataSize);
+    linearizer->linearizeColors(source.data(), linearized.data(), dataSize);
+    QVERIFY(linearized == reference);
+
+    QVector<quint8> delinearized(dataSize);
+    linearizer->delinearizeColors(linearized.data(), delinearized.data(), dataSize);
+    QVERIFY(delinearized == source);
+}
+
+void addLinearizationRows()
+{
+    QTest::addColumn<int>("pixelSize");
+    QTest::addColumn<bool>("optimized");
+
+    const int pixelSizes[] = {1, 2, 4, 8, 16};
+
+    for (int pixelSize : pixelSizes) {
+        QTest::newRow(qPrintable(QString("%1 bytes, scalar").arg(pixelSize)))
+            << pixelSize << false;
+        QTest::newRow(qPrintable(QString("%1 bytes, optimized").arg(pixelSize)))
+            << pixelSize << true;
+    }
+}
+
+void KisCompressionTests::benchmarkLinearization_data()
+{
+    addLinearizationRows();
+}
+
+void KisCompressionTests::benchmarkLinearization()
+{
+    QFETCH(int, pixelSize);
+    QFETCH(bool, optimized);
+
+    const qint32 dataSize = pixelSize * KisTileData::WIDTH * KisTileData::HEIGHT;
+    const int numTiles = 256;
+
+    QVector<quint8> source(dataSize, 1);
+    QVector<quint8> result(dataSize);
+
+    QScopedPointer<KisTileLinearizerBase> linearizer(
+        KisTileLinearizerFactory::create(pixelSize));
+
+    QBENCHMARK {
+        for (int i = 0; i < numTiles; i++) {
+            if (optimized) {
+                linearizer->linearizeColors(source.data(), result.data(), dataSize);
+            } else {
+                KisAbstractCompression::linearizeColors(source.data(), result.data(),
+                                                        dataSize, pixelSize);
+            }
+        }
+    }
+}
+
+void KisCompressionTests::benchmarkDelinearization_data()
+{
+    addLinearizationRows();
+}
+
+void KisCompressionTests::benchmarkDelinearization()
+{
+    QFETCH(int, pixelSize);
+    QFETCH(bool, optimized);
+
+    const qint32 dataSize = pixelSize * KisTileData::WIDTH * KisTileData::HEIGHT;
+    const int numTiles = 256;
+
+    QVector<quint8> source(dataSize, 1);
+    QVector<quint8> result(dataSize);
+
+    QScopedPointer<KisTileLinearizerBase> linearizer(
+        KisTileLinearizerFactory::create(pixelSize));
+
+    QBENCHMARK {
+        for (int i = 0; i < numTiles; i++) {
+            if (optimized) {
+                linearizer->delinearizeColors(source.data(), result.data(), dataSize);
+            } else {
+                KisAbstractCompression::delinearizeColors(source.data(), result.data(),
+                                                          dataSize, pixelSize);
+            }
+        }
+    }
+}
+
 SIMPLE_TEST_MAIN(KisCompressionTests)
 
@@ -36,6 +36,24 @@ private Q_SLOTS:
     void benchmarkCompressionLzfTwoPass();
     void benchmarkDecompressionLzf();
     void benchmarkDecompressionLzfTwoPass();
+
+    void testRoundTrip_data();
+    void testRoundTrip();
+    void testOverflow_data();
+    void testOverflow();
+
+    void benchmarkCompression_data();
+    void benchmarkCompression();
+    void benchmarkDecompression_data();
+    void benchmarkDecompression();
+
+    void testLinearization_data();
+    void testLinearization();
+
+    void benchmarkLinearization_data();
+    void benchmarkLinearization();
+    void benchmarkDelinearization_data();
+    void benchmarkDelinearization();
 };
 
 #endif /* KIS_COMPRESSION_TESTS_H */
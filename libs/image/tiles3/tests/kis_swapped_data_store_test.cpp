@@ -119,5 +119,99 @@ void KisSwappedDataStoreTest::testRandomAccess()
         delete tileDataList[i];
 }
 
+/**
+ * Fills the tile with a pseudo-random noise, so that the
+ * compressor could not shrink it
+ */
+static void fillWithNoise(qint32 seed, quint8 *data, qint32 size)
+{
+    quint32 state = seed + 1;
+    for(qint32 i = 0; i < size; i++) {
+        state = state * 1103515245 + 12345;
+        data[i] = state >> 16;
+    }
+}
+
+void KisSwappedDataStoreTest::testCompaction()
+{
+    const qint32 pixelSize = 1;
+    const quint8 defaultPixel = 128;
+    const qint32 NUM_TILES = 10000;
+    const qint32 KEEP_EVERY = 10;
+
+    KisImageConfig config(false);
+    config.setMaxSwapSize(64);
+    config.setSwapSlabSize(1);
+    config.setSwapWindowSize(1);
+
+
+    KisSwappedDataStore store;
+
+    QList<KisTileData*> tileDataList;
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        tileDataList.append(new KisTileData(pixelSize, &defaultPixel, KisTileDataStore::instance()));
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+        fillWithNoise(i, td->data(), TILESIZE);
+
+        // FIXME: take a lock of the tile data
+        QVERIFY(store.trySwapOutTileData(td));
+    }
+
+    QCOMPARE(store.fragmentation(), 0.0);
+
+    /**
+     * Leave only every tenth tile in the swap, so that the
+     * swap file becomes full of holes
+     */
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        if(!(i % KEEP_EVERY)) continue;
+
+        // FIXME: take a lock of the tile data
+        store.swapInTileData(tileDataList[i]);
+    }
+
+    const quint64 fragmentedFileSize = store.swapFileSize();
+
+    store.debugStatistics();
+    QVERIFY(store.fragmentation() > 0.8);
+
+    bool relocated;
+    do {
+        relocated = false;
+
+        Q_FOREACH(KisTileData *td, store.relocationCandidates(64)) {
+            // FIXME: take a lock of the tile data
+            relocated |= store.tryRelocateTileData(td);
+        }
+    } while(relocated);
+
+    store.shrinkSwapFile();
+
+    store.debugStatistics();
+    QVERIFY(store.fragmentation() < 0.05);
+    QVERIFY(store.swapFileSize() < fragmentedFileSize / 4);
+    QCOMPARE(store.numTiles(), quint64(NUM_TILES / KEEP_EVERY));
+
+    QByteArray expected(TILESIZE, 0);
+
+    for(qint32 i = 0; i < NUM_TILES; i += KEEP_EVERY) {
+        KisTileData *td = tileDataList[i];
+        QVERIFY(!td->data());
+
+        // FIXME: take a lock of the tile data
+        store.swapInTileData(td);
+
+        fillWithNoise(i, (quint8*)expected.data(), TILESIZE);
+        QVERIFY(!memcmp(expected.constData(), td->data(), TILESIZE));
+    }
+
+    QCOMPARE(store.fragmentation(), 0.0);
+
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        delete tileDataList[i];
+}
+
 SIMPLE_TEST_MAIN(KisSwappedDataStoreTest)
 
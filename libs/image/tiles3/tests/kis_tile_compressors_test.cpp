@@ -11,6 +11,9 @@
 #include "tiles3/swap/kis_legacy_tile_compressor.h"
 #include "tiles3/swap/kis_tile_compressor_2.h"
 
+#include <QElapsedTimer>
+#include <QImage>
+
 #include "tiles_test_utils.h"
 
 void KisTileCompressorsTest::doRoundTrip(KisAbstractTileCompressor *compressor)
@@ -167,6 +170,144 @@ void KisTileCompressorsTest::testLowLevelRoundTripIncompressible2()
     delete compressor;
 }
 
+void addCodecRows()
+{
+    QTest::addColumn<int>("type");
+
+    Q_FOREACH (KisCompressionFactory::Type type, KisCompressionFactory::availableTypes()) {
+        QTest::newRow(KisCompressionFactory::name(type).toLatin1()) << int(type);
+    }
+}
+
+void KisTileCompressorsTest::testRoundTripCodecs_data()
+{
+    addCodecRows();
+}
+
+void KisTileCompressorsTest::testRoundTripCodecs()
+{
+    QFETCH(int, type);
+
+    KisAbstractTileCompressor *compressor =
+        new KisTileCompressor2(KisCompressionFactory::Type(type));
+
+    doRoundTrip(compressor);
+    doLowLevelRoundTrip(compressor);
+    doLowLevelRoundTripIncompressible(compressor);
+
+    delete compressor;
+}
+
+void KisTileCompressorsTest::testReadForeignCodec()
+{
+    /**
+     * The tile data buffer should be readable by a compressor
+     * created with any other algorithm
+     */
+
+    const qint32 pixelSize = 1;
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+
+    KisTiledDataManager dm(pixelSize, &oddPixel1);
+    KisTileSP tile = dm.getTile(0, 0, true);
+    tile->lockForWrite();
+
+    KisTileData *td = tile->tileData();
+
+    Q_FOREACH (KisCompressionFactory::Type writeType, KisCompressionFactory::availableTypes()) {
+        Q_FOREACH (KisCompressionFactory::Type readType, KisCompressionFactory::availableTypes()) {
+            KisTileCompressor2 writer(writeType);
+            KisTileCompressor2 reader(readType);
+
+            memset(td->data(), oddPixel1, TILESIZE);
+
+            qint32 bufferSize = writer.tileDataBufferSize(td);
+            QByteArray buffer(bufferSize, 0);
+            qint32 bytesWritten;
+            writer.compressTileData(td, (quint8*)buffer.data(), bufferSize, bytesWritten);
+
+            memset(td->data(), oddPixel2, TILESIZE);
+
+            QVERIFY(reader.decompressTileData((quint8*)buffer.data(), bytesWritten, td));
+            QVERIFY(memoryIsFilled(oddPixel1, td->data(), TILESIZE));
+        }
+    }
+
+    tile->unlock();
+}
+
+void KisTileCompressorsTest::benchmarkCodecs_data()
+{
+    addCodecRows();
+}
+
+void KisTileCompressorsTest::benchmarkCodecs()
+{
+    QFETCH(int, type);
+
+    const qint32 pixelSize = 4;
+    quint8 defaultPixel[pixelSize] = {0, 0, 0, 0};
+
+    QImage image(QString(FILES_DATA_DIR) + QDir::separator() + "hakonepa.png");
+    image = image.convertToFormat(QImage::Format_ARGB32);
+
+    KisTiledDataManager dm(pixelSize, defaultPixel);
+    dm.writeBytes(image.constBits(), 0, 0, image.width(), image.height());
+
+    QVector<KisTileSP> tiles;
+    for (qint32 row = 0; row < image.height() / KisTileData::HEIGHT; row++) {
+        for (qint32 col = 0; col < image.width() / KisTileData::WIDTH; col++) {
+            tiles << dm.getTile(col, row, false);
+        }
+    }
+    QVERIFY(!tiles.isEmpty());
+
+    KisTileCompressor2 compressor((KisCompressionFactory::Type(type)));
+
+    const qint32 bufferSize = compressor.tileDataBufferSize(tiles.first()->tileData());
+    QVector<QByteArray> buffers(tiles.size(), QByteArray(bufferSize, 0));
+    QVector<qint32> compressedSizes(tiles.size());
+
+    const qint64 uncompressedSize = qint64(tiles.size()) * TILESIZE * pixelSize;
+    qint64 compressedSize = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < tiles.size(); i++) {
+        tiles[i]->lockForRead();
+        compressor.compressTileData(tiles[i]->tileData(), (quint8*)buffers[i].data(),
+                                    bufferSize, compressedSizes[i]);
+        tiles[i]->unlockForRead();
+        compressedSize += compressedSizes[i];
+    }
+
+    const qint64 compressionTime = qMax(qint64(1), timer.nsecsElapsed());
+    timer.restart();
+
+    for (int i = 0; i < tiles.size(); i++) {
+        tiles[i]->lockForWrite();
+        compressor.decompressTileData((quint8*)buffers[i].data(), compressedSizes[i],
+                                      tiles[i]->tileData());
+        tiles[i]->unlockForWrite();
+    }
+
+    const qint64 decompressionTime = qMax(qint64(1), timer.nsecsElapsed());
+
+    auto mbPerSecond = [uncompressedSize] (qint64 nsecs) {
+        return qreal(uncompressedSize) / (1 << 20) / (qreal(nsecs) / 1e9);
+    };
+
+    qDebug() << KisCompressionFactory::name(KisCompressionFactory::Type(type))
+             << "ratio:" << qreal(compressedSize) / uncompressedSize
+             << "compression (MiB/s):" << mbPerSecond(compressionTime)
+             << "decompression (MiB/s):" << mbPerSecond(decompressionTime);
+
+    QImage result(image.size(), QImage::Format_ARGB32);
+    dm.readBytes(result.bits(), 0, 0, image.width(), image.height());
+    QCOMPARE(result, image);
+}
 
 SIMPLE_TEST_MAIN(KisTileCompressorsTest)
 
@@ -26,6 +26,13 @@ private Q_SLOTS:
     void testRoundTrip2();
     void testLowLevelRoundTrip2();
     void testLowLevelRoundTripIncompressible2();
+
+    void testRoundTripCodecs_data();
+    void testRoundTripCodecs();
+    void testReadForeignCodec();
+
+    void benchmarkCodecs_data();
+    void benchmarkCodecs();
 };
 
 #endif /* KIS_TILE_COMPRESSORS_TEST_H */
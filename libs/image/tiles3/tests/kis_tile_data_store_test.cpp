@@ -135,6 +135,172 @@ void KisTileDataStoreTest::testLeaks()
     QCOMPARE(KisTileDataStore::instance()->numTiles(), 0);
 }
 
+void KisTileDataStoreTest::testPrefetch()
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->debugClear();
+
+    const qint32 pixelSize = 1;
+    const qint32 numTiles = 16;
+    quint8 defaultPixel = 128;
+    KisTiledDataManager dm(pixelSize, &defaultPixel);
+
+    for (qint32 col = 0; col < numTiles; col++) {
+        KisTileSP tile = dm.getTile(col, 0, true);
+        tile->lockForWrite();
+        memset(tile->data(), col, TILESIZE);
+        tile->unlockForWrite();
+    }
+
+    store->debugSwapAll();
+    QVERIFY(store->hasSwappedTiles());
+    QCOMPARE(store->numTilesInMemory(), 0);
+
+    store->testingResetPrefetchStatistics();
+
+    dm.prefetchRect(QRect(0, 0, numTiles * KisTileData::WIDTH, KisTileData::HEIGHT));
+
+    for (int i = 0; i < 100 && store->prefetchStatistics().numHits < numTiles; i++) {
+        QTest::qSleep(10);
+    }
+
+    QCOMPARE(store->numTilesInMemory(), numTiles);
+
+    KisTileDataPrefetcher::Statistics stats = store->prefetchStatistics();
+    QCOMPARE(stats.numRequested, qint64(numTiles));
+    QCOMPARE(stats.numHits, qint64(numTiles));
+    QCOMPARE(stats.numMisses, qint64(0));
+
+    for (qint32 col = 0; col < numTiles; col++) {
+        KisTileSP tile = dm.getTile(col, 0, false);
+        tile->lockForRead();
+        QVERIFY(memoryIsFilled(col, tile->data(), TILESIZE));
+        tile->unlockForRead();
+    }
+
+    stats = store->prefetchStatistics();
+    QCOMPARE(stats.numMisses, qint64(0));
+
+    /**
+     * Nothing is swapped now, so the request should be ignored
+     */
+    dm.prefetchRect(QRect(0, 0, numTiles * KisTileData::WIDTH, KisTileData::HEIGHT));
+    QCOMPARE(store->prefetchStatistics().numRequested, qint64(numTiles));
+}
+
+void KisTileDataStoreTest::testEvictionPriority()
+{
+    KisImageConfig config(false);
+    const qreal oldSoftLimit = config.memorySoftLimitPercent();
+    config.setMemorySoftLimitPercent(0);
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->debugClear();
+    store->testingRereadConfig();
+
+    const qint32 pixelSize = 1;
+    const qint32 numTiles = 32;
+    const qint64 devicePixels = numTiles * TILESIZE;
+    quint8 defaultPixel = 128;
+    KisTiledDataManager hiddenDM(pixelSize, &defaultPixel);
+    KisTiledDataManager activeDM(pixelSize, &defaultPixel);
+
+    for (qint32 col = 0; col < numTiles; col++) {
+        KisTiledDataManager *dms[] = {&hiddenDM, &activeDM};
+
+        for (KisTiledDataManager *dm : dms) {
+            KisTileSP tile = dm->getTile(col, 0, true);
+            tile->lockForWrite();
+            memset(tile->data(), col, TILESIZE);
+            tile->unlockForWrite();
+        }
+    }
+
+    hiddenDM.setEvictionPriority(KisTileEvictionPriority::Preferred);
+    activeDM.setEvictionPriority(KisTileEvictionPriority::Protected);
+
+    qint64 resident = 0;
+    qint64 swapped = 0;
+
+    hiddenDM.memoryStatistics(resident, swapped);
+    QCOMPARE(resident, devicePixels);
+    QCOMPARE(swapped, qint64(0));
+
+    /**
+     * The soft limit is zero, but there are no memento tiles,
+     * so only the tiles with preferred priority should go away
+     */
+    store->kickPooler();
+
+    for (int i = 0; i < 300 && swapped < devicePixels; i++) {
+        QTest::qSleep(10);
+        hiddenDM.memoryStatistics(resident, swapped);
+    }
+
+    QCOMPARE(resident, qint64(0));
+    QCOMPARE(swapped, devicePixels);
+
+    activeDM.memoryStatistics(resident, swapped);
+    QCOMPARE(resident, devicePixels);
+    QCOMPARE(swapped, qint64(0));
+
+    for (qint32 col = 0; col < numTiles; col++) {
+        KisTileSP tile = hiddenDM.getTile(col, 0, false);
+        tile->lockForRead();
+        QVERIFY(memoryIsFilled(col, tile->data(), TILESIZE));
+        QVERIFY(tile->tileData()->evictionPriority() == KisTileEvictionPriority::Preferred);
+        tile->unlockForRead();
+    }
+
+    config.setMemorySoftLimitPercent(oldSoftLimit);
+    store->testingRereadConfig();
+}
+
+void KisTileDataStoreTest::testEvictionPriorityOfNewTiles()
+{
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+    KisTiledDataManager dm(pixelSize, &defaultPixel);
+
+    {
+        KisTileSP tile = dm.getTile(0, 0, true);
+        tile->lockForWrite();
+        memset(tile->data(), 1, TILESIZE);
+        tile->unlockForWrite();
+    }
+
+    dm.setEvictionPriority(KisTileEvictionPriority::Preferred);
+
+    // the tile is created from the default tile data after the priority is set
+    {
+        KisTileSP tile = dm.getTile(1, 0, true);
+        tile->lockForWrite();
+        memset(tile->data(), 2, TILESIZE);
+        QVERIFY(tile->tileData()->evictionPriority() == KisTileEvictionPriority::Preferred);
+        tile->unlockForWrite();
+    }
+
+    // the copy shares the tile data with the original device
+    KisTiledDataManager copyDM(dm);
+    copyDM.setEvictionPriority(KisTileEvictionPriority::Protected);
+    dm.setEvictionPriority(KisTileEvictionPriority::Preferred);
+
+    for (qint32 col = 0; col < 3; col++) {
+        KisTileSP tile = copyDM.getTile(col, 0, true);
+        tile->lockForWrite();
+        memset(tile->data(), 3, TILESIZE);
+        QVERIFY(tile->tileData()->evictionPriority() == KisTileEvictionPriority::Protected);
+        tile->unlockForWrite();
+    }
+
+    for (qint32 col = 0; col < 3; col++) {
+        KisTileSP tile = dm.getTile(col, 0, true);
+        tile->lockForWrite();
+        QVERIFY(tile->tileData()->evictionPriority() == KisTileEvictionPriority::Preferred);
+        tile->unlockForWrite();
+    }
+}
+
 #define COLUMN2COLOR(col) (col%255)
 
 void KisTileDataStoreTest::testSwapping()
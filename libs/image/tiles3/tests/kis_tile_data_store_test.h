@@ -17,6 +17,9 @@ private:
 private Q_SLOTS:
     void testClockIterator();
     void testLeaks();
+    void testPrefetch();
+    void testEvictionPriority();
+    void testEvictionPriorityOfNewTiles();
     void testSwapping();
 };
 
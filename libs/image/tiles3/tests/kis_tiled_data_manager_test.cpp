@@ -8,6 +8,10 @@
 #include <simpletest.h>
 
 #include "tiles3/kis_tiled_data_manager.h"
+#include "tiles3/kis_hline_iterator.h"
+#include "tiles3/kis_vline_iterator.h"
+#include "tiles3/kis_random_accessor.h"
+#include "kis_datamanager.h"
 
 #include "tiles_test_utils.h"
 #include "config-limit-long-tests.h"
@@ -529,6 +533,312 @@ void KisTiledDataManagerTest::testUndoSetDefaultPixel()
 
 //#include <valgrind/callgrind.h>
 
+void KisTiledDataManagerTest::testDeduplication()
+{
+    /**
+     * The pooler may hold the tile data while pre-cloning,
+     * which would make the deduplication to skip it
+     */
+    KisTileDataStore::instance()->testingSuspendPooler();
+
+    quint8 defaultPixel = 0;
+    KisTiledDataManager srcDM(1, &defaultPixel);
+    KisTiledDataManager dstDM(1, &defaultPixel);
+
+    const QRect rect(0, 0, 128, 128);
+    const QRect tilesRect(0, 0, 2, 2);
+
+    QVector<quint8> buffer(rect.width() * rect.height());
+    for (int i = 0; i < buffer.size(); i++) {
+        buffer[i] = 1 + i % 251;
+    }
+
+    const qint64 deduplicatedSizeBefore =
+        KisTileDataStore::instance()->memoryStatistics().deduplicatedSize;
+
+    KisMementoSP memento1 = srcDM.getMemento();
+    srcDM.writeBytes(buffer.data(), rect.x(), rect.y(), rect.width(), rect.height());
+    srcDM.commit();
+
+    KisMementoSP memento2 = dstDM.getMemento();
+    dstDM.writeBytes(buffer.data(), rect.x(), rect.y(), rect.width(), rect.height());
+
+    QVERIFY(checkTilesNotShared(&srcDM, &dstDM, false, false, tilesRect));
+
+    dstDM.commit();
+
+    // both the tiles and the revisions share the same data now
+    QVERIFY(checkTilesShared(&srcDM, &dstDM, false, false, tilesRect));
+    QVERIFY(checkTilesShared(&srcDM, &dstDM, true, true, tilesRect));
+
+    QCOMPARE(KisTileDataStore::instance()->memoryStatistics().deduplicatedSize -
+             deduplicatedSizeBefore,
+             qint64(4 * TILESIZE));
+
+    // writing into a deduplicated tile doesn't affect the other device
+    KisMementoSP memento3 = dstDM.getMemento();
+    quint8 oddPixel = 255;
+    dstDM.clear(0, 0, 64, 64, &oddPixel);
+    dstDM.commit();
+
+    // the tile doesn't share its data anymore
+    QCOMPARE(KisTileDataStore::instance()->memoryStatistics().deduplicatedSize -
+             deduplicatedSizeBefore,
+             qint64(3 * TILESIZE));
+
+    QVector<quint8> result(buffer.size());
+    srcDM.readBytes(result.data(), rect.x(), rect.y(), rect.width(), rect.height());
+    QVERIFY(result == buffer);
+
+    dstDM.rollback(memento3);
+    dstDM.readBytes(result.data(), rect.x(), rect.y(), rect.width(), rect.height());
+    QVERIFY(result == buffer);
+
+    KisTileDataStore::instance()->testingResumePooler();
+}
+
+void KisTiledDataManagerTest::testDeltaMementos()
+{
+    KisTileDataStore::instance()->testingSuspendPooler();
+
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    const QRect rect(0, 0, 128, 128);
+    const int numRevisions = 12;
+
+    QVector<quint8> buffer(rect.width() * rect.height());
+    for (int i = 0; i < buffer.size(); i++) {
+        buffer[i] = 1 + i % 251;
+    }
+
+    QVector<KisMementoSP> mementos;
+    QVector<QVector<quint8>> revisions;
+
+    mementos << dm.getMemento();
+    dm.writeBytes(buffer.data(), rect.x(), rect.y(), rect.width(), rect.height());
+    dm.commit();
+    revisions << buffer;
+
+    const qint64 deltaSizeBefore =
+        KisTileDataStore::instance()->memoryStatistics().historicalDeltaSize;
+
+    // every revision changes a small dab in every tile
+    for (int i = 1; i < numRevisions; i++) {
+        quint8 pixel = 1 + i;
+
+        mementos << dm.getMemento();
+        for (int y = 0; y < rect.height(); y += 64) {
+            for (int x = 0; x < rect.width(); x += 64) {
+                dm.clear(x + 2 * i, y + 2 * i, 8, 8, &pixel);
+            }
+        }
+        dm.commit();
+
+        dm.readBytes(buffer.data(), rect.x(), rect.y(), rect.width(), rect.height());
+        revisions << buffer;
+    }
+
+    QVERIFY(KisTileDataStore::instance()->memoryStatistics().historicalDeltaSize >
+            deltaSizeBefore);
+
+    QVector<quint8> result(buffer.size());
+
+    for (int i = numRevisions - 1; i > 0; i--) {
+        dm.rollback(mementos[i]);
+        dm.readBytes(result.data(), rect.x(), rect.y(), rect.width(), rect.height());
+        QVERIFY(result == revisions[i - 1]);
+    }
+
+    for (int i = 1; i < numRevisions; i++) {
+        dm.rollforward(mementos[i]);
+        dm.readBytes(result.data(), rect.x(), rect.y(), rect.width(), rect.height());
+        QVERIFY(result == revisions[i]);
+    }
+
+    KisTileDataStore::instance()->testingResumePooler();
+}
+
+void KisTiledDataManagerTest::testVariableTileSize_data()
+{
+    QTest::addColumn<int>("tileSize");
+
+    QTest::newRow("32px") << 32;
+    QTest::newRow("128px") << 128;
+    QTest::newRow("256px") << 256;
+}
+
+void KisTiledDataManagerTest::testVariableTileSize()
+{
+    QFETCH(int, tileSize);
+
+    quint8 defaultPixel = 0;
+    KisDataManager dm(1, &defaultPixel, tileSize, tileSize);
+
+    QCOMPARE(dm.tileWidth(), tileSize);
+    QCOMPARE(dm.tileHeight(), tileSize);
+
+    const QRect rect(-50, -30, 300, 200);
+
+    QVector<quint8> buffer(rect.width() * rect.height());
+    for (int i = 0; i < buffer.size(); i++) {
+        buffer[i] = 1 + i % 251;
+    }
+
+    dm.writeBytes(buffer.data(), rect.x(), rect.y(), rect.width(), rect.height());
+
+    QVector<quint8> result(buffer.size());
+    dm.readBytes(result.data(), rect.x(), rect.y(), rect.width(), rect.height());
+    QVERIFY(result == buffer);
+
+    // the extent is aligned to the tiles of the data manager
+    const int firstCol = -((-rect.left() - 1) / tileSize + 1);
+    const int firstRow = -((-rect.top() - 1) / tileSize + 1);
+    const int lastCol = rect.right() / tileSize;
+    const int lastRow = rect.bottom() / tileSize;
+
+    QCOMPARE(dm.extent(), QRect(firstCol * tileSize, firstRow * tileSize,
+                                (lastCol - firstCol + 1) * tileSize,
+                                (lastRow - firstRow + 1) * tileSize));
+
+    // iterators
+    {
+        KisHLineConstIteratorSP it =
+            new KisHLineIterator2(&dm, rect.x(), rect.y(), rect.width(), 0, 0, false, 0);
+
+        for (int y = 0; y < rect.height(); y++) {
+            int x = 0;
+            do {
+                QCOMPARE(*it->oldRawData(), buffer[y * rect.width() + x]);
+                x++;
+            } while (it->nextPixel());
+            QCOMPARE(x, rect.width());
+            it->nextRow();
+        }
+    }
+
+    {
+        KisVLineConstIteratorSP it =
+            new KisVLineIterator2(&dm, rect.x(), rect.y(), rect.height(), 0, 0, false, 0);
+
+        for (int x = 0; x < rect.width(); x++) {
+            int y = 0;
+            do {
+                QCOMPARE(*it->oldRawData(), buffer[y * rect.width() + x]);
+                y++;
+            } while (it->nextPixel());
+            QCOMPARE(y, rect.height());
+            it->nextColumn();
+        }
+    }
+
+    {
+        KisRandomConstAccessorSP it = new KisRandomAccessor2(&dm, 0, 0, false, 0);
+
+        for (int i = 0; i < 1000; i++) {
+            const int x = (i * 7919) % rect.width();
+            const int y = (i * 104729) % rect.height();
+
+            it->moveTo(rect.x() + x, rect.y() + y);
+            QCOMPARE(*it->oldRawData(), buffer[y * rect.width() + x]);
+        }
+    }
+
+    // bitBlt between the data managers with different tile sizes
+    {
+        quint8 oddPixel = 128;
+        KisTiledDataManager defaultDM(1, &defaultPixel);
+        defaultDM.clear(rect, &oddPixel);
+
+        const QRect cloneRect(-20, -10, 200, 150);
+        defaultDM.bitBlt(&dm, cloneRect);
+
+        QVector<quint8> cloned(rect.width() * rect.height());
+        defaultDM.readBytes(cloned.data(), rect.x(), rect.y(), rect.width(), rect.height());
+
+        for (int y = 0; y < rect.height(); y++) {
+            for (int x = 0; x < rect.width(); x++) {
+                const int index = y * rect.width() + x;
+                const quint8 expected =
+                    cloneRect.contains(rect.x() + x, rect.y() + y) ? buffer[index] : oddPixel;
+                QCOMPARE(cloned[index], expected);
+            }
+        }
+
+        KisDataManager roughDM(1, &defaultPixel, tileSize, tileSize);
+        roughDM.bitBltRough(&defaultDM, rect);
+        roughDM.readBytes(result.data(), rect.x(), rect.y(), rect.width(), rect.height());
+        QVERIFY(result == cloned);
+    }
+
+    // undo
+    {
+        quint8 clearPixel = 7;
+
+        KisMementoSP memento = dm.getMemento();
+        dm.clear(rect.adjusted(10, 10, -10, -10), &clearPixel);
+        dm.commit();
+
+        dm.rollback(memento);
+        dm.readBytes(result.data(), rect.x(), rect.y(), rect.width(), rect.height());
+        QVERIFY(result == buffer);
+
+        dm.rollforward(memento);
+        dm.readBytes(result.data(), rect.x(), rect.y(), rect.width(), rect.height());
+        QCOMPARE(result[11 * rect.width() + 11], clearPixel);
+    }
+}
+
+void KisTiledDataManagerTest::testContentRevision()
+{
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    const QRect firstTileRect(0, 0, 64, 64);
+    const QRect farTileRect(256, 256, 64, 64);
+    const QRect bothTilesRect = firstTileRect | farTileRect;
+
+    const quint64 emptyFirst = dm.contentRevision(firstTileRect);
+    const quint64 emptyFar = dm.contentRevision(farTileRect);
+    const quint64 emptyBoth = dm.contentRevision(bothTilesRect);
+
+    QCOMPARE(dm.contentRevision(QRect(10, 10, 5, 5)), emptyFirst);
+
+    quint8 pixel = 128;
+    dm.clear(10, 10, 5, 5, &pixel);
+
+    const quint64 paintedFirst = dm.contentRevision(firstTileRect);
+    QVERIFY(paintedFirst != emptyFirst);
+    QVERIFY(dm.contentRevision(bothTilesRect) != emptyBoth);
+    QCOMPARE(dm.contentRevision(farTileRect), emptyFar);
+
+    // reading doesn't change the revision
+    QVector<quint8> buffer(64 * 64);
+    dm.readBytes(buffer.data(), 0, 0, 64, 64);
+    QCOMPARE(dm.contentRevision(firstTileRect), paintedFirst);
+
+    // every write does
+    dm.clear(20, 20, 5, 5, &pixel);
+    const quint64 repaintedFirst = dm.contentRevision(firstTileRect);
+    QVERIFY(repaintedFirst != paintedFirst);
+
+    // undo replaces the tile with the old one
+    KisMementoSP memento = dm.getMemento();
+    dm.clear(30, 30, 5, 5, &pixel);
+    dm.commit();
+    const quint64 committedFirst = dm.contentRevision(firstTileRect);
+    QVERIFY(committedFirst != repaintedFirst);
+
+    dm.rollback(memento);
+    QVERIFY(dm.contentRevision(firstTileRect) != committedFirst);
+    QVERIFY(dm.contentRevision(firstTileRect) != repaintedFirst);
+
+    // the removed tile is equivalent to the default one
+    dm.clear();
+    QCOMPARE(dm.contentRevision(firstTileRect), emptyFirst);
+    QCOMPARE(dm.contentRevision(bothTilesRect), emptyBoth);
+}
+
 void KisTiledDataManagerTest::benchmarkReadOnlyTileLazy()
 {
     quint8 defaultPixel = 0;
@@ -983,6 +1293,116 @@ void KisTiledDataManagerTest::stressTestExtentsColumn()
     QVERIFY(column.max() < column.min()); // really empty :)
 }
 
+void KisTiledDataManagerTest::stressTestHashTable()
+{
+    const quint8 defaultPixel = 0;
+    KisTileHashTable table(0);
+    table.setDefaultTileData(
+        KisTileDataStore::instance()->createDefaultTileData(1, &defaultPixel));
+
+    QAtomicInt numFailures(0);
+
+    /**
+     * All the workers fight for the same small set of tiles, so
+     * the lookups, lazy insertions and removals overlap all the time,
+     * which triggers migrations of the underlying map and makes the
+     * readers race with the memory reclamation.
+     */
+    struct Job : public QRunnable
+    {
+        Job(KisTileHashTable &table, QAtomicInt &numFailures,
+            int seed, int numCycles, bool canChangeDefault)
+            : m_table(table),
+              m_numFailures(numFailures),
+              m_seed(seed),
+              m_numCycles(numCycles),
+              m_canChangeDefault(canChangeDefault) {}
+
+        bool checkTile(KisTileSP tile, int col, int row) {
+            return tile && tile->col() == col && tile->row() == row;
+        }
+
+        void run() override {
+            quint32 random = m_seed;
+
+            for(qint32 i = 0; i < m_numCycles; i++) {
+                random = random * 1103515245 + 12345;
+                const int col = (random >> 8) % 16;
+                const int row = (random >> 16) % 16;
+                bool flag = false;
+
+                switch ((random >> 24) % 8) {
+                case 0:
+                case 1: {
+                    KisTileSP tile = m_table.getTileLazy(col, row, flag);
+                    if (!checkTile(tile, col, row)) m_numFailures.ref();
+                    break;
+                }
+                case 2:
+                case 3: {
+                    KisTileSP tile = m_table.getExistingTile(col, row);
+                    if (tile && !checkTile(tile, col, row)) m_numFailures.ref();
+                    break;
+                }
+                case 4: {
+                    KisTileSP tile = m_table.getReadOnlyTileLazy(col, row, flag);
+                    if (!tile || (flag && !checkTile(tile, col, row))) m_numFailures.ref();
+                    break;
+                }
+                case 5:
+                case 6:
+                    m_table.deleteTile(col, row);
+                    break;
+                case 7:
+                    if (m_canChangeDefault && !(i % 64)) {
+                        const quint8 pixel = i % 256;
+                        m_table.setDefaultTileData(
+                            KisTileDataStore::instance()->createDefaultTileData(1, &pixel));
+                    }
+                    break;
+                }
+            }
+        }
+
+        KisTileHashTable &m_table;
+        QAtomicInt &m_numFailures;
+        const int m_seed;
+        const int m_numCycles;
+        const bool m_canChangeDefault;
+    };
+
+#ifdef LIMIT_LONG_TESTS
+    const int numThreads = 8;
+    const int numWorkers = 16;
+    const int numCycles = 10000;
+#else
+    const int numThreads = 16;
+    const int numWorkers = 64;
+    const int numCycles = 100000;
+#endif
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads);
+
+    for(qint32 i = 0; i < numWorkers; i++) {
+        pool.start(new Job(table, numFailures, i + 1, numCycles, i == 0));
+    }
+    pool.waitForDone();
+
+    QCOMPARE(numFailures.loadAcquire(), 0);
+
+    int numTiles = 0;
+    {
+        KisTileHashTableIterator iter(&table);
+        for (; !iter.isDone(); iter.next()) {
+            KisTileSP tile = iter.tile();
+            QVERIFY(table.tileExists(tile->col(), tile->row()));
+            numTiles++;
+        }
+    }
+    QCOMPARE(numTiles, table.numTiles());
+}
+
 void KisTiledDataManagerTest::benchmaskQRegion()
 {
     QVector<QRect> rects;
@@ -40,6 +40,11 @@ private Q_SLOTS:
     void testTransactions();
     void testPurgeHistory();
     void testUndoSetDefaultPixel();
+    void testDeduplication();
+    void testDeltaMementos();
+    void testVariableTileSize_data();
+    void testVariableTileSize();
+    void testContentRevision();
 
     void benchmarkReadOnlyTileLazy();
     void benchmarkSharedPointers();
@@ -53,6 +58,8 @@ private Q_SLOTS:
 
     void stressTestExtentsColumn();
 
+    void stressTestHashTable();
+
     void benchmaskQRegion();
     void benchmaskKisRegion();
     void benchmaskOverlappedKisRegion();
@@ -7,11 +7,12 @@
 #include "KoColorConversionCache.h"
 
 #include <QHash>
-#include <QList>
-#include <QMutex>
+#include <QReadWriteLock>
+#include <QSharedPointer>
 #include <QThreadStorage>
 
 #include <KoColorSpace.h>
+#include <kis_lockless_stack.h>
 
 struct KoColorConversionCacheKey {
 
@@ -53,23 +54,117 @@ struct KoColorConversionCache::CachedTransformation {
         delete transfo;
     }
 
-    bool isNotInUse() {
-        return !use;
-    }
-
     KoColorConversionTransformation* transfo;
     QAtomicInt use;
+
+    /**
+     * The pool the transformation is checked out from. It is set only
+     * while the transformation is in use and keeps the pool alive, even
+     * if it has already been removed from the cache. The transformations
+     * that are stored in the pool don't reference it.
+     */
+    QSharedPointer<TransformationPool> pool;
+};
+
+struct KoColorConversionCache::TransformationPool {
+
+    TransformationPool(const KoColorConversionCacheKey &_key)
+        : key(_key)
+    {}
+
+    ~TransformationPool() {
+        int numAvailable = 0;
+
+        CachedTransformation *ct = 0;
+        while (available.pop(ct)) {
+            delete ct;
+            numAvailable++;
+        }
+
+        // every checked out transformation keeps a reference to the pool,
+        // so all of them should have been returned by now
+        Q_ASSERT(numAvailable == numTransformations);
+        Q_UNUSED(numAvailable);
+    }
+
+    KoColorConversionCacheKey key;
+    KisLocklessStack<CachedTransformation*> available;
+    QAtomicInt numTransformations;
 };
 
-typedef QPair<KoColorConversionCacheKey, KoCachedColorConversionTransformation> FastPathCacheItem;
+/**
+ * Non-owning map of the pools used by the current thread. The map
+ * is cleared when \p generation differs from the generation of the
+ * cache, which is incremented every time any pool is removed. The
+ * weak pointers make sure that the thread never uses a pool that
+ * has been destroyed in the meantime.
+ */
+struct ThreadLocalPools {
+    int generation = -1;
+    QHash<KoColorConversionCacheKey, QWeakPointer<KoColorConversionCache::TransformationPool>> pools;
+};
 
 struct KoColorConversionCache::Private {
-    QMultiHash< KoColorConversionCacheKey, CachedTransformation*> cache;
-    QMutex cacheMutex;
+    QHash< KoColorConversionCacheKey, QSharedPointer<TransformationPool>> pools;
+    QReadWriteLock poolsLock;
 
-    QThreadStorage<FastPathCacheItem*> fastStorage;
+    QAtomicInt generation;
+    QThreadStorage<ThreadLocalPools*> threadLocalPools;
+
+    QAtomicInt numSharedLookups;
+    QAtomicInt numContendedCheckouts;
+    QAtomicInt numTransformations;
+
+    QSharedPointer<TransformationPool> fetchPool(const KoColorConversionCacheKey &key);
 };
 
+/**
+ * The thread-local maps are cleared when they grow bigger than
+ * this size, it prevents long-living threads from accumulating
+ * lots of keys that are not used anymore.
+ */
+static const int maxThreadLocalPools = 64;
+
+QSharedPointer<KoColorConversionCache::TransformationPool> KoColorConversionCache::Private::fetchPool(const KoColorConversionCacheKey &key)
+{
+    ThreadLocalPools *localPools = threadLocalPools.localData();
+    if (!localPools) {
+        localPools = new ThreadLocalPools();
+        threadLocalPools.setLocalData(localPools);
+    }
+
+    const int currentGeneration = generation.loadAcquire();
+    if (localPools->generation != currentGeneration ||
+        localPools->pools.size() > maxThreadLocalPools) {
+
+        localPools->pools.clear();
+        localPools->generation = currentGeneration;
+    }
+
+    QSharedPointer<TransformationPool> pool = localPools->pools.value(key).toStrongRef();
+    if (pool) return pool;
+
+    numSharedLookups.ref();
+
+    {
+        QReadLocker l(&poolsLock);
+        pool = pools.value(key);
+    }
+
+    if (!pool) {
+        QWriteLocker l(&poolsLock);
+
+        // some other thread could have created it while we were waiting for the lock
+        pool = pools.value(key);
+        if (!pool) {
+            pool = QSharedPointer<TransformationPool>::create(key);
+            pools.insert(key, pool);
+        }
+    }
+
+    localPools->pools.insert(key, pool);
+    return pool;
+}
 
 KoColorConversionCache::KoColorConversionCache() : d(new Private)
 {
@@ -77,9 +172,6 @@ KoColorConversionCache::KoColorConversionCache() : d(new Private)
 
 KoColorConversionCache::~KoColorConversionCache()
 {
-    Q_FOREACH (CachedTransformation* transfo, d->cache) {
-        delete transfo;
-    }
     delete d;
 }
 
@@ -90,56 +182,73 @@ KoCachedColorConversionTransformation KoColorConversionCache::cachedConverter(co
 {
     KoColorConversionCacheKey key(src, dst, _renderingIntent, _conversionFlags);
 
-    FastPathCacheItem *cacheItem =
-        d->fastStorage.localData();
+    QSharedPointer<TransformationPool> pool = d->fetchPool(key);
 
-    if (cacheItem) {
-        if (cacheItem->first == key) {
-            return cacheItem->second;
-        }
-    }
-
-    cacheItem = 0;
-
-    QMutexLocker lock(&d->cacheMutex);
-    QList< CachedTransformation* > cachedTransfos = d->cache.values(key);
-    if (cachedTransfos.size() != 0) {
-        Q_FOREACH (CachedTransformation* ct, cachedTransfos) {
-            ct->transfo->setSrcColorSpace(src);
-            ct->transfo->setDstColorSpace(dst);
+    CachedTransformation *ct = 0;
+    if (!pool->available.pop(ct)) {
+        // the transformation is created without holding any locks,
+        // so other threads can continue using the cache
+        KoColorConversionTransformation* transfo = src->createColorConverter(dst, _renderingIntent, _conversionFlags);
+        ct = new CachedTransformation(transfo);
 
-            cacheItem = new FastPathCacheItem(key, KoCachedColorConversionTransformation(ct));
-            break;
+        if (pool->numTransformations.fetchAndAddOrdered(1) > 0) {
+            d->numContendedCheckouts.ref();
         }
-    }
-    if (!cacheItem) {
-        KoColorConversionTransformation* transfo = src->createColorConverter(dst, _renderingIntent, _conversionFlags);
-        CachedTransformation* ct = new CachedTransformation(transfo);
-        d->cache.insert(key, ct);
-        cacheItem = new FastPathCacheItem(key, KoCachedColorConversionTransformation(ct));
+        d->numTransformations.ref();
     }
 
-    d->fastStorage.setLocalData(cacheItem);
-    return cacheItem->second;
+    // the pool key compares color spaces by value, so the
+    // transformation could have been created for other (equal)
+    // instances of the color spaces
+    ct->transfo->setSrcColorSpace(src);
+    ct->transfo->setDstColorSpace(dst);
+    ct->pool = pool;
+
+    return KoCachedColorConversionTransformation(ct);
 }
 
 void KoColorConversionCache::colorSpaceIsDestroyed(const KoColorSpace* cs)
 {
-    d->fastStorage.setLocalData(0);
+    QWriteLocker lock(&d->poolsLock);
+
+    // invalidate the thread-local pointers to the pools
+    d->generation.ref();
 
-    QMutexLocker lock(&d->cacheMutex);
-    QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator endIt = d->cache.end();
-    for (QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator it = d->cache.begin(); it != endIt;) {
+    // the pools are destroyed when the last thread, that has
+    // fetched them, releases its reference
+    auto endIt = d->pools.end();
+    for (auto it = d->pools.begin(); it != endIt;) {
         if (it.key().src == cs || it.key().dst == cs) {
-            Q_ASSERT(it.value()->isNotInUse()); // That's terribely evil, if that assert fails, that means that someone is using a color transformation with a color space which is currently being deleted
-            delete it.value();
-            it = d->cache.erase(it);
+            it = d->pools.erase(it);
         } else {
             ++it;
         }
     }
 }
 
+KoColorConversionCache::Statistics KoColorConversionCache::statistics() const
+{
+    Statistics stats;
+
+    {
+        QReadLocker lock(&d->poolsLock);
+        stats.numPools = d->pools.size();
+    }
+
+    stats.numTransformations = d->numTransformations.loadAcquire();
+    stats.numSharedLookups = d->numSharedLookups.loadAcquire();
+    stats.numContendedCheckouts = d->numContendedCheckouts.loadAcquire();
+
+    return stats;
+}
+
+void KoColorConversionCache::resetStatistics()
+{
+    d->numTransformations.storeRelease(0);
+    d->numSharedLookups.storeRelease(0);
+    d->numContendedCheckouts.storeRelease(0);
+}
+
 //--------- KoCachedColorConversionTransformation ----------//
 
 KoCachedColorConversionTransformation::KoCachedColorConversionTransformation(KoColorConversionCache::CachedTransformation* transfo)
@@ -158,7 +267,13 @@ KoCachedColorConversionTransformation::KoCachedColorConversionTransformation(con
 KoCachedColorConversionTransformation::~KoCachedColorConversionTransformation()
 {
     Q_ASSERT(m_transfo->use > 0);
-    m_transfo->use.deref();
+    if (!m_transfo->use.deref()) {
+        // the pool should not be referenced by the stored transformation,
+        // otherwise they will keep each other alive forever
+        QSharedPointer<KoColorConversionCache::TransformationPool> pool;
+        pool.swap(m_transfo->pool);
+        pool->available.push(m_transfo);
+    }
 }
 
 const KoColorConversionTransformation* KoCachedColorConversionTransformation::transformation() const
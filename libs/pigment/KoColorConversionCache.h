@@ -11,16 +11,47 @@ class KoCachedColorConversionTransformation;
 class KoColorSpace;
 
 #include "KoColorConversionTransformation.h"
+#include "kritapigment_export.h"
 
 /**
  * This class holds a cache of KoColorConversionTransformations.
  *
+ * The transformations are kept in pools, one pool per conversion
+ * key (source, destination, intent and flags). A transformation is
+ * checked out of the pool exclusively for the lifetime of the
+ * KoCachedColorConversionTransformation handle, so the threads never
+ * share the same transformation object. If the pool is empty (all the
+ * transformations are busy in other threads), a new transformation
+ * is created, so the size of the pool is limited by the number of
+ * threads doing the same conversion concurrently.
+ *
+ * The pools are lock-free stacks, and each thread keeps its own
+ * map of key -> pool, so the fast path of cachedConverter() takes
+ * no locks at all.
+ *
  * This class is not part of public API, and can be changed without notice.
  */
-class KoColorConversionCache
+class KRITAPIGMENT_EXPORT KoColorConversionCache
 {
 public:
     struct CachedTransformation;
+    struct TransformationPool;
+
+    /**
+     * Counters of the cache usage. They are updated only on the slow
+     * paths of the cache, so they don't cause any contention themselves.
+     */
+    struct Statistics {
+        /// number of conversion keys known to the cache
+        int numPools = 0;
+        /// total number of transformations created by the cache
+        int numTransformations = 0;
+        /// lookups that missed the thread-local map and went to the shared one
+        int numSharedLookups = 0;
+        /// transformations created because the pool's ones were busy in other threads
+        int numContendedCheckouts = 0;
+    };
+
 public:
     KoColorConversionCache();
     ~KoColorConversionCache();
@@ -45,6 +76,18 @@ public:
      * @param src source color space
      */
     void colorSpaceIsDestroyed(const KoColorSpace* src);
+
+    /**
+     * @return the usage counters of the cache
+     */
+    Statistics statistics() const;
+
+    /**
+     * Reset the usage counters of the cache. The number of pools is
+     * not a counter, so it is not affected.
+     */
+    void resetStatistics();
+
 private:
     struct Private;
     Private* const d;
@@ -55,9 +98,12 @@ private:
  * by the cache and when it's deleted it return the transformation to
  * the pool of available color conversion transformation.
  *
+ * The copies of the handle share the same transformation, so they
+ * should not be used concurrently from different threads.
+ *
  * This class is not part of public API, and can be changed without notice.
  */
-class KoCachedColorConversionTransformation
+class KRITAPIGMENT_EXPORT KoCachedColorConversionTransformation
 {
     friend class KoColorConversionCache;
 private:
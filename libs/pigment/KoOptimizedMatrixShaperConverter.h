@@ -0,0 +1,280 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOOPTIMIZEDMATRIXSHAPERCONVERTER_H
+#define KOOPTIMIZEDMATRIXSHAPERCONVERTER_H
+
+#include <type_traits>
+
+#include "KoOptimizedMatrixShaperConverterBase.h"
+
+#include "KoAlwaysInline.h"
+#include "KoColorSpaceMaths.h"
+#include "KoMultiArchBuildSupport.h"
+
+
+/**
+ * Per-pixel implementation of the conversion. It is used as the
+ * generic (non-vectorized) version of the converter and for the
+ * tails of the lines that do not fill the whole SIMD register.
+ */
+template<class SrcTraits, class DstTraits>
+struct KoMatrixShaperConverterScalar
+{
+    using src_channels_type = typename SrcTraits::channels_type;
+    using dst_channels_type = typename DstTraits::channels_type;
+
+    static constexpr bool srcIsInteger = std::is_integral<src_channels_type>::value;
+    static constexpr bool dstIsInteger = std::is_integral<dst_channels_type>::value;
+
+    static constexpr int encodingLutSize = KoOptimizedMatrixShaperConverterBase::encodingLutSize;
+
+    KoMatrixShaperConverterScalar(const KoOptimizedMatrixShaperConverterBase::Params &params)
+        : hasMatrix(!params.isIdentityMatrix())
+    {
+        for (int i = 0; i < 9; i++) {
+            matrix[i] = params.matrix[i];
+        }
+
+        for (int ch = 0; ch < 3; ch++) {
+            srcLut[ch] = !params.srcLinearizationLut[ch].isEmpty() ?
+                params.srcLinearizationLut[ch].constData() : nullptr;
+            dstLut[ch] = !params.dstEncodingLut[ch].isEmpty() ?
+                params.dstEncodingLut[ch].constData() : nullptr;
+        }
+    }
+
+    template<typename T = src_channels_type>
+    static ALWAYS_INLINE
+    typename std::enable_if<std::is_integral<T>::value, float>::type
+    linearize(const float *lut, T value) {
+        return lut ? lut[value] : KoColorSpaceMaths<T, float>::scaleToA(value);
+    }
+
+    template<typename T = src_channels_type>
+    static ALWAYS_INLINE
+    typename std::enable_if<!std::is_integral<T>::value, float>::type
+    linearize(const float *lut, T value) {
+        Q_UNUSED(lut);
+        return KoColorSpaceMaths<T, float>::scaleToA(value);
+    }
+
+    static ALWAYS_INLINE float encode(const float *lut, float value) {
+        if (!dstIsInteger) return value;
+
+        value = qBound(0.0f, value, 1.0f);
+        if (!lut) return value;
+
+        const float pos = value * encodingLutSize;
+        const int index = qMin(static_cast<int>(pos), encodingLutSize - 1);
+        const float fraction = pos - index;
+
+        return lut[index] + (lut[index + 1] - lut[index]) * fraction;
+    }
+
+    void convertPixels(const quint8 *src, quint8 *dst, int numPixels) const
+    {
+        const src_channels_type *srcPixel = reinterpret_cast<const src_channels_type*>(src);
+        dst_channels_type *dstPixel = reinterpret_cast<dst_channels_type*>(dst);
+
+        for (int i = 0; i < numPixels; i++) {
+            float rgb[3];
+            rgb[0] = linearize(srcLut[0], srcPixel[SrcTraits::red_pos]);
+            rgb[1] = linearize(srcLut[1], srcPixel[SrcTraits::green_pos]);
+            rgb[2] = linearize(srcLut[2], srcPixel[SrcTraits::blue_pos]);
+
+            if (hasMatrix) {
+                const float r = rgb[0];
+                const float g = rgb[1];
+                const float b = rgb[2];
+
+                rgb[0] = matrix[0] * r + matrix[1] * g + matrix[2] * b;
+                rgb[1] = matrix[3] * r + matrix[4] * g + matrix[5] * b;
+                rgb[2] = matrix[6] * r + matrix[7] * g + matrix[8] * b;
+            }
+
+            dstPixel[DstTraits::red_pos] = KoColorSpaceMaths<float, dst_channels_type>::scaleToA(encode(dstLut[0], rgb[0]));
+            dstPixel[DstTraits::green_pos] = KoColorSpaceMaths<float, dst_channels_type>::scaleToA(encode(dstLut[1], rgb[1]));
+            dstPixel[DstTraits::blue_pos] = KoColorSpaceMaths<float, dst_channels_type>::scaleToA(encode(dstLut[2], rgb[2]));
+
+            // the alpha channel goes through float to get the same rounding
+            // as the vectorized version
+            const float alpha = KoColorSpaceMaths<src_channels_type, float>::scaleToA(srcPixel[SrcTraits::alpha_pos]);
+            dstPixel[DstTraits::alpha_pos] =
+                KoColorSpaceMaths<float, dst_channels_type>::scaleToA(dstIsInteger ? qBound(0.0f, alpha, 1.0f) : alpha);
+
+            srcPixel += SrcTraits::channels_nb;
+            dstPixel += DstTraits::channels_nb;
+        }
+    }
+
+    float matrix[9];
+    bool hasMatrix;
+    const float *srcLut[3];
+    const float *dstLut[3];
+};
+
+template<class SrcTraits,
+         class DstTraits,
+         typename _impl,
+         typename EnableDummyType = void>
+class KoOptimizedMatrixShaperConverter : public KoOptimizedMatrixShaperConverterBase
+{
+public:
+    KoOptimizedMatrixShaperConverter(const Params &params)
+        : KoOptimizedMatrixShaperConverterBase(params)
+        , m_scalar(m_params)
+    {
+    }
+
+    void convert(const quint8 *src, quint8 *dst, int numPixels) const override
+    {
+        m_scalar.convertPixels(src, dst, numPixels);
+    }
+
+private:
+    KoMatrixShaperConverterScalar<SrcTraits, DstTraits> m_scalar;
+};
+
+#ifdef HAVE_XSIMD
+
+#include "KoOptimizedCompositeOpGeneric.h"
+
+template<class SrcTraits, class DstTraits, typename _impl>
+class KoOptimizedMatrixShaperConverter<
+        SrcTraits, DstTraits, _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+    : public KoOptimizedMatrixShaperConverterBase
+{
+    using float_v = xsimd::batch<float, _impl>;
+    using int_v = xsimd::batch<int, _impl>;
+
+    using src_channels_type = typename SrcTraits::channels_type;
+    using dst_channels_type = typename DstTraits::channels_type;
+    using ScalarImpl = KoMatrixShaperConverterScalar<SrcTraits, DstTraits>;
+
+    static constexpr int vectorSize = static_cast<int>(float_v::size);
+
+public:
+    KoOptimizedMatrixShaperConverter(const Params &params)
+        : KoOptimizedMatrixShaperConverterBase(params)
+        , m_scalar(m_params)
+    {
+    }
+
+    void convert(const quint8 *src, quint8 *dst, int numPixels) const override
+    {
+        const int numBlocks = numPixels / vectorSize;
+        const int numRestPixels = numPixels % vectorSize;
+
+        const int srcVectorStride = vectorSize * static_cast<int>(SrcTraits::pixelSize);
+        const int dstVectorStride = vectorSize * static_cast<int>(DstTraits::pixelSize);
+
+        KoGenericCompositePixelWrapper<src_channels_type, _impl> srcWrapper;
+        KoGenericCompositePixelWrapper<dst_channels_type, _impl> dstWrapper;
+
+        const float_v srcUnitValue(static_cast<float>(KoColorSpaceMathsTraits<src_channels_type>::unitValue));
+        const float_v zeroValue(0.0f);
+        const float_v oneValue(1.0f);
+
+        float_v m[9];
+        for (int i = 0; i < 9; i++) {
+            m[i] = float_v(m_scalar.matrix[i]);
+        }
+
+        for (int i = 0; i < numBlocks; i++) {
+            float_v c[4];
+            srcWrapper.read(src, c);
+
+            float_v rgb[3] = {c[SrcTraits::red_pos], c[SrcTraits::green_pos], c[SrcTraits::blue_pos]};
+
+            if (ScalarImpl::srcIsInteger) {
+                for (int ch = 0; ch < 3; ch++) {
+                    if (!m_scalar.srcLut[ch]) continue;
+                    rgb[ch] = lookup(m_scalar.srcLut[ch], xsimd::nearbyint_as_int(rgb[ch] * srcUnitValue));
+                }
+            }
+
+            if (m_scalar.hasMatrix) {
+                const float_v r = rgb[0];
+                const float_v g = rgb[1];
+                const float_v b = rgb[2];
+
+                rgb[0] = xsimd::fma(m[0], r, xsimd::fma(m[1], g, m[2] * b));
+                rgb[1] = xsimd::fma(m[3], r, xsimd::fma(m[4], g, m[5] * b));
+                rgb[2] = xsimd::fma(m[6], r, xsimd::fma(m[7], g, m[8] * b));
+            }
+
+            float_v alpha = c[SrcTraits::alpha_pos];
+
+            if (ScalarImpl::dstIsInteger) {
+                for (int ch = 0; ch < 3; ch++) {
+                    rgb[ch] = xsimd::min(xsimd::max(rgb[ch], zeroValue), oneValue);
+                    if (!m_scalar.dstLut[ch]) continue;
+                    rgb[ch] = encode(m_scalar.dstLut[ch], rgb[ch]);
+                }
+                alpha = xsimd::min(xsimd::max(alpha, zeroValue), oneValue);
+            }
+
+            float_v result[4];
+            result[DstTraits::red_pos] = rgb[0];
+            result[DstTraits::green_pos] = rgb[1];
+            result[DstTraits::blue_pos] = rgb[2];
+            result[DstTraits::alpha_pos] = alpha;
+
+            dstWrapper.write(dst, result);
+
+            src += srcVectorStride;
+            dst += dstVectorStride;
+        }
+
+        m_scalar.convertPixels(src, dst, numRestPixels);
+    }
+
+private:
+    static ALWAYS_INLINE float_v lookup(const float *lut, const int_v &index)
+    {
+#if XSIMD_WITH_AVX2
+        return float_v(_mm256_i32gather_ps(lut, index, sizeof(float)));
+#else
+        int indexes[vectorSize];
+        float values[vectorSize];
+
+        index.store_unaligned(indexes);
+
+        for (int i = 0; i < vectorSize; i++) {
+            values[i] = lut[indexes[i]];
+        }
+
+        return float_v::load_unaligned(values);
+#endif
+    }
+
+    /**
+     * Linear interpolation of the encoding curve, \p value is
+     * expected to be clamped into [0.0, 1.0] range
+     */
+    static ALWAYS_INLINE float_v encode(const float *lut, const float_v &value)
+    {
+        const int lutSize = KoOptimizedMatrixShaperConverterBase::encodingLutSize;
+
+        const float_v pos = value * float_v(static_cast<float>(lutSize));
+        const int_v index = xsimd::min(xsimd::batch_cast<int>(pos), int_v(lutSize - 1));
+        const float_v fraction = pos - xsimd::batch_cast<float>(index);
+
+        const float_v v0 = lookup(lut, index);
+        const float_v v1 = lookup(lut, index + int_v(1));
+
+        return xsimd::fma(v1 - v0, fraction, v0);
+    }
+
+private:
+    ScalarImpl m_scalar;
+};
+
+#endif /* HAVE_XSIMD */
+
+#endif // KOOPTIMIZEDMATRIXSHAPERCONVERTER_H
@@ -0,0 +1,47 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedMatrixShaperConverterBase.h"
+
+#include <QtMath>
+
+
+KoOptimizedMatrixShaperConverterBase::Params::Params()
+    : matrix{1.0f, 0.0f, 0.0f,
+             0.0f, 1.0f, 0.0f,
+             0.0f, 0.0f, 1.0f}
+{
+}
+
+bool KoOptimizedMatrixShaperConverterBase::Params::isIdentityMatrix() const
+{
+    const float eps = 1e-6f;
+
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            const float expected = row == col ? 1.0f : 0.0f;
+            if (qAbs(matrix[row * 3 + col] - expected) > eps) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+KoOptimizedMatrixShaperConverterBase::KoOptimizedMatrixShaperConverterBase(const Params &params)
+    : m_params(params)
+{
+}
+
+KoOptimizedMatrixShaperConverterBase::~KoOptimizedMatrixShaperConverterBase()
+{
+}
+
+const KoOptimizedMatrixShaperConverterBase::Params &KoOptimizedMatrixShaperConverterBase::params() const
+{
+    return m_params;
+}
@@ -0,0 +1,83 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOOPTIMIZEDMATRIXSHAPERCONVERTERBASE_H
+#define KOOPTIMIZEDMATRIXSHAPERCONVERTERBASE_H
+
+#include <QVector>
+#include <KoID.h>
+#include "kritapigment_export.h"
+
+/**
+ * @brief Converts RGBA pixels between two matrix-shaper RGB profiles
+ *
+ * Conversion between two matrix-shaper profiles is a sequence of
+ * three simple steps: linearize the source channels with the tone
+ * curves of the source profile, multiply them by a 3x3 matrix
+ * (source colorants -> XYZ -> destination colorants) and encode
+ * the result with the inverse tone curves of the destination
+ * profile. The converter does all three steps in SIMD registers,
+ * so it is much faster than a generic cmsDoTransform() call.
+ *
+ * The tone curves are passed as lookup tables, which are prepared
+ * by the color engine:
+ *
+ * - `srcLinearizationLut[ch]` is indexed by the raw integer value
+ *   of the source channel, i.e. it has 256 entries for U8 and 65536
+ *   entries for U16 color spaces. Floating point color spaces cannot
+ *   have a linearization table.
+ *
+ * - `dstEncodingLut[ch]` contains `encodingLutSize + 1` samples of
+ *   the encoding curve in range [0.0, 1.0], the values between the
+ *   samples are linearly interpolated. Only integer color spaces can
+ *   have an encoding table, floating point color spaces are expected
+ *   to be linear.
+ *
+ * The empty table means that the channel is passed as it is (after
+ * normalization to [0.0, 1.0] range). The channels are indexed in
+ * logical order: red, green, blue. Alpha channel is always copied.
+ *
+ * The actual implementation is placed in class
+ * `KoOptimizedMatrixShaperConverter`. To create a converter, call
+ * KoOptimizedMatrixShaperConverterFactory::create(), it will create
+ * a version of the converter optimized for your CPU architecture.
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedMatrixShaperConverterBase
+{
+public:
+    static constexpr int encodingLutSize = 16384;
+
+    struct KRITAPIGMENT_EXPORT Params {
+        Params();
+
+        KoID srcDepthId;
+        KoID dstDepthId;
+
+        /**
+         * Row-major matrix that converts linear source RGB
+         * into linear destination RGB
+         */
+        float matrix[9];
+
+        QVector<float> srcLinearizationLut[3];
+        QVector<float> dstEncodingLut[3];
+
+        bool isIdentityMatrix() const;
+    };
+
+public:
+    KoOptimizedMatrixShaperConverterBase(const Params &params);
+    virtual ~KoOptimizedMatrixShaperConverterBase();
+
+    virtual void convert(const quint8 *src, quint8 *dst, int numPixels) const = 0;
+
+    const Params& params() const;
+
+protected:
+    Params m_params;
+};
+
+#endif // KOOPTIMIZEDMATRIXSHAPERCONVERTERBASE_H
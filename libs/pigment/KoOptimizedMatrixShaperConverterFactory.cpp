@@ -0,0 +1,84 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedMatrixShaperConverterFactory.h"
+
+#include <KoConfig.h>
+
+#include "KoOptimizedMatrixShaperConverterFactoryImpl.h"
+#include "KoColorModelStandardIds.h"
+#include "kis_assert.h"
+
+namespace {
+
+bool isSupportedDepth(const KoID &depthId)
+{
+    return depthId == Integer8BitsColorDepthID ||
+        depthId == Integer16BitsColorDepthID ||
+#ifdef HAVE_OPENEXR
+        depthId == Float16BitsColorDepthID ||
+#endif
+        depthId == Float32BitsColorDepthID;
+}
+
+int linearizationLutSize(const KoID &depthId)
+{
+    return depthId == Integer8BitsColorDepthID ? 256 :
+        depthId == Integer16BitsColorDepthID ? 65536 : 0;
+}
+
+bool isIntegerDepth(const KoID &depthId)
+{
+    return depthId == Integer8BitsColorDepthID ||
+        depthId == Integer16BitsColorDepthID;
+}
+
+bool paramsAreValid(const KoOptimizedMatrixShaperConverterBase::Params &params)
+{
+    if (!KoOptimizedMatrixShaperConverterFactory::isSupported(params.srcDepthId, params.dstDepthId)) {
+        return false;
+    }
+
+    for (int ch = 0; ch < 3; ch++) {
+        const QVector<float> &srcLut = params.srcLinearizationLut[ch];
+        const QVector<float> &dstLut = params.dstEncodingLut[ch];
+
+        KIS_SAFE_ASSERT_RECOVER(srcLut.isEmpty() || srcLut.size() == linearizationLutSize(params.srcDepthId)) {
+            return false;
+        }
+
+        KIS_SAFE_ASSERT_RECOVER(dstLut.isEmpty() ||
+                                (isIntegerDepth(params.dstDepthId) &&
+                                 dstLut.size() == KoOptimizedMatrixShaperConverterBase::encodingLutSize + 1)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
+
+bool KoOptimizedMatrixShaperConverterFactory::isSupported(const KoID &srcDepthId, const KoID &dstDepthId)
+{
+    return isSupportedDepth(srcDepthId) && isSupportedDepth(dstDepthId);
+}
+
+KoOptimizedMatrixShaperConverterBase *KoOptimizedMatrixShaperConverterFactory::create(const KoOptimizedMatrixShaperConverterBase::Params &params)
+{
+    if (!paramsAreValid(params)) return nullptr;
+
+    return createOptimizedClass<
+            KoOptimizedMatrixShaperConverterFactoryImpl>(params);
+}
+
+KoOptimizedMatrixShaperConverterBase *KoOptimizedMatrixShaperConverterFactory::createScalar(const KoOptimizedMatrixShaperConverterBase::Params &params)
+{
+    if (!paramsAreValid(params)) return nullptr;
+
+    return createOptimizedClass<
+            KoOptimizedMatrixShaperConverterFactoryImpl>(params, true);
+}
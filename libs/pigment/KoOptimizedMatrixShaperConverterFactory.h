@@ -0,0 +1,38 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOOPTIMIZEDMATRIXSHAPERCONVERTERFACTORY_H
+#define KOOPTIMIZEDMATRIXSHAPERCONVERTERFACTORY_H
+
+#include "KoOptimizedMatrixShaperConverterBase.h"
+
+/**
+ * \see KoOptimizedMatrixShaperConverterBase
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedMatrixShaperConverterFactory
+{
+public:
+    /**
+     * @return true if the converter can be created for the RGBA
+     * color spaces of depths \p srcDepthId and \p dstDepthId
+     */
+    static bool isSupported(const KoID &srcDepthId, const KoID &dstDepthId);
+
+    /**
+     * Creates a converter optimized for the current CPU. Returns
+     * nullptr if the pair of depths is not supported or the lookup
+     * tables in \p params do not fit the depths.
+     */
+    static KoOptimizedMatrixShaperConverterBase* create(const KoOptimizedMatrixShaperConverterBase::Params &params);
+
+    /**
+     * Creates a non-vectorized version of the converter, used
+     * for testing
+     */
+    static KoOptimizedMatrixShaperConverterBase* createScalar(const KoOptimizedMatrixShaperConverterBase::Params &params);
+};
+
+#endif // KOOPTIMIZEDMATRIXSHAPERCONVERTERFACTORY_H
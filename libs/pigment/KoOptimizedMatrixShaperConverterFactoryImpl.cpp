@@ -0,0 +1,60 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedMatrixShaperConverterFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include <KoConfig.h>
+
+#include "KoOptimizedMatrixShaperConverter.h"
+#include "KoColorModelStandardIds.h"
+#include "KoBgrColorSpaceTraits.h"
+#include "KoRgbColorSpaceTraits.h"
+
+namespace {
+
+template<typename _impl, class SrcTraits>
+KoOptimizedMatrixShaperConverterBase* createForSource(const KoOptimizedMatrixShaperConverterBase::Params &params)
+{
+    if (params.dstDepthId == Integer8BitsColorDepthID) {
+        return new KoOptimizedMatrixShaperConverter<SrcTraits, KoBgrU8Traits, _impl>(params);
+    } else if (params.dstDepthId == Integer16BitsColorDepthID) {
+        return new KoOptimizedMatrixShaperConverter<SrcTraits, KoBgrU16Traits, _impl>(params);
+#ifdef HAVE_OPENEXR
+    } else if (params.dstDepthId == Float16BitsColorDepthID) {
+        return new KoOptimizedMatrixShaperConverter<SrcTraits, KoRgbF16Traits, _impl>(params);
+#endif
+    } else if (params.dstDepthId == Float32BitsColorDepthID) {
+        return new KoOptimizedMatrixShaperConverter<SrcTraits, KoRgbF32Traits, _impl>(params);
+    }
+
+    return nullptr;
+}
+
+}
+
+template<typename _impl>
+KoOptimizedMatrixShaperConverterBase *KoOptimizedMatrixShaperConverterFactoryImpl::create(ParamType params)
+{
+    if (params.srcDepthId == Integer8BitsColorDepthID) {
+        return createForSource<_impl, KoBgrU8Traits>(params);
+    } else if (params.srcDepthId == Integer16BitsColorDepthID) {
+        return createForSource<_impl, KoBgrU16Traits>(params);
+#ifdef HAVE_OPENEXR
+    } else if (params.srcDepthId == Float16BitsColorDepthID) {
+        return createForSource<_impl, KoRgbF16Traits>(params);
+#endif
+    } else if (params.srcDepthId == Float32BitsColorDepthID) {
+        return createForSource<_impl, KoRgbF32Traits>(params);
+    }
+
+    return nullptr;
+}
+
+template KoOptimizedMatrixShaperConverterBase *
+KoOptimizedMatrixShaperConverterFactoryImpl::create<xsimd::current_arch>(ParamType);
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOOPTIMIZEDMATRIXSHAPERCONVERTERFACTORYIMPL_H
+#define KOOPTIMIZEDMATRIXSHAPERCONVERTERFACTORYIMPL_H
+
+#include <KoOptimizedMatrixShaperConverterBase.h>
+#include <KoMultiArchBuildSupport.h>
+
+class KRITAPIGMENT_EXPORT KoOptimizedMatrixShaperConverterFactoryImpl
+{
+public:
+    using ParamType = const KoOptimizedMatrixShaperConverterBase::Params &;
+    using ReturnType = KoOptimizedMatrixShaperConverterBase *;
+
+    template<typename _impl>
+    static KoOptimizedMatrixShaperConverterBase* create(ParamType params);
+};
+
+#endif // KOOPTIMIZEDMATRIXSHAPERCONVERTERFACTORYIMPL_H
@@ -9,6 +9,14 @@
 #include <simpletest.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorSpace.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorConversionTransformation.h>
+#include <KoConfig.h>
+#include <KoColorConversionCache.h>
+
+#include <QRandomGenerator>
+#include <QScopedPointer>
+#include <QThread>
 
 #define NB_PIXELS 1000000
 
@@ -134,4 +142,256 @@ void KoColorSpacesBenchmark::benchmarkSetAlpha2IndividualCall()
     END_BENCHMARK
 }
 
+void KoColorSpacesBenchmark::benchmarkConversion_data()
+{
+    QTest::addColumn<QString>("srcDepthID");
+    QTest::addColumn<QString>("srcProfile");
+    QTest::addColumn<QString>("dstDepthID");
+    QTest::addColumn<QString>("dstProfile");
+
+    const QString sRGB = "sRGB-elle-V2-srgbtrc.icc";
+    const QString linear = "sRGB-elle-V2-g10.icc";
+    const QString rec2020Linear = "Rec2020-elle-V4-g10.icc";
+    const QString gamma22 = "ClayRGB-elle-V2-g22.icc";
+
+    QTest::newRow("srgb-u8 -> linear-u16") << Integer8BitsColorDepthID.id() << sRGB << Integer16BitsColorDepthID.id() << linear;
+    QTest::newRow("linear-u16 -> srgb-u8") << Integer16BitsColorDepthID.id() << linear << Integer8BitsColorDepthID.id() << sRGB;
+    QTest::newRow("linear-u16 -> linear-f32") << Integer16BitsColorDepthID.id() << linear << Float32BitsColorDepthID.id() << linear;
+    QTest::newRow("linear-f32 -> linear-u16") << Float32BitsColorDepthID.id() << linear << Integer16BitsColorDepthID.id() << linear;
+    QTest::newRow("srgb-u16 -> srgb-f32") << Integer16BitsColorDepthID.id() << sRGB << Float32BitsColorDepthID.id() << sRGB;
+    QTest::newRow("srgb-u8 -> rec2020-f32") << Integer8BitsColorDepthID.id() << sRGB << Float32BitsColorDepthID.id() << rec2020Linear;
+#ifdef HAVE_OPENEXR
+    QTest::newRow("linear-f16 -> linear-f32") << Float16BitsColorDepthID.id() << linear << Float32BitsColorDepthID.id() << linear;
+    QTest::newRow("linear-f32 -> linear-f16") << Float32BitsColorDepthID.id() << linear << Float16BitsColorDepthID.id() << linear;
+#endif
+
+    // pure gamma curves are converted by LCMS, use them as a baseline
+    QTest::newRow("srgb-u8 -> g22-u16 (lcms)") << Integer8BitsColorDepthID.id() << sRGB << Integer16BitsColorDepthID.id() << gamma22;
+    QTest::newRow("g22-u16 -> linear-f32 (lcms)") << Integer16BitsColorDepthID.id() << gamma22 << Float32BitsColorDepthID.id() << linear;
+}
+
+void KoColorSpacesBenchmark::benchmarkConversion()
+{
+    QFETCH(QString, srcDepthID);
+    QFETCH(QString, srcProfile);
+    QFETCH(QString, dstDepthID);
+    QFETCH(QString, dstProfile);
+
+    const KoColorSpace *srcColorSpace = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), srcDepthID, srcProfile);
+    const KoColorSpace *dstColorSpace = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), dstDepthID, dstProfile);
+
+    if (!srcColorSpace || !dstColorSpace) {
+        QSKIP("The profiles are not available");
+    }
+
+    QScopedPointer<KoColorConversionTransformation> transformation(
+        srcColorSpace->createColorConverter(dstColorSpace,
+                                            KoColorConversionTransformation::internalRenderingIntent(),
+                                            KoColorConversionTransformation::internalConversionFlags()));
+
+    quint8 *src = new quint8[NB_PIXELS * srcColorSpace->pixelSize()];
+    quint8 *dst = new quint8[NB_PIXELS * dstColorSpace->pixelSize()];
+
+    QRandomGenerator random(1);
+    QVector<float> channels(4);
+
+    for (int i = 0; i < NB_PIXELS; i++) {
+        for (int ch = 0; ch < 4; ch++) {
+            channels[ch] = float(random.generateDouble());
+        }
+        srcColorSpace->fromNormalisedChannelsValue(src + i * srcColorSpace->pixelSize(), channels);
+    }
+
+    QBENCHMARK {
+        transformation->transform(src, dst, NB_PIXELS);
+    }
+
+    delete[] src;
+    delete[] dst;
+}
+
+/**
+ * Converts \p numTiles tiles with KoColorSpace::convertPixelsTo(),
+ * i.e. via the color conversion cache, like the parallel filter
+ * and export jobs do
+ */
+class TileConversionThread : public QThread
+{
+public:
+    TileConversionThread(const KoColorSpace *srcColorSpace, const KoColorSpace *dstColorSpace,
+                         const quint8 *srcTile, int numPixels, int numTiles)
+        : m_srcColorSpace(srcColorSpace)
+        , m_dstColorSpace(dstColorSpace)
+        , m_srcTile(srcTile)
+        , m_numPixels(numPixels)
+        , m_numTiles(numTiles)
+    {
+    }
+
+protected:
+    void run() override {
+        QVector<quint8> dstTile(m_numPixels * m_dstColorSpace->pixelSize());
+
+        for (int i = 0; i < m_numTiles; i++) {
+            m_srcColorSpace->convertPixelsTo(m_srcTile, dstTile.data(), m_dstColorSpace, m_numPixels,
+                                             KoColorConversionTransformation::internalRenderingIntent(),
+                                             KoColorConversionTransformation::internalConversionFlags());
+        }
+    }
+
+private:
+    const KoColorSpace *m_srcColorSpace;
+    const KoColorSpace *m_dstColorSpace;
+    const quint8 *m_srcTile;
+    int m_numPixels;
+    int m_numTiles;
+};
+
+void KoColorSpacesBenchmark::benchmarkMultithreadedConversion_data()
+{
+    QTest::addColumn<QString>("srcModelID");
+    QTest::addColumn<QString>("srcDepthID");
+    QTest::addColumn<QString>("srcProfile");
+    QTest::addColumn<QString>("dstModelID");
+    QTest::addColumn<QString>("dstDepthID");
+    QTest::addColumn<QString>("dstProfile");
+
+    const QString sRGB = "sRGB-elle-V2-srgbtrc.icc";
+    const QString linear = "sRGB-elle-V2-g10.icc";
+    const QString gamma22 = "ClayRGB-elle-V2-g22.icc";
+
+    QTest::newRow("srgb-u8 -> linear-u16")
+        << RGBAColorModelID.id() << Integer8BitsColorDepthID.id() << sRGB
+        << RGBAColorModelID.id() << Integer16BitsColorDepthID.id() << linear;
+    QTest::newRow("g22-u16 -> srgb-u8")
+        << RGBAColorModelID.id() << Integer16BitsColorDepthID.id() << gamma22
+        << RGBAColorModelID.id() << Integer8BitsColorDepthID.id() << sRGB;
+    QTest::newRow("srgb-u8 -> lab-u16")
+        << RGBAColorModelID.id() << Integer8BitsColorDepthID.id() << sRGB
+        << LABAColorModelID.id() << Integer16BitsColorDepthID.id() << QString();
+}
+
+void KoColorSpacesBenchmark::benchmarkMultithreadedConversion()
+{
+    QFETCH(QString, srcModelID);
+    QFETCH(QString, srcDepthID);
+    QFETCH(QString, srcProfile);
+    QFETCH(QString, dstModelID);
+    QFETCH(QString, dstDepthID);
+    QFETCH(QString, dstProfile);
+
+    const int numThreads = 32;
+    const int numTilesPerThread = 256;
+    const int tileSize = 64;
+    const int numPixels = tileSize * tileSize;
+
+    const KoColorSpace *srcColorSpace = KoColorSpaceRegistry::instance()->colorSpace(srcModelID, srcDepthID, srcProfile);
+    const KoColorSpace *dstColorSpace = KoColorSpaceRegistry::instance()->colorSpace(dstModelID, dstDepthID, dstProfile);
+
+    if (!srcColorSpace || !dstColorSpace) {
+        QSKIP("The profiles are not available");
+    }
+
+    QVector<quint8> srcTile(numPixels * srcColorSpace->pixelSize());
+
+    QRandomGenerator random(1);
+    QVector<float> channels(srcColorSpace->channelCount());
+
+    for (int i = 0; i < numPixels; i++) {
+        for (int ch = 0; ch < channels.size(); ch++) {
+            channels[ch] = float(random.generateDouble());
+        }
+        srcColorSpace->fromNormalisedChannelsValue(srcTile.data() + i * srcColorSpace->pixelSize(), channels);
+    }
+
+    KoColorConversionCache *cache = KoColorSpaceRegistry::instance()->colorConversionCache();
+    cache->resetStatistics();
+
+    QBENCHMARK {
+        QVector<TileConversionThread*> threads;
+
+        for (int i = 0; i < numThreads; i++) {
+            threads << new TileConversionThread(srcColorSpace, dstColorSpace,
+                                                srcTile.constData(), numPixels, numTilesPerThread);
+        }
+
+        Q_FOREACH (TileConversionThread *thread, threads) {
+            thread->start();
+        }
+
+        Q_FOREACH (TileConversionThread *thread, threads) {
+            thread->wait();
+        }
+
+        qDeleteAll(threads);
+    }
+
+    const KoColorConversionCache::Statistics stats = cache->statistics();
+    qDebug() << "Conversion cache:"
+             << "pools" << stats.numPools
+             << "transformations" << stats.numTransformations
+             << "shared lookups" << stats.numSharedLookups
+             << "contended checkouts" << stats.numContendedCheckouts;
+}
+
+void KoColorSpacesBenchmark::benchmarkDither_data()
+{
+    QTest::addColumn<QString>("modelID");
+    QTest::addColumn<QString>("srcDepthID");
+    QTest::addColumn<QString>("dstDepthID");
+    QTest::addColumn<int>("ditherType");
+
+    QTest::newRow("rgba-f32 -> u8 (bayer)") << RGBAColorModelID.id() << Float32BitsColorDepthID.id() << Integer8BitsColorDepthID.id() << int(DITHER_BAYER);
+    QTest::newRow("rgba-f32 -> u8 (blue noise)") << RGBAColorModelID.id() << Float32BitsColorDepthID.id() << Integer8BitsColorDepthID.id() << int(DITHER_BLUE_NOISE);
+    QTest::newRow("rgba-u16 -> u8 (bayer)") << RGBAColorModelID.id() << Integer16BitsColorDepthID.id() << Integer8BitsColorDepthID.id() << int(DITHER_BAYER);
+    QTest::newRow("rgba-u16 -> u8 (blue noise)") << RGBAColorModelID.id() << Integer16BitsColorDepthID.id() << Integer8BitsColorDepthID.id() << int(DITHER_BLUE_NOISE);
+    QTest::newRow("rgba-f32 -> u16 (bayer)") << RGBAColorModelID.id() << Float32BitsColorDepthID.id() << Integer16BitsColorDepthID.id() << int(DITHER_BAYER);
+    QTest::newRow("graya-f32 -> u8 (bayer)") << GrayAColorModelID.id() << Float32BitsColorDepthID.id() << Integer8BitsColorDepthID.id() << int(DITHER_BAYER);
+    QTest::newRow("graya-u16 -> u8 (bayer)") << GrayAColorModelID.id() << Integer16BitsColorDepthID.id() << Integer8BitsColorDepthID.id() << int(DITHER_BAYER);
+    QTest::newRow("cmyka-f32 -> u8 (bayer)") << CMYKAColorModelID.id() << Float32BitsColorDepthID.id() << Integer8BitsColorDepthID.id() << int(DITHER_BAYER);
+    QTest::newRow("cmyka-u16 -> u8 (blue noise)") << CMYKAColorModelID.id() << Integer16BitsColorDepthID.id() << Integer8BitsColorDepthID.id() << int(DITHER_BLUE_NOISE);
+}
+
+void KoColorSpacesBenchmark::benchmarkDither()
+{
+    QFETCH(QString, modelID);
+    QFETCH(QString, srcDepthID);
+    QFETCH(QString, dstDepthID);
+    QFETCH(int, ditherType);
+
+    // a strip of an 8k image
+    const int columns = 8192;
+    const int rows = NB_PIXELS / columns;
+
+    const KoColorSpace *srcColorSpace = KoColorSpaceRegistry::instance()->colorSpace(modelID, srcDepthID, 0);
+    const KoColorSpace *dstColorSpace = KoColorSpaceRegistry::instance()->colorSpace(modelID, dstDepthID, 0);
+
+    if (!srcColorSpace || !dstColorSpace) {
+        QSKIP("The color spaces are not available");
+    }
+
+    const KisDitherOp *op = srcColorSpace->ditherOp(dstDepthID, DitherType(ditherType));
+    QVERIFY(op);
+
+    const int srcRowStride = columns * srcColorSpace->pixelSize();
+    const int dstRowStride = columns * dstColorSpace->pixelSize();
+
+    QVector<quint8> src(rows * srcRowStride);
+    QVector<quint8> dst(rows * dstRowStride);
+
+    QRandomGenerator random(1);
+    QVector<float> channels(srcColorSpace->channelCount());
+
+    for (int i = 0; i < rows * columns; i++) {
+        for (int ch = 0; ch < channels.size(); ch++) {
+            channels[ch] = float(random.generateDouble());
+        }
+        srcColorSpace->fromNormalisedChannelsValue(src.data() + i * srcColorSpace->pixelSize(), channels);
+    }
+
+    QBENCHMARK {
+        op->dither(src.constData(), srcRowStride, dst.data(), dstRowStride, 0, 0, columns, rows);
+    }
+}
+
 SIMPLE_TEST_MAIN(KoColorSpacesBenchmark)
@@ -27,6 +27,12 @@ private Q_SLOTS:
     void benchmarkSetAlphaIndividualCall();
     void benchmarkSetAlpha2IndividualCall_data();
     void benchmarkSetAlpha2IndividualCall();
+    void benchmarkConversion_data();
+    void benchmarkConversion();
+    void benchmarkMultithreadedConversion_data();
+    void benchmarkMultithreadedConversion();
+    void benchmarkDither_data();
+    void benchmarkDither();
 };
 
 #endif
@@ -12,6 +12,7 @@
 
 #include <KoColorSpaceTraits.h>
 #include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
 
 #include <simpletest.h>
 
@@ -96,5 +97,67 @@ void KoCompositeOpsBenchmark::benchmarkCompositeAlphaDarkenCreamy()
     }
 }
 
+void KoCompositeOpsBenchmark::benchmarkCompositeAllModes_data()
+{
+    QTest::addColumn<QString>("depthId");
+    QTest::addColumn<QString>("compositeOpId");
+
+    const QStringList depthIds = {
+        Integer8BitsColorDepthID.id(),
+        Integer16BitsColorDepthID.id(),
+        Float16BitsColorDepthID.id(),
+        Float32BitsColorDepthID.id()
+    };
+
+    Q_FOREACH (const QString &depthId, depthIds) {
+        const KoColorSpace *cs =
+            KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), depthId, 0);
+        if (!cs) continue;
+
+        Q_FOREACH (const KoCompositeOp *op, cs->compositeOps()) {
+            QTest::newRow(QString("%1 %2").arg(depthId, op->id()).toLatin1().data())
+                << depthId << op->id();
+        }
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeAllModes()
+{
+    QFETCH(QString, depthId);
+    QFETCH(QString, compositeOpId);
+
+    const KoColorSpace *rgb8 = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), depthId, 0);
+    const KoCompositeOp *compositeOp = cs->compositeOp(compositeOpId);
+
+    const int numPixels = IMG_WIDTH * IMG_HEIGHT;
+    const int pixelSize = cs->pixelSize();
+    const int rowStride = IMG_WIDTH * pixelSize;
+
+    // convert the random 8-bit data to get valid pixels in every depth
+    QVector<quint8> dstBuffer(numPixels * pixelSize);
+    QVector<quint8> srcBuffer(numPixels * pixelSize);
+    rgb8->convertPixelsTo(m_dstBuffer, dstBuffer.data(), cs, numPixels,
+                          KoColorConversionTransformation::internalRenderingIntent(),
+                          KoColorConversionTransformation::internalConversionFlags());
+    rgb8->convertPixelsTo(m_srcBuffer, srcBuffer.data(), cs, numPixels,
+                          KoColorConversionTransformation::internalRenderingIntent(),
+                          KoColorConversionTransformation::internalConversionFlags());
+
+    QBENCHMARK{
+        for (int y = 0; y < TILES_IN_HEIGHT; y++){
+            for (int x = 0; x < TILES_IN_WIDTH; x++) {
+                const int bufOffset = y * TILE_HEIGHT * rowStride + x * TILE_WIDTH * pixelSize;
+                const int maskOffset = y * TILE_HEIGHT * IMG_WIDTH + x * TILE_WIDTH;
+                compositeOp->composite(dstBuffer.data() + bufOffset, rowStride,
+                                       srcBuffer.data() + bufOffset, rowStride,
+                                       m_mskBuffer + maskOffset, IMG_WIDTH,
+                                       TILE_WIDTH, TILE_HEIGHT,
+                                       OPACITY_HALF);
+            }
+        }
+    }
+}
 
 QTEST_GUILESS_MAIN(KoCompositeOpsBenchmark)
@@ -0,0 +1,172 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoMixColorsOpBenchmark.h"
+
+#include <simpletest.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoColorSpace.h>
+#include <KoColorModelStandardIds.h>
+#include <KoMixColorsOp.h>
+#include <kis_algebra_2d.h>
+
+#include <QRandomGenerator>
+#include <QScopedPointer>
+
+/**
+ * The sizes of the dabs used by color smudge brush. The sampler
+ * reads the whole dab rect and samples its pixels in Halton sequence
+ * until the mixed color converges.
+ */
+static const int dabSizes[] = {9, 25, 64, 150, 300};
+
+/**
+ * The sampler checks the convergence of the color every
+ * batch of samples
+ */
+static const int samplingBatchSize = 16;
+
+void KoMixColorsOpBenchmark::createRowsColumns()
+{
+    QTest::addColumn<QString>("depthID");
+    QTest::addColumn<int>("dabSize");
+
+    const QList<KoID> depthIds = {Integer8BitsColorDepthID, Integer16BitsColorDepthID, Float32BitsColorDepthID};
+
+    Q_FOREACH (const KoID &depthId, depthIds) {
+        for (int dabSize : dabSizes) {
+            QTest::newRow(QString("%1-%2px").arg(depthId.id()).arg(dabSize).toLatin1().data())
+                << depthId.id() << dabSize;
+        }
+    }
+}
+
+struct DabData
+{
+    DabData(const KoColorSpace *_colorSpace, int _dabSize)
+        : colorSpace(_colorSpace),
+          dabSize(_dabSize),
+          pixels(dabSize * dabSize * colorSpace->pixelSize()),
+          mask(dabSize * dabSize)
+    {
+        QRandomGenerator random(1);
+        QVector<float> channels(colorSpace->channelCount());
+
+        for (int i = 0; i < dabSize * dabSize; i++) {
+            for (int ch = 0; ch < channels.size(); ch++) {
+                channels[ch] = float(random.generateDouble());
+            }
+            colorSpace->fromNormalisedChannelsValue(pixels.data() + i * colorSpace->pixelSize(), channels);
+            mask[i] = random.bounded(256);
+        }
+    }
+
+    const KoColorSpace *colorSpace;
+    int dabSize;
+    QVector<quint8> pixels;
+    QVector<qint16> mask;
+};
+
+#define START_BENCHMARK \
+    QFETCH(QString, depthID); \
+    QFETCH(int, dabSize); \
+    \
+    const KoColorSpace *colorSpace = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), depthID, QString()); \
+    QVERIFY(colorSpace); \
+    \
+    DabData dab(colorSpace, dabSize); \
+    const int pixelSize = colorSpace->pixelSize(); \
+    QVector<quint8> mixedColor(pixelSize);
+
+/**
+ * Samples all the pixels of the dab the way
+ * KisColorSmudgeSampleUtils::sampleColor() does, i.e. passes
+ * them to the mixer one-by-one
+ */
+template <typename SampleFunc>
+void sampleDab(const DabData &dab, KoMixColorsOp::Mixer *mixer, quint8 *mixedColor, SampleFunc sampleFunc)
+{
+    KisAlgebra2D::HaltonSequenceGenerator hGen(2);
+    KisAlgebra2D::HaltonSequenceGenerator vGen(3);
+
+    const int numPixels = dab.dabSize * dab.dabSize;
+
+    for (int i = 0; i < numPixels; i++) {
+        const int x = hGen.generate(dab.dabSize - 1);
+        const int y = vGen.generate(dab.dabSize - 1);
+
+        sampleFunc(y * dab.dabSize + x);
+
+        if (i % samplingBatchSize == samplingBatchSize - 1) {
+            mixer->computeMixedColor(mixedColor);
+        }
+    }
+
+    mixer->computeMixedColor(mixedColor);
+}
+
+void KoMixColorsOpBenchmark::benchmarkSampleWeighted_data()
+{
+    createRowsColumns();
+}
+
+void KoMixColorsOpBenchmark::benchmarkSampleWeighted()
+{
+    START_BENCHMARK
+
+    QBENCHMARK {
+        QScopedPointer<KoMixColorsOp::Mixer> mixer(colorSpace->mixColorsOp()->createMixer());
+
+        sampleDab(dab, mixer.data(), mixedColor.data(), [&] (int index) {
+            const qint16 opacity = dab.mask[index];
+            mixer->accumulate(dab.pixels.constData() + index * pixelSize, &opacity, opacity, 1);
+        });
+    }
+}
+
+void KoMixColorsOpBenchmark::benchmarkSampleAveraged_data()
+{
+    createRowsColumns();
+}
+
+void KoMixColorsOpBenchmark::benchmarkSampleAveraged()
+{
+    START_BENCHMARK
+
+    QBENCHMARK {
+        QScopedPointer<KoMixColorsOp::Mixer> mixer(colorSpace->mixColorsOp()->createMixer());
+
+        sampleDab(dab, mixer.data(), mixedColor.data(), [&] (int index) {
+            mixer->accumulateAverage(dab.pixels.constData() + index * pixelSize, 1);
+        });
+    }
+}
+
+void KoMixColorsOpBenchmark::benchmarkAccumulateRows_data()
+{
+    createRowsColumns();
+}
+
+void KoMixColorsOpBenchmark::benchmarkAccumulateRows()
+{
+    START_BENCHMARK
+
+    const int rowStride = dabSize * pixelSize;
+
+    QBENCHMARK {
+        QScopedPointer<KoMixColorsOp::Mixer> mixer(colorSpace->mixColorsOp()->createMixer());
+
+        for (int y = 0; y < dabSize; y++) {
+            mixer->accumulate(dab.pixels.constData() + y * rowStride,
+                              dab.mask.constData() + y * dabSize,
+                              255, dabSize);
+        }
+
+        mixer->computeMixedColor(mixedColor.data());
+    }
+}
+
+SIMPLE_TEST_MAIN(KoMixColorsOpBenchmark)
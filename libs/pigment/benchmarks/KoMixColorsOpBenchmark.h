@@ -0,0 +1,26 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KO_MIX_COLORS_OP_BENCHMARK_H_
+#define KO_MIX_COLORS_OP_BENCHMARK_H_
+
+#include <QObject>
+
+class KoMixColorsOpBenchmark : public QObject
+{
+    Q_OBJECT
+private:
+    void createRowsColumns();
+private Q_SLOTS:
+    void benchmarkSampleWeighted_data();
+    void benchmarkSampleWeighted();
+    void benchmarkSampleAveraged_data();
+    void benchmarkSampleAveraged();
+    void benchmarkAccumulateRows_data();
+    void benchmarkAccumulateRows();
+};
+
+#endif
@@ -0,0 +1,197 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOGENERICCOMPOSITEOPSLIST_H
+#define KOGENERICCOMPOSITEOPSLIST_H
+
+#include <type_traits>
+
+#include <KoCompositeOp.h>
+#include <KoCompositeOpRegistry.h>
+
+#include "KoCompositeOpFunctions.h"
+
+class KoColorSpace;
+
+/**
+ * The modulo and binary blending modes depend on the precision of the
+ * channel type (they use its epsilon and its bit representation), so
+ * their float version is the same as the scalar one only for float
+ * colorspaces.
+ */
+template<class Traits>
+struct KoGenericCompositeOpsPrecision
+{
+    static const bool floatVersionIsExact =
+        std::is_same<typename Traits::channels_type, float>::value;
+};
+
+/**
+ * The list of the generic separable blending modes. It is shared by
+ * the scalar ops (KoCompositeOpGenericSC, added in KoCompositeOps.h) and
+ * the vectorized ones (added by KoOptimizedGenericCompositeOpFactoryPerArch),
+ * so both of them always register the same set of modes.
+ *
+ * \p Adder defines the type of the arguments of the blending functions
+ * (Adder::Arg) and creates the ops with its static methods:
+ *
+ *  - add<func>(cs, id, category)
+ *  - addPrecisionDependent<func>(cs, id, category), used for the modes
+ *    whose result depends on the precision of the channel type, see
+ *    KoGenericCompositeOpsPrecision
+ */
+template<class Adder>
+struct KoGenericSCCompositeOpsList
+{
+    typedef typename Adder::Arg Arg;
+
+    static void add(KoColorSpace *cs) {
+        Adder::template add<&cfOverlay<Arg>       >(cs, COMPOSITE_OVERLAY       , KoCompositeOp::categoryMix());
+        Adder::template add<&cfGrainMerge<Arg>    >(cs, COMPOSITE_GRAIN_MERGE   , KoCompositeOp::categoryMix());
+        Adder::template add<&cfGrainExtract<Arg>  >(cs, COMPOSITE_GRAIN_EXTRACT , KoCompositeOp::categoryMix());
+        Adder::template add<&cfHardMix<Arg>       >(cs, COMPOSITE_HARD_MIX      , KoCompositeOp::categoryMix());
+        Adder::template add<&cfHardMixPhotoshop<Arg>>(cs, COMPOSITE_HARD_MIX_PHOTOSHOP, KoCompositeOp::categoryMix());
+        Adder::template add<&cfHardMixSofterPhotoshop<Arg>>(cs, COMPOSITE_HARD_MIX_SOFTER_PHOTOSHOP, KoCompositeOp::categoryMix());
+        Adder::template add<&cfGeometricMean<Arg> >(cs, COMPOSITE_GEOMETRIC_MEAN, KoCompositeOp::categoryMix());
+        Adder::template add<&cfParallel<Arg>      >(cs, COMPOSITE_PARALLEL      , KoCompositeOp::categoryMix());
+        Adder::template add<&cfAllanon<Arg>       >(cs, COMPOSITE_ALLANON       , KoCompositeOp::categoryMix());
+        Adder::template add<&cfHardOverlay<Arg>   >(cs, COMPOSITE_HARD_OVERLAY  , KoCompositeOp::categoryMix());
+        Adder::template add<&cfInterpolation<Arg> >(cs, COMPOSITE_INTERPOLATION , KoCompositeOp::categoryMix());
+        Adder::template add<&cfInterpolationB<Arg>>(cs, COMPOSITE_INTERPOLATIONB, KoCompositeOp::categoryMix());
+        Adder::template add<&cfPenumbraA<Arg>     >(cs, COMPOSITE_PENUMBRAA     , KoCompositeOp::categoryMix());
+        Adder::template add<&cfPenumbraB<Arg>     >(cs, COMPOSITE_PENUMBRAB     , KoCompositeOp::categoryMix());
+        Adder::template add<&cfPenumbraC<Arg>     >(cs, COMPOSITE_PENUMBRAC     , KoCompositeOp::categoryMix());
+        Adder::template add<&cfPenumbraD<Arg>     >(cs, COMPOSITE_PENUMBRAD     , KoCompositeOp::categoryMix());
+
+        Adder::template add<&cfScreen<Arg>      >(cs, COMPOSITE_SCREEN      , KoCompositeOp::categoryLight());
+        Adder::template add<&cfColorDodge<Arg>  >(cs, COMPOSITE_DODGE       , KoCompositeOp::categoryLight());
+        Adder::template add<&cfAddition<Arg>    >(cs, COMPOSITE_LINEAR_DODGE, KoCompositeOp::categoryLight());
+        Adder::template add<&cfLightenOnly<Arg> >(cs, COMPOSITE_LIGHTEN     , KoCompositeOp::categoryLight());
+        Adder::template add<&cfHardLight<Arg>   >(cs, COMPOSITE_HARD_LIGHT  , KoCompositeOp::categoryLight());
+        Adder::template add<&cfSoftLightIFSIllusions<Arg>>(cs, COMPOSITE_SOFT_LIGHT_IFS_ILLUSIONS, KoCompositeOp::categoryLight());
+        Adder::template add<&cfSoftLightPegtopDelphi<Arg>>(cs, COMPOSITE_SOFT_LIGHT_PEGTOP_DELPHI, KoCompositeOp::categoryLight());
+        Adder::template add<&cfSoftLightSvg<Arg>>(cs, COMPOSITE_SOFT_LIGHT_SVG, KoCompositeOp::categoryLight());
+        Adder::template add<&cfSoftLight<Arg>   >(cs, COMPOSITE_SOFT_LIGHT_PHOTOSHOP, KoCompositeOp::categoryLight());
+        Adder::template add<&cfGammaLight<Arg>  >(cs, COMPOSITE_GAMMA_LIGHT , KoCompositeOp::categoryLight());
+        Adder::template add<&cfGammaIllumination<Arg>>(cs, COMPOSITE_GAMMA_ILLUMINATION, KoCompositeOp::categoryLight());
+        Adder::template add<&cfVividLight<Arg>  >(cs, COMPOSITE_VIVID_LIGHT , KoCompositeOp::categoryLight());
+        Adder::template add<&cfFlatLight<Arg>   >(cs, COMPOSITE_FLAT_LIGHT  , KoCompositeOp::categoryLight());
+        Adder::template add<&cfPinLight<Arg>    >(cs, COMPOSITE_PIN_LIGHT   , KoCompositeOp::categoryLight());
+        Adder::template add<&cfLinearLight<Arg> >(cs, COMPOSITE_LINEAR_LIGHT, KoCompositeOp::categoryLight());
+        Adder::template add<&cfPNormA<Arg>      >(cs, COMPOSITE_PNORM_A     , KoCompositeOp::categoryLight());
+        Adder::template add<&cfPNormB<Arg>      >(cs, COMPOSITE_PNORM_B     , KoCompositeOp::categoryLight());
+        Adder::template add<&cfSuperLight<Arg>  >(cs, COMPOSITE_SUPER_LIGHT , KoCompositeOp::categoryLight());
+        Adder::template add<&cfTintIFSIllusions<Arg>>(cs, COMPOSITE_TINT_IFS_ILLUSIONS, KoCompositeOp::categoryLight());
+        Adder::template add<&cfFogLightenIFSIllusions<Arg>>(cs, COMPOSITE_FOG_LIGHTEN_IFS_ILLUSIONS, KoCompositeOp::categoryLight());
+        Adder::template add<&cfEasyDodge<Arg>   >(cs, COMPOSITE_EASY_DODGE  , KoCompositeOp::categoryLight());
+
+        Adder::template add<&cfColorBurn<Arg>  >(cs, COMPOSITE_BURN        , KoCompositeOp::categoryDark());
+        Adder::template add<&cfLinearBurn<Arg> >(cs, COMPOSITE_LINEAR_BURN , KoCompositeOp::categoryDark());
+        Adder::template add<&cfDarkenOnly<Arg> >(cs, COMPOSITE_DARKEN      , KoCompositeOp::categoryDark());
+        Adder::template add<&cfGammaDark<Arg>  >(cs, COMPOSITE_GAMMA_DARK  , KoCompositeOp::categoryDark());
+        Adder::template add<&cfShadeIFSIllusions<Arg>>(cs, COMPOSITE_SHADE_IFS_ILLUSIONS, KoCompositeOp::categoryDark());
+        Adder::template add<&cfFogDarkenIFSIllusions<Arg>>(cs, COMPOSITE_FOG_DARKEN_IFS_ILLUSIONS, KoCompositeOp::categoryDark());
+        Adder::template add<&cfEasyBurn<Arg>   >(cs, COMPOSITE_EASY_BURN   , KoCompositeOp::categoryDark());
+
+        Adder::template add<&cfAddition<Arg>        >(cs, COMPOSITE_ADD             , KoCompositeOp::categoryArithmetic());
+        Adder::template add<&cfSubtract<Arg>        >(cs, COMPOSITE_SUBTRACT        , KoCompositeOp::categoryArithmetic());
+        Adder::template add<&cfInverseSubtract<Arg> >(cs, COMPOSITE_INVERSE_SUBTRACT, KoCompositeOp::categoryArithmetic());
+        Adder::template add<&cfMultiply<Arg>        >(cs, COMPOSITE_MULT            , KoCompositeOp::categoryArithmetic());
+        Adder::template add<&cfDivide<Arg>          >(cs, COMPOSITE_DIVIDE          , KoCompositeOp::categoryArithmetic());
+
+        Adder::template addPrecisionDependent<&cfModulo<Arg>               >(cs, COMPOSITE_MOD                , KoCompositeOp::categoryModulo());
+        Adder::template addPrecisionDependent<&cfModuloContinuous<Arg>     >(cs, COMPOSITE_MOD_CON            , KoCompositeOp::categoryModulo());
+        Adder::template addPrecisionDependent<&cfDivisiveModulo<Arg>       >(cs, COMPOSITE_DIVISIVE_MOD       , KoCompositeOp::categoryModulo());
+        Adder::template addPrecisionDependent<&cfDivisiveModuloContinuous<Arg>>(cs, COMPOSITE_DIVISIVE_MOD_CON, KoCompositeOp::categoryModulo());
+        Adder::template addPrecisionDependent<&cfModuloShift<Arg>          >(cs, COMPOSITE_MODULO_SHIFT       , KoCompositeOp::categoryModulo());
+        Adder::template addPrecisionDependent<&cfModuloShiftContinuous<Arg>>(cs, COMPOSITE_MODULO_SHIFT_CON   , KoCompositeOp::categoryModulo());
+
+        Adder::template add<&cfArcTangent<Arg>         >(cs, COMPOSITE_ARC_TANGENT         , KoCompositeOp::categoryNegative());
+        Adder::template add<&cfDifference<Arg>         >(cs, COMPOSITE_DIFF                , KoCompositeOp::categoryNegative());
+        Adder::template add<&cfExclusion<Arg>          >(cs, COMPOSITE_EXCLUSION           , KoCompositeOp::categoryNegative());
+        Adder::template add<&cfEquivalence<Arg>        >(cs, COMPOSITE_EQUIVALENCE         , KoCompositeOp::categoryNegative());
+        Adder::template add<&cfAdditiveSubtractive<Arg>>(cs, COMPOSITE_ADDITIVE_SUBTRACTIVE, KoCompositeOp::categoryNegative());
+        Adder::template add<&cfNegation<Arg>           >(cs, COMPOSITE_NEGATION            , KoCompositeOp::categoryNegative());
+
+        Adder::template addPrecisionDependent<&cfXor<Arg>        >(cs, COMPOSITE_XOR            , KoCompositeOp::categoryBinary());
+        Adder::template addPrecisionDependent<&cfOr<Arg>         >(cs, COMPOSITE_OR             , KoCompositeOp::categoryBinary());
+        Adder::template addPrecisionDependent<&cfAnd<Arg>        >(cs, COMPOSITE_AND            , KoCompositeOp::categoryBinary());
+        Adder::template addPrecisionDependent<&cfNand<Arg>       >(cs, COMPOSITE_NAND           , KoCompositeOp::categoryBinary());
+        Adder::template addPrecisionDependent<&cfNor<Arg>        >(cs, COMPOSITE_NOR            , KoCompositeOp::categoryBinary());
+        Adder::template addPrecisionDependent<&cfXnor<Arg>       >(cs, COMPOSITE_XNOR           , KoCompositeOp::categoryBinary());
+        Adder::template addPrecisionDependent<&cfImplies<Arg>    >(cs, COMPOSITE_IMPLICATION    , KoCompositeOp::categoryBinary());
+        Adder::template addPrecisionDependent<&cfNotImplies<Arg> >(cs, COMPOSITE_NOT_IMPLICATION, KoCompositeOp::categoryBinary());
+        Adder::template addPrecisionDependent<&cfConverse<Arg>   >(cs, COMPOSITE_CONVERSE       , KoCompositeOp::categoryBinary());
+        Adder::template addPrecisionDependent<&cfNotConverse<Arg>>(cs, COMPOSITE_NOT_CONVERSE   , KoCompositeOp::categoryBinary());
+
+        Adder::template add<&cfReflect<Arg>>(cs, COMPOSITE_REFLECT, KoCompositeOp::categoryQuadratic());
+        Adder::template add<&cfGlow<Arg>   >(cs, COMPOSITE_GLOW   , KoCompositeOp::categoryQuadratic());
+        Adder::template add<&cfFreeze<Arg> >(cs, COMPOSITE_FREEZE , KoCompositeOp::categoryQuadratic());
+        Adder::template add<&cfHeat<Arg>   >(cs, COMPOSITE_HEAT   , KoCompositeOp::categoryQuadratic());
+        Adder::template add<&cfGleat<Arg>  >(cs, COMPOSITE_GLEAT  , KoCompositeOp::categoryQuadratic());
+        Adder::template add<&cfHelow<Arg>  >(cs, COMPOSITE_HELOW  , KoCompositeOp::categoryQuadratic());
+        Adder::template add<&cfReeze<Arg>  >(cs, COMPOSITE_REEZE  , KoCompositeOp::categoryQuadratic());
+        Adder::template add<&cfFrect<Arg>  >(cs, COMPOSITE_FRECT  , KoCompositeOp::categoryQuadratic());
+        Adder::template add<&cfFhyrd<Arg>  >(cs, COMPOSITE_FHYRD  , KoCompositeOp::categoryQuadratic());
+    }
+};
+
+/**
+ * The list of the generic HSL blending modes of the RGB colorspaces,
+ * shared the same way as KoGenericSCCompositeOpsList. The functions
+ * always take float arguments, \p Adder creates the ops with its
+ * addHSL<func>(cs, id, category) method.
+ */
+template<class Adder>
+struct KoGenericHSLCompositeOpsList
+{
+    typedef float Arg;
+
+    static void add(KoColorSpace *cs) {
+        Adder::template addHSL<&cfTangentNormalmap  <HSYType,Arg> >(cs, COMPOSITE_TANGENT_NORMALMAP  , KoCompositeOp::categoryMisc());
+        Adder::template addHSL<&cfReorientedNormalMapCombine <HSYType, Arg> >(cs, COMPOSITE_COMBINE_NORMAL, KoCompositeOp::categoryMisc());
+
+        Adder::template addHSL<&cfColor             <HSYType,Arg> >(cs, COMPOSITE_COLOR         , KoCompositeOp::categoryHSY());
+        Adder::template addHSL<&cfHue               <HSYType,Arg> >(cs, COMPOSITE_HUE           , KoCompositeOp::categoryHSY());
+        Adder::template addHSL<&cfSaturation        <HSYType,Arg> >(cs, COMPOSITE_SATURATION    , KoCompositeOp::categoryHSY());
+        Adder::template addHSL<&cfIncreaseSaturation<HSYType,Arg> >(cs, COMPOSITE_INC_SATURATION, KoCompositeOp::categoryHSY());
+        Adder::template addHSL<&cfDecreaseSaturation<HSYType,Arg> >(cs, COMPOSITE_DEC_SATURATION, KoCompositeOp::categoryHSY());
+        Adder::template addHSL<&cfLightness         <HSYType,Arg> >(cs, COMPOSITE_LUMINIZE      , KoCompositeOp::categoryHSY());
+        Adder::template addHSL<&cfIncreaseLightness <HSYType,Arg> >(cs, COMPOSITE_INC_LUMINOSITY, KoCompositeOp::categoryHSY());
+        Adder::template addHSL<&cfDecreaseLightness <HSYType,Arg> >(cs, COMPOSITE_DEC_LUMINOSITY, KoCompositeOp::categoryHSY());
+        Adder::template addHSL<&cfDarkerColor <HSYType,Arg> >(cs, COMPOSITE_DARKER_COLOR        , KoCompositeOp::categoryDark());//darker color as PSD does it//
+        Adder::template addHSL<&cfLighterColor <HSYType,Arg> >(cs, COMPOSITE_LIGHTER_COLOR      , KoCompositeOp::categoryLight());//lighter color as PSD does it//
+
+        Adder::template addHSL<&cfColor             <HSIType,Arg> >(cs, COMPOSITE_COLOR_HSI         , KoCompositeOp::categoryHSI());
+        Adder::template addHSL<&cfHue               <HSIType,Arg> >(cs, COMPOSITE_HUE_HSI           , KoCompositeOp::categoryHSI());
+        Adder::template addHSL<&cfSaturation        <HSIType,Arg> >(cs, COMPOSITE_SATURATION_HSI    , KoCompositeOp::categoryHSI());
+        Adder::template addHSL<&cfIncreaseSaturation<HSIType,Arg> >(cs, COMPOSITE_INC_SATURATION_HSI, KoCompositeOp::categoryHSI());
+        Adder::template addHSL<&cfDecreaseSaturation<HSIType,Arg> >(cs, COMPOSITE_DEC_SATURATION_HSI, KoCompositeOp::categoryHSI());
+        Adder::template addHSL<&cfLightness         <HSIType,Arg> >(cs, COMPOSITE_INTENSITY         , KoCompositeOp::categoryHSI());
+        Adder::template addHSL<&cfIncreaseLightness <HSIType,Arg> >(cs, COMPOSITE_INC_INTENSITY     , KoCompositeOp::categoryHSI());
+        Adder::template addHSL<&cfDecreaseLightness <HSIType,Arg> >(cs, COMPOSITE_DEC_INTENSITY     , KoCompositeOp::categoryHSI());
+
+        Adder::template addHSL<&cfColor             <HSLType,Arg> >(cs, COMPOSITE_COLOR_HSL         , KoCompositeOp::categoryHSL());
+        Adder::template addHSL<&cfHue               <HSLType,Arg> >(cs, COMPOSITE_HUE_HSL           , KoCompositeOp::categoryHSL());
+        Adder::template addHSL<&cfSaturation        <HSLType,Arg> >(cs, COMPOSITE_SATURATION_HSL    , KoCompositeOp::categoryHSL());
+        Adder::template addHSL<&cfIncreaseSaturation<HSLType,Arg> >(cs, COMPOSITE_INC_SATURATION_HSL, KoCompositeOp::categoryHSL());
+        Adder::template addHSL<&cfDecreaseSaturation<HSLType,Arg> >(cs, COMPOSITE_DEC_SATURATION_HSL, KoCompositeOp::categoryHSL());
+        Adder::template addHSL<&cfLightness         <HSLType,Arg> >(cs, COMPOSITE_LIGHTNESS         , KoCompositeOp::categoryHSL());
+        Adder::template addHSL<&cfIncreaseLightness <HSLType,Arg> >(cs, COMPOSITE_INC_LIGHTNESS     , KoCompositeOp::categoryHSL());
+        Adder::template addHSL<&cfDecreaseLightness <HSLType,Arg> >(cs, COMPOSITE_DEC_LIGHTNESS     , KoCompositeOp::categoryHSL());
+
+        Adder::template addHSL<&cfColor             <HSVType,Arg> >(cs, COMPOSITE_COLOR_HSV         , KoCompositeOp::categoryHSV());
+        Adder::template addHSL<&cfHue               <HSVType,Arg> >(cs, COMPOSITE_HUE_HSV           , KoCompositeOp::categoryHSV());
+        Adder::template addHSL<&cfSaturation        <HSVType,Arg> >(cs, COMPOSITE_SATURATION_HSV    , KoCompositeOp::categoryHSV());
+        Adder::template addHSL<&cfIncreaseSaturation<HSVType,Arg> >(cs, COMPOSITE_INC_SATURATION_HSV, KoCompositeOp::categoryHSV());
+        Adder::template addHSL<&cfDecreaseSaturation<HSVType,Arg> >(cs, COMPOSITE_DEC_SATURATION_HSV, KoCompositeOp::categoryHSV());
+        Adder::template addHSL<&cfLightness         <HSVType,Arg> >(cs, COMPOSITE_VALUE             , KoCompositeOp::categoryHSV());
+        Adder::template addHSL<&cfIncreaseLightness <HSVType,Arg> >(cs, COMPOSITE_INC_VALUE         , KoCompositeOp::categoryHSV());
+        Adder::template addHSL<&cfDecreaseLightness <HSVType,Arg> >(cs, COMPOSITE_DEC_VALUE         , KoCompositeOp::categoryHSV());
+    }
+};
+
+#endif // KOGENERICCOMPOSITEOPSLIST_H
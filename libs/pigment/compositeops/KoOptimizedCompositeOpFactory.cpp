@@ -7,6 +7,8 @@
 #include "KoOptimizedCompositeOpFactoryPerArch.h"
 #include "KoOptimizedCompositeOpFactory.h"
 
+#include "KoColorSpaceTraits.h"
+
 KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOpHard32(const KoColorSpace *cs)
 {
     return createOptimizedClass<
@@ -78,3 +80,29 @@ KoCompositeOp* KoOptimizedCompositeOpFactory::createCopyOpU64(const KoColorSpace
 {
     return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopyU64> >(cs);
 }
+
+bool KoOptimizedCompositeOpFactory::addGenericOps32(KoColorSpace *cs, GenericOpsGroup group)
+{
+    return createOptimizedClass<
+        KoOptimizedGenericCompositeOpFactoryPerArch<KoBgrU8Traits>>({cs, group});
+}
+
+bool KoOptimizedCompositeOpFactory::addGenericOpsU64(KoColorSpace *cs, GenericOpsGroup group)
+{
+    return createOptimizedClass<
+        KoOptimizedGenericCompositeOpFactoryPerArch<KoBgrU16Traits>>({cs, group});
+}
+
+#ifdef HAVE_OPENEXR
+bool KoOptimizedCompositeOpFactory::addGenericOpsF16(KoColorSpace *cs, GenericOpsGroup group)
+{
+    return createOptimizedClass<
+        KoOptimizedGenericCompositeOpFactoryPerArch<KoRgbF16Traits>>({cs, group});
+}
+#endif
+
+bool KoOptimizedCompositeOpFactory::addGenericOps128(KoColorSpace *cs, GenericOpsGroup group)
+{
+    return createOptimizedClass<
+        KoOptimizedGenericCompositeOpFactoryPerArch<KoRgbF32Traits>>({cs, group});
+}
@@ -9,6 +9,8 @@
 
 #include "kritapigment_export.h"
 
+#include <KoConfig.h>
+
 class KoCompositeOp;
 class KoColorSpace;
 
@@ -39,6 +41,29 @@ public:
     static KoCompositeOp* createCopyOp32(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOpHardU64(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOpCreamyU64(const KoColorSpace *cs);
+
+    /**
+     * The groups of the generic blending modes, see KoGenericCompositeOpsList.h
+     */
+    enum GenericOpsGroup {
+        SeparableOps,
+        HSLOps
+    };
+
+    /**
+     * Add vectorized versions of the generic blending modes of \p group
+     * (Multiply, Screen, Hue, etc.) to an RGBA colorspace. Returns false
+     * if the current CPU has no vectorized implementation, then the caller
+     * should add KoCompositeOpGenericSC/HSL instead. The modes, that depend
+     * on the precision of the channel type, are vectorized only for float
+     * colorspaces, see KoGenericCompositeOpsPrecision.
+     */
+    static bool addGenericOps32(KoColorSpace *cs, GenericOpsGroup group);
+    static bool addGenericOpsU64(KoColorSpace *cs, GenericOpsGroup group);
+#ifdef HAVE_OPENEXR
+    static bool addGenericOpsF16(KoColorSpace *cs, GenericOpsGroup group);
+#endif
+    static bool addGenericOps128(KoColorSpace *cs, GenericOpsGroup group);
 };
 
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORY_H */
@@ -9,6 +9,7 @@
 #define KOOPTIMIZEDCOMPOSITEOPFACTORYPERARCH_H
 
 #include <compositeops/KoMultiArchBuildSupport.h>
+#include "KoOptimizedCompositeOpFactory.h"
 class KoCompositeOp;
 class KoColorSpace;
 
@@ -57,4 +58,21 @@ struct KoOptimizedCompositeOpFactoryPerArch {
     static ReturnType create(ParamType param);
 };
 
+/**
+ * Adds vectorized versions of the generic (separable or HSL) composite
+ * ops to the colorspace with \p Traits. Returns false if there is no
+ * vectorized implementation, i.e. in the scalar build.
+ */
+template<class Traits>
+struct KoOptimizedGenericCompositeOpFactoryPerArch {
+    struct ParamType {
+        KoColorSpace *colorSpace;
+        KoOptimizedCompositeOpFactory::GenericOpsGroup group;
+    };
+    using ReturnType = bool;
+
+    template <typename _impl>
+    static ReturnType create(ParamType param);
+};
+
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORYPERARCH_H */
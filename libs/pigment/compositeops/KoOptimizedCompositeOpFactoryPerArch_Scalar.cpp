@@ -110,3 +110,40 @@ KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamyU64>
     return new KoCompositeOpAlphaDarken<KoBgrU16Traits, KoAlphaDarkenParamsWrapperCreamy>(param);
 }
 
+/**
+ * There is no scalar version of the generic ops in this module,
+ * the caller adds KoCompositeOpGenericSC/HSL itself
+ */
+template<>
+template<>
+KoOptimizedGenericCompositeOpFactoryPerArch<KoBgrU8Traits>::ReturnType
+KoOptimizedGenericCompositeOpFactoryPerArch<KoBgrU8Traits>::create<xsimd::generic>(ParamType)
+{
+    return false;
+}
+
+template<>
+template<>
+KoOptimizedGenericCompositeOpFactoryPerArch<KoBgrU16Traits>::ReturnType
+KoOptimizedGenericCompositeOpFactoryPerArch<KoBgrU16Traits>::create<xsimd::generic>(ParamType)
+{
+    return false;
+}
+
+#ifdef HAVE_OPENEXR
+template<>
+template<>
+KoOptimizedGenericCompositeOpFactoryPerArch<KoRgbF16Traits>::ReturnType
+KoOptimizedGenericCompositeOpFactoryPerArch<KoRgbF16Traits>::create<xsimd::generic>(ParamType)
+{
+    return false;
+}
+#endif
+
+template<>
+template<>
+KoOptimizedGenericCompositeOpFactoryPerArch<KoRgbF32Traits>::ReturnType
+KoOptimizedGenericCompositeOpFactoryPerArch<KoRgbF32Traits>::create<xsimd::generic>(ParamType)
+{
+    return false;
+}
@@ -0,0 +1,448 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPGENERIC_H
+#define KOOPTIMIZEDCOMPOSITEOPGENERIC_H
+
+#include <limits>
+
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpFunctions.h"
+#include "KoStreamedMath.h"
+
+/**
+ * Reads and writes float_v::size RGBA pixels as four vectors of
+ * normalized channel values. The vectors are stored in the order
+ * of the channels in memory, that is c[Traits::red_pos] is always
+ * the red channel, whatever the layout of the pixel is.
+ *
+ * The generic version transposes the pixels via a temporary buffer
+ * (used for half-float pixels, which have no packed representation
+ * in xsimd)
+ */
+template<typename channels_type, typename _impl>
+struct KoGenericCompositePixelWrapper
+{
+    using float_v = xsimd::batch<float, _impl>;
+    static constexpr int vectorSize = static_cast<int>(float_v::size);
+
+    ALWAYS_INLINE void read(const quint8 *data, float_v *c)
+    {
+        const channels_type *pixels = reinterpret_cast<const channels_type*>(data);
+        float buf[4][vectorSize];
+
+        for (int i = 0; i < vectorSize; i++) {
+            for (int ch = 0; ch < 4; ch++) {
+                buf[ch][i] = KoColorSpaceMaths<channels_type, float>::scaleToA(pixels[4 * i + ch]);
+            }
+        }
+
+        for (int ch = 0; ch < 4; ch++) {
+            c[ch] = float_v::load_unaligned(buf[ch]);
+        }
+    }
+
+    ALWAYS_INLINE void write(quint8 *data, const float_v *c)
+    {
+        channels_type *pixels = reinterpret_cast<channels_type*>(data);
+        float buf[4][vectorSize];
+
+        for (int ch = 0; ch < 4; ch++) {
+            c[ch].store_unaligned(buf[ch]);
+        }
+
+        for (int i = 0; i < vectorSize; i++) {
+            for (int ch = 0; ch < 4; ch++) {
+                pixels[4 * i + ch] = KoColorSpaceMaths<float, channels_type>::scaleToA(buf[ch][i]);
+            }
+        }
+    }
+};
+
+template<typename _impl>
+struct KoGenericCompositePixelWrapper<quint8, _impl>
+{
+    using float_v = xsimd::batch<float, _impl>;
+
+    KoGenericCompositePixelWrapper()
+        : uint8Max(255.0f)
+        , uint8Rec1(1.0f / 255.0f)
+    {
+    }
+
+    ALWAYS_INLINE void read(const quint8 *data, float_v *c)
+    {
+        // PixelWrapper returns the channels in the most-significant-byte-first order
+        m_wrapper.read(data, c[2], c[1], c[0], c[3]);
+
+        c[0] *= uint8Rec1;
+        c[1] *= uint8Rec1;
+        c[2] *= uint8Rec1;
+    }
+
+    ALWAYS_INLINE void write(quint8 *data, const float_v *c)
+    {
+        m_wrapper.write(data, c[2] * uint8Max, c[1] * uint8Max, c[0] * uint8Max, c[3]);
+    }
+
+    PixelWrapper<quint8, _impl> m_wrapper;
+    const float_v uint8Max;
+    const float_v uint8Rec1;
+};
+
+template<typename _impl>
+struct KoGenericCompositePixelWrapper<quint16, _impl>
+{
+    using float_v = xsimd::batch<float, _impl>;
+
+    KoGenericCompositePixelWrapper()
+        : uint16Max(65535.0f)
+        , uint16Rec1(1.0f / 65535.0f)
+    {
+    }
+
+    ALWAYS_INLINE void read(const quint8 *data, float_v *c)
+    {
+        m_wrapper.read(data, c[0], c[1], c[2], c[3]);
+
+        c[0] *= uint16Rec1;
+        c[1] *= uint16Rec1;
+        c[2] *= uint16Rec1;
+    }
+
+    ALWAYS_INLINE void write(quint8 *data, const float_v *c)
+    {
+        m_wrapper.write(data, c[0] * uint16Max, c[1] * uint16Max, c[2] * uint16Max, c[3]);
+    }
+
+    PixelWrapper<quint16, _impl> m_wrapper;
+    const float_v uint16Max;
+    const float_v uint16Rec1;
+};
+
+template<typename _impl>
+struct KoGenericCompositePixelWrapper<float, _impl>
+{
+    using float_v = xsimd::batch<float, _impl>;
+
+    ALWAYS_INLINE void read(const quint8 *data, float_v *c)
+    {
+        m_wrapper.read(data, c[0], c[1], c[2], c[3]);
+    }
+
+    ALWAYS_INLINE void write(quint8 *data, const float_v *c)
+    {
+        m_wrapper.write(data, c[0], c[1], c[2], c[3]);
+    }
+
+    PixelWrapper<float, _impl> m_wrapper;
+};
+
+/**
+ * Applies a separable blending function, e.g. cfMultiply<float>,
+ * to the color channels of \p size pixels. The pixels are passed
+ * in planar form, so the loop is trivially vectorized by the compiler
+ * for the architecture the op is built for.
+ */
+template<float compositeFunc(float, float)>
+struct KoGenericCompositeFunctionSC
+{
+    template<class Traits, int size>
+    static ALWAYS_INLINE void apply(const float (&src)[3][size],
+                                    const float (&dst)[3][size],
+                                    float (&result)[3][size])
+    {
+        for (int ch = 0; ch < 3; ch++) {
+            for (int i = 0; i < size; i++) {
+                result[ch][i] = compositeFunc(src[ch][i], dst[ch][i]);
+            }
+        }
+    }
+};
+
+/**
+ * Applies a nonseparable (HSL-like) blending function,
+ * e.g. cfHue<HSYType, float>, to \p size pixels
+ */
+template<void compositeFunc(float, float, float, float&, float&, float&)>
+struct KoGenericCompositeFunctionHSL
+{
+    template<class Traits, int size>
+    static ALWAYS_INLINE void apply(const float (&src)[3][size],
+                                    const float (&dst)[3][size],
+                                    float (&result)[3][size])
+    {
+        const int red_pos = Traits::red_pos;
+        const int green_pos = Traits::green_pos;
+        const int blue_pos = Traits::blue_pos;
+
+        for (int i = 0; i < size; i++) {
+            float dstR = dst[red_pos][i];
+            float dstG = dst[green_pos][i];
+            float dstB = dst[blue_pos][i];
+
+            compositeFunc(src[red_pos][i], src[green_pos][i], src[blue_pos][i], dstR, dstG, dstB);
+
+            result[red_pos][i] = dstR;
+            result[green_pos][i] = dstG;
+            result[blue_pos][i] = dstB;
+        }
+    }
+};
+
+/**
+ * A compositor for KoStreamedMath::genericComposite() that implements
+ * the math of KoCompositeOpGenericSC and KoCompositeOpGenericHSL in
+ * normalized floating point numbers. The blending function is
+ * evaluated for the whole vector at once, the alpha math is done
+ * with xsimd.
+ *
+ * For the integer colorspaces the result of the blending function
+ * is clamped into the unit range, so it matches the integer version
+ * of the function up to the rounding error.
+ */
+template<class Traits, class ColorFunction, bool alphaLocked, bool allChannelsFlag>
+struct KoGenericCompositor
+{
+    using channels_type = typename Traits::channels_type;
+
+    static const qint32 alpha_pos = Traits::alpha_pos;
+    static const bool isIntegerSpace = std::numeric_limits<channels_type>::is_integer;
+
+    static_assert(Traits::channels_nb == 4 && Traits::alpha_pos == 3,
+                  "KoGenericCompositor supports RGBA colorspaces only");
+
+    struct ParamsWrapper {
+        ParamsWrapper(const KoCompositeOp::ParameterInfo& params)
+            : channelFlags(params.channelFlags)
+        {
+        }
+        const QBitArray &channelFlags;
+    };
+
+    template<typename T>
+    static ALWAYS_INLINE T clampToUnit(const T &value)
+    {
+        return isIntegerSpace ? xsimd::min(xsimd::max(value, T(0.0f)), T(1.0f)) : value;
+    }
+
+    static ALWAYS_INLINE float clampToUnit(float value)
+    {
+        return isIntegerSpace ? qBound(0.0f, value, 1.0f) : value;
+    }
+
+    template<bool haveMask, bool src_aligned, typename _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        using float_v = typename KoStreamedMath<_impl>::float_v;
+        using float_m = typename float_v::batch_bool_type;
+        constexpr int vectorSize = static_cast<int>(float_v::size);
+
+        Q_UNUSED(oparams);
+
+        KoGenericCompositePixelWrapper<channels_type, _impl> dataWrapper;
+
+        float_v srcPixel[4];
+        dataWrapper.read(src, srcPixel);
+
+        float_v srcAlpha = srcPixel[alpha_pos] * float_v(opacity);
+
+        if (haveMask) {
+            const float_v uint8Rec1(1.0f / 255.0f);
+            srcAlpha *= KoStreamedMath<_impl>::fetch_mask_8(mask) * uint8Rec1;
+        }
+
+        const float_v zeroValue(0.0f);
+        const float_v oneValue(1.0f);
+
+        // a transparent source changes nothing in all the blending modes
+        if (xsimd::all(srcAlpha == zeroValue)) {
+            return;
+        }
+
+        float_v dstPixel[4];
+        dataWrapper.read(dst, dstPixel);
+
+        const float_v dstAlpha = dstPixel[alpha_pos];
+
+        float srcColors[3][vectorSize];
+        float dstColors[3][vectorSize];
+        float result[3][vectorSize];
+
+        for (int ch = 0; ch < 3; ch++) {
+            srcPixel[ch].store_unaligned(srcColors[ch]);
+            dstPixel[ch].store_unaligned(dstColors[ch]);
+        }
+
+        ColorFunction::template apply<Traits, vectorSize>(srcColors, dstColors, result);
+
+        if (alphaLocked) {
+            const float_m dstTransparent = dstAlpha == zeroValue;
+
+            for (int ch = 0; ch < 3; ch++) {
+                const float_v value = clampToUnit(float_v::load_unaligned(result[ch]));
+                const float_v blended = srcAlpha * (value - dstPixel[ch]) + dstPixel[ch];
+                dstPixel[ch] = xsimd::select(dstTransparent, dstPixel[ch], clampToUnit(blended));
+            }
+        } else {
+            const float_v srcDstAlpha = srcAlpha * dstAlpha;
+            const float_v newAlpha = srcAlpha + dstAlpha - srcDstAlpha;
+            const float_m newTransparent = newAlpha == zeroValue;
+
+            /**
+             * The value of newAlpha can have *some* zero values,
+             * which will result in NaN values while division.
+             */
+            const float_v newAlphaRec = oneValue / xsimd::select(newTransparent, oneValue, newAlpha);
+            const float_v srcWeight = srcAlpha - srcDstAlpha;
+            const float_v dstWeight = dstAlpha - srcDstAlpha;
+
+            for (int ch = 0; ch < 3; ch++) {
+                const float_v value = clampToUnit(float_v::load_unaligned(result[ch]));
+                const float_v blended =
+                    (srcWeight * srcPixel[ch] + dstWeight * dstPixel[ch] + srcDstAlpha * value) * newAlphaRec;
+                dstPixel[ch] = xsimd::select(newTransparent, dstPixel[ch], clampToUnit(blended));
+            }
+
+            dstPixel[alpha_pos] = newAlpha;
+        }
+
+        dataWrapper.write(dst, dstPixel);
+    }
+
+    template<bool haveMask, typename _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        using namespace Arithmetic;
+
+        const channels_type *s = reinterpret_cast<const channels_type*>(src);
+        channels_type *d = reinterpret_cast<channels_type*>(dst);
+
+        if (!allChannelsFlag && d[alpha_pos] == zeroValue<channels_type>()) {
+            KoStreamedMathFunctions::clearPixel<Traits::pixelSize>(dst);
+        }
+
+        float srcAlpha = scale<float>(s[alpha_pos]) * opacity;
+
+        if (haveMask) {
+            srcAlpha *= scale<float>(*mask);
+        }
+
+        if (srcAlpha == 0.0f) {
+            return;
+        }
+
+        const float dstAlpha = scale<float>(d[alpha_pos]);
+
+        float srcColors[3][1];
+        float dstColors[3][1];
+        float result[3][1];
+
+        for (int ch = 0; ch < 3; ch++) {
+            srcColors[ch][0] = scale<float>(s[ch]);
+            dstColors[ch][0] = scale<float>(d[ch]);
+        }
+
+        ColorFunction::template apply<Traits, 1>(srcColors, dstColors, result);
+
+        const QBitArray &channelFlags = oparams.channelFlags;
+
+        if (alphaLocked) {
+            if (dstAlpha != 0.0f) {
+                for (int ch = 0; ch < 3; ch++) {
+                    if (allChannelsFlag || channelFlags.testBit(ch)) {
+                        const float value = clampToUnit(result[ch][0]);
+                        d[ch] = scale<channels_type>(clampToUnit(srcAlpha * (value - dstColors[ch][0]) + dstColors[ch][0]));
+                    }
+                }
+            }
+        } else {
+            const float srcDstAlpha = srcAlpha * dstAlpha;
+            const float newAlpha = srcAlpha + dstAlpha - srcDstAlpha;
+
+            if (newAlpha != 0.0f) {
+                for (int ch = 0; ch < 3; ch++) {
+                    if (allChannelsFlag || channelFlags.testBit(ch)) {
+                        const float value = clampToUnit(result[ch][0]);
+                        const float blended =
+                            (srcAlpha - srcDstAlpha) * srcColors[ch][0] +
+                            (dstAlpha - srcDstAlpha) * dstColors[ch][0] +
+                            srcDstAlpha * value;
+
+                        d[ch] = scale<channels_type>(clampToUnit(blended / newAlpha));
+                    }
+                }
+            }
+
+            d[alpha_pos] = scale<channels_type>(newAlpha);
+        }
+    }
+};
+
+/**
+ * A vectorized version of KoCompositeOpGenericSC and KoCompositeOpGenericHSL
+ * for RGBA colorspaces. The op is generated from the same blending functions
+ * as the scalar one, instantiated for float.
+ *
+ * The pixels are processed in blocks of float_v::size, the fully vectorized
+ * path is used when all the color channels are enabled (alpha may be locked),
+ * otherwise the op falls back to per-pixel processing.
+ */
+template<typename _impl, class Traits, class ColorFunction>
+class KoOptimizedCompositeOpGeneric : public KoCompositeOp
+{
+    static const int pixelSize = Traits::pixelSize;
+
+public:
+    KoOptimizedCompositeOpGeneric(const KoColorSpace* cs, const QString& id, const QString& category)
+        : KoCompositeOp(cs, id, category) {}
+
+    using KoCompositeOp::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        if(params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+    template <bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            KoStreamedMath<_impl>::template genericComposite<haveMask, false, KoGenericCompositor<Traits, ColorFunction, false, true>, pixelSize>(params);
+        } else {
+            const bool allChannelsFlag =
+                params.channelFlags.at(0) &&
+                params.channelFlags.at(1) &&
+                params.channelFlags.at(2);
+
+            const bool alphaLocked =
+                !params.channelFlags.at(3);
+
+            if (allChannelsFlag && alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite<haveMask, false, KoGenericCompositor<Traits, ColorFunction, true, true>, pixelSize>(params);
+            } else if (!allChannelsFlag && !alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite_novector<haveMask, false, KoGenericCompositor<Traits, ColorFunction, false, false>, pixelSize>(params);
+            } else /*if (!allChannelsFlag && alphaLocked) */{
+                KoStreamedMath<_impl>::template genericComposite_novector<haveMask, false, KoGenericCompositor<Traits, ColorFunction, true, false>, pixelSize>(params);
+            }
+        }
+    }
+};
+
+template<typename _impl, class Traits, float compositeFunc(float, float)>
+using KoOptimizedCompositeOpGenericSC =
+    KoOptimizedCompositeOpGeneric<_impl, Traits, KoGenericCompositeFunctionSC<compositeFunc>>;
+
+template<typename _impl, class Traits, void compositeFunc(float, float, float, float&, float&, float&)>
+using KoOptimizedCompositeOpGenericHSL =
+    KoOptimizedCompositeOpGeneric<_impl, Traits, KoGenericCompositeFunctionHSL<compositeFunc>>;
+
+#endif // KOOPTIMIZEDCOMPOSITEOPGENERIC_H
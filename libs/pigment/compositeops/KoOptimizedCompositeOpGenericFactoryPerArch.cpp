@@ -0,0 +1,74 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedCompositeOpFactoryPerArch.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include <KoConfig.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceTraits.h>
+
+#include "KoGenericCompositeOpsList.h"
+#include "KoOptimizedCompositeOpGeneric.h"
+
+namespace {
+
+/**
+ * Adds the vectorized twin of every blending function of the lists in
+ * KoGenericCompositeOpsList.h. The functions are always instantiated
+ * for float, so the precision-dependent modes are skipped for the
+ * colorspaces with other channel types, KoCompositeOps.h adds the
+ * scalar ops for them.
+ */
+template<class Traits, typename _impl>
+struct VectorizedGenericOpsAdder
+{
+    typedef float Arg;
+
+    template<Arg compositeFunc(Arg, Arg)>
+    static void add(KoColorSpace *cs, const QString &id, const QString &category) {
+        cs->addCompositeOp(new KoOptimizedCompositeOpGenericSC<_impl, Traits, compositeFunc>(cs, id, category));
+    }
+
+    template<Arg compositeFunc(Arg, Arg)>
+    static void addPrecisionDependent(KoColorSpace *cs, const QString &id, const QString &category) {
+        if (KoGenericCompositeOpsPrecision<Traits>::floatVersionIsExact) {
+            add<compositeFunc>(cs, id, category);
+        }
+    }
+
+    template<void compositeFunc(Arg, Arg, Arg, Arg&, Arg&, Arg&)>
+    static void addHSL(KoColorSpace *cs, const QString &id, const QString &category) {
+        cs->addCompositeOp(new KoOptimizedCompositeOpGenericHSL<_impl, Traits, compositeFunc>(cs, id, category));
+    }
+};
+
+} // namespace
+
+template<class Traits>
+template<typename _impl>
+typename KoOptimizedGenericCompositeOpFactoryPerArch<Traits>::ReturnType
+KoOptimizedGenericCompositeOpFactoryPerArch<Traits>::create(ParamType param)
+{
+    typedef VectorizedGenericOpsAdder<Traits, _impl> Adder;
+
+    if (param.group == KoOptimizedCompositeOpFactory::SeparableOps) {
+        KoGenericSCCompositeOpsList<Adder>::add(param.colorSpace);
+    } else {
+        KoGenericHSLCompositeOpsList<Adder>::add(param.colorSpace);
+    }
+
+    return true;
+}
+
+template bool KoOptimizedGenericCompositeOpFactoryPerArch<KoBgrU8Traits>::create<xsimd::current_arch>(ParamType);
+template bool KoOptimizedGenericCompositeOpFactoryPerArch<KoBgrU16Traits>::create<xsimd::current_arch>(ParamType);
+#ifdef HAVE_OPENEXR
+template bool KoOptimizedGenericCompositeOpFactoryPerArch<KoRgbF16Traits>::create<xsimd::current_arch>(ParamType);
+#endif
+template bool KoOptimizedGenericCompositeOpFactoryPerArch<KoRgbF32Traits>::create<xsimd::current_arch>(ParamType);
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
@@ -0,0 +1,329 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISOPTIMIZEDDITHEROP_H
+#define KISOPTIMIZEDDITHEROP_H
+
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include <QVarLengthArray>
+
+#include "KisDitherOpImpl.h"
+#include "KisCmykDitherOpImpl.h"
+#include "KoAlwaysInline.h"
+#include "KoMultiArchBuildSupport.h"
+
+
+/**
+ * The generic version of the selector, it doesn't create any
+ * optimized ops, so KisDitherOpImpl is used instead.
+ */
+template<typename src_channels_type,
+         typename dst_channels_type,
+         int channels_nb,
+         bool useCmykNormalization,
+         DitherType dType,
+         typename _impl,
+         typename EnableDummyType = void>
+struct KisOptimizedDitherOpSelector
+{
+    static KisDitherOp* create(const KoID &srcId, const KoID &dstId) {
+        Q_UNUSED(srcId);
+        Q_UNUSED(dstId);
+        return 0;
+    }
+};
+
+#ifdef HAVE_XSIMD
+
+template<DitherType dType>
+struct KisDitherFactor;
+
+template<>
+struct KisDitherFactor<DITHER_BAYER>
+{
+    static ALWAYS_INLINE float at(int x, int y) {
+        return KisDitherMaths::dither_factor_bayer_8(x, y);
+    }
+};
+
+template<>
+struct KisDitherFactor<DITHER_BLUE_NOISE>
+{
+    static ALWAYS_INLINE float at(int x, int y) {
+        return KisDitherMaths::dither_factor_blue_noise_64(x, y);
+    }
+};
+
+/**
+ * SIMD version of the row-based dithering of KisDitherOpImpl and
+ * KisCmykDitherOpImpl.
+ *
+ * The dithering of a pixel does exactly the same thing for every channel,
+ * only the dither factor depends on the position of the pixel. So the op
+ * handles a row of pixels as a flat array of channel values: the factors
+ * are calculated per pixel and expanded into a per-channel buffer, then
+ * the channels are converted and dithered float_v::size values at a time.
+ * For CMYK the normalization of the channel depends on whether it is
+ * alpha or not, so the op keeps a set of per-lane constants for every
+ * possible offset of the vector inside a pixel.
+ *
+ * All the arithmetic follows the one of the scalar op operation by
+ * operation (the normalization is done by division, not multiplication
+ * by a reciprocal), so the result is bit-exact. The tail of the row is
+ * copied into a zero-padded buffer and passed through the same vector
+ * code.
+ *
+ * Single-pixel dithering is inherited from the scalar op.
+ */
+template<typename src_channels_type,
+         typename dst_channels_type,
+         int channels_nb,
+         bool useCmykNormalization,
+         DitherType dType,
+         typename _impl>
+class KisOptimizedDitherOp
+    : public std::conditional<useCmykNormalization,
+                              KisCmykDitherOpImpl<KoCmykTraits<src_channels_type>, KoCmykTraits<dst_channels_type>, dType>,
+                              KisDitherOpImpl<KoColorSpaceTrait<src_channels_type, channels_nb, channels_nb - 1>,
+                                              KoColorSpaceTrait<dst_channels_type, channels_nb, channels_nb - 1>,
+                                              dType>>::type
+{
+    using BaseClass =
+        typename std::conditional<useCmykNormalization,
+                                  KisCmykDitherOpImpl<KoCmykTraits<src_channels_type>, KoCmykTraits<dst_channels_type>, dType>,
+                                  KisDitherOpImpl<KoColorSpaceTrait<src_channels_type, channels_nb, channels_nb - 1>,
+                                                  KoColorSpaceTrait<dst_channels_type, channels_nb, channels_nb - 1>,
+                                                  dType>>::type;
+
+    using float_v = xsimd::batch<float, _impl>;
+    using float_m = xsimd::batch_bool<float, _impl>;
+    using int_v = xsimd::batch<int, _impl>;
+
+    static constexpr int vectorSize = static_cast<int>(float_v::size);
+    static constexpr int alphaPos = channels_nb - 1;
+
+    static constexpr bool srcIsInteger = std::numeric_limits<src_channels_type>::is_integer;
+    static constexpr bool dstIsInteger = std::numeric_limits<dst_channels_type>::is_integer;
+
+    static_assert(!useCmykNormalization || channels_nb == 5, "CMYK should have five channels");
+
+    /**
+     * Per-lane constants for a vector that starts at a specific
+     * channel of the pixel
+     */
+    struct LaneParams {
+        float_v srcDivisor;
+        float_v dstMultiplier;
+        float_m useStandardRounding;
+    };
+
+public:
+    KisOptimizedDitherOp(const KoID &srcId, const KoID &dstId)
+        : BaseClass(srcId, dstId)
+    {
+    }
+
+    using BaseClass::dither;
+
+    void dither(const quint8 *srcRowStart, int srcRowStride, quint8 *dstRowStart, int dstRowStride, int x, int y, int columns, int rows) const override
+    {
+        const int numValues = columns * channels_nb;
+        const int numBlocks = numValues / vectorSize;
+        const int numRestValues = numValues % vectorSize;
+
+        LaneParams laneParams[channels_nb];
+        initLaneParams(laneParams);
+
+        QVarLengthArray<float, 2048> factors((numBlocks + 1) * vectorSize);
+        std::fill(factors.begin() + numValues, factors.end(), 0.0f);
+
+        const float_v scale(ditherScale());
+
+        for (int a = 0; a < rows; ++a) {
+            for (int b = 0; b < columns; ++b) {
+                const float f = KisDitherFactor<dType>::at(x + b, y + a);
+                float *pixelFactors = factors.data() + b * channels_nb;
+
+                for (int ch = 0; ch < channels_nb; ++ch) {
+                    pixelFactors[ch] = f;
+                }
+            }
+
+            const src_channels_type *srcPtr = reinterpret_cast<const src_channels_type*>(srcRowStart);
+            dst_channels_type *dstPtr = reinterpret_cast<dst_channels_type*>(dstRowStart);
+            const float *factorPtr = factors.constData();
+
+            for (int i = 0; i < numBlocks; i++) {
+                processBlock(srcPtr, factorPtr, dstPtr, scale, laneParams[(i * vectorSize) % channels_nb]);
+
+                srcPtr += vectorSize;
+                dstPtr += vectorSize;
+                factorPtr += vectorSize;
+            }
+
+            if (numRestValues) {
+                src_channels_type srcTail[vectorSize];
+                dst_channels_type dstTail[vectorSize];
+
+                std::fill(srcTail, srcTail + vectorSize, src_channels_type(0));
+                memcpy(srcTail, srcPtr, numRestValues * sizeof(src_channels_type));
+
+                processBlock(srcTail, factorPtr, dstTail, scale, laneParams[(numBlocks * vectorSize) % channels_nb]);
+
+                memcpy(dstPtr, dstTail, numRestValues * sizeof(dst_channels_type));
+            }
+
+            srcRowStart += srcRowStride;
+            dstRowStart += dstRowStride;
+        }
+    }
+
+private:
+    template<typename U = dst_channels_type, typename std::enable_if<!std::numeric_limits<U>::is_integer, void>::type * = nullptr>
+    static constexpr float ditherScale() {
+        return 0.f; // no dithering for floating point
+    }
+
+    template<typename U = dst_channels_type, typename std::enable_if<std::numeric_limits<U>::is_integer, void>::type * = nullptr>
+    static constexpr float ditherScale() {
+        return 1.f / static_cast<float>(1 << KoColorSpaceMathsTraits<U>::bits);
+    }
+
+    template<typename T>
+    static float cmykUnitValue(std::true_type) {
+        return static_cast<float>(KoColorSpaceMathsTraits<T>::unitValue);
+    }
+
+    template<typename T>
+    static float cmykUnitValue(std::false_type) {
+        return static_cast<float>(KoCmykColorSpaceMathsTraits<T>::unitValueCMYK);
+    }
+
+    static void initLaneParams(LaneParams *params)
+    {
+        const float srcUnitValue = static_cast<float>(KoColorSpaceMathsTraits<src_channels_type>::unitValue);
+        const float dstUnitValue = static_cast<float>(KoColorSpaceMathsTraits<dst_channels_type>::unitValue);
+
+        const float srcColorUnitValue = useCmykNormalization ?
+            cmykUnitValue<src_channels_type>(std::integral_constant<bool, srcIsInteger>()) : srcUnitValue;
+        const float dstColorUnitValue = useCmykNormalization ?
+            cmykUnitValue<dst_channels_type>(std::integral_constant<bool, dstIsInteger>()) : dstUnitValue;
+
+        for (int offset = 0; offset < channels_nb; offset++) {
+            float srcDivisor[vectorSize];
+            float dstMultiplier[vectorSize];
+            float isStandard[vectorSize];
+
+            for (int i = 0; i < vectorSize; i++) {
+                const bool isAlpha = (offset + i) % channels_nb == alphaPos;
+                const bool standard = !useCmykNormalization || isAlpha;
+
+                srcDivisor[i] = standard ? srcUnitValue : srcColorUnitValue;
+                dstMultiplier[i] = standard ? dstUnitValue : dstColorUnitValue;
+                isStandard[i] = standard ? 1.0f : 0.0f;
+            }
+
+            params[offset].srcDivisor = float_v::load_unaligned(srcDivisor);
+            params[offset].dstMultiplier = float_v::load_unaligned(dstMultiplier);
+            params[offset].useStandardRounding = float_v::load_unaligned(isStandard) == float_v(1.0f);
+        }
+    }
+
+    template<typename T>
+    static ALWAYS_INLINE
+    typename std::enable_if<std::numeric_limits<T>::is_integer, float_v>::type
+    loadValues(const T *src) {
+        return xsimd::to_float(xsimd::load_and_extend<int_v>(src));
+    }
+
+    template<typename T>
+    static ALWAYS_INLINE
+    typename std::enable_if<!std::numeric_limits<T>::is_integer, float_v>::type
+    loadValues(const T *src) {
+        return float_v::load_unaligned(src);
+    }
+
+    template<typename T>
+    static ALWAYS_INLINE
+    typename std::enable_if<std::numeric_limits<T>::is_integer>::type
+    storeValues(T *dst, const float_v &value) {
+        int values[vectorSize];
+        xsimd::batch_cast<int>(value).store_unaligned(values);
+
+        for (int i = 0; i < vectorSize; i++) {
+            dst[i] = static_cast<T>(values[i]);
+        }
+    }
+
+    template<typename T>
+    static ALWAYS_INLINE
+    typename std::enable_if<!std::numeric_limits<T>::is_integer>::type
+    storeValues(T *dst, const float_v &value) {
+        value.store_unaligned(dst);
+    }
+
+    /**
+     * Dither vectorSize channel values. The operations repeat the
+     * ones of KoColorSpaceMaths::scaleToA(), KisDitherMaths::apply_dither()
+     * and the CMYK normalization of KisCmykDitherOpImpl.
+     */
+    static ALWAYS_INLINE void processBlock(const src_channels_type *src,
+                                           const float *factors,
+                                           dst_channels_type *dst,
+                                           const float_v &scale,
+                                           const LaneParams &params)
+    {
+        float_v c = loadValues(src);
+
+        if (srcIsInteger || useCmykNormalization) {
+            c = c / params.srcDivisor;
+        }
+
+        const float_v f = float_v::load_unaligned(factors);
+        c = c + (f - c) * scale;
+
+        if (dstIsInteger) {
+            c = c * params.dstMultiplier;
+
+            const float_v rounded =
+                xsimd::min(xsimd::max(c, float_v(0.0f)), params.dstMultiplier) + float_v(0.5f);
+
+            // CMYK color channels are truncated without clamping
+            c = useCmykNormalization ? xsimd::select(params.useStandardRounding, rounded, c) : rounded;
+        } else if (useCmykNormalization) {
+            c = c * params.dstMultiplier;
+        }
+
+        storeValues(dst, c);
+    }
+};
+
+/**
+ * The optimized ops are created only for the vectorized architectures
+ */
+template<typename src_channels_type,
+         typename dst_channels_type,
+         int channels_nb,
+         bool useCmykNormalization,
+         DitherType dType,
+         typename _impl>
+struct KisOptimizedDitherOpSelector<
+        src_channels_type, dst_channels_type, channels_nb, useCmykNormalization, dType, _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+{
+    static KisDitherOp* create(const KoID &srcId, const KoID &dstId) {
+        return new KisOptimizedDitherOp<src_channels_type, dst_channels_type,
+                                        channels_nb, useCmykNormalization,
+                                        dType, _impl>(srcId, dstId);
+    }
+};
+
+#endif /* HAVE_XSIMD */
+
+#endif // KISOPTIMIZEDDITHEROP_H
@@ -0,0 +1,60 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisOptimizedDitherOpFactory.h"
+
+#include <KoColorModelStandardIds.h>
+
+#include "KisOptimizedDitherOpFactoryImpl.h"
+
+namespace {
+
+template<typename src_channels_type>
+KisDitherOp* createForSourceDepth(const KisOptimizedDitherOpParams &params)
+{
+    if (params.dstDepthId == Integer8BitsColorDepthID) {
+        return createOptimizedClass<KisOptimizedDitherOpFactoryImpl<src_channels_type, quint8>>(params);
+    } else if (params.dstDepthId == Integer16BitsColorDepthID) {
+        return createOptimizedClass<KisOptimizedDitherOpFactoryImpl<src_channels_type, quint16>>(params);
+    } else if (params.dstDepthId == Float32BitsColorDepthID) {
+        return createOptimizedClass<KisOptimizedDitherOpFactoryImpl<src_channels_type, float>>(params);
+    }
+
+    return 0;
+}
+
+KisDitherOp* createImpl(const KisOptimizedDitherOpParams &params)
+{
+    if (params.type != DITHER_BAYER && params.type != DITHER_BLUE_NOISE) {
+        return 0;
+    }
+
+    if (params.srcDepthId == Integer8BitsColorDepthID) {
+        return createForSourceDepth<quint8>(params);
+    } else if (params.srcDepthId == Integer16BitsColorDepthID) {
+        return createForSourceDepth<quint16>(params);
+    } else if (params.srcDepthId == Float32BitsColorDepthID) {
+        return createForSourceDepth<float>(params);
+    }
+
+    return 0;
+}
+
+}
+
+KisDitherOp *KisOptimizedDitherOpFactory::create(const KoID &srcDepthId, const KoID &dstDepthId, int channelsNb, DitherType type)
+{
+    if (channelsNb != 2 && channelsNb != 4) {
+        return 0;
+    }
+
+    return createImpl({srcDepthId, dstDepthId, channelsNb, false, type});
+}
+
+KisDitherOp *KisOptimizedDitherOpFactory::createCmyk(const KoID &srcDepthId, const KoID &dstDepthId, DitherType type)
+{
+    return createImpl({srcDepthId, dstDepthId, 5, true, type});
+}
@@ -0,0 +1,39 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISOPTIMIZEDDITHEROPFACTORY_H
+#define KISOPTIMIZEDDITHEROPFACTORY_H
+
+#include "kritapigment_export.h"
+
+#include <KoID.h>
+#include "KisDitherOp.h"
+
+class KRITAPIGMENT_EXPORT KisOptimizedDitherOpFactory
+{
+public:
+    /**
+     * Create a SIMD version of the dither op for the color space with
+     * \p channelsNb channels, which uses the standard normalization of
+     * the channels (see KisDitherOpImpl). Only U8, U16 and F32 depths
+     * with two (gray) or four (RGB-like) channels are supported.
+     *
+     * @return the dither op or null if the combination of the depths,
+     *         the dither type or the CPU is not supported. In such a case
+     *         the generic KisDitherOpImpl should be used.
+     */
+    static KisDitherOp* create(const KoID &srcDepthId, const KoID &dstDepthId, int channelsNb, DitherType type);
+
+    /**
+     * Create a SIMD version of KisCmykDitherOpImpl, which normalizes
+     * the color channels of the floating point CMYK into [0, 100] range.
+     *
+     * @return the dither op or null if the combination is not supported
+     */
+    static KisDitherOp* createCmyk(const KoID &srcDepthId, const KoID &dstDepthId, DitherType type);
+};
+
+#endif // KISOPTIMIZEDDITHEROPFACTORY_H
@@ -0,0 +1,58 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisOptimizedDitherOpFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KisOptimizedDitherOp.h"
+
+namespace {
+
+template<typename src_channels_type, typename dst_channels_type, int channels_nb, bool useCmykNormalization, typename _impl>
+KisDitherOp* createForChannels(const KisOptimizedDitherOpParams &params)
+{
+    if (params.type == DITHER_BAYER) {
+        return KisOptimizedDitherOpSelector<src_channels_type, dst_channels_type,
+                                            channels_nb, useCmykNormalization,
+                                            DITHER_BAYER, _impl>::create(params.srcDepthId, params.dstDepthId);
+    } else if (params.type == DITHER_BLUE_NOISE) {
+        return KisOptimizedDitherOpSelector<src_channels_type, dst_channels_type,
+                                            channels_nb, useCmykNormalization,
+                                            DITHER_BLUE_NOISE, _impl>::create(params.srcDepthId, params.dstDepthId);
+    }
+
+    return 0;
+}
+
+}
+
+template<typename src_channels_type, typename dst_channels_type>
+template<typename _impl>
+KisDitherOp*
+KisOptimizedDitherOpFactoryImpl<src_channels_type, dst_channels_type>::create(ParamType params)
+{
+    if (params.useCmykNormalization) {
+        return createForChannels<src_channels_type, dst_channels_type, 5, true, _impl>(params);
+    } else if (params.channelsNb == 2) {
+        return createForChannels<src_channels_type, dst_channels_type, 2, false, _impl>(params);
+    } else if (params.channelsNb == 4) {
+        return createForChannels<src_channels_type, dst_channels_type, 4, false, _impl>(params);
+    }
+
+    return 0;
+}
+
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<quint8, quint8>::create<xsimd::current_arch>(ParamType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<quint8, quint16>::create<xsimd::current_arch>(ParamType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<quint8, float>::create<xsimd::current_arch>(ParamType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<quint16, quint8>::create<xsimd::current_arch>(ParamType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<quint16, quint16>::create<xsimd::current_arch>(ParamType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<quint16, float>::create<xsimd::current_arch>(ParamType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<float, quint8>::create<xsimd::current_arch>(ParamType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<float, quint16>::create<xsimd::current_arch>(ParamType);
+template KisDitherOp* KisOptimizedDitherOpFactoryImpl<float, float>::create<xsimd::current_arch>(ParamType);
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
@@ -0,0 +1,35 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISOPTIMIZEDDITHEROPFACTORYIMPL_H
+#define KISOPTIMIZEDDITHEROPFACTORYIMPL_H
+
+#include <KoID.h>
+#include <KoMultiArchBuildSupport.h>
+
+#include "KisDitherOp.h"
+
+struct KisOptimizedDitherOpParams
+{
+    KoID srcDepthId;
+    KoID dstDepthId;
+    int channelsNb;
+    bool useCmykNormalization;
+    DitherType type;
+};
+
+template<typename src_channels_type, typename dst_channels_type>
+class KRITAPIGMENT_EXPORT KisOptimizedDitherOpFactoryImpl
+{
+public:
+    using ParamType = KisOptimizedDitherOpParams;
+    using ReturnType = KisDitherOp *;
+
+    template<typename _impl>
+    static KisDitherOp* create(ParamType);
+};
+
+#endif // KISOPTIMIZEDDITHEROPFACTORYIMPL_H
@@ -0,0 +1,199 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestKisDitherOp.h"
+
+#include <QRandomGenerator>
+#include <QScopedPointer>
+#include <QVector>
+
+#include <simpletest.h>
+
+#include "KisDitherOpImpl.h"
+#include "dithering/KisCmykDitherOpImpl.h"
+#include "dithering/KisOptimizedDitherOpFactory.h"
+
+namespace {
+
+bool optimizedDitherOpsAvailable()
+{
+    QScopedPointer<KisDitherOp> op(
+        KisOptimizedDitherOpFactory::create(Integer8BitsColorDepthID, Integer8BitsColorDepthID, 4, DITHER_BAYER));
+    return !op.isNull();
+}
+
+template<typename T>
+typename std::enable_if<std::numeric_limits<T>::is_integer, T>::type
+randomChannelValue(QRandomGenerator &random, bool isCmykColor)
+{
+    Q_UNUSED(isCmykColor);
+    return static_cast<T>(random.bounded(int(KoColorSpaceMathsTraits<T>::unitValue) + 1));
+}
+
+template<typename T>
+typename std::enable_if<!std::numeric_limits<T>::is_integer, T>::type
+randomChannelValue(QRandomGenerator &random, bool isCmykColor)
+{
+    if (isCmykColor) {
+        return static_cast<T>(random.generateDouble() * KoCmykColorSpaceMathsTraits<T>::unitValueCMYK);
+    }
+
+    // check that the values out of the normal range are clamped the same way
+    return static_cast<T>(random.generateDouble() * 1.2 - 0.1);
+}
+
+template<class SrcTraits, class DstTraits, class ScalarOp>
+void compareWithScalarOp(KisDitherOp *optimizedOp, bool useCmykNormalization)
+{
+    using src_channels_type = typename SrcTraits::channels_type;
+    using dst_channels_type = typename DstTraits::channels_type;
+
+    QScopedPointer<KisDitherOp> op(optimizedOp);
+    QScopedPointer<KisDitherOp> scalarOp(new ScalarOp(op->sourceDepthId(), op->destinationDepthId()));
+
+    QCOMPARE(int(op->type()), int(scalarOp->type()));
+
+    const int rows = 5;
+    const int columnsCases[] = {1, 3, 7, 13, 64, 257};
+
+    QRandomGenerator random(1);
+
+    for (int columns : columnsCases) {
+        // the rows have some padding to check that it is kept untouched
+        const int rowLength = (columns + 3) * int(SrcTraits::channels_nb);
+
+        QVector<src_channels_type> src(rows * rowLength);
+        for (int i = 0; i < src.size(); i++) {
+            const bool isCmykColor = useCmykNormalization && i % int(SrcTraits::channels_nb) != int(SrcTraits::alpha_pos);
+            src[i] = randomChannelValue<src_channels_type>(random, isCmykColor);
+        }
+
+        QVector<dst_channels_type> expected(rows * rowLength, dst_channels_type(7));
+        QVector<dst_channels_type> result(expected);
+
+        const int srcStride = rowLength * sizeof(src_channels_type);
+        const int dstStride = rowLength * sizeof(dst_channels_type);
+
+        scalarOp->dither(reinterpret_cast<const quint8*>(src.constData()), srcStride,
+                         reinterpret_cast<quint8*>(expected.data()), dstStride,
+                         13, 27, columns, rows);
+
+        op->dither(reinterpret_cast<const quint8*>(src.constData()), srcStride,
+                   reinterpret_cast<quint8*>(result.data()), dstStride,
+                   13, 27, columns, rows);
+
+        for (int i = 0; i < result.size(); i++) {
+            QVERIFY2(!memcmp(&result[i], &expected[i], sizeof(dst_channels_type)),
+                     qPrintable(QString("%1 -> %2, type %3, columns %4: value %5 differs (%6 vs %7)")
+                                .arg(op->sourceDepthId().id())
+                                .arg(op->destinationDepthId().id())
+                                .arg(op->type())
+                                .arg(columns)
+                                .arg(i)
+                                .arg(double(result[i]))
+                                .arg(double(expected[i]))));
+        }
+    }
+}
+
+template<class SrcTraits, class DstTraits>
+void testStandardDitherOps(const KoID &srcDepth, const KoID &dstDepth)
+{
+    compareWithScalarOp<SrcTraits, DstTraits, KisDitherOpImpl<SrcTraits, DstTraits, DITHER_BAYER>>(
+        KisOptimizedDitherOpFactory::create(srcDepth, dstDepth, SrcTraits::channels_nb, DITHER_BAYER), false);
+    compareWithScalarOp<SrcTraits, DstTraits, KisDitherOpImpl<SrcTraits, DstTraits, DITHER_BLUE_NOISE>>(
+        KisOptimizedDitherOpFactory::create(srcDepth, dstDepth, SrcTraits::channels_nb, DITHER_BLUE_NOISE), false);
+}
+
+template<class SrcTraits, class DstU8Traits, class DstU16Traits, class DstF32Traits>
+void testStandardDitherOpsForSource(const KoID &srcDepth)
+{
+    testStandardDitherOps<SrcTraits, DstU8Traits>(srcDepth, Integer8BitsColorDepthID);
+    testStandardDitherOps<SrcTraits, DstU16Traits>(srcDepth, Integer16BitsColorDepthID);
+    testStandardDitherOps<SrcTraits, DstF32Traits>(srcDepth, Float32BitsColorDepthID);
+}
+
+template<class SrcTraits, class DstTraits>
+void testCmykDitherOps(const KoID &srcDepth, const KoID &dstDepth)
+{
+    compareWithScalarOp<SrcTraits, DstTraits, KisCmykDitherOpImpl<SrcTraits, DstTraits, DITHER_BAYER>>(
+        KisOptimizedDitherOpFactory::createCmyk(srcDepth, dstDepth, DITHER_BAYER), true);
+    compareWithScalarOp<SrcTraits, DstTraits, KisCmykDitherOpImpl<SrcTraits, DstTraits, DITHER_BLUE_NOISE>>(
+        KisOptimizedDitherOpFactory::createCmyk(srcDepth, dstDepth, DITHER_BLUE_NOISE), true);
+}
+
+template<class SrcTraits>
+void testCmykDitherOpsForSource(const KoID &srcDepth)
+{
+    testCmykDitherOps<SrcTraits, KoCmykU8Traits>(srcDepth, Integer8BitsColorDepthID);
+    testCmykDitherOps<SrcTraits, KoCmykU16Traits>(srcDepth, Integer16BitsColorDepthID);
+    testCmykDitherOps<SrcTraits, KoCmykF32Traits>(srcDepth, Float32BitsColorDepthID);
+}
+
+}
+
+void TestKisDitherOp::testOptimizedRgb()
+{
+    if (!optimizedDitherOpsAvailable()) {
+        QSKIP("The optimized dither ops are not available on this CPU");
+    }
+
+    testStandardDitherOpsForSource<KoBgrU8Traits, KoBgrU8Traits, KoBgrU16Traits, KoRgbF32Traits>(Integer8BitsColorDepthID);
+    testStandardDitherOpsForSource<KoBgrU16Traits, KoBgrU8Traits, KoBgrU16Traits, KoRgbF32Traits>(Integer16BitsColorDepthID);
+    testStandardDitherOpsForSource<KoRgbF32Traits, KoBgrU8Traits, KoBgrU16Traits, KoRgbF32Traits>(Float32BitsColorDepthID);
+}
+
+void TestKisDitherOp::testOptimizedGray()
+{
+    if (!optimizedDitherOpsAvailable()) {
+        QSKIP("The optimized dither ops are not available on this CPU");
+    }
+
+    testStandardDitherOpsForSource<KoGrayU8Traits, KoGrayU8Traits, KoGrayU16Traits, KoGrayF32Traits>(Integer8BitsColorDepthID);
+    testStandardDitherOpsForSource<KoGrayU16Traits, KoGrayU8Traits, KoGrayU16Traits, KoGrayF32Traits>(Integer16BitsColorDepthID);
+    testStandardDitherOpsForSource<KoGrayF32Traits, KoGrayU8Traits, KoGrayU16Traits, KoGrayF32Traits>(Float32BitsColorDepthID);
+}
+
+void TestKisDitherOp::testOptimizedCmyk()
+{
+    if (!optimizedDitherOpsAvailable()) {
+        QSKIP("The optimized dither ops are not available on this CPU");
+    }
+
+    testCmykDitherOpsForSource<KoCmykU8Traits>(Integer8BitsColorDepthID);
+    testCmykDitherOpsForSource<KoCmykU16Traits>(Integer16BitsColorDepthID);
+    testCmykDitherOpsForSource<KoCmykF32Traits>(Float32BitsColorDepthID);
+}
+
+void TestKisDitherOp::testOptimizedSinglePixel()
+{
+    if (!optimizedDitherOpsAvailable()) {
+        QSKIP("The optimized dither ops are not available on this CPU");
+    }
+
+    QScopedPointer<KisDitherOp> op(
+        KisOptimizedDitherOpFactory::create(Integer16BitsColorDepthID, Integer8BitsColorDepthID, 4, DITHER_BLUE_NOISE));
+    KisDitherOpImpl<KoBgrU16Traits, KoBgrU8Traits, DITHER_BLUE_NOISE> scalarOp(Integer16BitsColorDepthID, Integer8BitsColorDepthID);
+
+    QRandomGenerator random(1);
+
+    for (int i = 0; i < 256; i++) {
+        quint16 src[4];
+        for (int ch = 0; ch < 4; ch++) {
+            src[ch] = randomChannelValue<quint16>(random, false);
+        }
+
+        quint8 expected[4];
+        quint8 result[4];
+
+        scalarOp.dither(reinterpret_cast<const quint8*>(src), expected, i, 3 * i);
+        op->dither(reinterpret_cast<const quint8*>(src), result, i, 3 * i);
+
+        QVERIFY(!memcmp(result, expected, sizeof(result)));
+    }
+}
+
+QTEST_GUILESS_MAIN(TestKisDitherOp)
@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTKISDITHEROP_H
+#define TESTKISDITHEROP_H
+
+#include <QObject>
+
+class TestKisDitherOp : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testOptimizedRgb();
+    void testOptimizedGray();
+    void testOptimizedCmyk();
+    void testOptimizedSinglePixel();
+};
+
+#endif
@@ -9,6 +9,9 @@
 
 #include <cfloat>
 
+#include <QRandomGenerator>
+#include <QScopedPointer>
+
 #include <simpletest.h>
 
 template <class T>
@@ -398,5 +401,126 @@ void TestKoColorSpaceAbstract::testMixColorsOpU8NoAlphaLinear()
     QCOMPARE(outputPixel[COLOR_CHANNEL_2], mixOpNoAlphaExpectedColor(pixel1[COLOR_CHANNEL_2], pixel2[COLOR_CHANNEL_2], weights));
 }
 
+template <class T>
+void compareMixedPixels(const T *result, const T *expected, int numChannels)
+{
+    for (int i = 0; i < numChannels; i++) {
+        QCOMPARE(result[i], expected[i]);
+    }
+}
+
+template <>
+void compareMixedPixels<float>(const float *result, const float *expected, int numChannels)
+{
+    for (int i = 0; i < numChannels; i++) {
+        QVERIFY2(qAbs(result[i] - expected[i]) < 1e-6f,
+                 qPrintable(QString("channel %1: %2 != %3").arg(i).arg(result[i]).arg(expected[i])));
+    }
+}
+
+/**
+ * Compare the mixer against KoMixColorsOpImpl::mixColors() when the
+ * pixels are passed one-by-one (like the color smudge sampler does)
+ * and in chunks of different sizes
+ */
+template <class T>
+void testMixerRgbaImpl()
+{
+    typedef KoColorSpaceTrait<T, 4, 3> RgbaColorSpace;
+    QScopedPointer<KoMixColorsOpImpl<RgbaColorSpace>> op(new KoMixColorsOpImpl<RgbaColorSpace>);
+
+    const int numPixels = 1031;
+    const int numChannels = RgbaColorSpace::channels_nb;
+
+    QVector<T> pixels(numPixels * numChannels);
+    QVector<qint16> weights(numPixels);
+
+    QRandomGenerator random(1);
+
+    for (int i = 0; i < numPixels; i++) {
+        for (int ch = 0; ch < numChannels; ch++) {
+            pixels[i * numChannels + ch] =
+                KoColorSpaceMaths<float, T>::scaleToA(float(random.generateDouble()));
+        }
+        weights[i] = random.bounded(256);
+    }
+
+    // some transparent pixels
+    for (int i = 0; i < numPixels; i += 17) {
+        pixels[i * numChannels + RgbaColorSpace::alpha_pos] = KoColorSpaceMathsTraits<T>::zeroValue;
+    }
+
+    const quint8 *data = reinterpret_cast<const quint8*>(pixels.constData());
+    const int chunkSizes[] = {1, 3, 16, numPixels};
+
+    T expected[numChannels];
+    T result[numChannels];
+
+    int totalWeightSum = 0;
+    for (int i = 0; i < numPixels; i++) {
+        totalWeightSum += weights[i];
+    }
+    op->mixColors(data, weights.constData(), numPixels, reinterpret_cast<quint8*>(expected), totalWeightSum);
+
+    for (int chunkSize : chunkSizes) {
+        QScopedPointer<KoMixColorsOp::Mixer> mixer(op->createMixer());
+        qint64 accumulatedWeightSum = 0;
+
+        for (int start = 0; start < numPixels; start += chunkSize) {
+            const int size = qMin(chunkSize, numPixels - start);
+
+            int weightSum = 0;
+            for (int i = start; i < start + size; i++) {
+                weightSum += weights[i];
+            }
+
+            mixer->accumulate(data + start * RgbaColorSpace::pixelSize,
+                              weights.constData() + start, weightSum, size);
+            accumulatedWeightSum += weightSum;
+
+            // the sampler of the color smudge brush checks the mixed color every 16 pixels
+            if (start % 16 == 15) {
+                QCOMPARE(mixer->currentWeightsSum(), accumulatedWeightSum);
+                mixer->computeMixedColor(reinterpret_cast<quint8*>(result));
+            }
+        }
+
+        QCOMPARE(mixer->currentWeightsSum(), qint64(totalWeightSum));
+
+        mixer->computeMixedColor(reinterpret_cast<quint8*>(result));
+        compareMixedPixels(result, expected, numChannels);
+    }
+
+    op->mixColors(data, numPixels, reinterpret_cast<quint8*>(expected));
+
+    for (int chunkSize : chunkSizes) {
+        QScopedPointer<KoMixColorsOp::Mixer> mixer(op->createMixer());
+
+        for (int start = 0; start < numPixels; start += chunkSize) {
+            const int size = qMin(chunkSize, numPixels - start);
+            mixer->accumulateAverage(data + start * RgbaColorSpace::pixelSize, size);
+        }
+
+        QCOMPARE(mixer->currentWeightsSum(), qint64(numPixels));
+
+        mixer->computeMixedColor(reinterpret_cast<quint8*>(result));
+        compareMixedPixels(result, expected, numChannels);
+    }
+}
+
+void TestKoColorSpaceAbstract::testMixerRgbaU8()
+{
+    testMixerRgbaImpl<quint8>();
+}
+
+void TestKoColorSpaceAbstract::testMixerRgbaU16()
+{
+    testMixerRgbaImpl<quint16>();
+}
+
+void TestKoColorSpaceAbstract::testMixerRgbaF32()
+{
+    testMixerRgbaImpl<float>();
+}
 
 QTEST_GUILESS_MAIN(TestKoColorSpaceAbstract)
@@ -15,6 +15,9 @@ private Q_SLOTS:
     void testMixColorsOpF32();
     void testMixColorsOpU8NoAlpha();
     void testMixColorsOpU8NoAlphaLinear();
+    void testMixerRgbaU8();
+    void testMixerRgbaU16();
+    void testMixerRgbaF32();
 };
 
 #endif
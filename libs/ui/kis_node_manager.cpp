@@ -184,6 +184,10 @@ bool KisNodeManager::Private::activateNodeImpl(KisNodeSP node)
             layerManager.activateLayer(static_cast<KisLayer*>(node->parent().data()));
         }
     }
+
+    // keep the tiles of the active node in memory as long as possible
+    imageView->image()->setMemoryActiveNode(node);
+
     return true;
 }
 
@@ -219,6 +223,7 @@ void KisNodeManager::setView(QPointer<KisView>imageView)
         connect(shapeController, SIGNAL(sigActivateNode(KisNodeSP)), SLOT(slotNonUiActivatedNode(KisNodeSP)));
         m_d->activateNodeConnection.connectInputSignal(m_d->imageView->image(), &KisImage::sigRequestNodeReselection);
         m_d->imageView->resourceProvider()->slotNodeActivated(m_d->imageView->currentNode());
+        m_d->imageView->image()->setMemoryActiveNode(m_d->imageView->currentNode());
         connect(m_d->imageView->image(), SIGNAL(sigIsolatedModeChanged()), this, SLOT(handleExternalIsolationChange()));
     }
 
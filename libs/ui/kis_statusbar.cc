@@ -14,6 +14,7 @@
 #include <QAction>
 #include <QToolTip>
 #include <QStatusBar>
+#include <QLocale>
 
 #include <ksqueezedtextlabel.h>
 #include <klocalizedstring.h>
@@ -269,7 +270,8 @@ void KisStatusBar::updateMemoryStatus()
 {
     KisMemoryStatisticsServer::Statistics stats =
             KisMemoryStatisticsServer::instance()
-            ->fetchMemoryStatistics(m_imageView ? m_imageView->image() : 0);
+            ->fetchMemoryStatistics(m_imageView ? m_imageView->image() : 0,
+                                    m_imageView ? m_viewManager->activeNode() : 0);
     const KFormat format;
 
     const QString imageStatsMsg =
@@ -283,12 +285,29 @@ void KisStatusBar::updateMemoryStatus()
                   format.formatByteSize(stats.projectionsSize),
                   format.formatByteSize(stats.lodSize));
 
+    const QString activeNodeStatsMsg =
+            i18nc("tooltip on statusbar memory reporting button (active layer stats)",
+                  "Active layer:\t %1\n"
+                  "  - in memory:\t %2\n"
+                  "  - swapped:\t %3\n",
+                  format.formatByteSize(stats.activeNodeResidentSize + stats.activeNodeSwappedSize),
+                  format.formatByteSize(stats.activeNodeResidentSize),
+                  format.formatByteSize(stats.activeNodeSwappedSize));
+
+    const QString sharingStatsMsg =
+            i18nc("tooltip on statusbar memory reporting button (memory saved by sharing "
+                  "identical tiles and its ratio to the image data in memory)",
+                  "%1 (%2%)",
+                  format.formatByteSize(stats.deduplicatedSize),
+                  QLocale().toString(stats.deduplicationRatio * 100.0, 'f', 1));
+
     const QString memoryStatsMsg =
             i18nc("tooltip on statusbar memory reporting button (total stats)",
                   "Memory used:\t %1 / %2\n"
                   "  image data:\t %3 / %4\n"
                   "  pool:\t\t %5 / %6\n"
                   "  undo data:\t %7\n"
+                  "  saved by sharing:\t %9\n"
                   "\n"
                   "Swap used:\t %8",
                   format.formatByteSize(stats.totalMemorySize),
@@ -301,9 +320,10 @@ void KisStatusBar::updateMemoryStatus()
                   format.formatByteSize(stats.tilesPoolLimit),
 
                   format.formatByteSize(stats.historicalMemorySize),
-                  format.formatByteSize(stats.swapSize));
+                  format.formatByteSize(stats.swapSize),
+                  sharingStatsMsg);
 
-    QString longStats = imageStatsMsg + "\n" + memoryStatsMsg;
+    QString longStats = imageStatsMsg + "\n" + activeNodeStatsMsg + "\n" + memoryStatsMsg;
 
     QString shortStats = format.formatByteSize(stats.imageSize);
     QIcon icon;
@@ -115,6 +115,13 @@ void FreehandStrokeStrategy::init(Flags flags)
 
     enableJob(KisSimpleStrokeStrategy::JOB_DOSTROKE);
 
+    /**
+     * The node has only one temporary target, so the LoD0 stroke can be
+     * replayed alongside its LodN buddy only when painting directly
+     */
+    setSupportsSpeculativeLod0Replay(!m_d->resources->needsIndirectPainting() &&
+                                     !m_d->resources->needsMaskingBrushRendering());
+
     if (m_d->needsAsynchronousUpdates) {
         /**
          * In case the paintop uses asynchronous updates, we should set priority to it,
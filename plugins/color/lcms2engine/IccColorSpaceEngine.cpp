@@ -12,6 +12,7 @@
 #include <klocalizedstring.h>
 
 #include "LcmsColorSpace.h"
+#include "LcmsMatrixShaperColorConversionTransformation.h"
 
 // -- KoLcmsColorConversionTransformation --
 
@@ -245,10 +246,21 @@ KoColorConversionTransformation *IccColorSpaceEngine::createColorTransformation(
     Q_ASSERT(srcColorSpace);
     Q_ASSERT(dstColorSpace);
 
+    LcmsColorProfileContainer *srcProfile = dynamic_cast<const IccColorProfile *>(srcColorSpace->profile())->asLcms();
+    LcmsColorProfileContainer *dstProfile = dynamic_cast<const IccColorProfile *>(dstColorSpace->profile())->asLcms();
+
+    KoColorConversionTransformation *fastTransformation =
+        LcmsMatrixShaperColorConversionTransformation::tryCreate(srcColorSpace, srcProfile,
+                                                                 dstColorSpace, dstProfile,
+                                                                 renderingIntent, conversionFlags);
+    if (fastTransformation) {
+        return fastTransformation;
+    }
+
     return new KoLcmsColorConversionTransformation(
-                srcColorSpace, computeColorSpaceType(srcColorSpace),
-                dynamic_cast<const IccColorProfile *>(srcColorSpace->profile())->asLcms(), dstColorSpace, computeColorSpaceType(dstColorSpace),
-                dynamic_cast<const IccColorProfile *>(dstColorSpace->profile())->asLcms(), renderingIntent, conversionFlags);
+                srcColorSpace, computeColorSpaceType(srcColorSpace), srcProfile,
+                dstColorSpace, computeColorSpaceType(dstColorSpace), dstProfile,
+                renderingIntent, conversionFlags);
 
 }
 KoColorProofingConversionTransformation *IccColorSpaceEngine::createColorProofingTransformation(const KoColorSpace *srcColorSpace,
@@ -0,0 +1,292 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "LcmsMatrixShaperColorConversionTransformation.h"
+
+#include <QtMath>
+
+#include <KoColorSpace.h>
+#include <KoColorModelStandardIds.h>
+#include <KoOptimizedMatrixShaperConverterBase.h>
+#include <KoOptimizedMatrixShaperConverterFactory.h>
+
+#include "colorprofiles/LcmsColorProfileContainer.h"
+
+namespace {
+
+using Params = KoOptimizedMatrixShaperConverterBase::Params;
+
+struct MatrixShaperProfile
+{
+    bool isValid = false;
+    const cmsToneCurve *curves[3] = {nullptr, nullptr, nullptr};
+
+    /// row-major RGB -> XYZ(D50) matrix
+    double matrix[9];
+};
+
+MatrixShaperProfile readMatrixShaperProfile(cmsHPROFILE profile)
+{
+    const cmsTagSignature trcTags[3] = {cmsSigRedTRCTag, cmsSigGreenTRCTag, cmsSigBlueTRCTag};
+    const cmsTagSignature colorantTags[3] = {cmsSigRedColorantTag, cmsSigGreenColorantTag, cmsSigBlueColorantTag};
+
+    MatrixShaperProfile result;
+
+    if (cmsGetColorSpace(profile) != cmsSigRgbData || !cmsIsMatrixShaper(profile)) {
+        return result;
+    }
+
+    for (int ch = 0; ch < 3; ch++) {
+        const cmsToneCurve *curve = static_cast<const cmsToneCurve*>(cmsReadTag(profile, trcTags[ch]));
+        const cmsCIEXYZ *colorant = static_cast<const cmsCIEXYZ*>(cmsReadTag(profile, colorantTags[ch]));
+
+        if (!curve || !colorant) {
+            return result;
+        }
+
+        /**
+         * LCMS detects the black point of a matrix-shaper profile as
+         * the darkest colorant, so when the curves pass through zero,
+         * black point compensation does nothing (and it is enabled
+         * implicitly for V4 profiles in perceptual intent)
+         */
+        if (qAbs(cmsEvalToneCurveFloat(curve, 0.0f)) > 1e-6f) {
+            return result;
+        }
+
+        result.curves[ch] = curve;
+        result.matrix[0 * 3 + ch] = colorant->X;
+        result.matrix[1 * 3 + ch] = colorant->Y;
+        result.matrix[2 * 3 + ch] = colorant->Z;
+    }
+
+    result.isValid = true;
+    return result;
+}
+
+bool invertMatrix(const double *m, double *result)
+{
+    const double det =
+        m[0] * (m[4] * m[8] - m[5] * m[7]) -
+        m[1] * (m[3] * m[8] - m[5] * m[6]) +
+        m[2] * (m[3] * m[7] - m[4] * m[6]);
+
+    if (qAbs(det) < 1e-12) return false;
+
+    const double invDet = 1.0 / det;
+
+    result[0] =  (m[4] * m[8] - m[5] * m[7]) * invDet;
+    result[1] = -(m[1] * m[8] - m[2] * m[7]) * invDet;
+    result[2] =  (m[1] * m[5] - m[2] * m[4]) * invDet;
+    result[3] = -(m[3] * m[8] - m[5] * m[6]) * invDet;
+    result[4] =  (m[0] * m[8] - m[2] * m[6]) * invDet;
+    result[5] = -(m[0] * m[5] - m[2] * m[3]) * invDet;
+    result[6] =  (m[3] * m[7] - m[4] * m[6]) * invDet;
+    result[7] = -(m[0] * m[7] - m[1] * m[6]) * invDet;
+    result[8] =  (m[0] * m[4] - m[1] * m[3]) * invDet;
+
+    return true;
+}
+
+bool isIntegerDepth(const KoID &depthId)
+{
+    return depthId == Integer8BitsColorDepthID ||
+        depthId == Integer16BitsColorDepthID;
+}
+
+bool curvesAreEqual(const cmsToneCurve *lhs, const cmsToneCurve *rhs)
+{
+    if (lhs == rhs) return true;
+
+    const int numSamples = 1024;
+
+    for (int i = 0; i <= numSamples; i++) {
+        const float x = float(i) / numSamples;
+        if (qAbs(cmsEvalToneCurveFloat(lhs, x) - cmsEvalToneCurveFloat(rhs, x)) > 1e-6f) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QVector<float> createLinearizationLut(const cmsToneCurve *curve, int size)
+{
+    QVector<float> lut(size);
+
+    for (int i = 0; i < size; i++) {
+        lut[i] = cmsEvalToneCurveFloat(curve, float(i) / (size - 1));
+    }
+
+    return lut;
+}
+
+/**
+ * Samples the inverse of \p curve and checks that linear interpolation
+ * between the samples does not deviate from the real curve more than
+ * \p maxError. Returns false if the curve cannot be sampled precisely
+ * enough.
+ */
+bool createEncodingLut(const cmsToneCurve *curve, float maxError, QVector<float> *lut)
+{
+    const int size = KoOptimizedMatrixShaperConverterBase::encodingLutSize;
+
+    cmsToneCurve *reverse = cmsReverseToneCurve(curve);
+    if (!reverse) return false;
+
+    QVector<float> samples(size + 1);
+
+    for (int i = 0; i <= size; i++) {
+        samples[i] = cmsEvalToneCurveFloat(reverse, float(i) / size);
+    }
+
+    bool isPrecise = true;
+
+    for (int i = 0; i < size; i++) {
+        const float exact = cmsEvalToneCurveFloat(reverse, (i + 0.5f) / size);
+        const float interpolated = 0.5f * (samples[i] + samples[i + 1]);
+
+        if (qAbs(exact - interpolated) > maxError) {
+            isPrecise = false;
+            break;
+        }
+    }
+
+    cmsFreeToneCurve(reverse);
+
+    if (isPrecise) {
+        *lut = samples;
+    }
+
+    return isPrecise;
+}
+
+/**
+ * The profiles usually have the same curve for all three channels,
+ * so let them share the memory of the table
+ */
+void shareEqualLuts(QVector<float> *luts)
+{
+    for (int ch = 1; ch < 3; ch++) {
+        for (int prev = 0; prev < ch; prev++) {
+            if (!luts[ch].isEmpty() && luts[ch] == luts[prev]) {
+                luts[ch] = luts[prev];
+                break;
+            }
+        }
+    }
+}
+
+}
+
+LcmsMatrixShaperColorConversionTransformation::LcmsMatrixShaperColorConversionTransformation(const KoColorSpace *srcCs,
+                                                                                           const KoColorSpace *dstCs,
+                                                                                           Intent renderingIntent,
+                                                                                           ConversionFlags conversionFlags,
+                                                                                           KoOptimizedMatrixShaperConverterBase *converter)
+    : KoColorConversionTransformation(srcCs, dstCs, renderingIntent, conversionFlags)
+    , m_converter(converter)
+{
+}
+
+LcmsMatrixShaperColorConversionTransformation::~LcmsMatrixShaperColorConversionTransformation()
+{
+}
+
+KoColorConversionTransformation *LcmsMatrixShaperColorConversionTransformation::tryCreate(const KoColorSpace *srcCs, LcmsColorProfileContainer *srcProfile,
+                                                                                           const KoColorSpace *dstCs, LcmsColorProfileContainer *dstProfile,
+                                                                                           Intent renderingIntent,
+                                                                                           ConversionFlags conversionFlags)
+{
+    if (srcCs->colorModelId() != RGBAColorModelID ||
+        dstCs->colorModelId() != RGBAColorModelID ||
+        !KoOptimizedMatrixShaperConverterFactory::isSupported(srcCs->colorDepthId(), dstCs->colorDepthId())) {
+
+        return nullptr;
+    }
+
+    // absolute colorimetric intent also scales the white point
+    if (renderingIntent == IntentAbsoluteColorimetric) {
+        return nullptr;
+    }
+
+    const MatrixShaperProfile src = readMatrixShaperProfile(srcProfile->lcmsProfile());
+    const MatrixShaperProfile dst = readMatrixShaperProfile(dstProfile->lcmsProfile());
+
+    if (!src.isValid || !dst.isValid) {
+        return nullptr;
+    }
+
+    Params params;
+    params.srcDepthId = srcCs->colorDepthId();
+    params.dstDepthId = dstCs->colorDepthId();
+
+    double dstInverseMatrix[9];
+    if (!invertMatrix(dst.matrix, dstInverseMatrix)) {
+        return nullptr;
+    }
+
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            double value = 0.0;
+            for (int i = 0; i < 3; i++) {
+                value += dstInverseMatrix[row * 3 + i] * src.matrix[i * 3 + col];
+            }
+            params.matrix[row * 3 + col] = float(value);
+        }
+    }
+
+    const bool srcIsInteger = isIntegerDepth(params.srcDepthId);
+    const bool dstIsInteger = isIntegerDepth(params.dstDepthId);
+
+    /**
+     * When the profiles have the same primaries and curves, the
+     * curves cancel each other and only the depth is changed
+     */
+    bool curvesCancelOut = params.isIdentityMatrix();
+    for (int ch = 0; ch < 3 && curvesCancelOut; ch++) {
+        curvesCancelOut = curvesAreEqual(src.curves[ch], dst.curves[ch]);
+    }
+
+    if (!curvesCancelOut) {
+        const int srcLutSize = params.srcDepthId == Integer8BitsColorDepthID ? 256 : 65536;
+        const float maxEncodingError = params.dstDepthId == Integer8BitsColorDepthID ?
+            0.25f / 255.0f : 1.0f / 65535.0f;
+
+        for (int ch = 0; ch < 3; ch++) {
+            if (!cmsIsToneCurveLinear(src.curves[ch])) {
+                if (!srcIsInteger) return nullptr;
+                params.srcLinearizationLut[ch] = createLinearizationLut(src.curves[ch], srcLutSize);
+            }
+
+            if (!cmsIsToneCurveLinear(dst.curves[ch])) {
+                if (!dstIsInteger) return nullptr;
+                if (!createEncodingLut(dst.curves[ch], maxEncodingError, &params.dstEncodingLut[ch])) {
+                    return nullptr;
+                }
+            }
+        }
+
+        shareEqualLuts(params.srcLinearizationLut);
+        shareEqualLuts(params.dstEncodingLut);
+    }
+
+    KoOptimizedMatrixShaperConverterBase *converter =
+        KoOptimizedMatrixShaperConverterFactory::create(params);
+
+    if (!converter) {
+        return nullptr;
+    }
+
+    return new LcmsMatrixShaperColorConversionTransformation(srcCs, dstCs,
+                                                             renderingIntent, conversionFlags,
+                                                             converter);
+}
+
+void LcmsMatrixShaperColorConversionTransformation::transform(const quint8 *src, quint8 *dst, qint32 numPixels) const
+{
+    m_converter->convert(src, dst, numPixels);
+}
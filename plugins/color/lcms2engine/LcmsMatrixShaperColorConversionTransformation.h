@@ -0,0 +1,65 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef LCMSMATRIXSHAPERCOLORCONVERSIONTRANSFORMATION_H
+#define LCMSMATRIXSHAPERCOLORCONVERSIONTRANSFORMATION_H
+
+#include <QScopedPointer>
+
+#include <KoColorConversionTransformation.h>
+
+class LcmsColorProfileContainer;
+class KoOptimizedMatrixShaperConverterBase;
+
+/**
+ * A fast path for the conversions between RGBA color spaces with
+ * matrix-shaper profiles, e.g. sRGB U8 -> linear sRGB U16 or
+ * linear Rec2020 U16 -> linear Rec2020 F32.
+ *
+ * The transformation does the same math as LCMS does for such
+ * profiles (tone curves -> 3x3 matrix -> inverse tone curves), but
+ * the curves are sampled into lookup tables and the pixels are
+ * processed with SIMD instructions by KoOptimizedMatrixShaperConverter.
+ *
+ * The transformation can be created only when the result is known
+ * to match LCMS closely:
+ *
+ * - both profiles are RGB matrix-shaper ones and their black is real zero
+ *   (so black point compensation is a no-op)
+ * - the rendering intent is not absolute colorimetric
+ * - the tone curves of floating point color spaces are linear, because
+ *   LCMS evaluates the curves in unbounded mode there
+ * - the inverse curves of integer color spaces can be interpolated
+ *   precisely enough (it is not the case for pure gamma curves, which
+ *   have infinite slope at zero)
+ *
+ * In all other cases tryCreate() returns nullptr and the caller should
+ * fall back to a normal LCMS transformation.
+ */
+class LcmsMatrixShaperColorConversionTransformation : public KoColorConversionTransformation
+{
+public:
+    static KoColorConversionTransformation* tryCreate(const KoColorSpace *srcCs, LcmsColorProfileContainer *srcProfile,
+                                                      const KoColorSpace *dstCs, LcmsColorProfileContainer *dstProfile,
+                                                      Intent renderingIntent,
+                                                      ConversionFlags conversionFlags);
+
+    ~LcmsMatrixShaperColorConversionTransformation() override;
+
+    void transform(const quint8 *src, quint8 *dst, qint32 numPixels) const override;
+
+private:
+    LcmsMatrixShaperColorConversionTransformation(const KoColorSpace *srcCs,
+                                                  const KoColorSpace *dstCs,
+                                                  Intent renderingIntent,
+                                                  ConversionFlags conversionFlags,
+                                                  KoOptimizedMatrixShaperConverterBase *converter);
+
+private:
+    QScopedPointer<KoOptimizedMatrixShaperConverterBase> m_converter;
+};
+
+#endif // LCMSMATRIXSHAPERCOLORCONVERSIONTRANSFORMATION_H
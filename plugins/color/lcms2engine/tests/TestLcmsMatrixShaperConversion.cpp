@@ -0,0 +1,174 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestLcmsMatrixShaperConversion.h"
+
+#include <simpletest.h>
+#include "sdk/tests/testpigment.h"
+
+#include <QRandomGenerator>
+
+#include <KoConfig.h>
+#include "KoColorProfile.h"
+#include "KoColorSpace.h"
+#include "KoColorSpaceRegistry.h"
+#include "KoColorModelStandardIds.h"
+
+#include <lcms2.h>
+
+namespace {
+
+const QString sRGBProfile = "sRGB-elle-V2-srgbtrc.icc";
+const QString sRGBLinearProfile = "sRGB-elle-V2-g10.icc";
+const QString rec2020LinearProfile = "Rec2020-elle-V4-g10.icc";
+const QString clayRGBGamma22Profile = "ClayRGB-elle-V2-g22.icc";
+
+cmsUInt32Number lcmsPixelType(const KoID &depthId)
+{
+    if (depthId == Integer8BitsColorDepthID) {
+        return TYPE_BGRA_8;
+    } else if (depthId == Integer16BitsColorDepthID) {
+        return TYPE_BGRA_16;
+    } else if (depthId == Float16BitsColorDepthID) {
+        return TYPE_RGBA_HALF_FLT;
+    }
+
+    return TYPE_RGBA_FLT;
+}
+
+float toleranceForDepth(const KoID &depthId)
+{
+    if (depthId == Integer8BitsColorDepthID) {
+        return 1.01f / 255.0f;
+    } else if (depthId == Integer16BitsColorDepthID) {
+        return 8.0f / 65535.0f;
+    } else if (depthId == Float16BitsColorDepthID) {
+        return 2e-3f;
+    }
+
+    return 1e-4f;
+}
+
+void fillRandomPixels(const KoColorSpace *cs, quint8 *data, int numPixels)
+{
+    QRandomGenerator random(1);
+    QVector<float> channels(4);
+
+    // floating point color spaces are tested with HDR values as well
+    const float maxColorValue = cs->colorDepthId().id().startsWith('F') ? 1.5f : 1.0f;
+
+    for (int i = 0; i < numPixels; i++) {
+        for (int ch = 0; ch < 3; ch++) {
+            channels[ch] = float(random.generateDouble()) * maxColorValue;
+        }
+        channels[3] = float(random.generateDouble());
+
+        cs->fromNormalisedChannelsValue(data + i * cs->pixelSize(), channels);
+    }
+}
+
+}
+
+void TestLcmsMatrixShaperConversion::testCompareWithLcms_data()
+{
+    QTest::addColumn<QString>("srcProfile");
+    QTest::addColumn<KoID>("srcDepth");
+    QTest::addColumn<QString>("dstProfile");
+    QTest::addColumn<KoID>("dstDepth");
+
+    QTest::newRow("srgb-u8 -> linear-u16") << sRGBProfile << Integer8BitsColorDepthID << sRGBLinearProfile << Integer16BitsColorDepthID;
+    QTest::newRow("linear-u16 -> srgb-u8") << sRGBLinearProfile << Integer16BitsColorDepthID << sRGBProfile << Integer8BitsColorDepthID;
+    QTest::newRow("srgb-u8 -> srgb-u16") << sRGBProfile << Integer8BitsColorDepthID << sRGBProfile << Integer16BitsColorDepthID;
+    QTest::newRow("srgb-u16 -> srgb-f32") << sRGBProfile << Integer16BitsColorDepthID << sRGBProfile << Float32BitsColorDepthID;
+    QTest::newRow("srgb-u16 -> linear-f32") << sRGBProfile << Integer16BitsColorDepthID << sRGBLinearProfile << Float32BitsColorDepthID;
+    QTest::newRow("linear-u16 -> linear-f32") << sRGBLinearProfile << Integer16BitsColorDepthID << sRGBLinearProfile << Float32BitsColorDepthID;
+    QTest::newRow("linear-f32 -> linear-u16") << sRGBLinearProfile << Float32BitsColorDepthID << sRGBLinearProfile << Integer16BitsColorDepthID;
+    QTest::newRow("linear-f32 -> srgb-u8") << sRGBLinearProfile << Float32BitsColorDepthID << sRGBProfile << Integer8BitsColorDepthID;
+    QTest::newRow("srgb-u8 -> rec2020-f32") << sRGBProfile << Integer8BitsColorDepthID << rec2020LinearProfile << Float32BitsColorDepthID;
+    QTest::newRow("rec2020-f32 -> srgb-u16") << rec2020LinearProfile << Float32BitsColorDepthID << sRGBProfile << Integer16BitsColorDepthID;
+    QTest::newRow("linear-f32 -> rec2020-f32") << sRGBLinearProfile << Float32BitsColorDepthID << rec2020LinearProfile << Float32BitsColorDepthID;
+
+#ifdef HAVE_OPENEXR
+    QTest::newRow("linear-f16 -> linear-f32") << sRGBLinearProfile << Float16BitsColorDepthID << sRGBLinearProfile << Float32BitsColorDepthID;
+    QTest::newRow("linear-f32 -> linear-f16") << sRGBLinearProfile << Float32BitsColorDepthID << sRGBLinearProfile << Float16BitsColorDepthID;
+    QTest::newRow("rec2020-f16 -> srgb-u8") << rec2020LinearProfile << Float16BitsColorDepthID << sRGBProfile << Integer8BitsColorDepthID;
+#endif
+
+    // pure gamma curves are not precise enough in the fast path, so they should fall back to LCMS
+    QTest::newRow("srgb-u8 -> clay-g22-u16") << sRGBProfile << Integer8BitsColorDepthID << clayRGBGamma22Profile << Integer16BitsColorDepthID;
+}
+
+void TestLcmsMatrixShaperConversion::testCompareWithLcms()
+{
+    QFETCH(QString, srcProfile);
+    QFETCH(KoID, srcDepth);
+    QFETCH(QString, dstProfile);
+    QFETCH(KoID, dstDepth);
+
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    const KoColorSpace *srcCs = registry->colorSpace(RGBAColorModelID.id(), srcDepth.id(), srcProfile);
+    const KoColorSpace *dstCs = registry->colorSpace(RGBAColorModelID.id(), dstDepth.id(), dstProfile);
+
+    if (!srcCs || !dstCs) {
+        QSKIP("The color spaces are not available on this system");
+    }
+
+    const int numPixels = 4099; // not a multiple of the SIMD register size
+    const KoColorConversionTransformation::Intent intent = KoColorConversionTransformation::internalRenderingIntent();
+    const KoColorConversionTransformation::ConversionFlags flags = KoColorConversionTransformation::internalConversionFlags();
+
+    QVector<quint8> srcData(numPixels * srcCs->pixelSize());
+    QVector<quint8> dstData(numPixels * dstCs->pixelSize());
+    QVector<quint8> refData(numPixels * dstCs->pixelSize());
+
+    fillRandomPixels(srcCs, srcData.data(), numPixels);
+
+    srcCs->convertPixelsTo(srcData.data(), dstData.data(), dstCs, numPixels, intent, flags);
+
+    const QByteArray srcIcc = srcCs->profile()->rawData();
+    const QByteArray dstIcc = dstCs->profile()->rawData();
+
+    cmsHPROFILE srcLcmsProfile = cmsOpenProfileFromMem(srcIcc.constData(), srcIcc.size());
+    cmsHPROFILE dstLcmsProfile = cmsOpenProfileFromMem(dstIcc.constData(), dstIcc.size());
+    QVERIFY(srcLcmsProfile);
+    QVERIFY(dstLcmsProfile);
+
+    cmsHTRANSFORM refTransform =
+        cmsCreateTransform(srcLcmsProfile, lcmsPixelType(srcDepth),
+                           dstLcmsProfile, lcmsPixelType(dstDepth),
+                           intent,
+                           static_cast<cmsUInt32Number>(flags) | cmsFLAGS_NOOPTIMIZE | cmsFLAGS_COPY_ALPHA);
+    QVERIFY(refTransform);
+
+    cmsDoTransform(refTransform, srcData.constData(), refData.data(), numPixels);
+
+    cmsDeleteTransform(refTransform);
+    cmsCloseProfile(srcLcmsProfile);
+    cmsCloseProfile(dstLcmsProfile);
+
+    const float tolerance = toleranceForDepth(dstDepth);
+    QVector<float> result(4);
+    QVector<float> reference(4);
+
+    for (int i = 0; i < numPixels; i++) {
+        dstCs->normalisedChannelsValue(dstData.constData() + i * dstCs->pixelSize(), result);
+        dstCs->normalisedChannelsValue(refData.constData() + i * dstCs->pixelSize(), reference);
+
+        for (int ch = 0; ch < 4; ch++) {
+            // floating point values are compared relatively to their magnitude
+            const float scaledTolerance = tolerance * qMax(1.0f, qAbs(reference[ch]));
+
+            if (qAbs(result[ch] - reference[ch]) > scaledTolerance) {
+                qDebug() << "Pixel" << i << "channel" << ch
+                         << "result" << result << "reference" << reference;
+                QFAIL("The result doesn't match LCMS");
+            }
+        }
+    }
+}
+
+KISTEST_MAIN(TestLcmsMatrixShaperConversion)
@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTLCMSMATRIXSHAPERCONVERSION_H
+#define TESTLCMSMATRIXSHAPERCONVERSION_H
+
+#include <QObject>
+
+class TestLcmsMatrixShaperConversion : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testCompareWithLcms_data();
+    void testCompareWithLcms();
+};
+
+#endif // TESTLCMSMATRIXSHAPERCONVERSION_H
@@ -51,6 +51,7 @@ HistogramComputationStrokeStrategy::HistogramComputationStrokeStrategy(KisImageW
     setRequestsOtherStrokesToEnd(false);
     setClearsRedoOnStart(false);
     setCanForgetAboutMe(true);
+    setPriority(KisStrokeStrategy::BACKGROUND);
 }
 
 HistogramComputationStrokeStrategy::~HistogramComputationStrokeStrategy()
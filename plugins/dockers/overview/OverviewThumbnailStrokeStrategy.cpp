@@ -54,6 +54,7 @@ OverviewThumbnailStrokeStrategy::OverviewThumbnailStrokeStrategy(KisPaintDeviceS
     setRequestsOtherStrokesToEnd(false);
     setClearsRedoOnStart(false);
     setCanForgetAboutMe(true);
+    setPriority(KisStrokeStrategy::BACKGROUND);
 }
 
 OverviewThumbnailStrokeStrategy::~OverviewThumbnailStrokeStrategy()
@@ -868,6 +868,8 @@ void InplaceTransformStrokeStrategy::reapplyTransform(ToolTransformArgs args,
          * still blocked by m_d->commandUpdatesBlockerCookie (for easy undo
          * purposes)
          */
+        KisBatchNodeUpdate graphUpdates;
+
         for (auto it = updateData->begin(); it != updateData->end(); ++it) {
             KisTransformMask *transformMask = dynamic_cast<KisTransformMask*>(it->first.data());
 
@@ -876,10 +878,12 @@ void InplaceTransformStrokeStrategy::reapplyTransform(ToolTransformArgs args,
                      (levelOfDetail <= 0 && m_d->previewLevelOfDetail > 0))) {
                 transformMask->threadSafeForceStaticImageUpdate();
             } else {
-                m_d->updatesFacade->refreshGraphAsync(it->first, it->second);
+                graphUpdates.addUpdate(it->first, it->second);
             }
 
         }
+
+        m_d->updatesFacade->refreshGraphAsync(graphUpdates);
     });
 }
 